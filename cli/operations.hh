@@ -11,17 +11,211 @@
 #ifndef _OPERATIONS_HH_
 #define _OPERATIONS_HH_
 
+// Standard library headers
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 // VATA headers
 #include <vata/vata.hh>
+#include <vata/util/cancellation.hh>
 
 // local headers
 #include "parse_args.hh"
+#include "profile.hh"
 
 using VATA::Util::Convert;
 using VATA::AutBase;
 
 extern timespec startTime;
 
+// only explicit automata have the engine for word automata
+template <class Automaton>
+bool CheckWordInclusion(const Automaton&, const Automaton&, bool, bool&)
+{
+	return false;
+}
+
+template <class SymbolType>
+bool CheckWordInclusion(const VATA::ExplicitTreeAut<SymbolType>& smaller,
+	const VATA::ExplicitTreeAut<SymbolType>& bigger, bool useSimulation,
+	bool& result)
+{
+	if (!VATA::IsWordAut(smaller) || !VATA::IsWordAut(bigger))
+	{
+		return false;
+	}
+
+	ProfilePhase phase("inclusion");
+	result = VATA::CheckWordInclusion(smaller, bigger, useSimulation);
+	return true;
+}
+
+/**
+ * @brief  Runs the strategies in separate threads and returns the first answer
+ *
+ * The remaining strategies are cancelled through @p token, which they poll.
+ * If all strategies fail, the first error is rethrown; if all of them are
+ * cancelled, e.g., at the deadline of @p token, the cancellation is rethrown.
+ */
+inline bool RaceStrategies(const std::vector<std::function<bool()>>& strategies,
+	VATA::Util::CancellationToken& token)
+{
+	std::mutex mutex;
+	std::condition_variable finished;
+	size_t running = strategies.size();
+	bool hasResult = false;
+	bool result = false;
+	std::exception_ptr error;
+
+	std::vector<std::thread> threads;
+	for (const std::function<bool()>& strategy : strategies)
+	{
+		threads.push_back(std::thread([&, strategy]()
+		{
+			bool answer = false;
+			std::exception_ptr strategyError;
+			bool cancelled = false;
+
+			try
+			{
+				VATA::Util::CancellationScope scope(token);
+				answer = strategy();
+			}
+			catch (VATA::Util::OperationCancelled&)
+			{
+				cancelled = true;
+			}
+			catch (...)
+			{
+				strategyError = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (strategyError)
+			{
+				if (!error)
+				{
+					error = strategyError;
+				}
+			}
+			else if (!cancelled && !hasResult)
+			{
+				hasResult = true;
+				result = answer;
+				token.Cancel();
+			}
+
+			--running;
+			finished.notify_one();
+		}));
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		finished.wait(lock, [&]() { return hasResult || (running == 0); });
+	}
+
+	token.Cancel();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (!hasResult && error)
+	{
+		std::rethrow_exception(error);
+	}
+	else if (!hasResult)
+	{	// all strategies have been cancelled, e.g., by the deadline
+		token.ThrowCancelled();
+	}
+
+	return result;
+}
+
+// the engines of symbolic automata share the global MTBDD node stores and
+// cannot run concurrently
+template <class Automaton>
+bool CheckPortfolioInclusion(const Automaton&, const Automaton&,
+	AutBase::StateType)
+{
+	throw std::runtime_error("Portfolio inclusion is supported only for "
+		"explicit automata");
+}
+
+template <class SymbolType>
+bool CheckPortfolioInclusion(const VATA::ExplicitTreeAut<SymbolType>& smaller,
+	const VATA::ExplicitTreeAut<SymbolType>& bigger, AutBase::StateType states)
+{
+	typedef AutBase::StateBinaryRelation StateBinaryRelation;
+
+	// the strategies are stopped by a token of their own, which keeps the
+	// deadline of the token of the caller
+	VATA::Util::CancellationToken token;
+	if (VATA::Util::CancellationToken::GetCurrent() != nullptr)
+	{
+		token.InheritLimits(*VATA::Util::CancellationToken::GetCurrent());
+	}
+
+	// created here as adding transitions modifies the cache of tuples, the
+	// strategies only read the automata
+	VATA::ExplicitTreeAut<SymbolType> unionAut =
+		VATA::UnionDisjunctStates(smaller, bigger);
+	VATA::Util::Identity ident(states);
+
+	// every simulation is computed once for the strategies that need it
+	auto computeSimulation = [&token](
+		std::function<StateBinaryRelation()> compute)
+	{
+		return std::async(std::launch::async, [&token, compute]()
+		{
+			VATA::Util::CancellationScope scope(token);
+			return compute();
+		}).share();
+	};
+
+	std::shared_future<StateBinaryRelation> upSim = computeSimulation([&]()
+	{
+		return VATA::ComputeUpwardSimulation(unionAut, states);
+	});
+	std::shared_future<StateBinaryRelation> downSim = computeSimulation([&]()
+	{
+		return VATA::ComputeDownwardSimulation(unionAut, states);
+	});
+
+	std::vector<std::function<bool()>> strategies =
+	{
+		[&]() { return VATA::CheckUpwardInclusionWithPreorder(smaller, bigger,
+			ident); },
+		[&]() { return VATA::CheckUpwardInclusionWithPreorder(smaller, bigger,
+			upSim.get()); },
+		[&]() { return VATA::CheckDownwardInclusionWithPreorder(smaller, bigger,
+			ident); },
+		[&]() { return VATA::CheckDownwardInclusionWithPreorder(smaller, bigger,
+			downSim.get()); },
+		[&]() { return VATA::CheckOptDownwardInclusionWithPreorder(smaller,
+			bigger, ident); }
+	};
+
+	bool result = RaceStrategies(strategies, token);
+
+	// the simulations see the cancelled token and stop
+	try
+	{
+		upSim.wait();
+		downSim.wait();
+	}
+	catch (...)
+	{ }
+
+	return result;
+}
+
 template <class Automaton>
 bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 {
@@ -32,17 +226,44 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 	options.insert(std::make_pair("optC", "no"));
 	options.insert(std::make_pair("timeS", "yes"));
 	options.insert(std::make_pair("rec", "yes"));
+	options.insert(std::make_pair("word", "auto"));
 
 	std::runtime_error optErrorEx("Invalid options for inclusion: " +
 			Convert::ToString(options));
 
-	AutBase::StateType states = AutBase::SanitizeAutsForInclusion(smaller, bigger);
+	AutBase::StateType states;
+
+	{
+		ProfilePhase phase("sanitize");
+		states = AutBase::SanitizeAutsForInclusion(smaller, bigger);
+	}
 
 	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &startTime);     // set the timer
 
+	if ((options["word"] != "auto") && (options["word"] != "no"))
+	{
+		throw optErrorEx;
+	}
+
+	bool wordResult;
+	if ((options["word"] == "auto") && (options["dir"] == "up") &&
+		((options["sim"] == "no") || (options["sim"] == "yes")) &&
+		CheckWordInclusion(smaller, bigger, options["sim"] == "yes", wordResult))
+	{
+		return wordResult;
+	}
+
+	if (options["dir"] == "portfolio")
+	{
+		ProfilePhase phase("inclusion");
+		return CheckPortfolioInclusion(smaller, bigger, states);
+	}
+
 	if (options["sim"] == "no")
 	{
 		VATA::Util::Identity ident(states);
+
+		ProfilePhase phase("inclusion");
 		if (options["dir"] == "up")
 		{
 			return VATA::CheckUpwardInclusionWithPreorder(smaller, bigger, ident);
@@ -85,7 +306,12 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 
 		if (options["dir"] == "up")
 		{
-			AutBase::StateBinaryRelation sim = ComputeUpwardSimulation(unionAut, states);
+			AutBase::StateBinaryRelation sim;
+
+			{
+				ProfilePhase phase("simulation");
+				sim = ComputeUpwardSimulation(unionAut, states);
+			}
 
 			if (options["timeS"] == "no")
 			{
@@ -98,11 +324,18 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 				throw optErrorEx;
 			}
 
+			ProfilePhase phase("inclusion");
+
 			return VATA::CheckUpwardInclusionWithPreorder(smaller, bigger, sim);
 		}
 		else if (options["dir"] == "down")
 		{
-			AutBase::StateBinaryRelation sim = ComputeDownwardSimulation(unionAut, states);
+			AutBase::StateBinaryRelation sim;
+
+			{
+				ProfilePhase phase("simulation");
+				sim = ComputeDownwardSimulation(unionAut, states);
+			}
 
 			if (options["timeS"] == "no")
 			{
@@ -115,6 +348,8 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 				throw optErrorEx;
 			}
 
+			ProfilePhase phase("inclusion");
+
 			if (options["rec"] == "yes")
 			{
 				return VATA::CheckDownwardInclusionWithPreorder(smaller, bigger, sim);
@@ -153,7 +388,14 @@ VATA::AutBase::StateBinaryRelation ComputeSimulation(Automaton aut,
 	Options options = args.options;
 	options.insert(std::make_pair("dir", "down"));
 
-	AutBase::StateType states = AutBase::SanitizeAutForSimulation(aut);
+	AutBase::StateType states;
+
+	{
+		ProfilePhase phase("sanitize");
+		states = AutBase::SanitizeAutForSimulation(aut);
+	}
+
+	ProfilePhase phase("simulation");
 
 	if (options["dir"] == "up")
 	{
@@ -12,6 +12,9 @@
 #include <vata/vata.hh>
 #include <vata/util/convert.hh>
 
+// Standard library headers
+#include <cstdlib>
+
 // local headers
 #include "parse_args.hh"
 
@@ -79,10 +82,14 @@ Arguments parseArguments(int argc, char* argv[])
 	bool parsedOutputFormat   = false;
 	bool parsedShowTime       = false;
 	bool parsedDontOutputRes  = false;
+	bool parsedUnsortedOutput = false;
 	bool parsedPruneUnreach   = false;
 	bool parsedPruneUseless   = false;
 	bool parsedOptions        = false;
 	bool parsedVerbose        = false;
+	bool parsedProfile        = false;
+	bool parsedTimeout        = false;
+	bool parsedProgress       = false;
 
 	// initialize the structure
 	Arguments args;
@@ -95,10 +102,14 @@ Arguments parseArguments(int argc, char* argv[])
 	args.fileName2            = "";
 	args.showTime             = false;
 	args.dontOutputResult     = false;
+	args.unsortedOutput       = false;
 	args.pruneUnreachable     = false;
 	args.pruneUseless         = false;
 	args.options              = { };
 	args.verbose              = false;
+	args.profile              = false;
+	args.timeout              = 0;
+	args.progress             = false;
 
 	while (argc > 0)
 	{	// until we parse all arguments
@@ -130,6 +141,51 @@ Arguments parseArguments(int argc, char* argv[])
 				parsedVerbose = true;
 				args.verbose = true;
 			}
+			else	if (currentArg == "--profile")
+			{
+				if (parsedProfile)
+				{
+					throw std::runtime_error("The \'--profile\' flag specified more times.");
+				}
+
+				parsedProfile = true;
+				args.profile = true;
+			}
+			else	if (currentArg == "--timeout")
+			{
+				if (parsedTimeout)
+				{
+					throw std::runtime_error("The \'--timeout\' flag specified more times.");
+				}
+
+				parsedTimeout = true;
+
+				--argc;
+				++argv;
+
+				if (argc == 0)
+				{
+					throw std::runtime_error("The \'--timeout\' flag needs an argument.");
+				}
+
+				currentArg = argv[0];
+				char* end = nullptr;
+				args.timeout = std::strtod(currentArg.c_str(), &end);
+				if (currentArg.empty() || (*end != '\0') || !(args.timeout > 0))
+				{
+					throw std::runtime_error("Invalid timeout: " + currentArg);
+				}
+			}
+			else	if (currentArg == "--progress")
+			{
+				if (parsedProgress)
+				{
+					throw std::runtime_error("The \'--progress\' flag specified more times.");
+				}
+
+				parsedProgress = true;
+				args.progress = true;
+			}
 			else	if (currentArg == "-p")
 			{
 				if (parsedPruneUnreach)
@@ -160,6 +216,16 @@ Arguments parseArguments(int argc, char* argv[])
 				parsedDontOutputRes = true;
 				args.dontOutputResult = true;
 			}
+			else	if (currentArg == "-u")
+			{
+				if (parsedUnsortedOutput)
+				{
+					throw std::runtime_error("The \'-u\' flag specified more times.");
+				}
+
+				parsedUnsortedOutput = true;
+				args.unsortedOutput = true;
+			}
 			else	if (currentArg == "-r")
 			{
 				if (parsedRepresentation)
@@ -367,6 +433,13 @@ Arguments parseArguments(int argc, char* argv[])
 
 					parserState = PARSING_LOAD_2_FILES_1;
 				}
+				else if (currentArg == "equiv")
+				{
+					args.command   = COMMAND_EQUIVALENCE;
+					args.operands  = 2;
+
+					parserState = PARSING_LOAD_2_FILES_1;
+				}
 				else
 				{
 					throw std::runtime_error("Unknown command: " + currentArg);
@@ -21,6 +21,7 @@ enum CommandEnum
 	COMMAND_UNION,
 	COMMAND_INTERSECTION,
 	COMMAND_INCLUSION,
+	COMMAND_EQUIVALENCE,
 	COMMAND_SIM,
 	COMMAND_RED,
 	COMMAND_WITNESS,
@@ -54,10 +55,14 @@ struct Arguments
 	std::string fileName2;
 	bool showTime;
 	bool dontOutputResult;
+	bool unsortedOutput;
 	bool pruneUnreachable;
 	bool pruneUseless;
 	Options options;
 	bool verbose;
+	bool profile;
+	double timeout;
+	bool progress;
 
 	Arguments() :
 		command(),
@@ -69,10 +74,14 @@ struct Arguments
 		fileName2(),
 		showTime(false),
 		dontOutputResult(false),
+		unsortedOutput(false),
 		pruneUnreachable(false),
 		pruneUseless(false),
 		options(),
-		verbose(false)
+		verbose(false),
+		profile(false),
+		timeout(0),
+		progress(false)
 	{ }
 };
 
@@ -0,0 +1,164 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Profiling of phases of the command-line interface to the VATA library.
+ *
+ *****************************************************************************/
+
+// Standard library headers
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+// system headers
+#include <sys/resource.h>
+
+// local headers
+#include "profile.hh"
+
+
+Profiler profiler;
+
+namespace
+{
+	const size_t NO_RECORD = static_cast<size_t>(-1);
+
+	std::atomic<uint64_t> allocationCount(0);
+
+	void getTime(clockid_t clock, timespec& time)
+	{
+		if (clock_gettime(clock, &time))
+		{
+			throw std::runtime_error("Could not get the time");
+		}
+	}
+
+	double elapsed(const timespec& start, const timespec& finish)
+	{
+		return (finish.tv_sec - start.tv_sec)
+			+ 1e-9 * (finish.tv_nsec - start.tv_nsec);
+	}
+
+	// in kilobytes
+	long getPeakRss()
+	{
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage))
+		{
+			throw std::runtime_error("Could not get the resource usage");
+		}
+
+		return usage.ru_maxrss;
+	}
+}
+
+
+// the allocation functions are replaced in order to count the allocations; the
+// array and nothrow versions call these ones
+void* operator new(std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void* ptr = std::malloc((size == 0)? 1 : size);
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+
+uint64_t Profiler::GetAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+
+Profiler::Phase::Phase(Profiler& profiler, const std::string& name) :
+	profiler_(profiler),
+	index_(NO_RECORD),
+	wallStart_(),
+	cpuStart_(),
+	peakRssStart_(0),
+	allocationsStart_(0)
+{
+	if (!profiler_.IsEnabled())
+	{
+		return;
+	}
+
+	// the record is reserved now so that the records are ordered by start
+	index_ = profiler_.records_.size();
+	profiler_.records_.push_back(Record());
+
+	std::string& fullName = profiler_.records_.back().name;
+	for (const std::string& enclosing : profiler_.stack_)
+	{
+		fullName += enclosing + ".";
+	}
+
+	fullName += name;
+	profiler_.stack_.push_back(name);
+
+	peakRssStart_ = getPeakRss();
+	allocationsStart_ = GetAllocationCount();
+	getTime(CLOCK_MONOTONIC, wallStart_);
+	getTime(CLOCK_PROCESS_CPUTIME_ID, cpuStart_);
+}
+
+
+Profiler::Phase::~Phase()
+{
+	if (index_ == NO_RECORD)
+	{
+		return;
+	}
+
+	timespec wallFinish;
+	timespec cpuFinish;
+	// errors are not reported from a destructor
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuFinish);
+	clock_gettime(CLOCK_MONOTONIC, &wallFinish);
+
+	Record& record = profiler_.records_[index_];
+	record.wallTime = elapsed(wallStart_, wallFinish);
+	record.cpuTime = elapsed(cpuStart_, cpuFinish);
+	record.allocations = GetAllocationCount() - allocationsStart_;
+
+	rusage usage;
+	if (!getrusage(RUSAGE_SELF, &usage))
+	{
+		record.peakRssDelta = usage.ru_maxrss - peakRssStart_;
+	}
+
+	profiler_.stack_.pop_back();
+}
+
+
+void Profiler::PrintJSON(std::ostream& os) const
+{
+	os << "{\n  \"phases\": [";
+	for (size_t i = 0; i < records_.size(); ++i)
+	{
+		const Record& record = records_[i];
+
+		os << ((i == 0)? "\n" : ",\n");
+		os << "    {\"name\": \"" << record.name << "\""
+			<< ", \"wall_s\": " << record.wallTime
+			<< ", \"cpu_s\": " << record.cpuTime
+			<< ", \"peak_rss_delta_kb\": " << record.peakRssDelta
+			<< ", \"allocations\": " << record.allocations << "}";
+	}
+
+	os << (records_.empty()? "]\n}\n" : "\n  ]\n}\n");
+}
@@ -0,0 +1,133 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Profiling of phases of the command-line interface to the VATA library.
+ *
+ *****************************************************************************/
+
+#ifndef _PROFILE_HH_
+#define _PROFILE_HH_
+
+// Standard library headers
+#include <ctime>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+
+/**
+ * @brief  Collects resources consumed by phases of the run
+ *
+ * For every phase, the wall-clock time, the CPU time of the process, the
+ * increase of the peak resident set size and the number of allocations are
+ * recorded. Phases may be nested; the name of a nested phase is prefixed by
+ * the names of the enclosing phases.
+ */
+class Profiler
+{
+public:   // data types
+
+	struct Record
+	{
+		std::string name;
+		double wallTime;
+		double cpuTime;
+		long peakRssDelta;
+		uint64_t allocations;
+
+		Record() :
+			name(),
+			wallTime(0),
+			cpuTime(0),
+			peakRssDelta(0),
+			allocations(0)
+		{ }
+	};
+
+	/**
+	 * @brief  A phase lasting for the lifetime of the object
+	 */
+	class Phase
+	{
+	private:  // data members
+
+		Profiler& profiler_;
+		size_t index_;
+		timespec wallStart_;
+		timespec cpuStart_;
+		long peakRssStart_;
+		uint64_t allocationsStart_;
+
+	private:  // methods
+
+		Phase(const Phase&);
+		Phase& operator=(const Phase&);
+
+	public:   // methods
+
+		Phase(Profiler& profiler, const std::string& name);
+
+		~Phase();
+	};
+
+private:  // data members
+
+	bool enabled_;
+	std::vector<std::string> stack_;
+	std::vector<Record> records_;
+
+public:   // methods
+
+	Profiler() :
+		enabled_(false),
+		stack_(),
+		records_()
+	{ }
+
+	void Enable()
+	{
+		enabled_ = true;
+	}
+
+	bool IsEnabled() const
+	{
+		return enabled_;
+	}
+
+	const std::vector<Record>& GetRecords() const
+	{
+		return records_;
+	}
+
+	/**
+	 * @brief  Prints the records of the finished phases as a JSON object
+	 */
+	void PrintJSON(std::ostream& os) const;
+
+	/**
+	 * @brief  Returns the number of allocations done by the program so far
+	 */
+	static uint64_t GetAllocationCount();
+};
+
+
+extern Profiler profiler;
+
+
+/**
+ * @brief  A phase of the global profiler
+ */
+class ProfilePhase : public Profiler::Phase
+{
+public:   // methods
+
+	explicit ProfilePhase(const std::string& name) :
+		Profiler::Phase(profiler, name)
+	{ }
+};
+
+#endif
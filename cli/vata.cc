@@ -19,16 +19,21 @@
 #include <vata/parsing/timbuk_parser.hh>
 #include <vata/serialization/timbuk_serializer.hh>
 #include <vata/util/convert.hh>
+#include <vata/util/stats.hh>
+#include <vata/util/cancellation.hh>
 #include <vata/util/transl_strict.hh>
 #include <vata/util/util.hh>
 
 // standard library headers
 #include <cstdlib>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 
 // local headers
 #include "parse_args.hh"
 #include "operations.hh"
+#include "profile.hh"
 
 
 using VATA::AutBase;
@@ -37,10 +42,12 @@ using VATA::BDDTopDownTreeAut;
 using VATA::Parsing::AbstrParser;
 using VATA::Parsing::TimbukParser;
 using VATA::Serialization::AbstrSerializer;
+using VATA::Serialization::AbstrStreamWriter;
 using VATA::Serialization::TimbukSerializer;
+using VATA::Util::AutDescription;
 using VATA::Util::Convert;
 
-typedef VATA::ExplicitTreeAut<size_t> ExplicitTreeAut;
+typedef VATA::ExplicitTreeAut<VATA::IdType> ExplicitTreeAut;
 
 typedef VATA::Util::TranslatorWeak<AutBase::StringToStateDict>
 	StateTranslatorWeak;
@@ -53,7 +60,7 @@ typedef VATA::Util::TranslatorWeak<BDDTopDownTreeAut::StringToSymbolDict>
 const char VATA_USAGE_STRING[] =
 	"VATA: VATA Tree Automata library interface\n"
 	"usage: vata [-r <representation>] [(-I|-O|-F) <format>] [-h|--help] [-t] [-n]\n"
-	"            [(-p|-s)] [-o <options>] <command> [<args>]\n"
+	"            [-u] [(-p|-s)] [-o <options>] <command> [<args>]\n"
 	;
 
 const char VATA_USAGE_COMMANDS[] =
@@ -83,6 +90,8 @@ const char VATA_USAGE_COMMANDS[] =
 	"\n"
 	"          'dir=down' : downward inclusion checking\n"
 	"          'dir=up'   : upward inclusion checking (default)\n"
+	"          'dir=portfolio': run the strategies in parallel and take the\n"
+	"                       first answer (only for '-r expl')\n"
 	"          'sim=yes'  : use corresponding simulation\n"
 	"          'sim=no'   : do not use simulation (default)\n"
 	"          'optC=yes' : use optimised cache for downward direction\n"
@@ -91,6 +100,14 @@ const char VATA_USAGE_COMMANDS[] =
 	"          'rec=no'   : non-recursive version (only for '-r expl' and 'optC=no')\n"
 	"          'timeS=yes': include time of simulation computation (default)\n"
 	"          'timeS=no' : do not include time of simulation computation\n"
+	"          'word=auto': use the word automata engine for upward inclusion of\n"
+	"                       explicit automata of rank at most one (default)\n"
+	"          'word=no'  : always use the tree automata engine\n"
+	"\n"
+	"    equiv <file1> <file2>   Checks language equivalence of automata from\n"
+	"                            <file1> and <file2> (not for '-r bdd-td'). If the\n"
+	"                            languages differ, an automaton accepting a tree\n"
+	"                            from exactly one of them is printed\n"
 	;
 
 const char VATA_USAGE_FLAGS[] =
@@ -111,8 +128,22 @@ const char VATA_USAGE_FLAGS[] =
 	"\n"
 	"    -t                      Print the time the operation took to error output\n"
 	"                            stream\n"
-	"    -v                      Be verbose\n"
+	"    -v                      Be verbose: print statistics collected during\n"
+	"                            the operation to error output stream in JSON\n"
+	"                            (requires the library built with VATA_STATS)\n"
+	"    --profile               Print wall time, CPU time, increase of the peak\n"
+	"                            resident set size and the number of allocations\n"
+	"                            of every phase (reading, parsing, pruning,\n"
+	"                            sanitization, simulation, the operation and\n"
+	"                            output) to error output stream in JSON\n"
+	"    --timeout <seconds>     Stop the operation after <seconds> seconds with\n"
+	"                            an error and exit status 124\n"
+	"    --progress              Print the state of the running engine (number\n"
+	"                            of iterations, size of the workset and of the\n"
+	"                            antichain) every second to error output stream\n"
 	"    -n                      Do not output the result automaton\n"
+	"    -u                      Output the result automaton unsorted while it is\n"
+	"                            being traversed (faster and uses less memory)\n"
 	"    -p                      Prune unreachable states first\n"
 	"    -s                      Prune useless states first (note that this is\n"
 	"                            stronger than -p)\n"
@@ -120,7 +151,8 @@ const char VATA_USAGE_FLAGS[] =
 	"                            <option>=<value> list\n"
 	;
 
-const size_t BDD_SIZE = 16;
+// the exit status of an operation stopped by '--timeout' (as of timeout(1))
+const int EXIT_TIMEOUT = 124;
 
 timespec startTime;
 
@@ -137,6 +169,47 @@ void printHelp(bool full = false)
 }
 
 
+void printProgress(const VATA::Util::Progress& progress)
+{
+	// written at once as the strategies of portfolio inclusion report in parallel
+	std::ostringstream os;
+	os << "[" << std::fixed << std::setprecision(1) << progress.elapsed << " s] "
+		<< progress.engine << ": " << progress.iterations << " iterations, workset "
+		<< progress.worksetSize << ", antichain " << progress.antichainSize << "\n";
+
+	std::cerr << os.str();
+}
+
+
+template <class Aut>
+void encodeAlphabet(const AutDescription::SymbolSet&)
+{
+	// the explicit representation needs no encoding of symbols
+}
+
+template <>
+void encodeAlphabet<BDDTopDownTreeAut>(const AutDescription::SymbolSet& symbols)
+{
+	VATA::SymbolicAutBase::EncodeAlphabet(symbols);
+}
+
+template <>
+void encodeAlphabet<BDDBottomUpTreeAut>(const AutDescription::SymbolSet& symbols)
+{
+	VATA::SymbolicAutBase::EncodeAlphabet(symbols);
+}
+
+void collectSymbols(const AutDescription& desc, AutDescription::SymbolSet& symbols)
+{
+	symbols.insert(desc.symbols.begin(), desc.symbols.end());
+
+	for (const AutDescription::Transition& trans : desc.transitions)
+	{	// also symbols that are not declared
+		symbols.insert(AutDescription::Symbol(trans.second, trans.first.size()));
+	}
+}
+
+
 template <class Aut>
 int performOperation(const Arguments& args, AbstrParser& parser,
 	AbstrSerializer& serializer)
@@ -155,16 +228,63 @@ int performOperation(const Arguments& args, AbstrParser& parser,
 	VATA::AutBase::StateToStateMap translMap1;
 	VATA::AutBase::StateToStateMap translMap2;
 
-	if (args.operands >= 1)
+	AutDescription autDesc1;
+	AutDescription autDesc2;
+	AutDescription::SymbolSet symbols;
+
+	std::string input1;
+	std::string input2;
+
 	{
-		autInput1.LoadFromString(parser, VATA::Util::ReadFile(args.fileName1),
-			stateDict1);
+		ProfilePhase phase("read");
+
+		if (args.operands >= 1)
+		{
+			input1 = VATA::Util::ReadFile(args.fileName1);
+		}
+
+		if (args.operands >= 2)
+		{
+			input2 = VATA::Util::ReadFile(args.fileName2);
+		}
 	}
 
-	if (args.operands >= 2)
 	{
-		autInput2.LoadFromString(parser, VATA::Util::ReadFile(args.fileName2),
-			stateDict2);
+		ProfilePhase phase("parse");
+
+		if (args.operands >= 1)
+		{
+			autDesc1 = parser.ParseString(input1);
+			collectSymbols(autDesc1, symbols);
+		}
+
+		if (args.operands >= 2)
+		{
+			autDesc2 = parser.ParseString(input2);
+			collectSymbols(autDesc2, symbols);
+		}
+	}
+
+	{
+		ProfilePhase phase("load");
+
+		// the whole alphabet is known now, so it can be encoded densely
+		encodeAlphabet<Aut>(symbols);
+
+		// automata constructed before the encoding need to adopt it
+		autInput1 = Aut();
+		autInput2 = Aut();
+		autResult = Aut();
+
+		if (args.operands >= 1)
+		{
+			autInput1.LoadFromAutDesc(autDesc1, stateDict1);
+		}
+
+		if (args.operands >= 2)
+		{
+			autInput2.LoadFromAutDesc(autDesc2, stateDict2);
+		}
 	}
 
 	if ((args.command == COMMAND_LOAD) ||
@@ -173,6 +293,8 @@ int performOperation(const Arguments& args, AbstrParser& parser,
 		(args.command == COMMAND_INTERSECTION) ||
 		(args.command == COMMAND_RED))
 	{
+		ProfilePhase phase("prune");
+
 		if (args.pruneUseless)
 		{
 			if (args.operands >= 1)
@@ -203,46 +325,74 @@ int performOperation(const Arguments& args, AbstrParser& parser,
 	AutBase::StateToStateMap opTranslMap2;
 	AutBase::ProductTranslMap prodTranslMap;
 
+	// only the operation itself is measured
+	VATA::Util::Stats::Reset();
+
 	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &startTime);     // set the timer
 
 	timespec finishTime;
 
-	// process command
-	if (args.command == COMMAND_LOAD)
-	{
-		autResult = autInput1;
-	}
-	else if (args.command == COMMAND_WITNESS)
-	{
-		autResult = GetCandidateTree(autInput1);
-	}
-	else if (args.command == COMMAND_COMPLEMENT)
-	{
-		autResult = Complement(autInput1, autInput1.GetAlphabet());
-	}
-	else if (args.command == COMMAND_UNION)
+	// the engines poll the token, which stops them at the deadline
+	VATA::Util::CancellationToken token;
+	if (args.timeout > 0)
 	{
-		autResult = Union(autInput1, autInput2, &opTranslMap1, &opTranslMap2);
+		token.SetTimeout(args.timeout);
 	}
-	else if (args.command == COMMAND_INTERSECTION)
-	{
-		autResult = Intersection(autInput1, autInput2, &prodTranslMap);
-	}
-	else if (args.command == COMMAND_INCLUSION)
-	{
-		boolResult = CheckInclusion(autInput1, autInput2, args);
-	}
-	else if (args.command == COMMAND_SIM)
-	{
-		relResult = ComputeSimulation(autInput1, args);
-	}
-	else if (args.command == COMMAND_RED)
+
+	if (args.progress)
 	{
-		autResult = ComputeReduction(autInput1, args);
+		token.SetProgressCallback(printProgress);
 	}
-	else
+
 	{
-		throw std::runtime_error("Internal error: invalid command");
+		ProfilePhase phase("operation");
+		VATA::Util::CancellationScope scope(token);
+
+		// process command
+		if (args.command == COMMAND_LOAD)
+		{
+			autResult = autInput1;
+		}
+		else if (args.command == COMMAND_WITNESS)
+		{
+			autResult = GetCandidateTree(autInput1);
+		}
+		else if (args.command == COMMAND_COMPLEMENT)
+		{
+			autResult = Complement(autInput1, autInput1.GetAlphabet());
+		}
+		else if (args.command == COMMAND_UNION)
+		{
+			autResult = Union(autInput1, autInput2, &opTranslMap1, &opTranslMap2);
+		}
+		else if (args.command == COMMAND_INTERSECTION)
+		{
+			// the translation map is only needed for printing the result
+			autResult = Intersection(autInput1, autInput2,
+				(args.dontOutputResult)? nullptr : &prodTranslMap);
+		}
+		else if (args.command == COMMAND_INCLUSION)
+		{
+			boolResult = CheckInclusion(autInput1, autInput2, args);
+		}
+		else if (args.command == COMMAND_EQUIVALENCE)
+		{
+			// the counterexample is only needed for printing the result
+			boolResult = CheckEquivalence(autInput1, autInput2,
+				(args.dontOutputResult)? nullptr : &autResult);
+		}
+		else if (args.command == COMMAND_SIM)
+		{
+			relResult = ComputeSimulation(autInput1, args);
+		}
+		else if (args.command == COMMAND_RED)
+		{
+			autResult = ComputeReduction(autInput1, args);
+		}
+		else
+		{
+			throw std::runtime_error("Internal error: invalid command");
+		}
 	}
 
 	// get the finish time
@@ -258,47 +408,75 @@ int performOperation(const Arguments& args, AbstrParser& parser,
 		std::cerr << opTime << "\n";
 	}
 
+	if (args.verbose)
+	{
+		VATA::Util::Stats::PrintJSON(std::cerr);
+	}
+
 	if (!args.dontOutputResult)
 	{	// in case output is not forbidden
+		ProfilePhase phase("output");
+
+		// the automaton is written into the output stream while it is traversed
+		std::unique_ptr<AbstrStreamWriter> writer =
+			serializer.CreateStreamWriter(std::cout);
+
 		if ((args.command == COMMAND_LOAD) ||
 			(args.command == COMMAND_WITNESS) ||
 			(args.command == COMMAND_RED))
 		{
-			std::cout << autResult.DumpToString(serializer,
+			autResult.DumpToStream(*writer,
 				StateBackTranslatorStrict(stateDict1.GetReverseMap()),
-				SymbolBackTranslatorStrict(autResult.GetSymbolDict().GetReverseMap()));
+				SymbolBackTranslatorStrict(autResult.GetSymbolDict().GetReverseMap()),
+				!args.unsortedOutput);
 		}
 
 		if (args.command == COMMAND_COMPLEMENT)
 		{
-			std::cout << autResult.DumpToString(serializer,
+			autResult.DumpToStream(*writer,
 				[](const AutBase::StateType& state){ return "q" + Convert::ToString(state); },
-				SymbolBackTranslatorStrict(autResult.GetSymbolDict().GetReverseMap()));
+				SymbolBackTranslatorStrict(autResult.GetSymbolDict().GetReverseMap()),
+				!args.unsortedOutput);
 		}
 
 		if (args.command == COMMAND_UNION)
-		{
-			stateDict1 = VATA::Util::CreateUnionStringToStateMap(
+		{	// names of states are created only for the printed states
+			const VATA::Util::UnionStateNames stateNames(
 				stateDict1, stateDict2, &opTranslMap1, &opTranslMap2);
+
+			autResult.DumpToStream(*writer,
+				[&stateNames](const AutBase::StateType& state){ return stateNames(state); },
+				SymbolBackTranslatorStrict(autResult.GetSymbolDict().GetReverseMap()),
+				!args.unsortedOutput);
 		}
 
 		if (args.command == COMMAND_INTERSECTION)
-		{
-			stateDict1 = VATA::Util::CreateProductStringToStateMap(
+		{	// names of states are created only for the printed states
+			const VATA::Util::ProductStateNames stateNames(
 				stateDict1, stateDict2, prodTranslMap);
+
+			autResult.DumpToStream(*writer,
+				[&stateNames](const AutBase::StateType& state){ return stateNames(state); },
+				SymbolBackTranslatorStrict(autResult.GetSymbolDict().GetReverseMap()),
+				!args.unsortedOutput);
 		}
 
-		if ((args.command == COMMAND_UNION) ||
-			(args.command == COMMAND_INTERSECTION))
+		if ((args.command == COMMAND_INCLUSION))
 		{
-			std::cout << autResult.DumpToString(serializer,
-				StateBackTranslatorStrict(stateDict1.GetReverseMap()),
-				SymbolBackTranslatorStrict(autResult.GetSymbolDict().GetReverseMap()));
+			std::cout << boolResult << "\n";
 		}
 
-		if ((args.command == COMMAND_INCLUSION))
+		if (args.command == COMMAND_EQUIVALENCE)
 		{
 			std::cout << boolResult << "\n";
+
+			if (!boolResult)
+			{	// the states of the counterexample are the nodes of the tree
+				autResult.DumpToStream(*writer,
+					[](const AutBase::StateType& state){ return "q" + Convert::ToString(state); },
+					SymbolBackTranslatorStrict(autResult.GetSymbolDict().GetReverseMap()),
+					!args.unsortedOutput);
+			}
 		}
 
 		if (args.command == COMMAND_SIM)
@@ -307,6 +485,11 @@ int performOperation(const Arguments& args, AbstrParser& parser,
 		}
 	}
 
+	if (args.profile)
+	{
+		profiler.PrintJSON(std::cerr);
+	}
+
 	return EXIT_SUCCESS;
 }
 
@@ -376,13 +559,19 @@ int main(int argc, char* argv[])
 		return EXIT_SUCCESS;
 	}
 
+	if (args.profile)
+	{
+		profiler.Enable();
+	}
+
 	// create the symbol directory for the BDD-based automata
 	BDDTopDownTreeAut::StringToSymbolDict bddSymbolDict;
 	BDDTopDownTreeAut::SetSymbolDictPtr(&bddSymbolDict);
 	BDDBottomUpTreeAut::SetSymbolDictPtr(&bddSymbolDict);
 
 	// create the ``next symbol'' variable for the BDD-based automata
-	BDDTopDownTreeAut::SymbolType bddNextSymbol(BDD_SIZE, 0);
+	BDDTopDownTreeAut::SymbolType bddNextSymbol(
+		VATA::SymbolicAutBase::GetSymbolSize(), 0);
 	BDDTopDownTreeAut::SetNextSymbolPtr(&bddNextSymbol);
 	BDDBottomUpTreeAut::SetNextSymbolPtr(&bddNextSymbol);
 
@@ -418,6 +607,12 @@ int main(int argc, char* argv[])
 			return EXIT_FAILURE;
 		}
 	}
+	catch (VATA::Util::OperationTimedOut& ex)
+	{
+		std::cerr << "An error occured: " << ex.what() << " (limit "
+			<< args.timeout << " s)\n";
+		return EXIT_TIMEOUT;
+	}
 	catch (std::exception& ex)
 	{
 		std::cerr << "An error occured: " << ex.what() << "\n";
@@ -16,6 +16,8 @@
 #include <vata/parsing/abstr_parser.hh>
 #include <vata/serialization/abstr_serializer.hh>
 #include <vata/util/binary_relation.hh>
+#include <vata/util/partitioned_relation.hh>
+#include <vata/util/product_transl_table.hh>
 #include <vata/util/two_way_dict.hh>
 #include <vata/util/transl_weak.hh>
 #include <vata/util/transl_strict.hh>
@@ -60,7 +62,7 @@ class VATA::AutBase
 {
 public:   // data types
 
-	typedef size_t StateType;
+	typedef VATA::IdType StateType;
 
 	typedef VATA::Util::TwoWayDict<std::string, StateType> StringToStateDict;
 	typedef VATA::Util::TranslatorStrict<AutBase::StringToStateDict::MapBwdType>
@@ -72,8 +74,10 @@ public:   // data types
 	typedef std::pair<StateType, StateType> StatePair;
 	typedef std::unordered_map<StatePair, StateType, boost::hash<StatePair>>
 		ProductTranslMap;
+	typedef VATA::Util::ProductTranslTable<StateType> ProductTranslTable;
 
 	typedef VATA::Util::BinaryRelation StateBinaryRelation;
+	typedef VATA::Util::PartitionedRelation StatePartitionedRelation;
 
 private:  // data members
 
@@ -83,6 +87,17 @@ protected:// methods
 
 	AutBase() { }
 
+	/**
+	 * @brief  Returns a fresh state from the counter set by SetNextStatePtr()
+	 */
+	inline static StateType AddSharedState()
+	{
+		// Assertions
+		assert(pNextState_ != nullptr);
+
+		return (*pNextState_)++;
+	}
+
 public:   // methods
 
 	inline static void SetNextStatePtr(StateType* pNextState)
@@ -93,6 +108,18 @@ public:   // methods
 		pNextState_ = pNextState;
 	}
 
+	/**
+	 * @brief  Creates an empty automaton that may be combined with @p aut
+	 *
+	 * Automata that are bound to a context override this in order to bind the
+	 * new automaton to the context of @p aut.
+	 */
+	template <class Automaton>
+	static Automaton CreateEmpty(const Automaton& /* aut */)
+	{
+		return Automaton();
+	}
+
 	template <class Automaton>
 	static StateType SanitizeAutsForInclusion(Automaton& smaller, Automaton& bigger)
 	{
@@ -102,12 +129,12 @@ public:   // methods
 			[&stateCnt](const StateType&){return stateCnt++;});
 
 		Automaton tmpAut = RemoveUselessStates(smaller);
-		Automaton newSmaller;
+		Automaton newSmaller = Automaton::CreateEmpty(tmpAut);
 		tmpAut.ReindexStates(newSmaller, stateTrans);
 
 		tmpAut = RemoveUselessStates(bigger);
 		stateMap.clear();
-		Automaton newBigger;
+		Automaton newBigger = Automaton::CreateEmpty(tmpAut);
 		tmpAut.ReindexStates(newBigger, stateTrans);
 
 		smaller = newSmaller;
@@ -125,7 +152,7 @@ public:   // methods
 			[&stateCnt](const StateType&){return stateCnt++;});
 
 		Automaton newAut = RemoveUselessStates(aut);
-		Automaton reindexedAut;
+		Automaton reindexedAut = Automaton::CreateEmpty(newAut);
 		newAut.ReindexStates(reindexedAut, stateTrans);
 
 		aut = reindexedAut;
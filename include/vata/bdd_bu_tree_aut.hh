@@ -19,6 +19,7 @@
 #include <vata/mtbdd/apply2func.hh>
 #include <vata/mtbdd/ondriks_mtbdd.hh>
 #include <vata/mtbdd/void_apply2func.hh>
+#include <vata/serialization/aut_description_writer.hh>
 #include <vata/util/bdd_bu_trans_table.hh>
 #include <vata/util/ord_vector.hh>
 #include <vata/util/transl_strict.hh>
@@ -48,7 +49,7 @@ GCC_DIAG_ON(effc++)
 public:   // data types
 
 	typedef std::unordered_set<StateType> StateHT;
-	typedef VATA::Util::OrdVector<StateType> StateSet;
+	typedef VATA::Util::SmallOrdVector<StateType>::Type StateSet;
 	typedef std::vector<StateType> StateTuple;
 	typedef VATA::Util::OrdVector<StateTuple> StateTupleSet;
 	typedef VATA::MTBDDPkg::OndriksMTBDD<StateSet> TransMTBDD;
@@ -74,7 +75,7 @@ private:  // data types
 	{
 	private:  // data types
 
-		typedef VATA::Util::BDDBottomUpTransTable<MTBDDHandle, StateSet> Table;
+		typedef VATA::Util::BDDBottomUpTransTable<StateType, StateSet> Table;
 
 		typedef typename Table::TupleMap::key_type key_type;
 		typedef typename Table::TupleMap::mapped_type mapped_type;
@@ -347,7 +348,8 @@ private:  // methods
 	}
 
 	template <class StateBackTransFunc, class SymbolBackTransFunc>
-	AutDescription dumpToAutDescExplicit(
+	void dumpToWriterExplicit(
+		VATA::Serialization::AbstrStreamWriter& writer,
 		StateBackTransFunc stateBackTranslator,
 		SymbolBackTransFunc /* symbolBackTranslator */) const
 	{
@@ -391,29 +393,37 @@ private:  // methods
 			}
 		};
 
-		AutDescription desc;
+		// copy states (only those that occur in tuples are known)
+		std::unordered_set<StateType> states;
+		for (auto tupleBddPair : GetTransTable())
+		{	// for all tuples
+			for (auto state : tupleBddPair.first)
+			{
+				if (states.insert(state).second)
+				{
+					writer.WriteState(stateBackTranslator(state));
+				}
+			}
+		}
 
 		// copy final states
 		for (auto fst : finalStates_)
 		{	// copy final states
-			desc.finalStates.insert(stateBackTranslator(fst));
+			writer.WriteFinalState(stateBackTranslator(fst));
 		}
 
 		CondColApplyFunctor collector;
+		AutDescription::StateTuple tupleStr;
 
-		// copy states, transitions and symbols
+		// copy transitions
 		for (auto tupleBddPair : GetTransTable())
-		{	// for all states
+		{	// for all tuples
 			const StateTuple& children = tupleBddPair.first;
 
-			std::vector<std::string> tupleStr;
-
+			tupleStr.clear();
 			for (auto state : children)
 			{
-				std::string stateStr = stateBackTranslator(state);
-
-				tupleStr.push_back(stateStr);
-				desc.states.insert(stateStr);
+				tupleStr.push_back(stateBackTranslator(state));
 			}
 
 			const TransMTBDD& transMtbdd = tupleBddPair.second;
@@ -428,13 +438,20 @@ private:  // methods
 
 				for (auto state : collector.GetAccumulator())
 				{	// for each state tuple for which there is a transition
-					std::string stateStr = stateBackTranslator(state);
-
-					desc.transitions.insert(AutDescription::Transition(tupleStr, symbol,
-						stateStr));
+					writer.WriteTransition(tupleStr, symbol, stateBackTranslator(state));
 				}
 			}
 		}
+	}
+
+	template <class StateBackTransFunc, class SymbolBackTransFunc>
+	AutDescription dumpToAutDescExplicit(
+		StateBackTransFunc stateBackTranslator,
+		SymbolBackTransFunc symbolBackTranslator) const
+	{
+		AutDescription desc;
+		VATA::Serialization::AutDescriptionWriter descWriter(desc);
+		dumpToWriterExplicit(descWriter, stateBackTranslator, symbolBackTranslator);
 
 		return desc;
 	}
@@ -460,11 +477,13 @@ public:   // methods
 	{ }
 
 	BDDBottomUpTreeAut(const BDDBottomUpTreeAut& aut) :
+		SymbolicAutBase(aut),
 		finalStates_(aut.finalStates_),
 		transTable_(aut.transTable_)
 	{ }
 
 	BDDBottomUpTreeAut(BDDBottomUpTreeAut&& aut) :
+		SymbolicAutBase(aut),
 		finalStates_(std::move(aut.finalStates_)),
 		transTable_(std::move(aut.transTable_))
 	{ }
@@ -473,6 +492,7 @@ public:   // methods
 	{
 		if (this != &rhs)
 		{
+			SymbolicAutBase::operator=(rhs);
 			finalStates_ = rhs.finalStates_;
 			transTable_ = rhs.transTable_;
 		}
@@ -484,6 +504,7 @@ public:   // methods
 	{
 		if (this != &rhs)
 		{
+			SymbolicAutBase::operator=(rhs);
 			finalStates_ = std::move(rhs.finalStates_);
 			transTable_ = std::move(rhs.transTable_);
 		}
@@ -500,8 +521,10 @@ public:   // methods
 	void AddTransition(const StateTuple& children,
 		SymbolType symbol, const StateType& parent)
 	{
+		CheckEncoding();
+
 		// Assertions
-		assert(symbol.length() == SYMBOL_SIZE);
+		assert(symbol.length() == GetSymbolSize());
 
 		if (transTable_.unique())
 		{
@@ -600,6 +623,8 @@ public:   // methods
 		StateBackTransFunc stateBackTranslator, SymbolTransFunc symbolTranslator,
 		const std::string& params = "") const
 	{
+		CheckEncoding();
+
 		AutDescription desc;
 		if (params == "symbolic")
 		{
@@ -613,6 +638,30 @@ public:   // methods
 		return serializer.Serialize(desc);
 	}
 
+	/**
+	 * @brief  Writes the automaton to a stream writer and finishes the output
+	 *
+	 * If @p sorted is @p false, the transitions are written while the
+	 * automaton is traversed and no text of the whole automaton is kept in
+	 * memory; otherwise, the output is the same as the one of DumpToString().
+	 */
+	template <class StateBackTransFunc, class SymbolTransFunc>
+	void DumpToStream(VATA::Serialization::AbstrStreamWriter& writer,
+		StateBackTransFunc stateBackTranslator, SymbolTransFunc symbolTranslator,
+		bool sorted = true) const
+	{
+		if (sorted)
+		{
+			writer.Write(dumpToAutDescExplicit(stateBackTranslator, symbolTranslator));
+		}
+		else
+		{
+			dumpToWriterExplicit(writer, stateBackTranslator, symbolTranslator);
+		}
+
+		writer.Finish();
+	}
+
 	template <class SymbolTransFunc>
 	std::string DumpToString(VATA::Serialization::AbstrSerializer& serializer,
 		SymbolTransFunc symbolTranslator,
@@ -636,11 +685,17 @@ public:   // methods
 
 	BDDTopDownTreeAut GetTopDownAut() const;
 
+	/**
+	 * @brief  Applies an operation on the leaves of a tuple and an MTBDD
+	 *
+	 * Calls @p opFunc on the pairs of leaves of the MTBDD of @p lhsTuple in
+	 * @p lhs and of @p rhsMtbdd (typically a union of MTBDDs of several
+	 * tuples, which callers may cache) for every symbol.
+	 */
 	template <class OperationFunc>
-	static void ForeachUpSymbolFromTupleAndTupleSetDo(
-		const BDDBottomUpTreeAut& lhs, const BDDBottomUpTreeAut& rhs,
-		const StateTuple& lhsTuple, const StateTupleSet& rhsTupleSet,
-		OperationFunc& opFunc)
+	static void ForeachUpSymbolFromTupleAndMtbddDo(
+		const BDDBottomUpTreeAut& lhs, const StateTuple& lhsTuple,
+		const TransMTBDD& rhsMtbdd, OperationFunc& opFunc)
 	{
 		GCC_DIAG_OFF(effc++)
 		class OperationApplyFunctor :
@@ -671,6 +726,19 @@ public:   // methods
 			}
 		};
 
+		// create apply functor
+		OperationApplyFunctor opApplyFunc(opFunc);
+
+		// perform the apply operation
+		opApplyFunc(lhs.GetMtbdd(lhsTuple), rhsMtbdd);
+	}
+
+	template <class OperationFunc>
+	static void ForeachUpSymbolFromTupleAndTupleSetDo(
+		const BDDBottomUpTreeAut& lhs, const BDDBottomUpTreeAut& rhs,
+		const StateTuple& lhsTuple, const StateTupleSet& rhsTupleSet,
+		OperationFunc& opFunc)
+	{
 		UnionApplyFunctor unioner;
 		TransMTBDD rhsUnionMtbdd((StateSet()));
 
@@ -680,11 +748,7 @@ public:   // methods
 			rhsUnionMtbdd = unioner(rhsUnionMtbdd, rhs.GetMtbdd(tuple));
 		}
 
-		// create apply functor
-		OperationApplyFunctor opApplyFunc(opFunc);
-
-		// perform the apply operation
-		opApplyFunc(lhs.GetMtbdd(lhsTuple), rhsUnionMtbdd);
+		ForeachUpSymbolFromTupleAndMtbddDo(lhs, lhsTuple, rhsUnionMtbdd, opFunc);
 	}
 
 	inline const TransMTBDD& GetMtbdd(const StateTuple& children) const
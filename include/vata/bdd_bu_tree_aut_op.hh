@@ -36,6 +36,18 @@ namespace VATA
 
 	BDDBottomUpTreeAut RemoveUselessStates(const BDDBottomUpTreeAut& aut);
 
+	/**
+	 * @brief  Re-encodes the symbols of an automaton
+	 *
+	 * Translates an automaton whose symbols are encoded using @p oldDict to
+	 * the encoding given by the current symbol dictionary (e.g. after
+	 * SymbolicAutBase::EncodeAlphabet()). Symbols are matched by their names.
+	 * Symbols used by @p aut that are missing in the current dictionary are
+	 * added to it; std::runtime_error is thrown if the encoding is full.
+	 */
+	BDDBottomUpTreeAut ReencodeSymbols(const BDDBottomUpTreeAut& aut,
+		const SymbolicAutBase::StringToSymbolDict& oldDict);
+
 	bool CheckUpwardInclusion(const BDDBottomUpTreeAut& smaller,
 		const BDDBottomUpTreeAut& bigger);
 
@@ -94,6 +106,9 @@ namespace VATA
 		const BDDBottomUpTreeAut& smaller, const BDDBottomUpTreeAut& bigger,
 		const Rel& preorder)
 	{
+		smaller.CheckEncoding();
+		bigger.CheckEncoding();
+
 		return CheckUpwardTreeInclusion<BDDBottomUpTreeAut,
 			VATA::UpwardInclusionFunctor>(smaller, bigger, preorder);
 	}
@@ -104,6 +119,16 @@ namespace VATA
 		return CheckUpwardInclusion(smaller, bigger);
 	}
 
+	/**
+	 * @brief  Checks language equivalence of automata
+	 *
+	 * If the languages differ and @p counterexample is given, it is set to an
+	 * automaton accepting a single tree accepted by exactly one of the automata.
+	 */
+	bool CheckEquivalence(const BDDBottomUpTreeAut& lhs,
+		const BDDBottomUpTreeAut& rhs,
+		BDDBottomUpTreeAut* counterexample = nullptr);
+
 	template <class SymbolType, class Dict>
 	BDDBottomUpTreeAut Complement(const BDDBottomUpTreeAut& aut,
 		const Dict& alphabet) {
@@ -21,6 +21,7 @@
 #include <vata/mtbdd/void_apply2func.hh>
 #include <vata/parsing/abstr_parser.hh>
 #include <vata/serialization/abstr_serializer.hh>
+#include <vata/serialization/aut_description_writer.hh>
 #include <vata/util/ord_vector.hh>
 #include <vata/util/bdd_td_trans_table.hh>
 #include <vata/util/vector_map.hh>
@@ -32,7 +33,11 @@
 #include <cstdint>
 #include <unordered_set>
 
-namespace VATA { class BDDTopDownTreeAut; }
+namespace VATA
+{
+	class BDDTopDownTreeAut;
+	class BDDBottomUpTreeAut;
+}
 
 GCC_DIAG_OFF(effc++)
 class VATA::BDDTopDownTreeAut
@@ -51,7 +56,11 @@ GCC_DIAG_ON(effc++)
 
 	friend BDDTopDownTreeAut RemoveUselessStates(const BDDTopDownTreeAut&);
 
+	friend BDDTopDownTreeAut ReencodeSymbols(const BDDTopDownTreeAut&,
+		const SymbolicAutBase::StringToSymbolDict&);
+
 	friend class BDDBottomUpTreeAut;
+	friend class TreeAutConverter;
 
 public:   // data types
 
@@ -61,7 +70,7 @@ public:   // data types
 	typedef StateTupleSet DownInclStateTupleSet;
 	typedef const std::vector<StateTuple>& DownInclStateTupleVector;
 	typedef std::unordered_set<StateType> StateSet;
-	typedef VATA::Util::OrdVector<StateType> StateSetLight;
+	typedef VATA::Util::SmallOrdVector<StateType>::Type StateSetLight;
 
 	typedef VATA::Util::TwoWayDict<std::string, SymbolType> StringToSymbolDict;
 
@@ -110,8 +119,6 @@ private:  // constants
 	static const size_t MAX_SYMBOL_ARITY =
 		VATA::Util::IntExp2(SYMBOL_ARITY_LENGTH) - 1;
 
-	static const size_t SYMBOL_TOTAL_SIZE = SYMBOL_SIZE + SYMBOL_ARITY_LENGTH;
-
 
 private:  // data members
 
@@ -160,7 +167,8 @@ private:  // methods
 	}
 
 	template <class StateBackTransFunc, class SymbolBackTransFunc>
-	AutDescription dumpToAutDescExplicit(StateBackTransFunc stateBackTranslator,
+	void dumpToWriterExplicit(VATA::Serialization::AbstrStreamWriter& writer,
+		StateBackTransFunc stateBackTranslator,
 		SymbolBackTransFunc /* symbolTranslator */) const
 	{
 		GCC_DIAG_OFF(effc++)
@@ -203,25 +211,28 @@ private:  // methods
 			}
 		};
 
-		AutDescription desc;
+		// copy states
+		for (auto stateBddPair : GetStates())
+		{	// for all states
+			writer.WriteState(stateBackTranslator(stateBddPair.first));
+		}
 
 		// copy final states
 		for (auto fst : finalStates_)
 		{	// copy final states
-			desc.finalStates.insert(stateBackTranslator(fst));
+			writer.WriteFinalState(stateBackTranslator(fst));
 		}
 
 		CondColApplyFunctor collector;
+		AutDescription::StateTuple tupleStr;
 
-		// copy states, transitions and symbols
+		// copy transitions
 		for (auto stateBddPair : GetStates())
 		{	// for all states
 			const StateType& state = stateBddPair.first;
 
 			std::string stateStr = stateBackTranslator(state);
 
-			desc.states.insert(stateStr);
-
 			const TransMTBDD& transMtbdd = GetMtbdd(state);
 
 			for (auto sym : GetSymbolDict())
@@ -234,17 +245,25 @@ private:  // methods
 
 				for (auto tuple : collector.GetAccumulator())
 				{	// for each state tuple for which there is a transition
-					std::vector<std::string> tupleStr;
+					tupleStr.clear();
 					for (auto tupState : tuple)
 					{	// for each element in the tuple
 						tupleStr.push_back(stateBackTranslator(tupState));
 					}
 
-					desc.transitions.insert(AutDescription::Transition(tupleStr, symbol,
-						stateStr));
+					writer.WriteTransition(tupleStr, symbol, stateStr);
 				}
 			}
 		}
+	}
+
+	template <class StateBackTransFunc, class SymbolBackTransFunc>
+	AutDescription dumpToAutDescExplicit(StateBackTransFunc stateBackTranslator,
+		SymbolBackTransFunc symbolTranslator) const
+	{
+		AutDescription desc;
+		VATA::Serialization::AutDescriptionWriter descWriter(desc);
+		dumpToWriterExplicit(descWriter, stateBackTranslator, symbolTranslator);
 
 		return desc;
 	}
@@ -281,6 +300,7 @@ public:   // public methods
 	{ }
 
 	BDDTopDownTreeAut(const BDDTopDownTreeAut& aut) :
+		SymbolicAutBase(aut),
 		finalStates_(aut.finalStates_),
 		transTable_(aut.transTable_)
 	{ }
@@ -289,6 +309,7 @@ public:   // public methods
 	{
 		if (this != &rhs)
 		{
+			SymbolicAutBase::operator=(rhs);
 			transTable_ = rhs.transTable_;
 			finalStates_ = rhs.finalStates_;
 		}
@@ -382,6 +403,8 @@ public:   // public methods
 		StateBackTransFunc stateBackTranslator, SymbolTransFunc symbolTranslator,
 		const std::string& params = "") const
 	{
+		CheckEncoding();
+
 		AutDescription desc;
 		if (params == "symbolic")
 		{
@@ -395,6 +418,30 @@ public:   // public methods
 		return serializer.Serialize(desc);
 	}
 
+	/**
+	 * @brief  Writes the automaton to a stream writer and finishes the output
+	 *
+	 * If @p sorted is @p false, the transitions are written while the
+	 * automaton is traversed and no text of the whole automaton is kept in
+	 * memory; otherwise, the output is the same as the one of DumpToString().
+	 */
+	template <class StateBackTransFunc, class SymbolTransFunc>
+	void DumpToStream(VATA::Serialization::AbstrStreamWriter& writer,
+		StateBackTransFunc stateBackTranslator, SymbolTransFunc symbolTranslator,
+		bool sorted = true) const
+	{
+		if (sorted)
+		{
+			writer.Write(dumpToAutDescExplicit(stateBackTranslator, symbolTranslator));
+		}
+		else
+		{
+			dumpToWriterExplicit(writer, stateBackTranslator, symbolTranslator);
+		}
+
+		writer.Finish();
+	}
+
 	template <class SymbolTransFunc>
 	std::string DumpToString(VATA::Serialization::AbstrSerializer& serializer,
 		SymbolTransFunc symbolTranslator,
@@ -428,11 +475,13 @@ public:   // public methods
 	void AddTransition(const StateTuple& children, SymbolType symbol,
 		const StateType& parent)
 	{
+		CheckEncoding();
+
 		// Assertions
-		assert(symbol.length() == SYMBOL_SIZE);
+		assert(symbol.length() == GetSymbolSize());
 
 		addArityToSymbol(symbol, children.size());
-		assert(symbol.length() == SYMBOL_TOTAL_SIZE);
+		assert(symbol.length() == GetSymbolSize() + SYMBOL_ARITY_LENGTH);
 
 		if (transTable_.unique())
 		{
@@ -514,6 +563,8 @@ public:   // public methods
 		return TransMTBDD::DumpToDot(stateVec);
 	}
 
+	BDDBottomUpTreeAut GetBottomUpAut() const;
+
 	inline static DownInclStateTupleVector StateTupleSetToVector(
 		const DownInclStateTupleSet& tupleSet)
 	{
@@ -580,7 +631,7 @@ public:   // public methods
 
 		SymbolType arityAsgn(SYMBOL_ARITY_LENGTH, arity);
 
-		return mtbdd.GetMtbddForPrefix(arityAsgn, SYMBOL_SIZE);
+		return mtbdd.GetMtbddForPrefix(arityAsgn, GetSymbolSize());
 	}
 
 	static inline bool ShareTransTable(const BDDTopDownTreeAut& lhs,
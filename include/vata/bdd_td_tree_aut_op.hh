@@ -39,6 +39,18 @@ namespace VATA
 
 	BDDTopDownTreeAut RemoveUselessStates(const BDDTopDownTreeAut& aut);
 
+	/**
+	 * @brief  Re-encodes the symbols of an automaton
+	 *
+	 * Translates an automaton whose symbols are encoded using @p oldDict to
+	 * the encoding given by the current symbol dictionary (e.g. after
+	 * SymbolicAutBase::EncodeAlphabet()). Symbols are matched by their names.
+	 * Symbols used by @p aut that are missing in the current dictionary are
+	 * added to it; std::runtime_error is thrown if the encoding is full.
+	 */
+	BDDTopDownTreeAut ReencodeSymbols(const BDDTopDownTreeAut& aut,
+		const SymbolicAutBase::StringToSymbolDict& oldDict);
+
 	bool CheckDownwardInclusion(const BDDTopDownTreeAut& smaller,
 		const BDDTopDownTreeAut& bigger);
 
@@ -62,6 +74,9 @@ namespace VATA
 		const BDDTopDownTreeAut& smaller, const BDDTopDownTreeAut& bigger,
 		const Rel& preorder)
 	{
+		smaller.CheckEncoding();
+		bigger.CheckEncoding();
+
 		return CheckDownwardTreeInclusion<BDDTopDownTreeAut,
 			DownwardInclusionFunctor>(smaller, bigger, preorder);
 	}
@@ -82,6 +97,9 @@ namespace VATA
 		const BDDTopDownTreeAut& smaller, const BDDTopDownTreeAut& bigger,
 		const Rel& preorder)
 	{
+		smaller.CheckEncoding();
+		bigger.CheckEncoding();
+
 		return CheckDownwardTreeInclusion<BDDTopDownTreeAut,
 			OptDownwardInclusionFunctor>(smaller, bigger, preorder);
 	}
@@ -103,6 +121,18 @@ namespace VATA
 		return CheckDownwardInclusion(smaller, bigger);
 	}
 
+	/**
+	 * @brief  Checks language equivalence of the automata
+	 *
+	 * The check is performed on the bottom-up counterparts of the automata.
+	 * If the languages differ and @p counterexample is given, it is set to an
+	 * automaton accepting a single tree accepted by exactly one of the
+	 * automata.
+	 */
+	bool CheckEquivalence(const BDDTopDownTreeAut& lhs,
+		const BDDTopDownTreeAut& rhs,
+		BDDTopDownTreeAut* counterexample = nullptr);
+
 	template <class SymbolType, class Dict>
 	BDDTopDownTreeAut Complement(const BDDTopDownTreeAut& aut,
 		const Dict& alphabet) {
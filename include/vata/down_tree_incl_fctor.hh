@@ -17,6 +17,8 @@
 #include <vata/util/antichain2c_v2.hh>
 #include <vata/util/cache.hh>
 #include <vata/util/cached_binary_op.hh>
+#include <vata/util/cancellation.hh>
+#include <vata/util/stats.hh>
 
 
 namespace VATA
@@ -32,7 +34,7 @@ class VATA::DownwardInclusionFunctor
 public:   // data types
 
 	typedef typename Aut::StateType StateType;
-	typedef typename VATA::Util::OrdVector<StateType> StateSet;
+	typedef typename VATA::Util::SmallOrdVector<StateType>::Type StateSet;
 	typedef typename Aut::StateTuple StateTuple;
 	typedef typename Aut::DownInclStateTupleSet StateTupleSet;
 	typedef typename Aut::DownInclStateTupleVector StateTupleVector;
@@ -90,6 +92,8 @@ public:   // data types
 				assert(x != nullptr);
 				assert(y != nullptr);
 
+				VATA_STATS_INC("lte_cache.misses");
+
 				for (const auto& s : *x)
 				{
 					assert(s < ind_.size());
@@ -153,6 +157,7 @@ public:   // data types
 			}
 			else
 			{
+				VATA_STATS_INC("lte_cache.lookups");
 				return lteCache_.lookup(lhs.get(), rhs.get(), noncachedLte_);
 			}
 		}
@@ -283,6 +288,9 @@ private:  // methods
 			return true;
 		}
 
+		VATA::Util::PollCancellation("downward inclusion", workset_.size(),
+			nonIncl_.size());
+
 		workset_.insert(key);
 
 		DownwardInclusionFunctor innerFctor(*this);
@@ -515,6 +523,11 @@ public:   // methods
 				ChoiceFunctionGenerator cfGen(rhsVector.size(), lhsTuple.size());
 				while (!cfGen.IsLast())
 				{	// for each choice function
+					// the number of choice functions is exponential and most of their
+					// expansions end in the cache, before the poll in expand()
+					VATA::Util::PollCancellation("downward inclusion",
+						workset_.size(), nonIncl_.size());
+
 					const ChoiceFunctionType& cf = cfGen.GetNext();
 					bool found = false;
 
@@ -16,6 +16,8 @@
 #include <vata/vata.hh>
 #include <vata/util/antichain2c_v2.hh>
 #include <vata/util/cache.hh>
+#include <vata/util/cancellation.hh>
+#include <vata/util/stats.hh>
 
 
 namespace VATA
@@ -31,7 +33,7 @@ class VATA::OptDownwardInclusionFunctor
 public:   // data types
 
 	typedef typename Aut::StateType StateType;
-	typedef typename VATA::Util::OrdVector<StateType> StateSet;
+	typedef typename VATA::Util::SmallOrdVector<StateType>::Type StateSet;
 	typedef typename Aut::StateTuple StateTuple;
 	typedef typename Aut::DownInclStateTupleSet StateTupleSet;
 	typedef typename Aut::DownInclStateTupleVector StateTupleVector;
@@ -88,6 +90,8 @@ public:   // data types
 				assert(x != nullptr);
 				assert(y != nullptr);
 
+				VATA_STATS_INC("lte_cache.misses");
+
 				for (const auto& s : *x)
 				{
 					assert(s < ind_.size());
@@ -151,6 +155,7 @@ public:   // data types
 			}
 			else
 			{
+				VATA_STATS_INC("lte_cache.lookups");
 				return lteCache_.lookup(lhs.get(), rhs.get(), noncachedLte_);
 			}
 		}
@@ -295,6 +300,9 @@ private:  // methods
 			return std::make_tuple(true, InclAntichainType(), ConsequentType());
 		}
 
+		VATA::Util::PollCancellation("downward inclusion", workset_.size(),
+			nonIncl_.size());
+
 		workset_.insert(key);
 
 		InclAntichainType antecedent;
@@ -586,6 +594,11 @@ public:   // methods
 				ChoiceFunctionGenerator cfGen(rhsVector.size(), lhsTuple.size());
 				while (!cfGen.IsLast())
 				{	// for each choice function
+					// the number of choice functions is exponential and most of their
+					// expansions end in the cache, before the poll in expand()
+					VATA::Util::PollCancellation("downward inclusion",
+						workset_.size(), nonIncl_.size());
+
 					const ChoiceFunctionType& cf = cfGen.GetNext();
 					bool found = false;
 
@@ -13,28 +13,32 @@
 
 #include <vector>
 
+#include <vata/vata.hh>
 #include <vata/util/binary_relation.hh>
+#include <vata/util/partitioned_relation.hh>
 #include <vata/util/smart_set.hh>
 
 namespace VATA { class ExplicitLTS; }
 
 class VATA::ExplicitLTS {
 
-	size_t states_;
+public:
+
+	typedef IdType StateType;
+	typedef std::vector<std::vector<StateType>> StateListTable;
+
+private:
+
+	StateType states_;
 	size_t transitions_;
-	std::vector<
-		std::pair<
-			std::vector<std::vector<size_t>>,
-			std::vector<std::vector<size_t>>
-		>
-	> data_;
+	std::vector<std::pair<StateListTable, StateListTable>> data_;
 	std::vector<Util::SmartSet> bwLabels_;
 
 public:
 
 	ExplicitLTS() : states_(0), transitions_(0), data_(), bwLabels_() {}
 
-	void addTransition(size_t q, size_t a, size_t r) {
+	void addTransition(StateType q, size_t a, StateType r) {
 
 		if (a >= this->data_.size())
 			this->data_.resize(a + 1);
@@ -67,7 +71,7 @@ public:
 			this->data_[a].first.resize(this->states_);
 			this->data_[a].second.resize(this->states_);
 
-			for (size_t r = 0; r < this->states_; ++r)
+			for (StateType r = 0; r < this->states_; ++r)
 				this->bwLabels_[r].init(a, this->data_[a].second[r].size());
 
 		}
@@ -83,7 +87,7 @@ public:
 
 	}
 
-	const std::vector<std::vector<size_t>>& post(size_t a) const {
+	const StateListTable& post(size_t a) const {
 
 		assert(a < this->data_.size());
 
@@ -91,7 +95,7 @@ public:
 
 	}
 
-	const std::vector<std::vector<size_t>>& pre(size_t a) const {
+	const StateListTable& pre(size_t a) const {
 
 		assert(a < this->data_.size());
 
@@ -107,13 +111,14 @@ public:
 
 	}
 	
-	void buildDelta1(std::vector<Util::SmartSet>& delta1) const {
+	void buildDelta1(std::vector<Util::SmartSet>& delta1,
+		Util::SmartSet::Allocator* allocator = nullptr) const {
 
-		delta1.resize(this->data_.size(), Util::SmartSet(this->states_));
+		delta1.resize(this->data_.size(), Util::SmartSet(this->states_, allocator));
 
 		for (size_t a = 0; a < this->data_.size(); ++a) {
 
-			for (size_t q = 0; q < this->data_[a].first.size(); ++q)
+			for (StateType q = 0; q < this->data_[a].first.size(); ++q)
 				delta1[a].init(q, delta1[a].count(q) + this->data_[a].first[q].size());
 
 		}
@@ -122,7 +127,9 @@ public:
 
 	size_t labels() const { return this->data_.size(); }
 
-	const size_t& states() const { return this->states_; }
+	StateType states() const { return this->states_; }
+
+	size_t transitions() const { return this->transitions_; }
 
 	friend std::ostream& operator<<(std::ostream& os, const ExplicitLTS& lts) {
 
@@ -144,16 +151,16 @@ public:
 public:
 
 	Util::BinaryRelation computeSimulation(
-		const std::vector<std::vector<size_t>>& partition,
+		const StateListTable& partition,
 		const Util::BinaryRelation& relation,
 		size_t outputSize
 	);
 
 	Util::BinaryRelation computeSimulation(size_t outputSize) {
 
-		std::vector<std::vector<size_t>> partition(1);
+		StateListTable partition(1);
 
-		for (size_t i = 0; i < this->states_; ++i)
+		for (StateType i = 0; i < this->states_; ++i)
 			partition[0].push_back(i);
 
 		return this->computeSimulation(
@@ -168,6 +175,36 @@ public:
 
 	}
 
+	/**
+	 * The same as computeSimulation() but the result is kept as the partition
+	 * and the relation on its blocks computed by the algorithm, which needs
+	 * memory linear in the output size plus the number of related blocks
+	 */
+	Util::PartitionedRelation computePartitionedSimulation(
+		const StateListTable& partition,
+		const Util::BinaryRelation& relation,
+		size_t outputSize
+	);
+
+	Util::PartitionedRelation computePartitionedSimulation(size_t outputSize) {
+
+		StateListTable partition(1);
+
+		for (StateType i = 0; i < this->states_; ++i)
+			partition[0].push_back(i);
+
+		return this->computePartitionedSimulation(
+			partition, Util::BinaryRelation(1, true), outputSize
+		);
+
+	}
+
+	Util::PartitionedRelation computePartitionedSimulation() {
+
+		return this->computePartitionedSimulation(this->states_);
+
+	}
+
 };
 
 #endif
@@ -17,11 +17,15 @@
 #include <vata/explicit_lts.hh>
 #include <vata/parsing/abstr_parser.hh>
 #include <vata/serialization/abstr_serializer.hh>
+#include <vata/serialization/aut_description_writer.hh>
 #include <vata/util/ord_vector.hh>
 #include <vata/util/transl_strict.hh>
 #include <vata/util/transl_weak.hh>
 #include <vata/util/convert.hh>
 #include <vata/util/cache.hh>
+#include <vata/util/inline_tuple.hh>
+#include <vata/util/persistent_map.hh>
+#include <vata/util/stats.hh>
 
 // Standard library headers
 #include <cstdint>
@@ -37,7 +41,10 @@ namespace VATA {
 
 		typedef AutBase::StateType StateType;
 
-		typedef std::vector<StateType> StateTuple;
+		/// ranks of tuples stored without allocation
+		static const size_t INLINE_RANK = 2;
+
+		typedef Util::InlineTuple<StateType, INLINE_RANK> StateTuple;
 		typedef std::shared_ptr<StateTuple> TuplePtr;
 		typedef std::set<StateTuple> TupleSet;
 		typedef std::unordered_set<StateType> StateSet;
@@ -89,7 +96,7 @@ GCC_DIAG_ON(effc++)
 
 	template <class SymbolType, class Rel, class Index>
 	friend ExplicitLTS TranslateUpward(const ExplicitTreeAut<SymbolType>&,
-		std::vector<std::vector<size_t>>&, Util::BinaryRelation&, const Rel&, const Index&);
+		ExplicitLTS::StateListTable&, Util::BinaryRelation&, const Rel&, const Index&);
 
 	template <class SymbolType, class Rel, class Index>
 	friend ExplicitTreeAut<SymbolType> CollapseStates(const ExplicitTreeAut<SymbolType>&,
@@ -98,10 +105,11 @@ GCC_DIAG_ON(effc++)
 	friend class ExplicitUpwardInclusion;
 	friend class ExplicitDownwardComplementation;
 	friend class ExplicitDownwardInclusion;
+	friend class TreeAutConverter;
 
 public:   // public data types
 
-	typedef VATA::Util::OrdVector<StateType> StateSetLight;
+	typedef VATA::Util::SmallOrdVector<StateType>::Type StateSetLight;
 	typedef Explicit::StateType StateType;
 	typedef Explicit::StateTuple StateTuple;
 	typedef Explicit::TuplePtr TuplePtr;
@@ -139,6 +147,117 @@ public:   // public data types
 	typedef VATA::Util::TranslatorStrict<typename StringToSymbolDict::MapBwdType>
 		SymbolBackTranslatorStrict;
 
+	/**
+	 * @brief  Alphabet, symbol and state counters and tuple cache of automata
+	 *
+	 * Automata bound to different contexts are independent; they may, e.g., be
+	 * processed in different threads. The result of an operation is bound to
+	 * the context of its operands and operations on automata from different
+	 * contexts are refused. A context needs to outlive its automata.
+	 *
+	 * The default context uses the dictionary and the counters set by
+	 * SetSymbolDictPtr(), SetNextSymbolPtr() and SetNextStatePtr() and the
+	 * global tuple cache.
+	 *
+	 * The parallelism of a context is the number of threads used by the
+	 * bottom-up reachability kernel on its automata (one by default).
+	 */
+	class Context
+	{
+	private:  // data members
+
+		bool isDefault_;
+
+		StringToSymbolDict symbolDict_;
+		SymbolType nextSymbol_;
+		StateType nextState_;
+		TupleCache tupleCache_;
+		unsigned parallelism_;
+
+	private:  // methods
+
+		Context(const Context&);
+		Context& operator=(const Context&);
+
+		explicit Context(bool isDefault) :
+			isDefault_(isDefault),
+			symbolDict_(),
+			nextSymbol_(),
+			nextState_(),
+			tupleCache_(),
+			parallelism_(1)
+		{ }
+
+	public:   // methods
+
+		Context() :
+			isDefault_(false),
+			symbolDict_(),
+			nextSymbol_(),
+			nextState_(),
+			tupleCache_(),
+			parallelism_(1)
+		{ }
+
+		StringToSymbolDict& GetSymbolDict()
+		{
+			if (isDefault_)
+			{
+				// Assertions
+				assert(pSymbolDict_ != nullptr);
+
+				return *pSymbolDict_;
+			}
+
+			return symbolDict_;
+		}
+
+		SymbolType AddSymbol()
+		{
+			if (isDefault_)
+			{
+				// Assertions
+				assert(pNextSymbol_ != nullptr);
+
+				return (*pNextSymbol_)++;
+			}
+
+			return nextSymbol_++;
+		}
+
+		StateType AddState()
+		{
+			if (isDefault_)
+			{
+				return AddSharedState();
+			}
+
+			return nextState_++;
+		}
+
+		TupleCache& GetTupleCache()
+		{
+			return (isDefault_)? Explicit::tupleCache : tupleCache_;
+		}
+
+		void SetParallelism(unsigned threads)
+		{
+			parallelism_ = (threads)? threads : 1;
+		}
+
+		unsigned GetParallelism() const
+		{
+			return parallelism_;
+		}
+
+		static Context& GetDefault()
+		{
+			static Context context(true);
+
+			return context;
+		}
+	};
+
 private:  // private data types
 
 	typedef VATA::Util::AutDescription AutDescription;
@@ -178,22 +297,28 @@ private:  // private data types
 	typedef std::shared_ptr<TransitionCluster> TransitionClusterPtr;
 
 	GCC_DIAG_OFF(effc++)
-	class StateToTransitionClusterMap : public std::unordered_map<StateType, TransitionClusterPtr> {
+	class StateToTransitionClusterMap :
+		public VATA::Util::PersistentHashMap<StateType, TransitionClusterPtr> {
 	GCC_DIAG_ON(effc++)
 
 	public:
 
 		const TransitionClusterPtr& uniqueCluster(const StateType& state) {
 
-			auto& cluster = this->insert(
-				std::make_pair(state, TransitionClusterPtr(nullptr))
-			).first->second;
+			if (this->find(state) == this->end()) {
 
-			if (!cluster) {
+				return this->insert(
+					std::make_pair(state, TransitionClusterPtr(new TransitionCluster()))
+				).first->second;
 
-				cluster = TransitionClusterPtr(new TransitionCluster());
+			}
 
-			} else if (!cluster.unique()) {
+			// copies the shared nodes on the path to the cluster
+			auto& cluster = (*this)[state];
+
+			assert(cluster);
+
+			if (!cluster.unique()) {
 
 				cluster = TransitionClusterPtr(new TransitionCluster(*cluster));
 
@@ -223,7 +348,11 @@ protected:
 
 	TuplePtr tupleLookup(const StateTuple& tuple) {
 
-		return this->cache_.lookup(tuple);
+		TuplePtr result = this->cache_->lookup(tuple);
+
+		VATA_STATS_MAX("explicit.tuple_cache.size_max", this->cache_->size());
+
+		return result;
 
 	}
 
@@ -233,6 +362,7 @@ protected:
 
 		if (!this->transitions_.unique()) {
 
+			// the map is persistent, the copy shares all its nodes
 			this->transitions_ = StateToTransitionClusterMapPtr(
 				new StateToTransitionClusterMap(*transitions_)
 			);
@@ -580,7 +710,9 @@ public:
 
 private:  // data members
 
-	TupleCache& cache_;
+	TupleCache* cache_;
+
+	Context* context_;
 
 	StateSet finalStates_;
 
@@ -593,7 +725,24 @@ public:   // public methods
 
 	ExplicitTreeAut(Explicit::TupleCache& tupleCache = Explicit::tupleCache) :
 		accepting(*this),
-		cache_(tupleCache),
+		cache_(&tupleCache),
+		context_(&Context::GetDefault()),
+		finalStates_(),
+		transitions_(StateToTransitionClusterMapPtr(new StateToTransitionClusterMap()))
+	{ }
+
+	explicit ExplicitTreeAut(Context& context) :
+		accepting(*this),
+		cache_(&context.GetTupleCache()),
+		context_(&context),
+		finalStates_(),
+		transitions_(StateToTransitionClusterMapPtr(new StateToTransitionClusterMap()))
+	{ }
+
+	ExplicitTreeAut(Explicit::TupleCache& tupleCache, Context& context) :
+		accepting(*this),
+		cache_(&tupleCache),
+		context_(&context),
 		finalStates_(),
 		transitions_(StateToTransitionClusterMapPtr(new StateToTransitionClusterMap()))
 	{ }
@@ -601,21 +750,26 @@ public:   // public methods
 	ExplicitTreeAut(const ExplicitTreeAut& aut) :
 		accepting(*this),
 		cache_(aut.cache_),
+		context_(aut.context_),
 		finalStates_(aut.finalStates_),
 		transitions_(aut.transitions_)
 	{ }
 
 	ExplicitTreeAut(const ExplicitTreeAut& aut, Explicit::TupleCache& tupleCache) :
 		accepting(*this),
-		cache_(tupleCache),
+		cache_(&tupleCache),
+		context_(aut.context_),
 		finalStates_(aut.finalStates_),
 		transitions_(aut.transitions)
 	{ }
 
+	// the automaton takes over the context and the tuple cache of rhs
 	ExplicitTreeAut& operator=(const ExplicitTreeAut& rhs) {
 
 		if (this != &rhs) {
 
+			this->cache_ = rhs.cache_;
+			this->context_ = rhs.context_;
 			this->finalStates_ = rhs.finalStates_;
 			this->transitions_ = rhs.transitions_;
 
@@ -646,7 +800,7 @@ public:   // public methods
 		LoadFromAutDesc(desc,
 			StateTranslator(stateDict,
 				[&stateCnt](const std::string&){return stateCnt++;}),
-			SymbolTranslator(GetSymbolDict(),
+			SymbolTranslator(this->GetSymbolDict(),
 				[this](const StringRank&){return this->AddSymbol();}));
 	}
 
@@ -716,66 +870,108 @@ public:   // public methods
 		};
 
 		SymbolTranslatorPrinter printer;
-		printer.translator = SymbolBackTranslatorStrict(GetSymbolDict().GetReverseMap());
+		printer.translator = SymbolBackTranslatorStrict(this->GetSymbolDict().GetReverseMap());
 
 		return DumpToString(serializer,
 			StateBackTranslatorStrict(stateDict.GetReverseMap()),
 			printer);
 	}
 
-	template <class StatePrintFunc, class SymbolPrintFunc>
-	std::string DumpToString(
-		VATA::Serialization::AbstrSerializer&     serializer,
-		StatePrintFunc                            statePrinter,
-		SymbolPrintFunc                           symbolPrinter,
-		const std::string&                        /* params */ = "") const
+private:  // data types
+
+	template <class SymbolPrintFunc>
+	struct SymbolStrPrinter
 	{
-		struct SymbolTranslatorPrinter
-		{
-			const SymbolPrintFunc& printFunc;
+		const SymbolPrintFunc& printFunc;
 
-			SymbolTranslatorPrinter(const SymbolPrintFunc& printFunc) :
-				printFunc(printFunc)
-			{ }
+		SymbolStrPrinter(const SymbolPrintFunc& printFunc) :
+			printFunc(printFunc)
+		{ }
 
-			std::string operator()(const SymbolType& sym) const
-			{
-				if (nullptr == &sym)
-				{ }
+		std::string operator()(const SymbolType& sym) const
+		{
+			if (nullptr == &sym)
+			{ }
 
-				return printFunc(sym).symbolStr;
-			}
-		};
+			return printFunc(sym).symbolStr;
+		}
+	};
 
-		SymbolTranslatorPrinter printer(symbolPrinter);
+private:  // methods
 
-		AutDescription desc;
+	template <class StatePrintFunc, class SymbolPrintFunc>
+	void dumpToWriter(
+		VATA::Serialization::AbstrStreamWriter&   writer,
+		StatePrintFunc                            statePrinter,
+		SymbolPrintFunc                           symbolPrinter) const
+	{
+		SymbolStrPrinter<SymbolPrintFunc> printer(symbolPrinter);
 
 		for (auto& s : this->finalStates_)
 		{
-			desc.finalStates.insert(statePrinter(s));
+			writer.WriteFinalState(statePrinter(s));
 		}
 
+		AutDescription::StateTuple tupleStr;
 		for (auto t : *this)
 		{
-			std::vector<std::string> tupleStr;
-
+			tupleStr.clear();
 			for (auto& s : t.children())
 			{
 				tupleStr.push_back(statePrinter(s));
 			}
 
-			AutDescription::Transition trans(
-				tupleStr,
-				printer(t.symbol()),
+			writer.WriteTransition(tupleStr, printer(t.symbol()),
 				statePrinter(t.state()));
-
-			desc.transitions.insert(trans);
 		}
+	}
+
+public:   // public methods
+
+	template <class StatePrintFunc, class SymbolPrintFunc>
+	std::string DumpToString(
+		VATA::Serialization::AbstrSerializer&     serializer,
+		StatePrintFunc                            statePrinter,
+		SymbolPrintFunc                           symbolPrinter,
+		const std::string&                        /* params */ = "") const
+	{
+		AutDescription desc;
+		VATA::Serialization::AutDescriptionWriter descWriter(desc);
+		dumpToWriter(descWriter, statePrinter, symbolPrinter);
 
 		return serializer.Serialize(desc);
 	}
 
+	/**
+	 * @brief  Writes the automaton to a stream writer and finishes the output
+	 *
+	 * If @p sorted is @p false, the transitions are written in the order in
+	 * which they are stored and no text of the whole automaton is kept in
+	 * memory; otherwise, the output is the same as the one of DumpToString().
+	 */
+	template <class StatePrintFunc, class SymbolPrintFunc>
+	void DumpToStream(
+		VATA::Serialization::AbstrStreamWriter&   writer,
+		StatePrintFunc                            statePrinter,
+		SymbolPrintFunc                           symbolPrinter,
+		bool                                      sorted = true) const
+	{
+		if (sorted)
+		{
+			AutDescription desc;
+			VATA::Serialization::AutDescriptionWriter descWriter(desc);
+			dumpToWriter(descWriter, statePrinter, symbolPrinter);
+
+			writer.Write(desc);
+		}
+		else
+		{
+			dumpToWriter(writer, statePrinter, symbolPrinter);
+		}
+
+		writer.Finish();
+	}
+
 	inline const StateSet& GetFinalStates() const {
 		return this->finalStates_;
 	}
@@ -847,6 +1043,8 @@ public:   // public methods
 	template <class Index>
 	void ReindexStates(ExplicitTreeAut& dst, Index& index) const {
 
+		CheckContexts(*this, dst);
+
 		for (auto& state : this->finalStates_)
 			dst.SetStateFinal(index[state]);
 
@@ -940,28 +1138,44 @@ public:   // public methods
 
 public:
 
-	inline StateType AddState()
+	inline Context& GetContext() const
 	{
-		// Assertions
-		assert(pNextState_ != nullptr);
+		return *context_;
+	}
 
-		return (*pNextState_)++;
+	/**
+	 * @brief  Creates an empty automaton bound to the context of @p aut
+	 */
+	static ExplicitTreeAut CreateEmpty(const ExplicitTreeAut& aut)
+	{
+		return ExplicitTreeAut(*aut.cache_, *aut.context_);
 	}
 
-	static inline SymbolType AddSymbol()
+	/**
+	 * @brief  Throws an exception if the automata are bound to different
+	 *         contexts
+	 */
+	static void CheckContexts(const ExplicitTreeAut& lhs, const ExplicitTreeAut& rhs)
 	{
-		// Assertions
-		assert(pNextSymbol_ != nullptr);
+		if (lhs.context_ != rhs.context_)
+		{
+			throw std::runtime_error("Automata bound to different contexts");
+		}
+	}
 
-		return (*pNextSymbol_)++;
+	inline StateType AddState()
+	{
+		return context_->AddState();
 	}
 
-	static inline StringToSymbolDict& GetSymbolDict()
+	inline SymbolType AddSymbol() const
 	{
-		// Assertions
-		assert(pSymbolDict_ != nullptr);
+		return context_->AddSymbol();
+	}
 
-		return *pSymbolDict_;
+	inline StringToSymbolDict& GetSymbolDict() const
+	{
+		return context_->GetSymbolDict();
 	}
 
 	inline static void SetSymbolDictPtr(StringToSymbolDict* pSymbolDict)
@@ -986,7 +1200,7 @@ public:
 		return DownInclStateTupleVector(tupleSet.begin(), tupleSet.end());
 	}
 
-	static AlphabetType GetAlphabet()
+	AlphabetType GetAlphabet() const
 	{
 		AlphabetType alphabet;
 		for (auto stringRankAndSymbolPair : GetSymbolDict())
@@ -19,16 +19,20 @@
 #include <vata/explicit_tree_useless.hh>
 #include <vata/explicit_tree_unreach.hh>
 #include <vata/explicit_tree_candidate.hh>
+#include <vata/explicit_tree_equiv.hh>
 #include <vata/explicit_tree_comp_down.hh>
 #include <vata/explicit_tree_transl.hh>
 #include <vata/explicit_tree_incl_down.hh>
 #include <vata/explicit_tree_incl_up.hh>
+#include <vata/explicit_word_aut.hh>
 #include <vata/down_tree_incl_fctor.hh>
 #include <vata/down_tree_opt_incl_fctor.hh>
 #include <vata/tree_incl_down.hh>
 #include <vata/util/transl_strict.hh>
+#include <vata/util/transl_weak.hh>
 #include <vata/util/two_way_dict.hh>
 #include <vata/util/binary_relation.hh>
+#include <vata/util/partitioned_relation.hh>
 #include <vata/util/util.hh>
 //#include <vata/util/convert.hh>
 
@@ -58,7 +62,7 @@ namespace VATA {
 		StateToStateTranslator stateTransLhs(*pTranslMapLhs, translFunc);
 		StateToStateTranslator stateTransRhs(*pTranslMapRhs, translFunc);
 
-		ExplicitTreeAut<SymbolType> res(lhs.cache_);
+		ExplicitTreeAut<SymbolType> res(ExplicitTreeAut<SymbolType>::CreateEmpty(lhs));
 
 		lhs.ReindexStates(res, stateTransLhs);
 		rhs.ReindexStates(res, stateTransRhs);
@@ -71,6 +75,8 @@ namespace VATA {
 	ExplicitTreeAut<SymbolType> UnionDisjunctStates(const ExplicitTreeAut<SymbolType>& lhs,
 		const ExplicitTreeAut<SymbolType>& rhs) {
 
+		ExplicitTreeAut<SymbolType>::CheckContexts(lhs, rhs);
+
 		ExplicitTreeAut<SymbolType> res(lhs);
 
 		assert(rhs.transitions_);
@@ -125,11 +131,13 @@ namespace VATA {
 
 		rel.buildClasses(representatives);
 
-		std::vector<AutBase::StateType> transl(representatives.size());
+		// the relation is indexed by the positions given by bwIndex
+		std::unordered_map<AutBase::StateType, AutBase::StateType> transl;
 
-		Util::RebindMap2(transl, representatives, bwIndex);
+		for (size_t i = 0; i < representatives.size(); ++i)
+			transl[bwIndex[i]] = bwIndex[representatives[i]];
 
-		ExplicitTreeAut<SymbolType> res(aut.cache_);
+		ExplicitTreeAut<SymbolType> res(ExplicitTreeAut<SymbolType>::CreateEmpty(aut));
 
 		aut.ReindexStates(res, transl);
 
@@ -165,7 +173,7 @@ namespace VATA {
 	AutBase::StateBinaryRelation ComputeUpwardSimulation(
 		const ExplicitTreeAut<SymbolType>& aut, const size_t& size, const Index& index) {
 
-		std::vector<std::vector<size_t>> partition;
+		ExplicitLTS::StateListTable partition;
 
 		AutBase::StateBinaryRelation relation;
 
@@ -179,7 +187,7 @@ namespace VATA {
 	AutBase::StateBinaryRelation ComputeUpwardSimulation(
 		const ExplicitTreeAut<SymbolType>& aut, const size_t& size) {
 
-		std::vector<std::vector<size_t>> partition;
+		ExplicitLTS::StateListTable partition;
 
 		AutBase::StateBinaryRelation relation;
 
@@ -197,6 +205,68 @@ namespace VATA {
 
 	}
 
+	template <class SymbolType, class Index>
+	AutBase::StatePartitionedRelation ComputePartitionedDownwardSimulation(
+		const ExplicitTreeAut<SymbolType>& aut, const size_t& size, const Index& index) {
+
+		return TranslateDownward(aut, index).computePartitionedSimulation(size);
+
+	}
+
+	template <class SymbolType>
+	AutBase::StatePartitionedRelation ComputePartitionedDownwardSimulation(
+		const ExplicitTreeAut<SymbolType>& aut, const size_t& size) {
+
+		return TranslateDownward(aut).computePartitionedSimulation(size);
+
+	}
+
+	template <class SymbolType>
+	AutBase::StatePartitionedRelation ComputePartitionedDownwardSimulation(
+		const ExplicitTreeAut<SymbolType>& aut) {
+
+		return ComputePartitionedDownwardSimulation(aut,
+			AutBase::SanitizeAutForSimulation(aut));
+
+	}
+
+	template <class SymbolType, class Index>
+	AutBase::StatePartitionedRelation ComputePartitionedUpwardSimulation(
+		const ExplicitTreeAut<SymbolType>& aut, const size_t& size, const Index& index) {
+
+		ExplicitLTS::StateListTable partition;
+
+		AutBase::StateBinaryRelation relation;
+
+		return TranslateUpward(
+			aut, partition, relation, Util::Identity(size), index
+		).computePartitionedSimulation(partition, relation, size);
+
+	}
+
+	template <class SymbolType>
+	AutBase::StatePartitionedRelation ComputePartitionedUpwardSimulation(
+		const ExplicitTreeAut<SymbolType>& aut, const size_t& size) {
+
+		ExplicitLTS::StateListTable partition;
+
+		AutBase::StateBinaryRelation relation;
+
+		return TranslateUpward(
+			aut, partition, relation, Util::Identity(size)
+		).computePartitionedSimulation(partition, relation, size);
+
+	}
+
+	template <class SymbolType>
+	AutBase::StatePartitionedRelation ComputePartitionedUpwardSimulation(
+		const ExplicitTreeAut<SymbolType>& aut) {
+
+		return ComputePartitionedUpwardSimulation(aut,
+			AutBase::SanitizeAutForSimulation(aut));
+
+	}
+
 	template <class SymbolType>
 	ExplicitTreeAut<SymbolType> Reduce(const ExplicitTreeAut<SymbolType>& aut) {
 
@@ -218,7 +288,7 @@ namespace VATA {
 
 		aut.BuildStateIndex(stateTranslator);
 
-		AutBase::StateBinaryRelation sim = ComputeDownwardSimulation(
+		AutBase::StatePartitionedRelation sim = ComputePartitionedDownwardSimulation(
 			aut, stateDict.size(), Util::TranslatorStrict<StateDict>(stateDict)
 		);
 
@@ -236,7 +306,7 @@ namespace VATA {
 	ExplicitTreeAut<SymbolType> ComplementWithPreorder(const ExplicitTreeAut<SymbolType>& aut,
 		const Dict& alphabet, const Rel& preorder) {
 
-		ExplicitTreeAut<SymbolType> res;
+		ExplicitTreeAut<SymbolType> res(ExplicitTreeAut<SymbolType>::CreateEmpty(aut));
 
 		ExplicitDownwardComplementation::Compute(res, aut, alphabet, preorder);
 
@@ -274,6 +344,8 @@ namespace VATA {
 	bool CheckUpwardInclusionWithPreorder(const ExplicitTreeAut<SymbolType>& smaller,
 		const ExplicitTreeAut<SymbolType>& bigger, const Rel& preorder) {
 
+		ExplicitTreeAut<SymbolType>::CheckContexts(smaller, bigger);
+
 		return ExplicitUpwardInclusion::Check(smaller, bigger, preorder);
 
 	}
@@ -283,6 +355,8 @@ namespace VATA {
 		const ExplicitTreeAut<SymbolType>& smaller,
 		const ExplicitTreeAut<SymbolType>& bigger, const Rel& preorder) {
 
+		ExplicitTreeAut<SymbolType>::CheckContexts(smaller, bigger);
+
 		return CheckDownwardTreeInclusion<ExplicitTreeAut<SymbolType>,
 			VATA::OptDownwardInclusionFunctor>(smaller, bigger, preorder);
 	}
@@ -291,6 +365,8 @@ namespace VATA {
 	bool CheckDownwardInclusionWithPreorder(const ExplicitTreeAut<SymbolType>& smaller,
 		const ExplicitTreeAut<SymbolType>& bigger, const Rel& preorder) {
 
+		ExplicitTreeAut<SymbolType>::CheckContexts(smaller, bigger);
+
 		return CheckDownwardTreeInclusion<ExplicitTreeAut<SymbolType>,
 			VATA::DownwardInclusionFunctor>(smaller, bigger, preorder);
 
@@ -300,14 +376,111 @@ namespace VATA {
 	bool CheckDownwardInclusionNonRecWithPreorder(const ExplicitTreeAut<SymbolType>& smaller,
 		const ExplicitTreeAut<SymbolType>& bigger, const Rel& preorder) {
 
+		ExplicitTreeAut<SymbolType>::CheckContexts(smaller, bigger);
+
 		return ExplicitDownwardInclusion::Check(smaller, bigger, preorder);
 
 	}
 
+	template <class SymbolType>
+	bool IsWordAut(const ExplicitTreeAut<SymbolType>& aut) {
+
+		for (auto transition : aut) {
+
+			if (transition.children().size() > 1)
+				return false;
+
+		}
+
+		return true;
+
+	}
+
+	template <class SymbolType>
+	bool CheckWordInclusion(const ExplicitTreeAut<SymbolType>& smaller,
+		const ExplicitTreeAut<SymbolType>& bigger, bool useSimulation = true) {
+
+		typedef AutBase::StateType StateType;
+		typedef std::unordered_map<SymbolType, size_t> SymbolMap;
+
+		ExplicitTreeAut<SymbolType>::CheckContexts(smaller, bigger);
+
+		AutBase::StateToStateMap smallerStateMap, biggerStateMap;
+		SymbolMap symbolMap;
+		size_t smallerStateCnt = 0, biggerStateCnt = 0, symbolCnt = 0;
+
+		AutBase::StateToStateTranslator smallerStateTrans(smallerStateMap,
+			[&smallerStateCnt](const StateType&){ return smallerStateCnt++; });
+		AutBase::StateToStateTranslator biggerStateTrans(biggerStateMap,
+			[&biggerStateCnt](const StateType&){ return biggerStateCnt++; });
+		Util::TranslatorWeak2<SymbolMap> symbolTrans(symbolMap,
+			[&symbolCnt](const SymbolType&){ return symbolCnt++; });
+
+		ExplicitWordAut newSmaller, newBigger;
+
+		newSmaller.LoadFromTreeAut(smaller, smallerStateTrans, symbolTrans);
+		newBigger.LoadFromTreeAut(bigger, biggerStateTrans, symbolTrans);
+
+		return ExplicitWordAut::CheckInclusion(newSmaller, newBigger, useSimulation);
+
+	}
+
+	template <class SymbolType>
+	bool CheckWordUniversality(const ExplicitTreeAut<SymbolType>& aut,
+		bool useSimulation = true) {
+
+		typedef AutBase::StateType StateType;
+		typedef std::unordered_map<SymbolType, size_t> SymbolMap;
+
+		AutBase::StateToStateMap stateMap;
+		SymbolMap symbolMap;
+		size_t stateCnt = 0, symbolCnt = 0;
+
+		AutBase::StateToStateTranslator stateTrans(stateMap,
+			[&stateCnt](const StateType&){ return stateCnt++; });
+		Util::TranslatorWeak2<SymbolMap> symbolTrans(symbolMap,
+			[&symbolCnt](const SymbolType&){ return symbolCnt++; });
+
+		ExplicitWordAut::AlphabetType alphabet;
+		bool hasLeaves = false, hasBranching = false;
+
+		for (auto& symbolRankPair : aut.GetAlphabet()) {
+
+			if (symbolRankPair.second > 1) {
+
+				hasBranching = true;
+
+				continue;
+
+			}
+
+			hasLeaves = hasLeaves || (symbolRankPair.second == 0);
+
+			alphabet.push_back(
+				std::make_pair(symbolTrans(symbolRankPair.first), symbolRankPair.second)
+			);
+
+		}
+
+		// trees with branching are rejected by word automata
+		if (hasLeaves && hasBranching)
+			return false;
+
+		ExplicitWordAut newAut;
+
+		newAut.LoadFromTreeAut(aut, stateTrans, symbolTrans);
+
+		return newAut.CheckUniversality(alphabet, useSimulation);
+
+	}
+
 	template <class SymbolType>
 	bool CheckUpwardInclusion(const ExplicitTreeAut<SymbolType>& smaller,
 		const ExplicitTreeAut<SymbolType>& bigger) {
 
+		if (IsWordAut(smaller) && IsWordAut(bigger))
+			return CheckWordInclusion(smaller, bigger, false);
+
 		ExplicitTreeAut<SymbolType> newSmaller = smaller;
 		ExplicitTreeAut<SymbolType> newBigger = bigger;
 		typename AutBase::StateType states =
@@ -328,7 +501,7 @@ namespace VATA {
 			AutBase::SanitizeAutsForInclusion(newSmaller, newBigger);
 
 		return CheckDownwardInclusionWithPreorder(newSmaller, newBigger,
-			ComputeDownwardSimulation(
+			ComputePartitionedDownwardSimulation(
 				UnionDisjunctStates(newSmaller, newBigger), states)
 			);
 	}
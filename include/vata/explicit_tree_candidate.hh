@@ -13,12 +13,11 @@
 
 // Standard library headers
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 
 // VATA headers
 #include <vata/vata.hh>
 #include <vata/explicit_tree_aut.hh>
+#include <vata/explicit_tree_reach.hh>
 
 namespace VATA {
 
@@ -42,36 +41,20 @@ VATA::ExplicitTreeAut<SymbolType> VATA::GetCandidateTree(
 		SymbolType symbol_;
 		StateType state_;
 
-		std::set<StateType> childrenSet_;
-
 		TransitionInfo(const TuplePtr& children, const SymbolType& symbol, const StateType& state)
-			: children_(children), symbol_(symbol), state_(state),
-			childrenSet_(children->begin(), children->end()) {
-		}
-
-		bool reachedBy(const StateType& state) {
-
-			assert(this->childrenSet_.count(state));
-
-			this->childrenSet_.erase(state);
-
-			return this->childrenSet_.empty();
-
-		}
+			: children_(children), symbol_(symbol), state_(state) {}
 
 	};
 
-	typedef std::shared_ptr<TransitionInfo> TransitionInfoPtr;
+	// transitions indexed in the same way as in the reachability kernel
+	std::vector<TransitionInfo> transitions;
+	ExplicitTreeReachability reach(aut.GetContext().GetParallelism());
 
-	std::unordered_map<StateType, std::vector<TransitionInfoPtr>> stateMap;
-	std::unordered_set<StateType> reachableStates;
-	std::vector<TransitionInfoPtr> reachableTransitions;
-	std::list<StateType> newStates;
+	for (auto& state : aut.finalStates_)
+		reach.SetTarget(state);
 
 	assert(aut.transitions_);
 
-	size_t remaining = 0;
-
 	for (auto& stateClusterPair : *aut.transitions_) {
 
 		assert(stateClusterPair.second);
@@ -84,30 +67,11 @@ VATA::ExplicitTreeAut<SymbolType> VATA::GetCandidateTree(
 
 				assert(tuple);
 
-				auto transitionInfoPtr = TransitionInfoPtr(
-					new TransitionInfo(tuple, symbolTupleSetPair.first, stateClusterPair.first)
-				);
-
-				if (tuple->empty()) {
+				reach.AddTransition(stateClusterPair.first, *tuple);
 
-					reachableTransitions.push_back(transitionInfoPtr);
-
-					if (reachableStates.insert(stateClusterPair.first).second)
-						newStates.push_back(stateClusterPair.first);
-
-					continue;
-
-				}
-
-				for (auto& s : transitionInfoPtr->childrenSet_) {
-
-					stateMap.insert(
-						std::make_pair(s, std::vector<TransitionInfoPtr>())
-					).first->second.push_back(transitionInfoPtr);
-
-					++remaining;
-
-				}
+				transitions.push_back(
+					TransitionInfo(tuple, symbolTupleSetPair.first, stateClusterPair.first)
+				);
 
 			}
 
@@ -115,61 +79,27 @@ VATA::ExplicitTreeAut<SymbolType> VATA::GetCandidateTree(
 
 	}
 
-	while (!newStates.empty()) {
-
-		auto i = stateMap.find(newStates.front());
-
-		newStates.pop_front();
+	// breadth-first search stops at the first final state
+	reach.Run(true);
 
-		if (i == stateMap.end())
-			continue;
-
-		for (auto& info : i->second) {
-
-			assert(info);
-
-			if (!info->reachedBy(i->first))
-				continue;
-
-			--remaining;
-
-			if (reachableStates.insert(info->state_).second) {
-
-				reachableTransitions.push_back(info);
-
-				newStates.push_back(info->state_);
-
-				if (aut.IsFinalState(info->state_))
-					goto found_;
-
-			}
-
-		}
-
-	}
-found_:
-	ExplicitTA result(aut.cache_);
+	ExplicitTA result(ExplicitTA::CreateEmpty(aut));
 
 	for (auto& state : aut.finalStates_) {
 
-		if (reachableStates.count(state))
+		if (reach.IsStateReached(state))
 			result.SetStateFinal(state);
 
 	}
 
-	if (!remaining) {
-
-		result.transitions_ = aut.transitions_;
-
-		return RemoveUnreachableStates(result);
-
-	}
-
-	for (auto& info : reachableTransitions) {
+	// every reached state keeps only the transition which reached it first
+	for (size_t i = 0; i < transitions.size(); ++i) {
 
-		assert(info);
+		if (!reach.IsWitness(i))
+			continue;
 
-		result.internalAddTransition(info->children_, info->symbol_, info->state_);
+		result.internalAddTransition(
+			transitions[i].children_, transitions[i].symbol_, transitions[i].state_
+		);
 
 	}
 
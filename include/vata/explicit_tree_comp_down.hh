@@ -17,6 +17,7 @@
 
 #include <vata/explicit_tree_aut.hh>
 #include <vata/util/antichain1c.hh>
+#include <vata/util/cancellation.hh>
 #include <vata/util/transl_strict.hh>
 
 namespace VATA {
@@ -187,7 +188,7 @@ public:
 
 		ExplicitDownwardComplementation::topDownIndex(transitionIndex, symbolTranslator, src);
 
-		std::vector<std::vector<size_t>> ind, inv;
+		Util::BinaryRelation::IndexType ind, inv;
 
 		preorder.buildIndex(ind, inv);
 
@@ -231,6 +232,9 @@ public:
 
 		while (todo.size()) {
 
+			VATA::Util::PollCancellation("downward complementation", todo.size(),
+				stateCache.size());
+
 			const auto P = *todo.begin();
 
 			todo.erase(todo.begin());
@@ -295,6 +299,9 @@ public:
 				do {
 
 					// we loop for each choice function
+					VATA::Util::PollCancellation("downward complementation",
+						todo.size(), stateCache.size());
+
 					for (size_t i = 0; i < choiceFunction.size(); ++i) {
 
 						auto choice = choiceFunction[i];
@@ -0,0 +1,357 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Upward language equivalence for explicitly represented tree automata.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_EXPLICIT_TREE_EQUIV_HH_
+#define _VATA_EXPLICIT_TREE_EQUIV_HH_
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <vata/explicit_tree_aut.hh>
+#include <vata/tree_equiv_up.hh>
+
+namespace VATA {
+
+	template <class Symbol>
+	class ExplicitUpwardEquivalence;
+
+	/*
+	 * Checks equivalence upwards by bisimulation up to congruence. If the
+	 * languages differ and counterexample is given, it is set to an automaton
+	 * accepting a single tree accepted by exactly one of the automata.
+	 */
+	template <class SymbolType>
+	bool CheckEquivalence(const ExplicitTreeAut<SymbolType>& lhs,
+		const ExplicitTreeAut<SymbolType>& rhs,
+		ExplicitTreeAut<SymbolType>* counterexample = nullptr);
+
+}
+
+/*
+ * Post-images of tuples of macro-states of two explicit automata for
+ * UpwardEquivalenceChecker.
+ */
+template <class Symbol>
+class VATA::ExplicitUpwardEquivalence {
+
+public:
+
+	typedef Explicit::StateType StateType;
+	typedef Symbol SymbolType;
+
+	typedef std::vector<StateType> StateSet;
+	typedef std::vector<const StateSet*> MacroTuple;
+
+private:
+
+	typedef ExplicitTreeAut<SymbolType> ExplicitTA;
+	typedef typename ExplicitTA::StateTuple StateTuple;
+
+	// a parent of a transition taken from a tuple, tagged by the automaton
+	typedef std::tuple<SymbolType, bool, StateType> Post;
+	typedef std::vector<Post> PostList;
+
+	struct Transition {
+
+		const StateTuple* children_;
+		SymbolType symbol_;
+		StateType state_;
+
+		Transition(const StateTuple* children, const SymbolType& symbol,
+			const StateType& state)
+			: children_(children), symbol_(symbol), state_(state) {}
+
+	};
+
+	typedef std::vector<std::vector<std::unordered_set<StateType>>> PositionIndex;
+
+	/*
+	 * Transitions of one automaton; the leaf ones together, the others by their
+	 * first child state. The child states are also kept for every rank and
+	 * position.
+	 */
+	struct Side {
+
+		std::vector<Transition> leaves_;
+		std::unordered_map<StateType, std::vector<Transition>> byFirstChild_;
+		PositionIndex children_;
+		std::unordered_set<StateType> finalStates_;
+
+		Side() : leaves_(), byFirstChild_(), children_(), finalStates_() {}
+
+	};
+
+	Side lhsSide_;
+	Side rhsSide_;
+
+	std::vector<size_t> ranks_;
+
+private:
+
+	static void post(const Side& side, const MacroTuple& tuple, PostList& posts,
+		bool lhs) {
+
+		if (tuple.empty()) {
+
+			for (auto& trans : side.leaves_)
+				posts.push_back(Post(trans.symbol_, lhs, trans.state_));
+
+			return;
+
+		}
+
+		for (auto& state : *tuple[0]) {
+
+			auto iter = side.byFirstChild_.find(state);
+
+			if (iter == side.byFirstChild_.end())
+				continue;
+
+			for (auto& trans : iter->second) {
+
+				const StateTuple& children = *trans.children_;
+
+				if (children.size() != tuple.size())
+					continue;
+
+				size_t i = 1;
+
+				while ((i < children.size()) &&
+					std::binary_search(tuple[i]->begin(), tuple[i]->end(), children[i]))
+					++i;
+
+				if (i == children.size())
+					posts.push_back(Post(trans.symbol_, lhs, trans.state_));
+
+			}
+
+		}
+
+	}
+
+	/*
+	 * Calls func(symbol, lhsPost, rhsPost) for every symbol with a transition
+	 * from the tuples.
+	 */
+	template <class Func>
+	void foreachSymbolPost(const MacroTuple& lhsTuple, const MacroTuple& rhsTuple,
+		Func func) const {
+
+		PostList posts;
+
+		post(this->lhsSide_, lhsTuple, posts, true);
+		post(this->rhsSide_, rhsTuple, posts, false);
+
+		// the posts are grouped by symbol and automaton, the states are sorted
+		std::sort(posts.begin(), posts.end());
+		posts.erase(std::unique(posts.begin(), posts.end()), posts.end());
+
+		StateSet lhsPost, rhsPost;
+
+		for (auto iter = posts.begin(); iter != posts.end(); ) {
+
+			const SymbolType& symbol = std::get<0>(*iter);
+
+			lhsPost.clear();
+			rhsPost.clear();
+
+			for ( ; (iter != posts.end()) && (std::get<0>(*iter) == symbol); ++iter)
+				(std::get<1>(*iter) ? lhsPost : rhsPost).push_back(std::get<2>(*iter));
+
+			func(symbol, lhsPost, rhsPost);
+
+		}
+
+	}
+
+	void indexAut(const ExplicitTA& aut, Side& side, std::set<size_t>& ranks) {
+
+		for (auto& state : aut.GetFinalStates())
+			side.finalStates_.insert(state);
+
+		for (auto trans : aut) {
+
+			const StateTuple& children = trans.children();
+
+			if (children.empty()) {
+
+				side.leaves_.push_back(Transition(&children, trans.symbol(), trans.state()));
+
+				continue;
+
+			}
+
+			side.byFirstChild_[children[0]].push_back(
+				Transition(&children, trans.symbol(), trans.state())
+			);
+
+			ranks.insert(children.size());
+
+			if (side.children_.size() <= children.size())
+				side.children_.resize(children.size() + 1);
+
+			side.children_[children.size()].resize(children.size());
+
+			for (size_t i = 0; i < children.size(); ++i)
+				side.children_[children.size()][i].insert(children[i]);
+
+		}
+
+	}
+
+	static bool occursAt(const Side& side, size_t rank, size_t position,
+		const StateSet& states) {
+
+		if ((rank >= side.children_.size()) || side.children_[rank].empty())
+			return false;
+
+		auto& children = side.children_[rank][position];
+
+		for (auto& state : states) {
+
+			if (children.count(state))
+				return true;
+
+		}
+
+		return false;
+
+	}
+
+public:
+
+	ExplicitUpwardEquivalence(const ExplicitTA& lhs, const ExplicitTA& rhs)
+		: lhsSide_(), rhsSide_(), ranks_() {
+
+		std::set<size_t> ranks;
+
+		this->indexAut(lhs, this->lhsSide_, ranks);
+		this->indexAut(rhs, this->rhsSide_, ranks);
+
+		this->ranks_.assign(ranks.begin(), ranks.end());
+
+	}
+
+	const std::vector<size_t>& GetRanks() const {
+
+		return this->ranks_;
+
+	}
+
+	bool IsLhsFinal(const StateType& state) const {
+
+		return this->lhsSide_.finalStates_.count(state) > 0;
+
+	}
+
+	bool IsRhsFinal(const StateType& state) const {
+
+		return this->rhsSide_.finalStates_.count(state) > 0;
+
+	}
+
+	bool OccursAt(size_t rank, size_t position, const StateSet& lhs,
+		const StateSet& rhs) const {
+
+		return occursAt(this->lhsSide_, rank, position, lhs) ||
+			occursAt(this->rhsSide_, rank, position, rhs);
+
+	}
+
+	template <class Func>
+	void ForeachPost(const MacroTuple& lhsTuple, const MacroTuple& rhsTuple,
+		Func func) const {
+
+		this->foreachSymbolPost(lhsTuple, rhsTuple,
+			[&func](const SymbolType&, const StateSet& lhsPost, const StateSet& rhsPost) {
+
+				func(lhsPost, rhsPost);
+
+			}
+		);
+
+	}
+
+	SymbolType FindSymbol(const MacroTuple& lhsTuple, const MacroTuple& rhsTuple,
+		const StateSet& lhsPost, const StateSet& rhsPost) const {
+
+		SymbolType result = SymbolType();
+		bool found = false;
+
+		this->foreachSymbolPost(lhsTuple, rhsTuple,
+			[&](const SymbolType& symbol, const StateSet& lhsSet, const StateSet& rhsSet) {
+
+				if (!found && (lhsSet == lhsPost) && (rhsSet == rhsPost)) {
+
+					result = symbol;
+					found = true;
+
+				}
+
+			}
+		);
+
+		if (!found)
+			throw std::runtime_error("No symbol for the post-image of a tuple");
+
+		return result;
+
+	}
+
+};
+
+template <class SymbolType>
+bool VATA::CheckEquivalence(const ExplicitTreeAut<SymbolType>& lhs,
+	const ExplicitTreeAut<SymbolType>& rhs,
+	ExplicitTreeAut<SymbolType>* counterexample) {
+
+	typedef ExplicitUpwardEquivalence<SymbolType> Backend;
+	typedef UpwardEquivalenceChecker<Backend> Checker;
+
+	ExplicitTreeAut<SymbolType>::CheckContexts(lhs, rhs);
+
+	Backend backend(lhs, rhs);
+	Checker checker(backend);
+
+	if (checker.Check())
+		return true;
+
+	if (!counterexample)
+		return false;
+
+	// every node of the tree becomes a state with a single transition
+	typename Checker::Counterexample tree = checker.GetCounterexample();
+
+	*counterexample = ExplicitTreeAut<SymbolType>::CreateEmpty(lhs);
+
+	for (size_t i = 0; i < tree.size(); ++i) {
+
+		std::vector<AutBase::StateType> children(
+			tree[i].children.begin(), tree[i].children.end()
+		);
+
+		counterexample->AddTransition(
+			typename ExplicitTreeAut<SymbolType>::StateTuple(children), tree[i].symbol, i
+		);
+
+	}
+
+	counterexample->SetStateFinal(tree.size() - 1);
+
+	return false;
+
+}
+
+#endif
@@ -86,7 +86,7 @@ public:
 		ExplicitDownwardInclusion::topDownIndex(smaller, smallerIndex, symbolTranslator);
 		ExplicitDownwardInclusion::topDownIndex(bigger, biggerIndex, symbolTranslator);
 
-		std::vector<std::vector<size_t>> ind, inv;
+		Util::BinaryRelation::IndexType ind, inv;
 
 		preorder.buildIndex(ind, inv);
 
@@ -119,7 +119,7 @@ public:
 			bigger, biggerIndex, biggerLeaves, symbolTranslator
 		);
 
-		std::vector<std::vector<size_t>> ind, inv;
+		Util::BinaryRelation::IndexType ind, inv;
 
 		preorder.buildIndex(ind, inv);
 
@@ -143,8 +143,8 @@ private:
 		const Explicit::StateSet& smallerFinalStates,
 		const DoubleIndexedTupleList& biggerIndex,
 		const Explicit::StateSet& biggerFinalStates,
-		const std::vector<std::vector<size_t>>& ind,
-		const std::vector<std::vector<size_t>>& inv
+		const Util::BinaryRelation::IndexType& ind,
+		const Util::BinaryRelation::IndexType& inv
 	);
 /*
 	static bool checkInternalOpt(
@@ -154,8 +154,8 @@ private:
 		const SymbolToTransitionListMap& biggerLeaves,
 		const SymbolToDoubleIndexedTransitionListMap& biggerIndex,
 		const Explicit::StateSet& biggerFinalStates,
-		const std::vector<std::vector<size_t>>& ind,
-		const std::vector<std::vector<size_t>>& inv
+		const Util::BinaryRelation::IndexType& ind,
+		const Util::BinaryRelation::IndexType& inv
 	);
 */
 };
@@ -11,6 +11,9 @@
 #ifndef _VATA_EXPLICIT_TREE_INCL_UP_HH_
 #define _VATA_EXPLICIT_TREE_INCL_UP_HH_
 
+#include <vector>
+#include <stdint.h>
+
 #include <vata/explicit_tree_aut.hh>
 
 namespace VATA {
@@ -21,110 +24,104 @@ namespace VATA {
 
 class VATA::ExplicitUpwardInclusion {
 
-	class Transition {
-
-		Explicit::TuplePtr children_;
-		size_t symbol_;
-		Explicit::StateType state_;
-
-	public:
-
-		Transition(const Explicit::TuplePtr& children, const size_t& symbol,
-			const Explicit::StateType& state) : children_(children), symbol_(symbol), state_(state)
-			{}
-
-		const Explicit::StateTuple& children() const { return *this->children_; }
-		const size_t& symbol() const { return this->symbol_; }
-		const Explicit::StateType& state() const { return this->state_; }
+public:
 
-		friend std::ostream& operator<<(std::ostream& os, const Transition& t) {
+	typedef uint32_t TransitionId;
+	typedef std::vector<TransitionId> TransitionIdList;
 
-			return os << t.symbol_ << Util::Convert::ToString(*t.children_) << "->" << t.state_;
+private:
 
-		}
+	/*
+	 * Transitions with children numbered by 32-bit ids in the order of their
+	 * symbols and parents together with the parents of leaf transitions for
+	 * every symbol. Either the ids of transitions with a given child state are
+	 * indexed (for the smaller automaton), or the posting lists of ids for every
+	 * symbol, position and child state are (for the bigger one). Both indices
+	 * are stored as compressed sparse rows, so a posting list is a sorted range
+	 * of one array.
+	 */
+	class TransitionIndex {
 
-	};
+		struct Entry {
 
-	typedef std::shared_ptr<Transition> TransitionPtr;
-	typedef std::vector<TransitionPtr> TransitionList;
-	typedef std::vector<TransitionList> IndexedTransitionList;
-	typedef std::vector<IndexedTransitionList> DoubleIndexedTransitionList;
-	typedef std::vector<TransitionList> SymbolToTransitionListMap;
-	typedef std::vector<IndexedTransitionList> SymbolToIndexedTransitionListMap;
-	typedef std::vector<DoubleIndexedTransitionList> SymbolToDoubleIndexedTransitionListMap;
-	typedef std::vector<SymbolToIndexedTransitionListMap> IndexedSymbolToIndexedTransitionListMap;
+			size_t symbol_;
+			Explicit::StateType state_;
+			const Explicit::StateTuple* children_;
 
-	template <class Aut, class SymbolIndex>
-	static void bottomUpIndex(const Aut& aut,
-		IndexedSymbolToIndexedTransitionListMap& bottomUpIndex,
-		SymbolToTransitionListMap& leaves, SymbolIndex& symbolIndex) {
+			Entry(size_t symbol, Explicit::StateType state,
+				const Explicit::StateTuple* children)
+				: symbol_(symbol), state_(state), children_(children) {}
 
-		for (auto& stateClusterPair : *aut.transitions_) {
+			bool operator<(const Entry& rhs) const {
 
-			assert(stateClusterPair.second);
+				return (this->symbol_ < rhs.symbol_) ||
+					((this->symbol_ == rhs.symbol_) && (this->state_ < rhs.state_));
 
-			for (auto& symbolTupleSetPair : *stateClusterPair.second) {
+			}
 
-				assert(symbolTupleSetPair.second);
-				assert(symbolTupleSetPair.second->size());
+		};
 
-				auto& symbol = symbolIndex[symbolTupleSetPair.first];
+		size_t states_;
 
-				auto& first = *symbolTupleSetPair.second->begin();
+		std::vector<size_t> symbols_;
+		std::vector<Explicit::StateType> parents_;
+		std::vector<const Explicit::StateTuple*> children_;
 
-				assert(first);
+		std::vector<size_t> leafOffsets_;
+		std::vector<Explicit::StateType> leafParents_;
 
-				if (first->empty()) {
+		// transitions by a child state; the position of the child is kept aside
+		std::vector<size_t> childOffsets_;
+		TransitionIdList childTransitions_;
+		std::vector<uint32_t> childPositions_;
 
-					if (leaves.size() <= symbol)
-						leaves.resize(symbol + 1);
+		// posting lists by symbol, position and child state
+		std::vector<size_t> slotOffsets_;
+		std::vector<size_t> postingOffsets_;
+		TransitionIdList postings_;
 
-					auto& transitionList = leaves[symbol];
+		void init(std::vector<Entry>& entries,
+			std::vector<std::vector<Explicit::StateType>>& leaves);
 
-					for (auto& tuple : *symbolTupleSetPair.second) {
-
-						assert(tuple);
-						assert(tuple->empty());
+	public:
 
-						transitionList.push_back(
-							TransitionPtr(new Transition(tuple, symbol, stateClusterPair.first))
-						);
+		TransitionIndex() : states_(0), symbols_(), parents_(), children_(),
+			leafOffsets_(1, 0), leafParents_(), childOffsets_(), childTransitions_(),
+			childPositions_(), slotOffsets_(), postingOffsets_(), postings_() {}
 
-					}
+		template <class Aut, class SymbolIndex>
+		void build(const Aut& aut, SymbolIndex& symbolIndex) {
 
-					continue;
+			std::vector<Entry> entries;
+			std::vector<std::vector<Explicit::StateType>> leaves;
 
-				}
+			for (auto& stateClusterPair : *aut.transitions_) {
 
-				for (auto& tuple : *symbolTupleSetPair.second) {
+				assert(stateClusterPair.second);
 
-					assert(tuple);
-					assert(tuple->size());
+				for (auto& symbolTupleSetPair : *stateClusterPair.second) {
 
-					TransitionPtr transition(
-						new Transition(tuple, symbol, stateClusterPair.first)
-					);
+					assert(symbolTupleSetPair.second);
+					assert(symbolTupleSetPair.second->size());
 
-					size_t i = 0;
+					auto& symbol = symbolIndex[symbolTupleSetPair.first];
 
-					for (auto& state : *tuple) {
+					for (auto& tuple : *symbolTupleSetPair.second) {
 
-						if (bottomUpIndex.size() <= state)
-							bottomUpIndex.resize(state + 1);
+						assert(tuple);
 
-						auto& symbolIndexedTransitionList = bottomUpIndex[state];
+						if (tuple->empty()) {
 
-						if (symbolIndexedTransitionList.size() <= symbol)
-							symbolIndexedTransitionList.resize(symbol + 1);
+							if (leaves.size() <= symbol)
+								leaves.resize(symbol + 1);
 
-						auto& indexedTransitionList = symbolIndexedTransitionList[symbol];
+							leaves[symbol].push_back(stateClusterPair.first);
 
-						if (indexedTransitionList.size() <= i)
-							indexedTransitionList.resize(i + 1);
+							continue;
 
-						indexedTransitionList[i].push_back(transition);
+						}
 
-						++i;
+						entries.push_back(Entry(symbol, stateClusterPair.first, tuple.get()));
 
 					}
 
@@ -132,100 +129,86 @@ class VATA::ExplicitUpwardInclusion {
 
 			}
 
-		}
-
-	}
-
-	template <class Aut, class SymbolIndex>
-	static void bottomUpIndex2(const Aut& aut,
-		SymbolToDoubleIndexedTransitionListMap& bottomUpIndex,
-		SymbolToTransitionListMap& leaves, SymbolIndex& symbolIndex) {
+			this->init(entries, leaves);
 
-		for (auto& stateClusterPair : *aut.transitions_) {
-
-			assert(stateClusterPair.second);
-
-			for (auto& symbolTupleSetPair : *stateClusterPair.second) {
-
-				assert(symbolTupleSetPair.second);
-				assert(symbolTupleSetPair.second->size());
-
-				auto& symbol = symbolIndex[symbolTupleSetPair.first];
+		}
 
-				auto& first = *symbolTupleSetPair.second->begin();
+		void indexByChild();
 
-				assert(first);
+		void indexBySymbolPositionChild();
 
-				if (first->empty()) {
+		size_t states() const { return this->states_; }
 
-					if (leaves.size() <= symbol)
-						leaves.resize(symbol + 1);
+		size_t symbol(TransitionId transition) const { return this->symbols_[transition]; }
 
-					auto& transitionList = leaves[symbol];
+		const Explicit::StateType& parent(TransitionId transition) const {
 
-					for (auto& tuple : *symbolTupleSetPair.second) {
+			return this->parents_[transition];
 
-						assert(tuple);
-						assert(tuple->empty());
+		}
 
-						transitionList.push_back(
-							TransitionPtr(new Transition(tuple, symbol, stateClusterPair.first))
-						);
+		const Explicit::StateTuple& children(TransitionId transition) const {
 
-					}
+			return *this->children_[transition];
 
-					continue;
+		}
 
-				}
+		// the number of symbols up to the last one of a leaf transition
+		size_t leafSymbols() const { return this->leafOffsets_.size() - 1; }
 
-				if (bottomUpIndex.size() <= symbol)
-					bottomUpIndex.resize(symbol + 1);
+		std::pair<const Explicit::StateType*, const Explicit::StateType*> leafParents(
+			size_t symbol) const {
 
-				auto& doubleIndexedTransitionList = bottomUpIndex[symbol];
+			if (symbol >= this->leafSymbols())
+				return std::make_pair(nullptr, nullptr);
 
-				if (doubleIndexedTransitionList.size() < first->size())
-					doubleIndexedTransitionList.resize(first->size());
+			return std::make_pair(
+				this->leafParents_.data() + this->leafOffsets_[symbol],
+				this->leafParents_.data() + this->leafOffsets_[symbol + 1]
+			);
 
-				for (auto& tuple : *symbolTupleSetPair.second) {
+		}
 
-					assert(tuple);
-					assert(tuple->size());
+		// positions [first, last) of childTransitions()/childPositions()
+		std::pair<size_t, size_t> byChild(const Explicit::StateType& state) const {
 
-					TransitionPtr transition(
-						new Transition(tuple, symbol, stateClusterPair.first)
-					);
+			if (state + 1 >= this->childOffsets_.size())
+				return std::make_pair(0, 0);
 
-					size_t i = 0;
+			return std::make_pair(this->childOffsets_[state], this->childOffsets_[state + 1]);
 
-					for (auto& state : *tuple) {
+		}
 
-						assert(i < doubleIndexedTransitionList.size());
+		const TransitionIdList& childTransitions() const { return this->childTransitions_; }
 
-						if (doubleIndexedTransitionList[i].size() <= state)
-							doubleIndexedTransitionList[i].resize(state + 1);
+		const std::vector<uint32_t>& childPositions() const { return this->childPositions_; }
 
-						doubleIndexedTransitionList[i][state].push_back(transition);
+		std::pair<const TransitionId*, const TransitionId*> postings(size_t symbol,
+			size_t position, const Explicit::StateType& state) const {
 
-						++i;
+			if ((symbol + 1 >= this->slotOffsets_.size()) || (state >= this->states_))
+				return std::make_pair(nullptr, nullptr);
 
-					}
+			size_t slot = this->slotOffsets_[symbol] + position * this->states_ + state;
 
-				}
+			if (slot >= this->slotOffsets_[symbol + 1])
+				return std::make_pair(nullptr, nullptr);
 
-			}
+			return std::make_pair(
+				this->postings_.data() + this->postingOffsets_[slot],
+				this->postings_.data() + this->postingOffsets_[slot + 1]
+			);
 
 		}
 
-	}
+	};
 
 public:
 
 	template <class Aut, class Rel>
 	static bool Check(const Aut& smaller, const Aut& bigger, const Rel& preorder) {
 
-		IndexedSymbolToIndexedTransitionListMap smallerIndex;
-		SymbolToDoubleIndexedTransitionListMap biggerIndex;
-		SymbolToTransitionListMap smallerLeaves, biggerLeaves;
+		TransitionIndex smallerIndex, biggerIndex;
 
 		size_t symbolCnt = 0;
 		std::unordered_map<typename Aut::SymbolType, size_t> symbolMap;
@@ -235,23 +218,19 @@ public:
 				[&symbolCnt](const typename Aut::SymbolType&){ return symbolCnt++; }
 			);
 
-		ExplicitUpwardInclusion::bottomUpIndex(
-			smaller, smallerIndex, smallerLeaves, symbolTranslator
-		);
+		smallerIndex.build(smaller, symbolTranslator);
+		smallerIndex.indexByChild();
 
-		ExplicitUpwardInclusion::bottomUpIndex2(
-			bigger, biggerIndex, biggerLeaves, symbolTranslator
-		);
+		biggerIndex.build(bigger, symbolTranslator);
+		biggerIndex.indexBySymbolPositionChild();
 
-		std::vector<std::vector<size_t>> ind, inv;
+		Util::BinaryRelation::IndexType ind, inv;
 
 		preorder.buildIndex(ind, inv);
 
 		return ExplicitUpwardInclusion::checkInternal(
-			smallerLeaves,
 			smallerIndex,
 			smaller.GetFinalStates(),
-			biggerLeaves,
 			biggerIndex,
 			bigger.GetFinalStates(),
 			ind,
@@ -263,14 +242,12 @@ public:
 private:
 
 	static bool checkInternal(
-		const SymbolToTransitionListMap& smallerLeaves,
-		const IndexedSymbolToIndexedTransitionListMap& smallerIndex,
+		const TransitionIndex& smallerIndex,
 		const Explicit::StateSet& smallerFinalStates,
-		const SymbolToTransitionListMap& biggerLeaves,
-		const SymbolToDoubleIndexedTransitionListMap& biggerIndex,
+		const TransitionIndex& biggerIndex,
 		const Explicit::StateSet& biggerFinalStates,
-		const std::vector<std::vector<size_t>>& ind,
-		const std::vector<std::vector<size_t>>& inv
+		const Util::BinaryRelation::IndexType& ind,
+		const Util::BinaryRelation::IndexType& inv
 	);
 
 };
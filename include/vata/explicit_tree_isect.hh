@@ -20,6 +20,8 @@
 
 namespace VATA {
 
+	template <class TupleSet> class ExplicitTupleProduct;
+
 	template <class SymbolType>
 	ExplicitTreeAut<SymbolType> Intersection(
 		const ExplicitTreeAut<SymbolType>& lhs,
@@ -28,6 +30,70 @@ namespace VATA {
 
 }
 
+/**
+ * @brief  Product of two sets of tuples
+ *
+ * Tuples under one symbol usually have the same rank, hence the product is
+ * computed by apply<Rank>() instantiated for every small rank, where the loop
+ * over positions of tuples has a constant bound. Tuples of another rank (the
+ * automaton may use a symbol with several ranks) take the DYNAMIC_RANK loop
+ * and pairs of tuples of different ranks are skipped.
+ */
+template <class TupleSet>
+class VATA::ExplicitTupleProduct {
+
+	typedef Explicit::StateTuple StateTuple;
+
+	const TupleSet& lhs_;
+	const TupleSet& rhs_;
+	TupleSet& result_;
+	AutBase::ProductTranslTable& table_;
+	Explicit::TupleCache& cache_;
+
+	template <size_t Rank>
+	void applyTuple(const StateTuple& lhsTuple) {
+
+		size_t rank = StateTuple::RankOf<Rank>(lhsTuple);
+
+		for (auto& rhsTuplePtr : this->rhs_) {
+
+			if (rhsTuplePtr->size() != rank)
+				continue;
+
+			StateTuple children(rank);
+
+			for (size_t i = 0; i < rank; ++i)
+				children[i] = this->table_.Insert(lhsTuple[i], (*rhsTuplePtr)[i]).first;
+
+			this->result_.insert(this->cache_.lookup(children));
+
+		}
+
+	}
+
+public:
+
+	ExplicitTupleProduct(const TupleSet& lhs, const TupleSet& rhs, TupleSet& result,
+		AutBase::ProductTranslTable& table, Explicit::TupleCache& cache) : lhs_(lhs),
+		rhs_(rhs), result_(result), table_(table), cache_(cache) {}
+
+	template <size_t Rank>
+	void apply() {
+
+		for (auto& lhsTuplePtr : this->lhs_) {
+
+			// the rank is checked before the specialised loop is entered
+			if ((Rank != StateTuple::DYNAMIC_RANK) && (lhsTuplePtr->size() != Rank))
+				this->template applyTuple<StateTuple::DYNAMIC_RANK>(*lhsTuplePtr);
+			else
+				this->template applyTuple<Rank>(*lhsTuplePtr);
+
+		}
+
+	}
+
+};
+
 template <class SymbolType>
 VATA::ExplicitTreeAut<SymbolType> VATA::Intersection(
 	const VATA::ExplicitTreeAut<SymbolType>& lhs,
@@ -35,46 +101,51 @@ VATA::ExplicitTreeAut<SymbolType> VATA::Intersection(
 	VATA::AutBase::ProductTranslMap* pTranslMap = nullptr) {
 
 	typedef VATA::ExplicitTreeAut<SymbolType> ExplicitTA;
+	typedef typename ExplicitTA::StateType StateType;
 
-	VATA::AutBase::ProductTranslMap translMap;
+	ExplicitTA::CheckContexts(lhs, rhs);
 
-	if (!pTranslMap)
-		pTranslMap = &translMap;
+	// final states and parents of transitions determine the ranges
+	auto collectStates = [](const ExplicitTA& aut) -> std::vector<StateType> {
 
-	ExplicitTA res(lhs.cache_);
+		std::vector<StateType> states(aut.finalStates_.begin(), aut.finalStates_.end());
 
-	std::vector<const VATA::AutBase::ProductTranslMap::value_type*> stack;
+		for (auto& stateClusterPair : *aut.transitions_)
+			states.push_back(stateClusterPair.first);
 
-	for (auto& s : lhs.finalStates_) {
+		return states;
 
-		for (auto& t : rhs.finalStates_) {
+	};
 
-			auto u = pTranslMap->insert(
-				std::make_pair(std::make_pair(s, t), pTranslMap->size())
-			).first;
+	VATA::AutBase::ProductTranslTable table;
 
-			res.SetStateFinal(u->second);
+	table.SetRanges(collectStates(lhs), collectStates(rhs));
 
-			stack.push_back(&*u);
+	if (pTranslMap)
+		table.ImportFrom(*pTranslMap);
 
-		}
+	ExplicitTA res(ExplicitTA::CreateEmpty(lhs));
+
+	for (auto& s : lhs.finalStates_) {
+
+		for (auto& t : rhs.finalStates_)
+			res.SetStateFinal(table.Insert(s, t).first);
 
 	}
 
 	auto transitions = res.transitions_;
 
-	while (!stack.empty()) {
-
-		auto p = stack.back();
+	// product states are processed in the order of creation
+	for (StateType state = table.GetFirstState(); state < table.GetNextState(); ++state) {
 
-		stack.pop_back();
+		auto p = table.GetPair(state);
 
-		auto leftCluster = ExplicitTA::genericLookup(*lhs.transitions_, p->first.first);
+		auto leftCluster = ExplicitTA::genericLookup(*lhs.transitions_, p.first);
 
 		if (!leftCluster)
 			continue;
 
-		auto rightCluster = ExplicitTA::genericLookup(*rhs.transitions_, p->first.second);
+		auto rightCluster = ExplicitTA::genericLookup(*rhs.transitions_, p.second);
 
 		if (!rightCluster)
 			continue;
@@ -92,45 +163,27 @@ VATA::ExplicitTreeAut<SymbolType> VATA::Intersection(
 				continue;
 
 			if (!cluster)
-				cluster = transitions->uniqueCluster(p->second);
+				cluster = transitions->uniqueCluster(state);
 
 			auto tuplePtrSet = cluster->uniqueTuplePtrSet(leftSymbolStateTupleSetPtr.first);
 
-			for (auto& leftTuplePtr : *leftSymbolStateTupleSetPtr.second) {
+			assert(!leftSymbolStateTupleSetPtr.second->empty());
 
-				for (auto& rightTuplePtr : *rightTupleSet) {
+			ExplicitTupleProduct<typename ExplicitTA::TuplePtrSet> product(
+				*leftSymbolStateTupleSetPtr.second, *rightTupleSet, *tuplePtrSet, table, *res.cache_
+			);
 
-					assert(leftTuplePtr->size() == rightTuplePtr->size());
-
-					typename ExplicitTA::StateTuple children;
-
-					for (size_t i = 0; i < leftTuplePtr->size(); ++i) {
-
-						auto u = pTranslMap->insert(
-							std::make_pair(
-								std::make_pair((*leftTuplePtr)[i], (*rightTuplePtr)[i]),
-								pTranslMap->size()
-							)
-						);
-
-						if (u.second)
-							stack.push_back(&*u.first);
-
-						children.push_back(u.first->second);
-
-					}
-
-//					res.AddTransition(children, leftSymbolStateTupleSetPtr.first, p->second);
-					tuplePtrSet->insert(res.tupleLookup(children));
-
-				}
-
-			}
+			ExplicitTA::StateTuple::DispatchRank(
+				(*leftSymbolStateTupleSetPtr.second->begin())->size(), product
+			);
 
 		}
 
 	}
 
+	if (pTranslMap)
+		table.ExportTo(*pTranslMap);
+
 	return res;
 
 }
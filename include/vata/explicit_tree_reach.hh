@@ -0,0 +1,173 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2012  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Header file for the bottom-up reachability kernel of explicit tree
+ *    automata.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_EXPLICIT_TREE_REACH_HH_
+#define _VATA_EXPLICIT_TREE_REACH_HH_
+
+// Standard library headers
+#include <vector>
+#include <unordered_map>
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/aut_base.hh>
+
+namespace VATA {
+
+	class ExplicitTreeReachability;
+
+}
+
+/**
+ * @brief  Bottom-up reachability on flat arrays
+ *
+ * Transitions are added one by one and identified by their index. States are
+ * reindexed to a dense range, children of all transitions are stored in a
+ * single array and occurrences of states in tuples are kept in compressed
+ * (CSR) lists. Every transition has a counter of child occurrences that are
+ * not reached yet; the transition fires when the counter drops to zero. The
+ * whole computation is thus linear in the size of the automaton.
+ *
+ * If the parallelism passed to the constructor is larger than one, every
+ * level of the frontier is split among threads (the counters are then
+ * decremented atomically).
+ */
+class VATA::ExplicitTreeReachability {
+
+public:
+
+	typedef AutBase::StateType StateType;
+
+private:
+
+	std::unordered_map<StateType, size_t> stateIndex_;
+	std::vector<StateType> states_;
+
+	std::vector<size_t> parents_;
+	std::vector<size_t> childOffsets_;
+	std::vector<size_t> children_;
+
+	std::vector<size_t> occurrenceOffsets_;
+	std::vector<size_t> occurrences_;
+
+	std::vector<char> targets_;
+
+	std::vector<char> reached_;
+	std::vector<char> fired_;
+	std::vector<size_t> witnesses_;
+
+	size_t firedCount_;
+
+	unsigned parallelism_;
+
+private:
+
+	size_t getIndex(const StateType& state);
+
+	void buildOccurrences();
+
+	bool runSequential(const std::vector<size_t>& initial, bool stopAtTarget);
+
+	bool runParallel(const std::vector<size_t>& initial, bool stopAtTarget);
+
+public:
+
+	/**
+	 * @brief  Constructor
+	 *
+	 * @param  parallelism  The number of threads processing the frontier
+	 */
+	explicit ExplicitTreeReachability(unsigned parallelism = 1) : stateIndex_(),
+		states_(), parents_(), childOffsets_(1, 0), children_(),
+		occurrenceOffsets_(), occurrences_(), targets_(), reached_(), fired_(),
+		witnesses_(), firedCount_(0), parallelism_((parallelism)?(parallelism):(1)) {}
+
+	/**
+	 * @brief  Adds a transition
+	 *
+	 * @param  parent    The parent state
+	 * @param  children  The tuple of children states
+	 *
+	 * @return  Index of the transition
+	 */
+	template <class Tuple>
+	size_t AddTransition(const StateType& parent, const Tuple& children) {
+
+		size_t parentIndex = this->getIndex(parent);
+
+		for (auto& child : children)
+			this->children_.push_back(this->getIndex(child));
+
+		this->parents_.push_back(parentIndex);
+		this->childOffsets_.push_back(this->children_.size());
+
+		return this->parents_.size() - 1;
+
+	}
+
+	/**
+	 * @brief  Marks a state as a target
+	 *
+	 * Run() can stop as soon as some target is reached.
+	 */
+	void SetTarget(const StateType& state);
+
+	/**
+	 * @brief  Computes the states reachable bottom-up
+	 *
+	 * @param  stopAtTarget  Stop once a target state is reached
+	 *
+	 * @return  @p true if a target state has been reached
+	 */
+	bool Run(bool stopAtTarget = false);
+
+	bool IsStateReached(const StateType& state) const {
+
+		auto i = this->stateIndex_.find(state);
+
+		return (i != this->stateIndex_.end()) && this->reached_[i->second];
+
+	}
+
+	bool IsTransitionFired(size_t transition) const {
+
+		return this->fired_[transition];
+
+	}
+
+	/**
+	 * @brief  Checks whether a transition first reached its parent
+	 *
+	 * Witness transitions form an automaton accepting a tree for every reached
+	 * state.
+	 */
+	bool IsWitness(size_t transition) const {
+
+		return this->fired_[transition] &&
+			(this->witnesses_[this->parents_[transition]] == transition);
+
+	}
+
+	bool AllTransitionsFired() const {
+
+		return this->firedCount_ == this->parents_.size();
+
+	}
+
+	unsigned GetParallelism() const {
+
+		return this->parallelism_;
+
+	}
+
+};
+
+#endif
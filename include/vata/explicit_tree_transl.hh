@@ -34,7 +34,7 @@ namespace VATA {
 		class Index = Util::IdentityTranslator<AutBase::StateType>
 	>
 	ExplicitLTS TranslateUpward(const ExplicitTreeAut<SymbolType>& aut,
-		std::vector<std::vector<size_t>>& partition, Util::BinaryRelation& relation,
+		ExplicitLTS::StateListTable& partition, Util::BinaryRelation& relation,
 		const Rel& param, const Index& stateIndex = Index());
 
 }
@@ -78,10 +78,10 @@ VATA::ExplicitLTS VATA::TranslateDownward(const ExplicitTreeAut<SymbolType>& aut
 
 				if (tuple->size() == 1) {
 					// inline lhs of size 1 >:-)
-					result.addTransition(state, symbol, tuple->front());
+					result.addTransition(state, symbol, stateIndex[tuple->front()]);
 				} else {
 					result.addTransition(
-						stateClusterPair.first, symbol, lhsTranslator(tuple.get())
+						state, symbol, lhsTranslator(tuple.get())
 					);
 				}
 
@@ -115,7 +115,7 @@ VATA::ExplicitLTS VATA::TranslateDownward(const ExplicitTreeAut<SymbolType>& aut
 
 template <class SymbolType, class Rel, class Index>
 VATA::ExplicitLTS VATA::TranslateUpward(const ExplicitTreeAut<SymbolType>& aut,
-	std::vector<std::vector<size_t>>& partition, Util::BinaryRelation& relation,
+	ExplicitLTS::StateListTable& partition, Util::BinaryRelation& relation,
 	const Rel& param, const Index& stateIndex) {
 
 	typedef Explicit::StateTuple StateTuple;
@@ -240,7 +240,7 @@ VATA::ExplicitLTS VATA::TranslateUpward(const ExplicitTreeAut<SymbolType>& aut,
 
 				head.push_back(&env);
 
-				partition.push_back(std::vector<size_t>(1, stateCnt));
+				partition.push_back(ExplicitLTS::StateListTable::value_type(1, stateCnt));
 
 				return stateCnt++;
 
@@ -19,6 +19,7 @@
 
 // Standard library headers
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace VATA {
@@ -89,7 +90,7 @@ VATA::ExplicitTreeAut<SymbolType> VATA::RemoveUnreachableStates(
 	if (reachableStates.size() == aut.transitions_->size())
 		return aut;
 
-	ExplicitTA result(aut.cache_);
+	ExplicitTA result(ExplicitTA::CreateEmpty(aut));
 
 	result.finalStates_ = aut.finalStates_;
 	result.transitions_ = StateToTransitionClusterMapPtr(
@@ -167,19 +168,32 @@ VATA::ExplicitTreeAut<SymbolType> VATA::RemoveUnreachableStates(
 
 	rel.buildIndex(ind, inv);
 
+	// the relation is indexed by the positions given by index
+	std::unordered_map<size_t, AutBase::StateType> finalIndex;
+
 	for (auto& state : aut.GetFinalStates()) {
 
-		if (finalStates.contains(ind[state]))
+		size_t i = index[state];
+
+		if (finalStates.contains(ind[i]))
 			continue;
 
-		finalStates.refine(inv[state]);
-		finalStates.insert(state);
+		finalStates.refine(inv[i]);
+		finalStates.insert(i);
+
+		finalIndex.insert(std::make_pair(i, state));
 
 	}
 
-	std::unordered_set<AutBase::StateType> reachableStates(
-		finalStates.data().begin(), finalStates.data().end()
-	);
+	std::unordered_set<AutBase::StateType> reachableStates;
+
+	for (auto& i : finalStates.data()) {
+
+		assert(finalIndex.count(i));
+
+		reachableStates.insert(finalIndex[i]);
+
+	}
 
 	std::vector<AutBase::StateType> newStates(reachableStates.begin(), reachableStates.end());
 
@@ -269,9 +283,10 @@ VATA::ExplicitTreeAut<SymbolType> VATA::RemoveUnreachableStates(
 		(finalStates.data().size() == aut.finalStates_.size()))
 		return aut;
 
-	ExplicitTA result(aut.cache_);
+	ExplicitTA result(ExplicitTA::CreateEmpty(aut));
 
-	result.finalStates_.insert(finalStates.data().begin(), finalStates.data().end());
+	for (auto& i : finalStates.data())
+		result.finalStates_.insert(finalIndex[i]);
 
 	if (!transitionsModified && (reachableStates.size() == aut.transitions_->size())) {
 
@@ -13,13 +13,12 @@
 
 // Standard library headers
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 
 // VATA headers
 #include <vata/vata.hh>
 #include <vata/explicit_tree_aut.hh>
 #include <vata/explicit_tree_unreach.hh>
+#include <vata/explicit_tree_reach.hh>
 
 namespace VATA {
 
@@ -46,36 +45,17 @@ VATA::ExplicitTreeAut<SymbolType> VATA::RemoveUselessStates(
 		SymbolType symbol_;
 		StateType state_;
 
-		std::set<StateType> childrenSet_;
-
 		TransitionInfo(const TuplePtr& children, const SymbolType& symbol, const StateType& state)
-			: children_(children), symbol_(symbol), state_(state),
-			childrenSet_(children->begin(), children->end()) {
-		}
-
-		bool reachedBy(const StateType& state) {
-
-			assert(this->childrenSet_.count(state));
-
-			this->childrenSet_.erase(state);
-
-			return this->childrenSet_.empty();
-
-		}
+			: children_(children), symbol_(symbol), state_(state) {}
 
 	};
 
-	typedef std::shared_ptr<TransitionInfo> TransitionInfoPtr;
-
-	std::unordered_map<StateType, std::vector<TransitionInfoPtr>> stateMap;
-	std::unordered_set<StateType> reachableStates;
-	std::vector<TransitionInfoPtr> reachableTransitions;
-	std::vector<StateType> newStates;
+	// transitions indexed in the same way as in the reachability kernel
+	std::vector<TransitionInfo> transitions;
+	ExplicitTreeReachability reach(aut.GetContext().GetParallelism());
 
 	assert(aut.transitions_);
 
-	size_t remaining = 0;
-
 	for (auto& stateClusterPair : *aut.transitions_) {
 
 		assert(stateClusterPair.second);
@@ -88,30 +68,11 @@ VATA::ExplicitTreeAut<SymbolType> VATA::RemoveUselessStates(
 
 				assert(tuple);
 
-				auto transitionInfoPtr = TransitionInfoPtr(
-					new TransitionInfo(tuple, symbolTupleSetPair.first, stateClusterPair.first)
-				);
-
-				if (tuple->empty()) {
-
-					reachableTransitions.push_back(transitionInfoPtr);
-
-					if (reachableStates.insert(stateClusterPair.first).second)
-						newStates.push_back(stateClusterPair.first);
-
-					continue;
-
-				}
-
-				for (auto& s : transitionInfoPtr->childrenSet_) {
-
-					stateMap.insert(
-						std::make_pair(s, std::vector<TransitionInfoPtr>())
-					).first->second.push_back(transitionInfoPtr);
-
-					++remaining;
+				reach.AddTransition(stateClusterPair.first, *tuple);
 
-				}
+				transitions.push_back(
+					TransitionInfo(tuple, symbolTupleSetPair.first, stateClusterPair.first)
+				);
 
 			}
 
@@ -119,50 +80,18 @@ VATA::ExplicitTreeAut<SymbolType> VATA::RemoveUselessStates(
 
 	}
 
-	while (!newStates.empty()) {
-
-		auto i = stateMap.find(newStates.back());
-
-		newStates.pop_back();
-
-		if (i == stateMap.end())
-			continue;
-
-		for (auto& info : i->second) {
-
-			assert(info);
-
-			if (!info->reachedBy(i->first))
-				continue;
-
-			reachableTransitions.push_back(info);
-
-			--remaining;
-
-			if (reachableStates.insert(info->state_).second)
-				newStates.push_back(info->state_);
-
-		}
-
-	}
-/*
-	if (pTranslMap) {
-
-		for (auto& state : reachableStates)
-			pTranslMap->insert(std::make_pair(state, state));
+	reach.Run();
 
-	}
-*/
-	ExplicitTA result(aut.cache_);
+	ExplicitTA result(ExplicitTA::CreateEmpty(aut));
 
 	for (auto& state : aut.finalStates_) {
 
-		if (reachableStates.count(state))
+		if (reach.IsStateReached(state))
 			result.SetStateFinal(state);
 
 	}
 
-	if (!remaining) {
+	if (reach.AllTransitionsFired()) {
 
 		result.transitions_ = aut.transitions_;
 
@@ -170,11 +99,14 @@ VATA::ExplicitTreeAut<SymbolType> VATA::RemoveUselessStates(
 
 	}
 
-	for (auto& info : reachableTransitions) {
+	for (size_t i = 0; i < transitions.size(); ++i) {
 
-		assert(info);
+		if (!reach.IsTransitionFired(i))
+			continue;
 
-		result.internalAddTransition(info->children_, info->symbol_, info->state_);
+		result.internalAddTransition(
+			transitions[i].children_, transitions[i].symbol_, transitions[i].state_
+		);
 
 	}
 
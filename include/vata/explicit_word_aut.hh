@@ -0,0 +1,347 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Header file for explicitly represented word automata, i.e., tree automata
+ *    over alphabets of rank at most one.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_EXPLICIT_WORD_AUT_HH_
+#define _VATA_EXPLICIT_WORD_AUT_HH_
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <vata/vata.hh>
+#include <vata/aut_base.hh>
+#include <vata/explicit_lts.hh>
+#include <vata/explicit_tree_aut.hh>
+#include <vata/util/binary_relation.hh>
+
+namespace VATA { class ExplicitWordAut; }
+
+/*
+ * A tree automaton whose transitions have at most one child is a finite word
+ * automaton read from the leaf to the root: a transition a -> q makes q initial
+ * under the label a and a transition a(p) -> q is the edge p --a--> q. States
+ * and labels are dense indices; the conversions from and to ExplicitTreeAut
+ * translate them.
+ */
+class VATA::ExplicitWordAut {
+
+public:
+
+	typedef AutBase::StateType StateType;
+	typedef size_t LabelType;
+	typedef std::vector<StateType> StateList;
+
+	// pairs of a label and its rank, which is either 0 or 1
+	typedef std::vector<std::pair<LabelType, size_t>> AlphabetType;
+
+	/*
+	 * A set of states stored as a bit vector so that the subset construction
+	 * works on whole words.
+	 */
+	class StateBitSet {
+
+		std::vector<uint64_t> words_;
+
+	public:
+
+		StateBitSet() : words_() {}
+
+		explicit StateBitSet(size_t size) : words_((size + 63) / 64, 0) {}
+
+		void set(size_t i) {
+
+			assert((i >> 6) < this->words_.size());
+
+			this->words_[i >> 6] |= static_cast<uint64_t>(1) << (i & 63);
+
+		}
+
+		bool test(size_t i) const {
+
+			return ((i >> 6) < this->words_.size()) &&
+				((this->words_[i >> 6] >> (i & 63)) & 1);
+
+		}
+
+		void unite(const StateBitSet& rhs) {
+
+			assert(rhs.words_.size() <= this->words_.size());
+
+			for (size_t i = 0; i < rhs.words_.size(); ++i)
+				this->words_[i] |= rhs.words_[i];
+
+		}
+
+		bool intersects(const StateBitSet& rhs) const {
+
+			size_t size = std::min(this->words_.size(), rhs.words_.size());
+
+			for (size_t i = 0; i < size; ++i) {
+
+				if (this->words_[i] & rhs.words_[i])
+					return true;
+
+			}
+
+			return false;
+
+		}
+
+		bool isSubsetOf(const StateBitSet& rhs) const {
+
+			for (size_t i = 0; i < this->words_.size(); ++i) {
+
+				uint64_t rhsWord = (i < rhs.words_.size()) ? rhs.words_[i] : 0;
+
+				if (this->words_[i] & ~rhsWord)
+					return false;
+
+			}
+
+			return true;
+
+		}
+
+		bool empty() const {
+
+			for (auto& word : this->words_) {
+
+				if (word)
+					return false;
+
+			}
+
+			return true;
+
+		}
+
+		template <class F>
+		void forEach(F f) const {
+
+			for (size_t i = 0; i < this->words_.size(); ++i) {
+
+				for (uint64_t word = this->words_[i]; word; word &= word - 1)
+					f((i << 6) + __builtin_ctzll(word));
+
+			}
+
+		}
+
+		bool operator==(const StateBitSet& rhs) const {
+
+			return this->words_ == rhs.words_;
+
+		}
+
+		friend size_t hash_value(const StateBitSet& set) {
+
+			return boost::hash_range(set.words_.begin(), set.words_.end());
+
+		}
+
+	};
+
+private:
+
+	size_t states_;
+	std::vector<StateList> initialStates_;
+	std::vector<std::vector<StateList>> transitions_;
+	std::vector<bool> finalStates_;
+
+	static const StateList emptyList_;
+
+	void addState(const StateType& state) {
+
+		if (state < this->states_)
+			return;
+
+		this->states_ = state + 1;
+		this->finalStates_.resize(this->states_, false);
+
+	}
+
+public:
+
+	ExplicitWordAut() : states_(0), initialStates_(), transitions_(), finalStates_() {}
+
+	void AddInitialTransition(const LabelType& label, const StateType& state) {
+
+		this->addState(state);
+
+		if (label >= this->initialStates_.size())
+			this->initialStates_.resize(label + 1);
+
+		this->initialStates_[label].push_back(state);
+
+	}
+
+	void AddTransition(const StateType& state, const LabelType& label,
+		const StateType& target) {
+
+		this->addState(state);
+		this->addState(target);
+
+		if (label >= this->transitions_.size())
+			this->transitions_.resize(label + 1);
+
+		if (state >= this->transitions_[label].size())
+			this->transitions_[label].resize(state + 1);
+
+		this->transitions_[label][state].push_back(target);
+
+	}
+
+	void SetStateFinal(const StateType& state) {
+
+		this->addState(state);
+
+		this->finalStates_[state] = true;
+
+	}
+
+	bool IsStateFinal(const StateType& state) const {
+
+		return (state < this->states_) && this->finalStates_[state];
+
+	}
+
+	size_t states() const { return this->states_; }
+
+	size_t labels() const {
+
+		return std::max(this->initialStates_.size(), this->transitions_.size());
+
+	}
+
+	const StateList& GetInitialStates(const LabelType& label) const {
+
+		return (label < this->initialStates_.size()) ?
+			this->initialStates_[label] : emptyList_;
+
+	}
+
+	const StateList& GetSuccessors(const StateType& state, const LabelType& label) const {
+
+		if ((label >= this->transitions_.size()) ||
+			(state >= this->transitions_[label].size()))
+			return emptyList_;
+
+		return this->transitions_[label][state];
+
+	}
+
+	/*
+	 * The transitions as an LTS over the same states; the state following the
+	 * last one has a loop under a label of its own so that the LTS covers all
+	 * states of the automaton.
+	 */
+	ExplicitLTS TranslateToLTS() const;
+
+	/*
+	 * Forward simulation respecting final states; (p, q) is in the relation if
+	 * q simulates p, and so the language of p is included in the one of q.
+	 */
+	Util::BinaryRelation ComputeSimulation() const;
+
+	ExplicitWordAut Determinize() const;
+
+	static bool CheckInclusion(const ExplicitWordAut& smaller,
+		const ExplicitWordAut& bigger, bool useSimulation = true);
+
+	bool CheckUniversality(const AlphabetType& alphabet,
+		bool useSimulation = true) const;
+
+	template <class SymbolType, class StateTransFunc, class SymbolTransFunc>
+	void LoadFromTreeAut(const ExplicitTreeAut<SymbolType>& aut,
+		StateTransFunc stateTrans, SymbolTransFunc symbolTrans) {
+
+		for (auto transition : aut) {
+
+			switch (transition.children().size()) {
+
+				case 0:
+					this->AddInitialTransition(
+						symbolTrans(transition.symbol()), stateTrans(transition.state())
+					);
+					break;
+
+				case 1:
+					this->AddTransition(
+						stateTrans(transition.children()[0]), symbolTrans(transition.symbol()),
+						stateTrans(transition.state())
+					);
+					break;
+
+				default:
+					throw std::runtime_error(
+						"Transitions of word automata have at most one child"
+					);
+
+			}
+
+		}
+
+		for (auto& state : aut.GetFinalStates())
+			this->SetStateFinal(stateTrans(state));
+
+	}
+
+	template <class SymbolType, class StateBackTransFunc, class SymbolBackTransFunc>
+	void ConvertToTreeAut(ExplicitTreeAut<SymbolType>& dst,
+		StateBackTransFunc stateBackTrans, SymbolBackTransFunc symbolBackTrans) const {
+
+		for (size_t label = 0; label < this->initialStates_.size(); ++label) {
+
+			for (auto& state : this->initialStates_[label]) {
+
+				dst.AddTransition(
+					typename ExplicitTreeAut<SymbolType>::StateTuple(),
+					symbolBackTrans(label), stateBackTrans(state)
+				);
+
+			}
+
+		}
+
+		for (size_t label = 0; label < this->transitions_.size(); ++label) {
+
+			for (size_t state = 0; state < this->transitions_[label].size(); ++state) {
+
+				for (auto& target : this->transitions_[label][state]) {
+
+					dst.AddTransition(
+						typename ExplicitTreeAut<SymbolType>::StateTuple(
+							1, stateBackTrans(state)
+						),
+						symbolBackTrans(label), stateBackTrans(target)
+					);
+
+				}
+
+			}
+
+		}
+
+		for (size_t state = 0; state < this->states_; ++state) {
+
+			if (this->finalStates_[state])
+				dst.SetStateFinal(stateBackTrans(state));
+
+		}
+
+	}
+
+};
+
+#endif
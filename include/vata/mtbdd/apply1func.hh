@@ -14,6 +14,7 @@
 // VATA headers
 #include	<vata/vata.hh>
 #include	<vata/mtbdd/ondriks_mtbdd.hh>
+#include	<vata/util/stats.hh>
 
 // Standard library headers
 #include  <unordered_set>
@@ -95,8 +96,10 @@ private:  // Private methods
 		{	// for the terminal case
 			CacheAddressType cacheAddress(node1);
 			typename CacheHashTable::iterator itHt;
+			VATA_STATS_INC("mtbdd.apply1.lookups");
 			if ((itHt = ht.find(cacheAddress)) != ht.end())
 			{	// if the result is already known
+				VATA_STATS_INC("mtbdd.apply1.hits");
 				assert(!IsNull(itHt->second));
 				return itHt->second;
 			}
@@ -153,6 +156,9 @@ public:   // Public methods
 
 	MTBDDOutType operator()(const MTBDD1Type& mtbdd1)
 	{
+		// mark the running operation (reordering is not possible inside)
+		VarOrdering::OperationGuard guard;
+
 		// store the MTBDD
 		mtbdd1_ = &mtbdd1;
 
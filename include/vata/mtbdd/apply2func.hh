@@ -14,9 +14,13 @@
 // VATA headers
 #include	<vata/vata.hh>
 #include	<vata/mtbdd/ondriks_mtbdd.hh>
+#include	<vata/util/stats.hh>
 #include	<vata/mtbdd/classify_case.hh>
+#include	<vata/util/triple.hh>
 
 // Standard library headers
+#include  <stdint.h>
+#include  <unordered_map>
 #include  <unordered_set>
 
 // Boost library headers
@@ -71,6 +75,11 @@ private:  // Private data types
 	typedef std::unordered_map<CacheAddressType, NodeOutPtrType,
 		boost::hash<CacheAddressType>> CacheHashTable;
 
+	typedef VATA::Util::Triple<Node1PtrType, Node2PtrType, NodeOutPtrType>
+		LeafOperationType;
+
+	typedef std::unordered_map<uint64_t, LeafOperationType> LeafMemoTable;
+
 private:  // Private data members
 
 	const MTBDD1Type* mtbdd1_;
@@ -78,6 +87,18 @@ private:  // Private data members
 
 	CacheHashTable ht;
 
+	bool memoizeLeaves_;
+
+	/**
+	 * @brief  Results of the operation on leaves
+	 *
+	 * Maps pairs of identifiers of leaf values to the leaves and the result of
+	 * the operation on them. The table is kept between invocations of the
+	 * functor and all leaves in it are referenced so that their identifiers
+	 * cannot be reused for other values.
+	 */
+	LeafMemoTable leafMemo_;
+
 private:  // Private methods
 
 	Apply2Functor(const Apply2Functor&);
@@ -91,8 +112,10 @@ private:  // Private methods
 
 		CacheAddressType cacheAddress(node1, node2);
 		typename CacheHashTable::iterator itHt;
+		VATA_STATS_INC("mtbdd.apply2.lookups");
 		if ((itHt = ht.find(cacheAddress)) != ht.end())
 		{	// if the result is already known
+			VATA_STATS_INC("mtbdd.apply2.hits");
 			assert(!IsNull(itHt->second));
 			return itHt->second;
 		}
@@ -102,7 +125,8 @@ private:  // Private methods
 
 		if (!relation)
 		{	// for the terminal case
-			NodeOutPtrType result = MTBDDOutType::spawnLeaf(makeBase().ApplyOperation(
+			NodeOutPtrType result = memoizeLeaves_? leafOperation(node1, node2)
+				: MTBDDOutType::spawnLeaf(makeBase().ApplyOperation(
 				GetDataFromLeaf(node1), GetDataFromLeaf(node2)));
 
 			ht.insert(std::make_pair(cacheAddress, result));
@@ -162,6 +186,30 @@ private:  // Private methods
 		}
 	}
 
+	NodeOutPtrType leafOperation(const Node1PtrType& node1,
+		const Node2PtrType& node2)
+	{
+		uint64_t key = (static_cast<uint64_t>(GetIdFromLeaf(node1)) << 32) |
+			GetIdFromLeaf(node2);
+
+		typename LeafMemoTable::const_iterator itMemo;
+		if ((itMemo = leafMemo_.find(key)) != leafMemo_.end())
+		{	// in case the values have already been processed
+			return itMemo->second.third;
+		}
+
+		NodeOutPtrType result = MTBDDOutType::spawnLeaf(makeBase().ApplyOperation(
+			GetDataFromLeaf(node1), GetDataFromLeaf(node2)));
+
+		IncrementRefCnt(node1);
+		IncrementRefCnt(node2);
+		IncrementRefCnt(result);
+		leafMemo_.insert(std::make_pair(key,
+			LeafOperationType(node1, node2, result)));
+
+		return result;
+	}
+
 	inline BaseClass& makeBase()
 	{
 		return static_cast<BaseClass&>(*this);
@@ -172,11 +220,27 @@ public:   // Public methods
 	Apply2Functor() :
 		mtbdd1_(nullptr),
 		mtbdd2_(nullptr),
-		ht()
+		ht(),
+		memoizeLeaves_(false),
+		leafMemo_()
 	{ }
 
+	~Apply2Functor()
+	{
+		for (const typename LeafMemoTable::value_type& keyOperationPair : leafMemo_)
+		{	// release the memoized leaves
+			const LeafOperationType& operation = keyOperationPair.second;
+			MTBDD1Type::recursivelyDeleteMTBDDNode(operation.first);
+			MTBDD2Type::recursivelyDeleteMTBDDNode(operation.second);
+			MTBDDOutType::recursivelyDeleteMTBDDNode(operation.third);
+		}
+	}
+
 	MTBDDOutType operator()(const MTBDD1Type& mtbdd1, const MTBDD2Type& mtbdd2)
 	{
+		// mark the running operation (reordering is not possible inside)
+		VarOrdering::OperationGuard guard;
+
 		// store the MTBDDs
 		mtbdd1_ = &mtbdd1;
 		mtbdd2_ = &mtbdd2;
@@ -198,6 +262,25 @@ public:   // Public methods
 
 protected:// Protected methods
 
+	/**
+	 * @brief  Enables memoization of the operation on leaves
+	 *
+	 * Results of ApplyOperation are remembered for each pair of leaf values
+	 * for the whole lifetime of the functor, so the operation is called at
+	 * most once for every pair. This may only be used if the result of
+	 * ApplyOperation depends on nothing but its arguments.
+	 *
+	 * Every memoized pair keeps its leaves alive until the functor is
+	 * destroyed, so this only pays off when the same pairs of operands recur
+	 * over many applications (e.g., in a product construction). Functors that
+	 * accumulate a result (as in @c result = f(result, x)) see mostly fresh
+	 * pairs and should not enable it.
+	 */
+	inline void enableLeafMemoization()
+	{
+		memoizeLeaves_ = true;
+	}
+
 	inline const MTBDD1Type& getMTBDD1() const
 	{
 		assert(mtbdd1_ != nullptr);
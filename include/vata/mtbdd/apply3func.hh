@@ -14,6 +14,7 @@
 // VATA headers
 #include	<vata/vata.hh>
 #include	<vata/mtbdd/ondriks_mtbdd.hh>
+#include	<vata/util/stats.hh>
 #include	<vata/util/triple.hh>
 
 // Standard library headers
@@ -154,8 +155,10 @@ private:  // Private methods
 
 		CacheAddressType cacheAddress(node1, node2, node3);
 		typename CacheHashTable::iterator itHt;
+		VATA_STATS_INC("mtbdd.apply3.lookups");
 		if ((itHt = ht.find(cacheAddress)) != ht.end())
 		{	// if the result is already known
+			VATA_STATS_INC("mtbdd.apply3.hits");
 			assert(!IsNull(itHt->second));
 			return itHt->second;
 		}
@@ -257,6 +260,9 @@ public:   // Public methods
 	MTBDDOutType operator()(const MTBDD1Type& mtbdd1,
 		const MTBDD2Type& mtbdd2, const MTBDD3Type& mtbdd3)
 	{
+		// mark the running operation (reordering is not possible inside)
+		VarOrdering::OperationGuard guard;
+
 		// store the MTBDDs
 		mtbdd1_ = &mtbdd1;
 		mtbdd2_ = &mtbdd2;
@@ -97,6 +97,14 @@ public:   // public data types
 	 */
 	typedef uintptr_t VarType;
 
+	/**
+	 * @brief  Type of leaf identifiers
+	 *
+	 * The data type of identifiers of leaf values. Every distinct value
+	 * stored in some leaf has its own identifier.
+	 */
+	typedef uint32_t LeafIdType;
+
 private:  // private data types
 
 	/**
@@ -361,13 +369,15 @@ public:
 	 * pointer to the node.
 	 *
 	 * @param[in]  data  The data value to be stored in the leaf
+	 * @param[in]  id    Identifier of the value
 	 *
 	 * @return  Pointer to the created leaf node
 	 *
 	 * @tparam  DataType  The data type of the leaf
 	 */
 	template <typename DataType>
-	friend MTBDDNodePtr<DataType> CreateLeaf(const DataType& data);
+	friend MTBDDNodePtr<DataType> CreateLeaf(const DataType& data,
+		const typename MTBDDNodePtr<DataType>::LeafIdType& id);
 
 	/**
 	 * @brief  Creates an internal node
@@ -512,6 +522,25 @@ public:
 	template <typename NodePtrType>
 	friend NodePtrType GetHighFromInternal(const NodePtrType& node);
 
+	/**
+	 * @brief  Rewrites an internal node in place
+	 *
+	 * Changes children and variable of the internal node pointed to by the
+	 * passed MTBDD node pointer. Reference counters of the children are not
+	 * touched. This is used for in-place variable reordering, where the node
+	 * keeps representing the same function.
+	 *
+	 * @param[in]  node  Pointer to the internal node
+	 * @param[in]  low   Pointer to the new @e low child
+	 * @param[in]  high  Pointer to the new @e high child
+	 * @param[in]  var   New variable of the node
+	 *
+	 * @tparam  NodePtrType  Type of node pointer
+	 */
+	template <typename NodePtrType>
+	friend void RelabelInternal(NodePtrType node, NodePtrType low,
+		NodePtrType high, const typename NodePtrType::VarType& var);
+
 	/**
 	 * @brief  Gets data from a leaf
 	 *
@@ -528,6 +557,22 @@ public:
 	friend const typename NodePtrType::DataType& GetDataFromLeaf(
 		const NodePtrType& node);
 
+	/**
+	 * @brief  Gets identifier of a leaf
+	 *
+	 * The function to retrieve the identifier of the value stored in the leaf
+	 * node pointed to by the passed MTBDD node pointer.
+	 *
+	 * @param[in]  node  Pointer to a leaf node
+	 *
+	 * @return  The identifier of the value stored in the leaf node
+	 *
+	 * @tparam  NodePtrType  Type of node pointer
+	 */
+	template <typename NodePtrType>
+	friend const typename NodePtrType::LeafIdType& GetIdFromLeaf(
+		const NodePtrType& node);
+
 	/**
 	 * @brief  Gets leaf's reference counter
 	 *
@@ -799,6 +844,26 @@ namespace
 
 			return --refcnt_;
 		}
+
+		/**
+		 * @brief  Rewrites the node
+		 *
+		 * Sets new children and variable of the node.
+		 *
+		 * @param[in]  low   The new @e low child pointer
+		 * @param[in]  high  The new @e high child pointer
+		 * @param[in]  var   The new Boolean variable
+		 */
+		inline void Relabel(NodePtrType low, NodePtrType high, const VarType& var)
+		{
+			// Assertions
+			assert(!IsNull(low));
+			assert(!IsNull(high));
+
+			low_ = low;
+			high_ = high;
+			var_ = var;
+		}
 	};
 
 
@@ -838,6 +903,13 @@ namespace
 		 */
 		typedef typename NodePtr::RefCntType RefCntType;
 
+		/**
+		 * @brief  Data type of the identifier
+		 *
+		 * The data type of the identifier of the value.
+		 */
+		typedef typename NodePtr::LeafIdType LeafIdType;
+
 	private:  // private data members
 
 		/**
@@ -847,6 +919,13 @@ namespace
 		 */
 		DataType data_;
 
+		/**
+		 * @brief  Identifier of the value
+		 *
+		 * Identifier of the data value, unique among living leaves.
+		 */
+		LeafIdType id_;
+
 		/**
 		 * @brief  Reference counter
 		 *
@@ -863,13 +942,28 @@ namespace
 		 * Constructs the leaf from components.
 		 *
 		 * @param[in]  data    The data value
+		 * @param[in]  id      The identifier of the value
 		 * @param[in]  refcnt  The reference counter
 		 */
-		LeafNode(const DataType& data, const RefCntType& refcnt)
+		LeafNode(const DataType& data, const LeafIdType& id,
+			const RefCntType& refcnt)
 			: data_(data),
+				id_(id),
 				refcnt_(refcnt)
 		{ }
 
+		/**
+		 * @brief  Gets identifier of the value
+		 *
+		 * Returns the identifier of the data value stored in the leaf.
+		 *
+		 * @return  Identifier of the leaf's value
+		 */
+		inline const LeafIdType& GetId() const
+		{
+			return id_;
+		}
+
 		/**
 		 * @brief  Gets data from the leaf
 		 *
@@ -952,6 +1046,17 @@ namespace VATA
 			return NodePtrType::nodeToLeaf(node)->GetData();
 		}
 
+		template <typename NodePtrType>
+		inline const typename NodePtrType::LeafIdType& GetIdFromLeaf(
+			const NodePtrType& node)
+		{
+			// Assertions
+			assert(!IsNull(node));
+			assert(IsLeaf(node));
+
+			return NodePtrType::nodeToLeaf(node)->GetId();
+		}
+
 		template <typename NodePtrType>
 		inline const typename NodePtrType::VarType& GetVarFromInternal(
 			NodePtrType& node)
@@ -1003,14 +1108,26 @@ namespace VATA
 			return NodePtrType::nodeToInternal(node)->GetHigh();
 		}
 
+		template <typename NodePtrType>
+		inline void RelabelInternal(NodePtrType node, NodePtrType low,
+			NodePtrType high, const typename NodePtrType::VarType& var)
+		{
+			// Assertions
+			assert(!IsNull(node));
+			assert(IsInternal(node));
+
+			NodePtrType::nodeToInternal(node)->Relabel(low, high, var);
+		}
+
 		template <typename DataType>
-		inline MTBDDNodePtr<DataType> CreateLeaf(const DataType& data)
+		inline MTBDDNodePtr<DataType> CreateLeaf(const DataType& data,
+			const typename MTBDDNodePtr<DataType>::LeafIdType& id)
 		{
 			typedef MTBDDNodePtr<DataType> NodePtrType;
 			typedef typename NodePtrType::LeafType LeafType;
 
 			// TODO: create allocator						
-			LeafType* newNode = new LeafType(data, 0);
+			LeafType* newNode = new LeafType(data, id, 0);
 
 			return NodePtrType::makeLeaf(newNode);
 		}
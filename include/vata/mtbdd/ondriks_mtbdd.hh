@@ -15,10 +15,14 @@
 #include	<vata/vata.hh>
 #include	<vata/mtbdd/mtbdd_node.hh>
 #include	<vata/mtbdd/var_asgn.hh>
+#include	<vata/mtbdd/var_ordering.hh>
 #include	<vata/util/triple.hh>
+#include	<vata/util/stats.hh>
 
 // Standard library headers
+#include	<algorithm>
 #include	<cassert>
+#include	<limits>
 #include	<stdint.h>
 #include	<stdexcept>
 #include	<vector>
@@ -100,6 +104,7 @@ private:  // private data types
 public:   // public data types
 
 	typedef typename NodePtrType::VarType VarType;
+	typedef typename NodePtrType::LeafIdType LeafIdType;
 	typedef std::vector<VarType> PermutationTable;
 	typedef std::shared_ptr<PermutationTable> PermutationTablePtr;
 
@@ -118,6 +123,18 @@ private:  // private data types
 
 	typedef std::unordered_set<NodePtrType, boost::hash<NodePtrType>> NodePtrSet;
 
+	typedef std::vector<std::pair<VarType, bool>> CubeType;
+
+	typedef std::unordered_map<std::pair<NodePtrType, size_t>, NodePtrType,
+		boost::hash<std::pair<NodePtrType, size_t>>> CubeCacheType;
+
+	typedef std::unordered_map<NodePtrType, NodePtrType,
+		boost::hash<NodePtrType>> RestrictCacheType;
+
+public:   // public data types
+
+	typedef std::vector<std::pair<VarAsgn, DataType>> AsgnValueList;
+
 private:  // private data members
 
 	NodePtrType root_;
@@ -127,6 +144,9 @@ private:  // private data members
 	static LeafCacheType leafCache_;
 	static InternalCacheType internalCache_;
 
+	static LeafIdType nextLeafId_;
+	static std::vector<LeafIdType> freeLeafIds_;
+
 
 private:  // private methods
 
@@ -136,7 +156,8 @@ private:  // private methods
 	 *
 	 * This function is used for constructing a new MTBDD, such that the
 	 * variable assignment @p asgn is set to @p value and all other assignments
-	 * are set to @p defaultValue.
+	 * are set to @p defaultValue. Variables are placed at their levels given
+	 * by the current VarOrdering.
 	 *
 	 * @param  asgn          Variable assignment to be set to @p value
 	 * @param  value         Value to be set for assignment @p asgn
@@ -163,38 +184,243 @@ private:  // private methods
 			return node;
 		}
 
-		// the sink leaf
-		NodePtrType sink = spawnLeaf(defaultValue);
-
-		// working node
-		NodePtrType procNode = node;
-
+		// levels of the variables that are not don't care, bottom-up
+		CubeType cube;
 		for (size_t i = 0; i < asgn.length(); ++i)
-		{	// construct the MTBDD according to the variable ordering
+		{
 			VarType var =	i;
 			if (asgn.GetIthVariableValue(var) == VarAsgn::ONE)
 			{	// in case the variable is 1
-				procNode = spawnInternal(sink, procNode, varTrans(var));
+				cube.push_back(std::make_pair(
+					VarOrdering::GetLevelOfVar(varTrans(var)), true));
 			}
 			else if (asgn.GetIthVariableValue(var) == VarAsgn::ZERO)
 			{	// in case the variable is 0
-				procNode = spawnInternal(procNode, sink, varTrans(var));
+				cube.push_back(std::make_pair(
+					VarOrdering::GetLevelOfVar(varTrans(var)), false));
 			}
 			// otherwise don't care about the variable
 		}
 
-		if (procNode == node)
-		{	// in case there is nothing above the original node
-			if (GetLeafRefCnt(sink) == 0)
-			{	// in case there is no one pointing to the sink
-				disposeOfLeafNode(sink);
+		std::sort(cube.begin(), cube.end());
+
+		// the sink leaf
+		NodePtrType sink = spawnLeaf(defaultValue);
+
+		// working node
+		NodePtrType procNode = node;
+
+		if (cube.empty() || IsLeaf(node) ||
+			(GetVarFromInternal(node) < cube.front().first))
+		{	// in case the whole cube is above the node
+			for (const std::pair<VarType, bool>& levelValue : cube)
+			{	// construct the MTBDD according to the variable ordering
+				if (levelValue.second)
+				{	// in case the variable is 1
+					procNode = spawnInternal(sink, procNode, levelValue.first);
+				}
+				else
+				{	// in case the variable is 0
+					procNode = spawnInternal(procNode, sink, levelValue.first);
+				}
 			}
 		}
+		else
+		{	// in case the cube needs to be interleaved with the node's levels
+			CubeCacheType cache;
+			procNode = insertCube(node, cube, cube.size(), sink, cache);
+		}
+
+		if ((procNode != sink) && (GetLeafRefCnt(sink) == 0))
+		{	// in case there is no one pointing to the sink
+			disposeOfLeafNode(sink);
+		}
 
 		IncrementRefCnt(procNode);
 		return procNode;
 	}
 
+	/**
+	 * @brief  Function for constructing an MTBDD from several assignments
+	 *
+	 * Constructs the diagram in which the assignments of @p asgnValues given
+	 * by @p indices have their values and all other assignments have the value
+	 * of @p sink. The assignments are split by the variables level by level,
+	 * starting at the level right below @p levels; levels at which none of the
+	 * assignments is decided are skipped.
+	 *
+	 * @param  asgnValues  Pairwise disjoint assignments with their values
+	 * @param  indices     Indices of the considered items of @p asgnValues
+	 * @param  levels      Number of levels still to be processed
+	 * @param  sink        The leaf for assignments not in @p indices
+	 *
+	 * @return  The constructed diagram (with no reference added)
+	 */
+	static NodePtrType constructMTBDD(const AsgnValueList& asgnValues,
+		const std::vector<size_t>& indices, VarType levels, const NodePtrType& sink)
+	{
+		if (indices.empty())
+		{	// in case no assignment is left
+			return sink;
+		}
+
+		std::vector<size_t> lowIndices;
+		std::vector<size_t> highIndices;
+		while (levels > 0)
+		{
+			--levels;
+			const VarType var = VarOrdering::GetVarAtLevel(levels);
+
+			lowIndices.clear();
+			highIndices.clear();
+			bool decided = false;
+			for (const size_t& index : indices)
+			{
+				const VarAsgn& asgn = asgnValues[index].first;
+				char value = (var < asgn.length())? asgn.GetIthVariableValue(var)
+					: static_cast<char>(VarAsgn::DONT_CARE);
+
+				if (value != VarAsgn::ONE)
+				{	// in case the assignment allows 0
+					lowIndices.push_back(index);
+				}
+
+				if (value != VarAsgn::ZERO)
+				{	// in case the assignment allows 1
+					highIndices.push_back(index);
+				}
+
+				decided = decided || (value != VarAsgn::DONT_CARE);
+			}
+
+			if (decided)
+			{	// in case the level splits the assignments
+				return makeInternal(
+					constructMTBDD(asgnValues, lowIndices, levels, sink),
+					constructMTBDD(asgnValues, highIndices, levels, sink),
+					levels);
+			}
+		}
+
+		// all variables are decided, so the assignments overlap unless single
+		assert(indices.size() == 1);
+
+		return spawnLeaf(asgnValues[indices.front()].second);
+	}
+
+	/**
+	 * @brief  Puts a cube above the levels of a diagram
+	 *
+	 * Constructs the diagram that has the value of @p node for assignments
+	 * satisfying the topmost @p count items of @p cube and the value of @p sink
+	 * otherwise.
+	 *
+	 * @param  node   The diagram to be put below the cube
+	 * @param  cube   Pairs (level, value) sorted by levels
+	 * @param  count  Number of items of @p cube to be considered
+	 * @param  sink   The leaf for assignments not satisfying the cube
+	 * @param  cache  Cache of already processed nodes
+	 *
+	 * @return  The constructed diagram (with no reference added)
+	 */
+	static NodePtrType insertCube(const NodePtrType& node, const CubeType& cube,
+		const size_t& count, const NodePtrType& sink, CubeCacheType& cache)
+	{
+		if (count == 0)
+		{	// in case the whole cube has been processed
+			return node;
+		}
+
+		typename CubeCacheType::const_iterator itCache;
+		if ((itCache = cache.find(std::make_pair(node, count))) != cache.end())
+		{	// in case the result is already known
+			return itCache->second;
+		}
+
+		const VarType& level = cube[count - 1].first;
+		const bool& value = cube[count - 1].second;
+
+		NodePtrType result = 0;
+		if (IsLeaf(node) || (GetVarFromInternal(node) < level))
+		{	// in case the cube variable goes first
+			NodePtrType child = insertCube(node, cube, count - 1, sink, cache);
+			result = value? makeInternal(sink, child, level)
+				: makeInternal(child, sink, level);
+		}
+		else if (GetVarFromInternal(node) > level)
+		{	// in case the node goes first
+			result = makeInternal(
+				insertCube(GetLowFromInternal(node), cube, count, sink, cache),
+				insertCube(GetHighFromInternal(node), cube, count, sink, cache),
+				GetVarFromInternal(node));
+		}
+		else
+		{	// in case the node tests the cube variable
+			NodePtrType child = insertCube(value? GetHighFromInternal(node)
+				: GetLowFromInternal(node), cube, count - 1, sink, cache);
+			result = value? makeInternal(sink, child, level)
+				: makeInternal(child, sink, level);
+		}
+
+		cache.insert(std::make_pair(std::make_pair(node, count), result));
+		return result;
+	}
+
+	/**
+	 * @brief  Restricts values of variables
+	 *
+	 * Fixes the values of variables from @p offset to @p offset + @p
+	 * asgn.length() - 1 according to @p asgn (don't care is taken as 0).
+	 *
+	 * @param  node      The diagram to be restricted
+	 * @param  asgn      Values of the variables
+	 * @param  offset    Index of the first variable
+	 * @param  minLevel  The lowest level of the restricted variables
+	 * @param  cache     Cache of already processed nodes
+	 *
+	 * @return  The restricted diagram (with no reference added)
+	 */
+	static NodePtrType restrictVars(const NodePtrType& node, const VarAsgn& asgn,
+		const size_t& offset, const VarType& minLevel, RestrictCacheType& cache)
+	{
+		if (IsLeaf(node) || (GetVarFromInternal(node) < minLevel))
+		{	// in case no restricted variable is below
+			return node;
+		}
+
+		typename RestrictCacheType::const_iterator itCache;
+		if ((itCache = cache.find(node)) != cache.end())
+		{	// in case the result is already known
+			return itCache->second;
+		}
+
+		NodePtrType result = 0;
+		const VarType var = VarOrdering::GetVarAtLevel(GetVarFromInternal(node));
+		if ((var >= offset) && (var - offset < asgn.length()))
+		{	// in case the variable is restricted
+			if (asgn.GetIthVariableValue(var - offset) == VarAsgn::ONE)
+			{	// if one
+				result = restrictVars(GetHighFromInternal(node), asgn, offset,
+					minLevel, cache);
+			}
+			else
+			{	// if zero or don't care
+				result = restrictVars(GetLowFromInternal(node), asgn, offset,
+					minLevel, cache);
+			}
+		}
+		else
+		{	// in case the variable is kept
+			result = makeInternal(
+				restrictVars(GetLowFromInternal(node), asgn, offset, minLevel, cache),
+				restrictVars(GetHighFromInternal(node), asgn, offset, minLevel, cache),
+				GetVarFromInternal(node));
+		}
+
+		cache.insert(std::make_pair(node, result));
+		return result;
+	}
+
 	OndriksMTBDD(NodePtrType root, const DataType& defaultValue) :
 		root_(root),
 		defaultValue_(defaultValue)
@@ -220,6 +446,8 @@ private:  // private methods
 			assert(false);     // fail gracefully
 		}
 
+		freeLeafIds_.push_back(GetIdFromLeaf(node));
+
 		DeleteLeafNode(node);
 	}
 
@@ -274,6 +502,23 @@ private:  // private methods
 		}
 	}
 
+	static LeafIdType allocateLeafId()
+	{
+		if (!freeLeafIds_.empty())
+		{	// reuse an identifier of a disposed leaf
+			LeafIdType id = freeLeafIds_.back();
+			freeLeafIds_.pop_back();
+			return id;
+		}
+
+		if (nextLeafId_ == std::numeric_limits<LeafIdType>::max())
+		{
+			throw std::runtime_error("Too many distinct values in MTBDD leaves.");
+		}
+
+		return nextLeafId_++;
+	}
+
 	static inline NodePtrType spawnLeaf(const DataType& data)
 	{
 		NodePtrType result = 0;
@@ -285,8 +530,11 @@ private:  // private methods
 		}
 		else
 		{	// if the leaf doesn't exist
-			result = CreateLeaf(data);
+			result = CreateLeaf(data, allocateLeafId());
 			leafCache_.insert(std::make_pair(data, result));
+
+			VATA_STATS_INC("mtbdd.leaves_created");
+			VATA_STATS_MAX("mtbdd.leaves_max", leafCache_.size());
 		}
 
 		assert(!IsNull(result));
@@ -306,16 +554,154 @@ private:  // private methods
 		}
 		else
 		{	// if the internal doesn't exist
+			static const bool registered =
+				VarOrdering::RegisterNodeStore(getNodeStore());
+			(void)registered;
+
 			result = CreateInternal(low, high, var);
 			IncrementRefCnt(low);
 			IncrementRefCnt(high);
 			internalCache_.insert(std::make_pair(addr, result));
+
+			VATA_STATS_INC("mtbdd.nodes_created");
+			VATA_STATS_MAX("mtbdd.nodes_max", internalCache_.size());
 		}
 
 		assert(!IsNull(result));
 		return result;
 	}
 
+	static inline NodePtrType makeInternal(
+		NodePtrType low, NodePtrType high, const VarType& var)
+	{
+		return (low == high)? low : spawnInternal(low, high, var);
+	}
+
+	static inline InternalAddressType addressOf(const NodePtrType& node)
+	{
+		return InternalAddressType(GetLowFromInternal(node),
+			GetHighFromInternal(node), GetVarFromInternal(node));
+	}
+
+	static inline void rehashInternal(const NodePtrType& node)
+	{
+		if (!internalCache_.insert(std::make_pair(addressOf(node), node)).second)
+		{	// in case the node was already there
+			assert(false);   // fail gracefully
+		}
+	}
+
+	static void addLevelNodeCounts(VarOrdering::LevelCountTable& counts)
+	{
+		for (const auto& addrNodePair : internalCache_)
+		{
+			const VarType& level = addrNodePair.first.third;
+			if (counts.size() <= level)
+			{
+				counts.resize(level + 1, 0);
+			}
+
+			++counts[level];
+		}
+	}
+
+	/**
+	 * @brief  Swaps two adjacent levels in place
+	 *
+	 * Swaps levels @p level and @p level + 1 in all diagrams of the node store
+	 * such that every node keeps representing the same function. Only nodes at
+	 * the two levels are touched.
+	 *
+	 * @param  level  The lower of the levels
+	 */
+	static void swapLevels(const VarType& level)
+	{
+		const VarType upper = level + 1;
+
+		std::vector<NodePtrType> lowerNodes;
+		std::vector<NodePtrType> upperNodes;
+		for (const auto& addrNodePair : internalCache_)
+		{
+			if (addrNodePair.first.third == level)
+			{
+				lowerNodes.push_back(addrNodePair.second);
+			}
+			else if (addrNodePair.first.third == upper)
+			{
+				upperNodes.push_back(addrNodePair.second);
+			}
+		}
+
+		// cofactors of upper nodes depending on the lower variable: node, f00,
+		// f01, f10, f11, where fij is the value for upper = i and lower = j
+		std::vector<std::vector<NodePtrType>> dependent;
+		std::vector<NodePtrType> independent;
+		for (const NodePtrType& node : upperNodes)
+		{
+			NodePtrType low = GetLowFromInternal(node);
+			NodePtrType high = GetHighFromInternal(node);
+			bool lowAtLevel = IsInternal(low) && (GetVarFromInternal(low) == level);
+			bool highAtLevel = IsInternal(high) && (GetVarFromInternal(high) == level);
+
+			if (!lowAtLevel && !highAtLevel)
+			{	// the node just moves down
+				independent.push_back(node);
+			}
+			else
+			{
+				dependent.push_back({node,
+					lowAtLevel? GetLowFromInternal(low) : low,
+					lowAtLevel? GetHighFromInternal(low) : low,
+					highAtLevel? GetLowFromInternal(high) : high,
+					highAtLevel? GetHighFromInternal(high) : high});
+			}
+
+			internalCache_.erase(addressOf(node));
+		}
+
+		for (const NodePtrType& node : lowerNodes)
+		{	// nodes from the lower level move up
+			internalCache_.erase(addressOf(node));
+			RelabelInternal(node, GetLowFromInternal(node), GetHighFromInternal(node),
+				upper);
+			rehashInternal(node);
+		}
+
+		for (const NodePtrType& node : independent)
+		{
+			RelabelInternal(node, GetLowFromInternal(node), GetHighFromInternal(node),
+				level);
+			rehashInternal(node);
+		}
+
+		std::vector<NodePtrType> oldChildren;
+		for (const std::vector<NodePtrType>& cofactors : dependent)
+		{	// the lower variable goes above the upper one
+			const NodePtrType& node = cofactors[0];
+			NodePtrType low = makeInternal(cofactors[1], cofactors[3], level);
+			NodePtrType high = makeInternal(cofactors[2], cofactors[4], level);
+			IncrementRefCnt(low);
+			IncrementRefCnt(high);
+
+			oldChildren.push_back(GetLowFromInternal(node));
+			oldChildren.push_back(GetHighFromInternal(node));
+
+			RelabelInternal(node, low, high, upper);
+			rehashInternal(node);
+		}
+
+		for (const NodePtrType& child : oldChildren)
+		{	// release the former children
+			recursivelyDeleteMTBDDNode(child);
+		}
+	}
+
+	static VarOrdering::NodeStore getNodeStore()
+	{
+		return VarOrdering::NodeStore([](){return internalCache_.size();},
+			addLevelNodeCounts, swapLevels);
+	}
+
 	static std::string mtbddNodeToDotString(const NodePtrType& ptr, NodePtrSet& cache)
 	{
 		// Assertions
@@ -337,7 +723,12 @@ private:  // private methods
 		{
 			assert(IsInternal(ptr));
 
-			return Convert::ToString(ptr) + " -> " +
+			// nodes are labelled by levels, so print the variable at the level
+			const VarType var = VarOrdering::GetVarAtLevel(GetVarFromInternal(ptr));
+
+			return Convert::ToString(ptr) + " [label = \"x" +
+				Convert::ToString(var) + "\"]\n" +
+				Convert::ToString(ptr) + " -> " +
 				Convert::ToString(GetLowFromInternal(ptr)) + " [style = dashed];\n" +
 				Convert::ToString(ptr) + " -> " +
 				Convert::ToString(GetHighFromInternal(ptr)) + " [style = solid];\n" +
@@ -370,6 +761,45 @@ public:   // public methods
 		root_ = constructMTBDD(asgn, value, defaultValue_);
 	}
 
+	/**
+	 * @brief  Constructor from a list of assignments
+	 *
+	 * This constructor creates a new MTBDD, such that every variable
+	 * assignment in @p asgnValues is set to its value and all other
+	 * assignments are set to @p defaultValue. The diagram is built in a single
+	 * pass over the variable levels, which is much cheaper than a union of the
+	 * diagrams for the particular assignments.
+	 *
+	 * @param  asgnValues    Pairwise disjoint variable assignments with values
+	 * @param  defaultValue  Value to be set for all other assignments
+	 */
+	OndriksMTBDD(const AsgnValueList& asgnValues, const DataType& defaultValue) :
+		root_(static_cast<uintptr_t>(0)),
+		defaultValue_(defaultValue)
+	{
+		VarType levels = 0;
+		std::vector<size_t> indices;
+		for (size_t i = 0; i < asgnValues.size(); ++i)
+		{	// find the highest level of the variables
+			for (size_t var = 0; var < asgnValues[i].first.length(); ++var)
+			{
+				levels = std::max(levels, VarOrdering::GetLevelOfVar(var) + 1);
+			}
+
+			indices.push_back(i);
+		}
+
+		NodePtrType sink = spawnLeaf(defaultValue_);
+		root_ = constructMTBDD(asgnValues, indices, levels, sink);
+
+		if ((root_ != sink) && (GetLeafRefCnt(sink) == 0))
+		{	// in case there is no one pointing to the sink
+			disposeOfLeafNode(sink);
+		}
+
+		IncrementRefCnt(root_);
+	}
+
 	OndriksMTBDD(const OndriksMTBDD& mtbdd)
 		: root_(mtbdd.root_),
 			defaultValue_(mtbdd.defaultValue_)
@@ -441,7 +871,7 @@ public:   // public methods
 
 		while (!IsLeaf(node))
 		{	// try to proceed according to the assignment
-			const VarType& var = GetVarFromInternal(node);
+			const VarType var = VarOrdering::GetVarAtLevel(GetVarFromInternal(node));
 
 			if (asgn.GetIthVariableValue(var) == VarAsgn::ONE)
 			{	// if one
@@ -474,26 +904,15 @@ public:   // public methods
 
 	OndriksMTBDD GetMtbddForPrefix(const VarAsgn& asgn, const size_t& offset) const
 	{
-		NodePtrType newRoot = root_;
-
-		while (!IsLeaf(newRoot))
-		{
-			const VarType& var = GetVarFromInternal(newRoot);
-			if (var < offset)
-			{
-				break;
-			}
-
-			if (asgn.GetIthVariableValue(var - offset) == VarAsgn::ONE)
-			{	// if one
-				newRoot = GetHighFromInternal(newRoot);
-			}
-			else
-			{	// if zero or don't care
-				newRoot = GetLowFromInternal(newRoot);
-			}
+		VarType minLevel = std::numeric_limits<VarType>::max();
+		for (size_t i = 0; i < asgn.length(); ++i)
+		{	// find the lowest level of the prefix
+			minLevel = std::min(minLevel, VarOrdering::GetLevelOfVar(offset + i));
 		}
 
+		RestrictCacheType cache;
+		NodePtrType newRoot = restrictVars(root_, asgn, offset, minLevel, cache);
+
 		IncrementRefCnt(newRoot);
 		return OndriksMTBDD(newRoot, defaultValue_);
 	}
@@ -513,4 +932,12 @@ template <typename Data>
 typename VATA::MTBDDPkg::OndriksMTBDD<Data>::InternalCacheType
 	VATA::MTBDDPkg::OndriksMTBDD<Data>::internalCache_;
 
+template <typename Data>
+typename VATA::MTBDDPkg::OndriksMTBDD<Data>::LeafIdType
+	VATA::MTBDDPkg::OndriksMTBDD<Data>::nextLeafId_ = 0;
+
+template <typename Data>
+std::vector<typename VATA::MTBDDPkg::OndriksMTBDD<Data>::LeafIdType>
+	VATA::MTBDDPkg::OndriksMTBDD<Data>::freeLeafIds_;
+
 #endif
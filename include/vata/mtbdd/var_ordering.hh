@@ -0,0 +1,284 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Global variable ordering of MTBDDs with dynamic reordering (sifting).
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_VAR_ORDERING_HH_
+#define _VATA_VAR_ORDERING_HH_
+
+// VATA headers
+#include <vata/vata.hh>
+
+// Standard library headers
+#include <cassert>
+#include <functional>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+
+// insert class into correct namespace
+namespace VATA
+{
+	namespace MTBDDPkg
+	{
+		class VarOrdering;
+	}
+}
+
+
+/**
+ * @brief  Global variable ordering of MTBDDs
+ *
+ * Internal nodes of MTBDDs are not labelled by variables directly but by
+ * @e levels. Leaves are below level 0 and a node at level @p l only points to
+ * nodes at lower levels. This class keeps the (global) mapping between
+ * variables (as indexed in VarAsgn) and levels, initially the identity.
+ *
+ * Every node store (i.e., the unique table of OndriksMTBDD for a given leaf
+ * type) registers itself here, so that two adjacent levels can be swapped in
+ * all diagrams at once. The swap is performed in place: every node pointer
+ * represents the same function before and after the swap, therefore roots of
+ * existing MTBDDs remain valid. Sifting (Rudell, 1993) built on top of the swap
+ * moves every variable through all levels and leaves it at the level where the
+ * total number of nodes is minimal.
+ *
+ * Reordering is only allowed when no MTBDD operation is in progress.
+ * Operations (i.e., the Apply functors) announce themselves using
+ * OperationGuard, which is also the point where automatic sifting is
+ * triggered once the number of nodes grows beyond a threshold.
+ *
+ * The ordering is global state without any synchronisation (as are the node
+ * stores themselves), so MTBDDs may only be used from a single thread. The
+ * first thread that uses the ordering becomes its owner; debug builds assert
+ * that no other thread uses it afterwards.
+ */
+class VATA::MTBDDPkg::VarOrdering
+{
+public:   // public data types
+
+	typedef uintptr_t VarType;
+
+	typedef std::vector<VarType> LevelTable;
+	typedef std::vector<size_t> LevelCountTable;
+
+	/**
+	 * @brief  Interface of a node store
+	 *
+	 * Set of functions through which a node store is manipulated.
+	 */
+	struct NodeStore
+	{
+		/// returns the number of internal nodes in the store
+		std::function<size_t()> GetNodeCount;
+
+		/// adds numbers of internal nodes at each level to the table
+		std::function<void(LevelCountTable&)> AddLevelNodeCounts;
+
+		/// swaps given level with the one right above it
+		std::function<void(const VarType&)> SwapLevels;
+
+		NodeStore(const std::function<size_t()>& getNodeCount,
+			const std::function<void(LevelCountTable&)>& addLevelNodeCounts,
+			const std::function<void(const VarType&)>& swapLevels) :
+			GetNodeCount(getNodeCount),
+			AddLevelNodeCounts(addLevelNodeCounts),
+			SwapLevels(swapLevels)
+		{ }
+	};
+
+	/**
+	 * @brief  RAII marker of a running MTBDD operation
+	 *
+	 * Creating the outermost guard gives automatic sifting a chance to run.
+	 * While any guard exists, reordering is disabled.
+	 */
+	class OperationGuard
+	{
+	private:  // private methods
+
+		OperationGuard(const OperationGuard&);
+		OperationGuard& operator=(const OperationGuard&);
+
+	public:   // public methods
+
+		OperationGuard()
+		{
+			assertSingleThread();
+
+			if (operationDepth_ == 0)
+			{	// only outside of other operations
+				CheckAutoSifting();
+			}
+
+			++operationDepth_;
+		}
+
+		~OperationGuard()
+		{
+			assert(operationDepth_ > 0);
+			--operationDepth_;
+		}
+	};
+
+public:   // public constants
+
+	static const size_t DEFAULT_SIFTING_THRESHOLD = 1 << 16;
+
+	/**
+	 * @brief  Maximum allowed growth while sifting a variable
+	 *
+	 * Moving a variable in one direction is stopped when the total number of
+	 * nodes exceeds the best size seen so far multiplied by this factor.
+	 */
+	static const double MAX_SIFTING_GROWTH;
+
+private:  // private data members
+
+	static LevelTable varToLevel_;
+	static LevelTable levelToVar_;
+
+	static std::vector<NodeStore> nodeStores_;
+
+	static size_t operationDepth_;
+
+	static bool autoSifting_;
+	static size_t siftingThreshold_;
+	static size_t nextSifting_;
+
+	static std::thread::id ownerThread_;
+
+private:  // private methods
+
+	VarOrdering();
+
+	/**
+	 * @brief  Asserts that the ordering is used by its owner thread only
+	 *
+	 * The calling thread becomes the owner if there is none yet. The check is
+	 * only performed in debug builds.
+	 */
+	static inline void assertSingleThread()
+	{
+#ifndef NDEBUG
+		if (ownerThread_ == std::thread::id())
+		{	// in case this is the first use
+			ownerThread_ = std::this_thread::get_id();
+		}
+
+		assert(ownerThread_ == std::this_thread::get_id());
+#endif
+	}
+
+	static void ensureLevels(const VarType& levels);
+
+	static void siftVariable(const VarType& var, const VarType& levels);
+
+public:   // public methods
+
+	/**
+	 * @brief  Returns the level of a variable
+	 *
+	 * @param[in]  var  Index of the variable
+	 *
+	 * @return  Level at which the variable is tested
+	 */
+	static inline VarType GetLevelOfVar(const VarType& var)
+	{
+		return (var < varToLevel_.size())? varToLevel_[var] : var;
+	}
+
+	/**
+	 * @brief  Returns the variable at a level
+	 *
+	 * @param[in]  level  Level in diagrams
+	 *
+	 * @return  Index of the variable tested at the level
+	 */
+	static inline VarType GetVarAtLevel(const VarType& level)
+	{
+		return (level < levelToVar_.size())? levelToVar_[level] : level;
+	}
+
+	/**
+	 * @brief  Registers a node store
+	 *
+	 * Called by every OndriksMTBDD instantiation before it creates its first
+	 * internal node.
+	 *
+	 * @param[in]  store  Interface to the node store
+	 *
+	 * @return  @p true
+	 */
+	static bool RegisterNodeStore(const NodeStore& store);
+
+	/**
+	 * @brief  Returns the total number of internal nodes
+	 *
+	 * @return  Number of internal nodes in all node stores
+	 */
+	static size_t GetNodeCount();
+
+	/**
+	 * @brief  Swaps two adjacent levels
+	 *
+	 * Swaps variables at levels @p level and @p level + 1 in all diagrams.
+	 *
+	 * @param[in]  level  The lower of the two levels
+	 */
+	static void SwapAdjacentLevels(const VarType& level);
+
+	/**
+	 * @brief  Reorders variables using sifting
+	 *
+	 * Sifts all variables that occur in some diagram, the ones at the most
+	 * populated levels first.
+	 */
+	static void Sift();
+
+	/**
+	 * @brief  Enables automatic sifting
+	 *
+	 * Sifting is triggered whenever an operation starts and the number of
+	 * internal nodes is larger than @p threshold, and then again each time the
+	 * number doubles with respect to the size after the last sifting.
+	 *
+	 * @param[in]  threshold  The initial node count threshold
+	 */
+	static void EnableAutoSifting(
+		const size_t& threshold = DEFAULT_SIFTING_THRESHOLD);
+
+	/**
+	 * @brief  Disables automatic sifting
+	 */
+	static void DisableAutoSifting();
+
+	/**
+	 * @brief  Performs automatic sifting if it is due
+	 */
+	static inline void CheckAutoSifting()
+	{
+		if (autoSifting_ && (GetNodeCount() > nextSifting_))
+		{	// in case the diagrams grew enough
+			Sift();
+		}
+	}
+
+	/**
+	 * @brief  Returns the current variable-to-level table
+	 *
+	 * @return  Table mapping variables to levels (variables not in the table
+	 *          are mapped to themselves)
+	 */
+	static inline const LevelTable& GetVarToLevelTable()
+	{
+		return varToLevel_;
+	}
+};
+
+#endif
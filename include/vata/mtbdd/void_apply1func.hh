@@ -14,6 +14,7 @@
 // VATA headers
 #include	<vata/vata.hh>
 #include	<vata/mtbdd/ondriks_mtbdd.hh>
+#include	<vata/util/stats.hh>
 
 
 namespace VATA
@@ -78,8 +79,10 @@ private:  // Private methods
 		assert(!IsNull(node1));
 
 		typename CacheHashTable::iterator itHt;
+		VATA_STATS_INC("mtbdd.void_apply1.lookups");
 		if ((itHt = ht.find(node1)) != ht.end())
 		{	// if the result is already known
+			VATA_STATS_INC("mtbdd.void_apply1.hits");
 			return;
 		}
 
@@ -119,6 +122,9 @@ public:   // Public methods
 
 	void operator()(const MTBDD1Type& mtbdd1)
 	{
+		// mark the running operation (reordering is not possible inside)
+		VarOrdering::OperationGuard guard;
+
 		// store the MTBDD
 		mtbdd1_ = &mtbdd1;
 
@@ -14,6 +14,7 @@
 // VATA headers
 #include	<vata/vata.hh>
 #include	<vata/mtbdd/ondriks_mtbdd.hh>
+#include	<vata/util/stats.hh>
 
 // Standard library headers
 #include  <unordered_set>
@@ -93,8 +94,10 @@ private:  // Private methods
 
 		CacheAddressType cacheAddress(node1, node2);
 		typename CacheHashTable::iterator itHt;
+		VATA_STATS_INC("mtbdd.void_apply2.lookups");
 		if ((itHt = ht.find(cacheAddress)) != ht.end())
 		{	// if the result is already known
+			VATA_STATS_INC("mtbdd.void_apply2.hits");
 			return;
 		}
 
@@ -163,6 +166,9 @@ public:   // Public methods
 
 	void operator()(const MTBDD1Type& mtbdd1, const MTBDD2Type& mtbdd2)
 	{
+		// mark the running operation (reordering is not possible inside)
+		VarOrdering::OperationGuard guard;
+
 		// store the MTBDDs
 		mtbdd1_ = &mtbdd1;
 		mtbdd2_ = &mtbdd2;
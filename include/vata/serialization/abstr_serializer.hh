@@ -15,16 +15,63 @@
 #include <vata/vata.hh>
 #include <vata/util/aut_description.hh>
 
+// Standard library headers
+#include <memory>
+#include <ostream>
+
 
 namespace VATA
 {
 	namespace Serialization
 	{
 		class AbstrSerializer;
+		class AbstrStreamWriter;
 	}
 }
 
 
+/**
+ * @brief  Writer of an automaton that outputs text while it is given the parts
+ *         of the automaton
+ *
+ * The parts have to be given in the order: symbols, name, states, final
+ * states, transitions; any of them may be omitted. The output is complete
+ * after Finish() is called.
+ */
+class VATA::Serialization::AbstrStreamWriter
+{
+public:   // data types
+
+	typedef VATA::Util::AutDescription AutDescription;
+
+public:   // methods
+
+	virtual void WriteSymbol(const std::string& symbol, unsigned rank) = 0;
+
+	virtual void WriteName(const std::string& name) = 0;
+
+	virtual void WriteState(const std::string& state) = 0;
+
+	virtual void WriteFinalState(const std::string& state) = 0;
+
+	virtual void WriteTransition(const AutDescription::StateTuple& children,
+		const std::string& symbol, const std::string& parent) = 0;
+
+	/**
+	 * @brief  Writes a whole description of an automaton
+	 */
+	virtual void Write(const AutDescription& desc) = 0;
+
+	/**
+	 * @brief  Completes the output and flushes it
+	 */
+	virtual void Finish() = 0;
+
+	virtual ~AbstrStreamWriter()
+	{ }
+};
+
+
 class VATA::Serialization::AbstrSerializer
 {
 public:   // data types
@@ -35,6 +82,17 @@ public:   // methods
 
 	virtual std::string Serialize(const AutDescription& desc) = 0;
 
+	/**
+	 * @brief  Creates a writer to an output stream
+	 */
+	virtual std::unique_ptr<AbstrStreamWriter> CreateStreamWriter(
+		std::ostream& os) = 0;
+
+	/**
+	 * @brief  Creates a writer to a file descriptor
+	 */
+	virtual std::unique_ptr<AbstrStreamWriter> CreateStreamWriter(int fd) = 0;
+
 	virtual ~AbstrSerializer()
 	{ }
 };
@@ -0,0 +1,90 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Header file for a writer of automata into an automaton description.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_AUT_DESCRIPTION_WRITER_HH_
+#define _VATA_AUT_DESCRIPTION_WRITER_HH_
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/serialization/abstr_serializer.hh>
+
+namespace VATA
+{
+	namespace Serialization
+	{
+		class AutDescriptionWriter;
+	}
+}
+
+/**
+ * @brief  Stream writer collecting the automaton in an AutDescription
+ *
+ * The automata use it in order to share the code dumping their parts with the
+ * writers that produce text.
+ */
+class VATA::Serialization::AutDescriptionWriter :
+	public VATA::Serialization::AbstrStreamWriter
+{
+private:  // data members
+
+	AutDescription& desc_;
+
+private:  // methods
+
+	AutDescriptionWriter(const AutDescriptionWriter&);
+	AutDescriptionWriter& operator=(const AutDescriptionWriter&);
+
+public:   // methods
+
+	explicit AutDescriptionWriter(AutDescription& desc) :
+		desc_(desc)
+	{ }
+
+	virtual void WriteSymbol(const std::string& symbol, unsigned rank)
+	{
+		desc_.symbols.insert(AutDescription::Symbol(symbol, rank));
+	}
+
+	virtual void WriteName(const std::string& name)
+	{
+		desc_.name = name;
+	}
+
+	virtual void WriteState(const std::string& state)
+	{
+		desc_.states.insert(state);
+	}
+
+	virtual void WriteFinalState(const std::string& state)
+	{
+		desc_.finalStates.insert(state);
+	}
+
+	virtual void WriteTransition(const AutDescription::StateTuple& children,
+		const std::string& symbol, const std::string& parent)
+	{
+		desc_.transitions.insert(AutDescription::Transition(children, symbol,
+			parent));
+	}
+
+	virtual void Write(const AutDescription& desc)
+	{
+		desc_.name = desc.name;
+		desc_.symbols.insert(desc.symbols.begin(), desc.symbols.end());
+		desc_.states.insert(desc.states.begin(), desc.states.end());
+		desc_.finalStates.insert(desc.finalStates.begin(), desc.finalStates.end());
+		desc_.transitions.insert(desc.transitions.begin(), desc.transitions.end());
+	}
+
+	virtual void Finish()
+	{ }
+};
+
+#endif
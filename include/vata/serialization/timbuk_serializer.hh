@@ -20,6 +20,7 @@ namespace VATA
 	namespace Serialization
 	{
 		class TimbukSerializer;
+		class TimbukStreamWriter;
 	}
 }
 
@@ -51,6 +52,99 @@ public:   // methods
 	}
 
 	virtual std::string Serialize(const AutDescription& desc);
+
+	virtual std::unique_ptr<AbstrStreamWriter> CreateStreamWriter(
+		std::ostream& os);
+
+	virtual std::unique_ptr<AbstrStreamWriter> CreateStreamWriter(int fd);
+};
+
+
+/**
+ * @brief  Writer of automata in the Timbuk format
+ *
+ * The text is collected in a buffer of a fixed size which is passed to the
+ * output stream or the file descriptor whenever it fills up, so the memory
+ * needed does not depend on the size of the automaton.
+ */
+class VATA::Serialization::TimbukStreamWriter :
+	public VATA::Serialization::AbstrStreamWriter
+{
+public:   // constants
+
+	static const size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+private:  // data types
+
+	enum SectionEnum
+	{
+		SECTION_NONE,
+		SECTION_OPS,
+		SECTION_AUTOMATON,
+		SECTION_STATES,
+		SECTION_FINAL_STATES,
+		SECTION_TRANSITIONS,
+		SECTION_DONE
+	};
+
+private:  // data members
+
+	std::ostream* os_;
+	int fd_;
+
+	std::string buffer_;
+	size_t bufferSize_;
+
+	SectionEnum section_;
+
+private:  // methods
+
+	TimbukStreamWriter(const TimbukStreamWriter&);
+	TimbukStreamWriter& operator=(const TimbukStreamWriter&);
+
+	/**
+	 * @brief  Closes the sections up to the given one and opens it
+	 */
+	void enterSection(SectionEnum section);
+
+	inline void append(const std::string& str)
+	{
+		buffer_ += str;
+
+		if (buffer_.size() >= bufferSize_)
+		{
+			flush();
+		}
+	}
+
+	void flush();
+
+public:   // methods
+
+	explicit TimbukStreamWriter(std::ostream& os,
+		size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+	explicit TimbukStreamWriter(int fd, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+	virtual void WriteSymbol(const std::string& symbol, unsigned rank);
+
+	virtual void WriteName(const std::string& name);
+
+	virtual void WriteState(const std::string& state);
+
+	virtual void WriteFinalState(const std::string& state);
+
+	virtual void WriteTransition(const AutDescription::StateTuple& children,
+		const std::string& symbol, const std::string& parent);
+
+	virtual void Write(const AutDescription& desc);
+
+	virtual void Finish();
+
+	/**
+	 * @brief  Flushes the output, errors are ignored (Finish() reports them)
+	 */
+	virtual ~TimbukStreamWriter();
 };
 
 #endif
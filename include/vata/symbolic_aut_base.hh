@@ -14,7 +14,10 @@
 // VATA headers
 #include <vata/vata.hh>
 #include <vata/aut_base.hh>
+#include <vata/mtbdd/ondriks_mtbdd.hh>
 #include <vata/mtbdd/var_asgn.hh>
+#include <vata/util/aut_description.hh>
+#include <vata/util/ord_vector.hh>
 
 
 namespace VATA
@@ -35,29 +38,55 @@ public:   // data types
 
 	typedef VATA::Util::TwoWayDict<std::string, SymbolType> StringToSymbolDict;
 
-protected:// constants
+	typedef VATA::Util::OrdVector<size_t> SymbolIndexSet;
+	typedef VATA::MTBDDPkg::OndriksMTBDD<SymbolIndexSet> AlphabetMTBDD;
 
-	const static size_t SYMBOL_SIZE = 16;
+public:   // constants
+
+	const static size_t DEFAULT_SYMBOL_SIZE = 16;
 
 private:  // data members
 
 	static StringToSymbolDict* pSymbolDict_;
 	static SymbolType* pNextSymbol_;
 
+	static size_t symbolSize_;
+
+	/// the number of variables encoding a symbol when the automaton was created
+	size_t encodingSize_;
+
 protected:// methods
 
-	SymbolicAutBase() { }
+	SymbolicAutBase() :
+		encodingSize_(symbolSize_)
+	{ }
 
-public:   // methods
+	SymbolicAutBase(const SymbolicAutBase& aut) :
+		AutBase(aut),
+		encodingSize_(aut.encodingSize_)
+	{ }
 
-	static inline SymbolType AddSymbol()
+	SymbolicAutBase& operator=(const SymbolicAutBase& rhs)
 	{
-		// Assertions
-		assert(pNextSymbol_ != nullptr);
+		encodingSize_ = rhs.encodingSize_;
 
-		return (*pNextSymbol_)++;
+		return *this;
 	}
 
+public:   // methods
+
+	/**
+	 * @brief  Returns a fresh symbol
+	 *
+	 * Returns the next unused code of the current encoding. Once all codes of
+	 * the encoding (given by the length of the next symbol) have been handed
+	 * out, the encoding is full and the function throws std::runtime_error
+	 * instead of returning a code that collides with an existing symbol.
+	 *
+	 * @returns  A symbol different from all previously returned ones
+	 */
+	static SymbolType AddSymbol();
+
 	inline static void SetNextSymbolPtr(SymbolType* pNextSymbol)
 	{
 		// Assertions
@@ -82,6 +111,93 @@ public:   // methods
 		return *pSymbolDict_;
 	}
 
+	/**
+	 * @brief  Returns the number of variables encoding a symbol
+	 */
+	static inline size_t GetSymbolSize()
+	{
+		return symbolSize_;
+	}
+
+	/**
+	 * @brief  Returns the number of variables encoding a symbol in the automaton
+	 *
+	 * This is the encoding that was current when the automaton was created.
+	 */
+	inline size_t GetEncodingSize() const
+	{
+		return encodingSize_;
+	}
+
+	/**
+	 * @brief  Checks that the automaton uses the current encoding of symbols
+	 *
+	 * Operations on symbolic automata call this function, so that an
+	 * automaton created before the encoding changed is not interpreted using
+	 * the new one.
+	 *
+	 * @throws  std::runtime_error  if the number of variables encoding
+	 *                              a symbol has changed since the automaton was
+	 *                              created
+	 */
+	void CheckEncoding() const;
+
+	/**
+	 * @brief  Sets the number of variables encoding a symbol
+	 *
+	 * The encoding is shared by all symbolic automata. Automata created with
+	 * a different number of variables cannot be used any more (operations on
+	 * them throw, see CheckEncoding()) except for conversion by
+	 * ReencodeSymbols().
+	 */
+	static inline void SetSymbolSize(size_t symbolSize)
+	{
+		// Assertions
+		assert(symbolSize > 0);
+
+		symbolSize_ = symbolSize;
+	}
+
+	/**
+	 * @brief  Returns the minimal number of variables for an alphabet
+	 *
+	 * @param[in]  alphabetSize  The number of symbols in the alphabet
+	 *
+	 * @returns  The smallest number of variables that can encode @p
+	 *           alphabetSize different symbols (at least one)
+	 */
+	static size_t GetMinimalSymbolSize(size_t alphabetSize);
+
+	/**
+	 * @brief  Creates a dense encoding of an alphabet
+	 *
+	 * Creates a new encoding of the symbols from @p symbols together with the
+	 * symbols that are already in the symbol dictionary, using the smallest
+	 * sufficient number of variables. Symbols are assigned consecutive codes
+	 * ordered by their rank and name, so that symbols of the same rank share
+	 * the upper part of MTBDDs. The symbol dictionary and the next symbol are
+	 * replaced; automata that were created using the previous encoding need to
+	 * be converted using ReencodeSymbols() (other operations on them throw if
+	 * the number of variables has changed).
+	 *
+	 * Note that the encoding only has room for further symbols up to the next
+	 * power of two, so the alphabet needs to be complete; AddSymbol() throws
+	 * when the encoding is full.
+	 *
+	 * @param[in]  symbols  Symbols (with ranks) of the alphabet
+	 */
+	static void EncodeAlphabet(const VATA::Util::AutDescription::SymbolSet& symbols);
+
+	/**
+	 * @brief  Creates an MTBDD of an alphabet
+	 *
+	 * Creates an MTBDD that maps the encoding of every symbol in @p dict to the
+	 * index of the name of the symbol in @p names. The names are appended to @p
+	 * names.
+	 */
+	static AlphabetMTBDD GetAlphabetMtbdd(const StringToSymbolDict& dict,
+		std::vector<std::string>& names);
+
 };
 
 #endif
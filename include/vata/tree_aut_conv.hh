@@ -0,0 +1,444 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Header file for direct conversions between explicitly and
+ *    symbolically represented tree automata.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_TREE_AUT_CONV_HH_
+#define _VATA_TREE_AUT_CONV_HH_
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/bdd_bu_tree_aut.hh>
+#include <vata/bdd_td_tree_aut.hh>
+#include <vata/explicit_tree_aut.hh>
+#include <vata/mtbdd/ondriks_mtbdd.hh>
+#include <vata/mtbdd/void_apply2func.hh>
+#include <vata/util/ord_vector.hh>
+#include <vata/util/transl_weak.hh>
+
+// Standard library headers
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// Boost library headers
+#include <boost/functional/hash.hpp>
+
+namespace VATA { class TreeAutConverter; }
+
+
+/**
+ * @brief  Converter between explicit and MTBDD-based automata
+ *
+ * This class converts automata between the explicit representation and the
+ * MTBDD-based (both top-down and bottom-up) representations by working
+ * directly on their internal structures, i.e., without dumping them to
+ * a textual description and parsing them back. Symbols are matched by their
+ * names: the name of an explicit symbol (of any rank) is translated to the
+ * corresponding variable assignment using the dictionary of symbolic
+ * automata (and vice versa); missing symbols are added to the target
+ * dictionary. States are preserved.
+ *
+ * When converting to MTBDDs, the transitions are first grouped per MTBDD and
+ * by symbol, and each MTBDD is then built in a single pass over the variable
+ * levels (no union of per-symbol diagrams is performed). When converting from MTBDDs,
+ * all cubes of a diagram are split into concrete symbols using a single
+ * apply operation with an MTBDD of the whole alphabet.
+ */
+class VATA::TreeAutConverter
+{
+private:  // data types
+
+	typedef AutBase::StateType StateType;
+	typedef SymbolicAutBase::SymbolType VarAsgnType;
+	typedef SymbolicAutBase::StringToSymbolDict VarAsgnDict;
+
+	typedef std::vector<StateType> StateTuple;
+
+	typedef SymbolicAutBase::SymbolIndexSet SymbolIndexSet;
+	typedef SymbolicAutBase::AlphabetMTBDD AlphabetMTBDD;
+
+	typedef std::vector<std::string> SymbolNameVector;
+
+	template <class Symbol>
+	class ExplicitSymbolTranslator
+	{
+	private:  // data types
+
+		typedef ExplicitTreeAut<Symbol> ExplicitAut;
+		typedef typename ExplicitAut::StringRank StringRank;
+
+		typedef std::pair<size_t, size_t> IndexRankPair;
+		typedef std::unordered_map<IndexRankPair, Symbol,
+			boost::hash<IndexRankPair>> IndexRankToSymbolMap;
+
+	private:  // data members
+
+		const SymbolNameVector& names_;
+		const ExplicitAut& aut_;
+		IndexRankToSymbolMap cache_;
+
+	public:   // methods
+
+		ExplicitSymbolTranslator(const SymbolNameVector& names,
+			const ExplicitAut& aut) :
+			names_(names),
+			aut_(aut),
+			cache_()
+		{ }
+
+		const Symbol& operator()(size_t index, size_t rank)
+		{
+			// Assertions
+			assert(index < names_.size());
+
+			auto res = cache_.insert(std::make_pair(std::make_pair(index, rank),
+				Symbol()));
+			if (res.second)
+			{	// in case the symbol has not been translated yet
+				VATA::Util::TranslatorWeak<typename ExplicitAut::StringToSymbolDict>
+					trans(aut_.GetSymbolDict(),
+					[this](const StringRank&){return aut_.AddSymbol();});
+
+				res.first->second = trans(StringRank(names_[index], rank));
+			}
+
+			return res.first->second;
+		}
+	};
+
+	template <class Symbol>
+	class VarAsgnTranslator
+	{
+	private:  // data types
+
+		typedef ExplicitTreeAut<Symbol> ExplicitAut;
+
+		typedef std::unordered_map<Symbol, VarAsgnType> SymbolToVarAsgnMap;
+
+	private:  // data members
+
+		const ExplicitAut& aut_;
+		SymbolToVarAsgnMap cache_;
+
+	public:   // methods
+
+		explicit VarAsgnTranslator(const ExplicitAut& aut) :
+			aut_(aut),
+			cache_()
+		{ }
+
+		const VarAsgnType& operator()(const Symbol& symbol)
+		{
+			auto itCache = cache_.find(symbol);
+			if (itCache == cache_.end())
+			{	// in case the symbol has not been translated yet
+				VATA::Util::TranslatorWeak<VarAsgnDict> trans(
+					SymbolicAutBase::GetSymbolDict(),
+					[](const std::string&){return SymbolicAutBase::AddSymbol();});
+
+				const std::string& name =
+					aut_.GetSymbolDict().TranslateBwd(symbol).symbolStr;
+
+				itCache = cache_.insert(std::make_pair(symbol, trans(name))).first;
+			}
+
+			return itCache->second;
+		}
+	};
+
+public:   // methods
+
+	/**
+	 * @brief  Converts an explicit automaton to a top-down MTBDD automaton
+	 */
+	template <class Symbol>
+	static BDDTopDownTreeAut ToBDDTopDown(const ExplicitTreeAut<Symbol>& aut)
+	{
+		typedef BDDTopDownTreeAut::TransMTBDD TransMTBDD;
+		typedef BDDTopDownTreeAut::StateTupleSet StateTupleSet;
+
+		BDDTopDownTreeAut result;
+		VarAsgnTranslator<Symbol> symbolTrans(aut);
+
+		for (const StateType& fst : aut.GetFinalStates())
+		{
+			result.SetStateFinal(fst);
+		}
+
+		for (auto& stateClusterPair : *aut.transitions_)
+		{	// for every parent state
+			assert(stateClusterPair.second);
+
+			// group the tuples by symbol and arity (which is a part of the symbol)
+			std::map<VarAsgnType, std::vector<StateTuple>> asgnTuples;
+			for (auto& symbolTupleSetPair : *stateClusterPair.second)
+			{	// for every symbol
+				assert(symbolTupleSetPair.second);
+
+				const VarAsgnType& symbol = symbolTrans(symbolTupleSetPair.first);
+				for (auto& tuple : *symbolTupleSetPair.second)
+				{
+					assert(tuple);
+
+					if (tuple->size() > BDDTopDownTreeAut::MAX_SYMBOL_ARITY)
+					{	// the arity would not fit into the arity variables
+						throw std::runtime_error("The arity " +
+							VATA::Util::Convert::ToString(tuple->size()) +
+							" exceeds the maximal arity of a top-down automaton.");
+					}
+
+					VarAsgnType asgn = symbol;
+					asgn.append(VarAsgnType(
+						BDDTopDownTreeAut::SYMBOL_ARITY_LENGTH, tuple->size()));
+
+					asgnTuples[asgn].push_back(*tuple);
+				}
+			}
+
+			TransMTBDD::AsgnValueList asgnValues;
+			for (auto& asgnTuplesPair : asgnTuples)
+			{
+				asgnValues.push_back(std::make_pair(asgnTuplesPair.first,
+					StateTupleSet(asgnTuplesPair.second)));
+			}
+
+			result.SetMtbdd(stateClusterPair.first,
+				TransMTBDD(asgnValues, StateTupleSet()));
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief  Converts an explicit automaton to a bottom-up MTBDD automaton
+	 */
+	template <class Symbol>
+	static BDDBottomUpTreeAut ToBDDBottomUp(const ExplicitTreeAut<Symbol>& aut)
+	{
+		typedef BDDBottomUpTreeAut::TransMTBDD TransMTBDD;
+		typedef BDDBottomUpTreeAut::StateSet StateSet;
+
+		typedef std::map<VarAsgnType, std::vector<StateType>> AsgnToStatesMap;
+		typedef std::unordered_map<StateTuple, AsgnToStatesMap,
+			boost::hash<StateTuple>> TupleToAsgnMap;
+
+		BDDBottomUpTreeAut result;
+		VarAsgnTranslator<Symbol> symbolTrans(aut);
+
+		for (const StateType& fst : aut.GetFinalStates())
+		{
+			result.SetStateFinal(fst);
+		}
+
+		// invert the transitions
+		TupleToAsgnMap tupleMap;
+		for (auto& stateClusterPair : *aut.transitions_)
+		{
+			assert(stateClusterPair.second);
+
+			for (auto& symbolTupleSetPair : *stateClusterPair.second)
+			{
+				assert(symbolTupleSetPair.second);
+
+				const VarAsgnType& symbol = symbolTrans(symbolTupleSetPair.first);
+				for (auto& tuple : *symbolTupleSetPair.second)
+				{
+					assert(tuple);
+
+					tupleMap[*tuple][symbol].push_back(stateClusterPair.first);
+				}
+			}
+		}
+
+		for (auto& tupleAsgnMapPair : tupleMap)
+		{	// for every tuple
+			TransMTBDD::AsgnValueList asgnValues;
+			for (auto& asgnStatesPair : tupleAsgnMapPair.second)
+			{
+				asgnValues.push_back(std::make_pair(asgnStatesPair.first,
+					StateSet(asgnStatesPair.second)));
+			}
+
+			result.SetMtbdd(tupleAsgnMapPair.first,
+				TransMTBDD(asgnValues, StateSet()));
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief  Converts a top-down MTBDD automaton to an explicit automaton
+	 *
+	 * The result is bound to @p context.
+	 */
+	template <class Symbol>
+	static ExplicitTreeAut<Symbol> ToExplicit(const BDDTopDownTreeAut& aut,
+		typename ExplicitTreeAut<Symbol>::Context& context =
+		ExplicitTreeAut<Symbol>::Context::GetDefault())
+	{
+		typedef ExplicitTreeAut<Symbol> ExplicitAut;
+		typedef BDDTopDownTreeAut::StateTupleSet StateTupleSet;
+
+		aut.CheckEncoding();
+
+		GCC_DIAG_OFF(effc++)
+		class SplitApplyFunctor :
+			public VATA::MTBDDPkg::VoidApply2Functor<SplitApplyFunctor,
+			StateTupleSet, SymbolIndexSet>
+		{
+		GCC_DIAG_ON(effc++)
+
+		private:  // data members
+
+			ExplicitAut& aut_;
+			ExplicitSymbolTranslator<Symbol>& symbolTrans_;
+			StateType parent_;
+
+		public:   // methods
+
+			SplitApplyFunctor(ExplicitAut& aut,
+				ExplicitSymbolTranslator<Symbol>& symbolTrans) :
+				aut_(aut),
+				symbolTrans_(symbolTrans),
+				parent_()
+			{ }
+
+			inline void SetParent(const StateType& parent)
+			{
+				parent_ = parent;
+			}
+
+			inline void ApplyOperation(const StateTupleSet& lhs,
+				const SymbolIndexSet& rhs)
+			{
+				if (lhs.empty())
+				{
+					return;
+				}
+
+				auto cluster = aut_.uniqueClusterMap()->uniqueCluster(parent_);
+
+				for (const size_t& index : rhs)
+				{	// for every symbol with the given tuples
+					for (const StateTuple& tuple : lhs)
+					{
+						cluster->uniqueTuplePtrSet(symbolTrans_(index, tuple.size()))->insert(
+							aut_.tupleLookup(tuple));
+					}
+				}
+			}
+		};
+
+		ExplicitAut result(context);
+
+		SymbolNameVector names;
+		AlphabetMTBDD alphabetMtbdd = SymbolicAutBase::GetAlphabetMtbdd(
+			SymbolicAutBase::GetSymbolDict(), names);
+		ExplicitSymbolTranslator<Symbol> symbolTrans(names, result);
+
+		for (const StateType& fst : aut.GetFinalStates())
+		{
+			result.SetStateFinal(fst);
+		}
+
+		SplitApplyFunctor splitter(result, symbolTrans);
+		for (auto stateBddPair : aut.GetStates())
+		{	// for every parent state
+			splitter.SetParent(stateBddPair.first);
+			splitter(aut.GetMtbdd(stateBddPair.first), alphabetMtbdd);
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief  Converts a bottom-up MTBDD automaton to an explicit automaton
+	 *
+	 * The result is bound to @p context.
+	 */
+	template <class Symbol>
+	static ExplicitTreeAut<Symbol> ToExplicit(const BDDBottomUpTreeAut& aut,
+		typename ExplicitTreeAut<Symbol>::Context& context =
+		ExplicitTreeAut<Symbol>::Context::GetDefault())
+	{
+		typedef ExplicitTreeAut<Symbol> ExplicitAut;
+		typedef BDDBottomUpTreeAut::StateSet StateSet;
+
+		aut.CheckEncoding();
+
+		GCC_DIAG_OFF(effc++)
+		class SplitApplyFunctor :
+			public VATA::MTBDDPkg::VoidApply2Functor<SplitApplyFunctor,
+			StateSet, SymbolIndexSet>
+		{
+		GCC_DIAG_ON(effc++)
+
+		private:  // data members
+
+			ExplicitAut& aut_;
+			ExplicitSymbolTranslator<Symbol>& symbolTrans_;
+			typename ExplicitAut::TuplePtr tuple_;
+
+		public:   // methods
+
+			SplitApplyFunctor(ExplicitAut& aut,
+				ExplicitSymbolTranslator<Symbol>& symbolTrans) :
+				aut_(aut),
+				symbolTrans_(symbolTrans),
+				tuple_()
+			{ }
+
+			inline void SetTuple(const StateTuple& tuple)
+			{
+				tuple_ = aut_.tupleLookup(tuple);
+			}
+
+			inline void ApplyOperation(const StateSet& lhs, const SymbolIndexSet& rhs)
+			{
+				// Assertions
+				assert(tuple_);
+
+				for (const size_t& index : rhs)
+				{	// for every symbol with the given parents
+					const Symbol& symbol = symbolTrans_(index, tuple_->size());
+
+					for (const StateType& parent : lhs)
+					{
+						aut_.internalAddTransition(tuple_, symbol, parent);
+					}
+				}
+			}
+		};
+
+		ExplicitAut result(context);
+
+		SymbolNameVector names;
+		AlphabetMTBDD alphabetMtbdd = SymbolicAutBase::GetAlphabetMtbdd(
+			SymbolicAutBase::GetSymbolDict(), names);
+		ExplicitSymbolTranslator<Symbol> symbolTrans(names, result);
+
+		for (const StateType& fst : aut.GetFinalStates())
+		{
+			result.SetStateFinal(fst);
+		}
+
+		SplitApplyFunctor splitter(result, symbolTrans);
+		for (auto tupleBddPair : aut.GetTransTable())
+		{	// for every tuple (including the nullary one)
+			splitter.SetTuple(tupleBddPair.first);
+			splitter(tupleBddPair.second, alphabetMtbdd);
+		}
+
+		return result;
+	}
+};
+
+#endif
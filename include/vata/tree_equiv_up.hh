@@ -0,0 +1,629 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Header file for the upward check of language equivalence of tree
+ *    automata using bisimulation up to congruence.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_TREE_EQUIV_UP_HH_
+#define _VATA_TREE_EQUIV_UP_HH_
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/util/cancellation.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Boost headers
+#include <boost/functional/hash.hpp>
+
+namespace VATA
+{
+	template <class Backend>
+	class UpwardEquivalenceChecker;
+}
+
+
+/**
+ * @brief  Checks language equivalence of two tree automata upwards
+ *
+ * The checker runs the bottom-up subset construction of both automata at once:
+ * it explores pairs (X, Y) of macro-states of the left-hand and the right-hand
+ * automaton that are reached by the same tree, so one run decides both
+ * inclusions. The languages differ iff some pair is accepting on one side only.
+ *
+ * A new pair is dropped when it is in the congruence closure of the pairs that
+ * have already been kept, i.e., in the smallest equivalence on sets of states
+ * of both automata that contains the kept pairs and is closed under union
+ * (bisimulation up to congruence, as in the HKC algorithm for finite
+ * automata): the post-image distributes over unions at every position of a
+ * tuple and so does acceptance, hence the dropped pair behaves as the kept
+ * ones it is derived from. Whether a pair (X, Y) is in the closure is decided
+ * by saturating X and Y by the rules "if one side of a kept pair is included,
+ * add the other side" and comparing the results.
+ *
+ * The @p Backend computes post-images of tuples of pairs and has to provide
+ *   - types @p StateType and @p SymbolType,
+ *   - <tt>const std::vector<size_t>& GetRanks() const</tt> giving the non-zero
+ *     ranks of transitions of the automata,
+ *   - <tt>bool IsLhsFinal(const StateType&) const</tt> and @p IsRhsFinal,
+ *   - <tt>bool OccursAt(size_t rank, size_t position, const StateSet& lhs,
+ *     const StateSet& rhs) const</tt> telling whether some state of the pair
+ *     is a child at the given position of a transition of the given rank,
+ *   - <tt>void ForeachPost(const MacroTuple& lhs, const MacroTuple& rhs,
+ *     Func func) const</tt> calling <tt>func(lhsPost, rhsPost)</tt> for the
+ *     post-images (as sorted vectors of states) of the tuples over all symbols,
+ *   - <tt>SymbolType FindSymbol(const MacroTuple& lhs, const MacroTuple& rhs,
+ *     const StateSet& lhsPost, const StateSet& rhsPost) const</tt> returning a
+ *     symbol under which the tuples reach the given post-images; it is used
+ *     only to build the counterexample.
+ */
+template <class Backend>
+class VATA::UpwardEquivalenceChecker
+{
+public:   // data types
+
+	typedef typename Backend::StateType StateType;
+	typedef typename Backend::SymbolType SymbolType;
+
+	typedef std::vector<StateType> StateSet;
+	typedef std::vector<const StateSet*> MacroTuple;
+
+	/**
+	 * @brief  A node of a counterexample tree
+	 */
+	struct CounterexampleNode
+	{
+		SymbolType symbol;
+
+		/// indices of the child nodes, which precede the node
+		std::vector<size_t> children;
+
+		CounterexampleNode(const SymbolType& sym,
+			const std::vector<size_t>& childNodes) :
+			symbol(sym),
+			children(childNodes)
+		{ }
+	};
+
+	/**
+	 * @brief  A tree accepted by exactly one of the automata
+	 *
+	 * The root is the last node.
+	 */
+	typedef std::vector<CounterexampleNode> Counterexample;
+
+private:  // data types
+
+	struct MacroPair
+	{
+		StateSet lhs;
+		StateSet rhs;
+
+		/// the kept pairs this pair is the post-image of
+		std::vector<size_t> children;
+
+		MacroPair(const StateSet& lhsSet, const StateSet& rhsSet,
+			const std::vector<size_t>& childPairs) :
+			lhs(lhsSet),
+			rhs(rhsSet),
+			children(childPairs)
+		{ }
+	};
+
+	/// kept pairs by the hash of their states
+	typedef std::unordered_multimap<size_t, size_t> PairMap;
+	typedef std::unordered_map<StateType, std::vector<size_t>> PairIndex;
+
+private:  // data members
+
+	const Backend& backend_;
+
+	/// the kept pairs (in a deque so that they do not move while post-images
+	/// of tuples of them are computed)
+	std::deque<MacroPair> pairs_;
+	PairMap pairMap_;
+
+	/// the kept pairs indexed by all their left-hand (and right-hand) states
+	PairIndex lhsIndex_;
+	PairIndex rhsIndex_;
+
+	/// the kept pairs with no left-hand (or right-hand) state
+	std::vector<size_t> lhsEmpty_;
+	std::vector<size_t> rhsEmpty_;
+
+	/// the number of pairs dropped as they are in the congruence closure of the
+	/// kept ones (not counting the pairs that have been kept already)
+	size_t prunedCnt_;
+
+	/// the kept pairs whose post-images have not been computed yet
+	std::deque<size_t> workset_;
+
+	/// the kept pairs whose post-images have been computed, in that order,
+	/// for every rank (in the order of GetRanks()) and position of a child at
+	/// which they occur
+	std::vector<std::vector<std::vector<size_t>>> processed_;
+
+	/// the pair accepting on one side only (if found)
+	std::vector<MacroPair> failing_;
+
+private:  // methods
+
+	UpwardEquivalenceChecker(const UpwardEquivalenceChecker&);
+	UpwardEquivalenceChecker& operator=(const UpwardEquivalenceChecker&);
+
+	static size_t hashPair(const StateSet& lhs, const StateSet& rhs)
+	{
+		size_t seed = boost::hash_range(lhs.begin(), lhs.end());
+		boost::hash_combine(seed, rhs.size());
+		boost::hash_range(seed, rhs.begin(), rhs.end());
+
+		return seed;
+	}
+
+	bool isKept(const StateSet& lhs, const StateSet& rhs) const
+	{
+		auto range = pairMap_.equal_range(hashPair(lhs, rhs));
+		for (auto itPairs = range.first; itPairs != range.second; ++itPairs)
+		{
+			const MacroPair& pair = pairs_[itPairs->second];
+			if ((pair.lhs == lhs) && (pair.rhs == rhs))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool isLhsAccepting(const StateSet& states) const
+	{
+		for (const StateType& state : states)
+		{
+			if (backend_.IsLhsFinal(state))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool isRhsAccepting(const StateSet& states) const
+	{
+		for (const StateType& state : states)
+		{
+			if (backend_.IsRhsFinal(state))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief  Adds a state to the set and to the queue if it is new
+	 *
+	 * @returns  @p true if the state is in the target and was not in the set
+	 */
+	static bool addState(const StateType& state, std::unordered_set<StateType>& set,
+		std::vector<StateType>& queue, const StateSet& target)
+	{
+		if (!set.insert(state).second)
+		{
+			return false;
+		}
+
+		queue.push_back(state);
+
+		return std::binary_search(target.begin(), target.end(), state);
+	}
+
+	/**
+	 * @brief  Checks whether the saturation of (@p lhs, @p rhs) by the kept
+	 *         pairs contains (@p lhsTarget, @p rhsTarget)
+	 *
+	 * Whenever a side of a kept pair is contained, the other side is added. A
+	 * pair is contained once each of its states is, which is tracked by the
+	 * number of its missing states.
+	 */
+	bool saturates(const StateSet& lhs, const StateSet& rhs,
+		const StateSet& lhsTarget, const StateSet& rhsTarget) const
+	{
+		size_t missing = lhsTarget.size() + rhsTarget.size();
+
+		std::unordered_set<StateType> lhsSet;
+		std::unordered_set<StateType> rhsSet;
+		std::vector<StateType> lhsQueue;
+		std::vector<StateType> rhsQueue;
+
+		// the numbers of missing left-hand (or right-hand) states of kept pairs
+		std::unordered_map<size_t, size_t> lhsMissing;
+		std::unordered_map<size_t, size_t> rhsMissing;
+
+		auto addStates = [&](const StateSet& states, bool isLhs)
+		{
+			for (const StateType& state : states)
+			{
+				if ((isLhs)? addState(state, lhsSet, lhsQueue, lhsTarget) :
+					addState(state, rhsSet, rhsQueue, rhsTarget))
+				{
+					--missing;
+				}
+			}
+		};
+
+		addStates(lhs, true);
+		addStates(rhs, false);
+
+		// pairs with an empty side apply to every set
+		for (size_t pairId : lhsEmpty_)
+		{
+			addStates(pairs_[pairId].rhs, false);
+		}
+
+		for (size_t pairId : rhsEmpty_)
+		{
+			addStates(pairs_[pairId].lhs, true);
+		}
+
+		auto processState = [&](const StateType& state, const PairIndex& index,
+			std::unordered_map<size_t, size_t>& pairMissing, bool isLhs)
+		{
+			auto itIndex = index.find(state);
+			if (itIndex == index.end())
+			{
+				return;
+			}
+
+			for (size_t pairId : itIndex->second)
+			{
+				const MacroPair& pair = pairs_[pairId];
+				auto itMissing = pairMissing.insert(std::make_pair(pairId,
+					(isLhs)? pair.lhs.size() : pair.rhs.size())).first;
+
+				if (--itMissing->second == 0)
+				{	// the side is contained, so the other side is added
+					addStates((isLhs)? pair.rhs : pair.lhs, !isLhs);
+				}
+			}
+		};
+
+		while ((missing > 0) && !(lhsQueue.empty() && rhsQueue.empty()))
+		{
+			if (!lhsQueue.empty())
+			{
+				StateType state = lhsQueue.back();
+				lhsQueue.pop_back();
+				processState(state, lhsIndex_, lhsMissing, true);
+			}
+			else
+			{
+				StateType state = rhsQueue.back();
+				rhsQueue.pop_back();
+				processState(state, rhsIndex_, rhsMissing, false);
+			}
+		}
+
+		return missing == 0;
+	}
+
+	/**
+	 * @brief  Checks whether the pair is in the congruence closure of the kept
+	 *         pairs
+	 *
+	 * The saturations of both sides are equal iff each of them contains the
+	 * other side.
+	 */
+	bool isCongruent(const StateSet& lhs, const StateSet& rhs) const
+	{
+		return saturates(lhs, StateSet(), StateSet(), rhs) &&
+			saturates(StateSet(), rhs, lhs, StateSet());
+	}
+
+	/**
+	 * @brief  Processes a pair reached by a tree
+	 *
+	 * @returns  @p false if the pair is accepting on one side only
+	 */
+	bool addPair(const StateSet& lhs, const StateSet& rhs,
+		const std::vector<size_t>& children)
+	{
+		if (isLhsAccepting(lhs) != isRhsAccepting(rhs))
+		{
+			failing_.push_back(MacroPair(lhs, rhs, children));
+			return false;
+		}
+
+		if ((lhs.empty() && rhs.empty()) || isKept(lhs, rhs))
+		{	// the empty pair is reached by no tree of either automaton
+			return true;
+		}
+
+		if (isCongruent(lhs, rhs))
+		{
+			++prunedCnt_;
+			return true;
+		}
+
+		size_t pairId = pairs_.size();
+		pairs_.push_back(MacroPair(lhs, rhs, children));
+		pairMap_.insert(std::make_pair(hashPair(lhs, rhs), pairId));
+
+		for (const StateType& state : lhs)
+		{
+			lhsIndex_[state].push_back(pairId);
+		}
+
+		for (const StateType& state : rhs)
+		{
+			rhsIndex_[state].push_back(pairId);
+		}
+
+		if (lhs.empty())
+		{
+			lhsEmpty_.push_back(pairId);
+		}
+
+		if (rhs.empty())
+		{
+			rhsEmpty_.push_back(pairId);
+		}
+
+		workset_.push_back(pairId);
+
+		return true;
+	}
+
+	/**
+	 * @brief  Processes the post-images of tuples of processed pairs
+	 *
+	 * @returns  @p false if a pair accepting on one side only is found
+	 */
+	bool post(const std::vector<size_t>& tuple)
+	{
+		MacroTuple lhsTuple;
+		MacroTuple rhsTuple;
+		for (size_t pairId : tuple)
+		{
+			lhsTuple.push_back(&pairs_[pairId].lhs);
+			rhsTuple.push_back(&pairs_[pairId].rhs);
+		}
+
+		bool equivalent = true;
+		backend_.ForeachPost(lhsTuple, rhsTuple,
+			[&](const StateSet& lhsPost, const StateSet& rhsPost)
+			{
+				if (equivalent)
+				{
+					equivalent = addPair(lhsPost, rhsPost, tuple);
+				}
+			});
+
+		return equivalent;
+	}
+
+	/**
+	 * @brief  Processes the tuples of processed pairs containing @p pairId,
+	 *         which has been processed last
+	 *
+	 * The pair is at the first of its positions in the tuple, the positions
+	 * before it range over the pairs processed before it.
+	 */
+	bool processTuples(size_t rankIndex, size_t pairId)
+	{
+		const std::vector<std::vector<size_t>>& domains = processed_[rankIndex];
+		const size_t rank = domains.size();
+
+		for (size_t fixed = 0; fixed < rank; ++fixed)
+		{
+			if (domains[fixed].empty() || (domains[fixed].back() != pairId))
+			{	// the pair does not occur at the position
+				continue;
+			}
+
+			std::vector<size_t> bounds(rank);
+			bool emptyDomain = false;
+			for (size_t i = 0; i < rank; ++i)
+			{
+				bounds[i] = domains[i].size();
+				if ((i < fixed) && (bounds[i] > 0) && (domains[i].back() == pairId))
+				{
+					--bounds[i];
+				}
+
+				emptyDomain = emptyDomain || (bounds[i] == 0);
+			}
+
+			if (emptyDomain)
+			{
+				continue;
+			}
+
+			std::vector<size_t> choice(rank, 0);
+			std::vector<size_t> tuple(rank);
+			for (size_t i = 0; i < rank; ++i)
+			{
+				tuple[i] = (i == fixed)? pairId : domains[i][0];
+			}
+
+			bool lastChoice = false;
+			while (!lastChoice)
+			{
+				VATA::Util::PollCancellation("equivalence", workset_.size(),
+					pairs_.size());
+
+				if (!post(tuple))
+				{
+					return false;
+				}
+
+				// move to the next choice
+				lastChoice = true;
+				for (size_t i = 0; i < rank; ++i)
+				{
+					if (i == fixed)
+					{
+						continue;
+					}
+
+					if (++choice[i] < bounds[i])
+					{
+						tuple[i] = domains[i][choice[i]];
+						lastChoice = false;
+						break;
+					}
+
+					choice[i] = 0;
+					tuple[i] = domains[i][0];
+				}
+			}
+		}
+
+		return true;
+	}
+
+	CounterexampleNode getCounterexampleNode(const MacroPair& pair,
+		const std::map<size_t, size_t>& nodes) const
+	{
+		MacroTuple lhsTuple;
+		MacroTuple rhsTuple;
+		std::vector<size_t> childNodes;
+		for (size_t pairId : pair.children)
+		{
+			lhsTuple.push_back(&pairs_[pairId].lhs);
+			rhsTuple.push_back(&pairs_[pairId].rhs);
+			childNodes.push_back(nodes.find(pairId)->second);
+		}
+
+		return CounterexampleNode(
+			backend_.FindSymbol(lhsTuple, rhsTuple, pair.lhs, pair.rhs), childNodes);
+	}
+
+public:   // methods
+
+	explicit UpwardEquivalenceChecker(const Backend& backend) :
+		backend_(backend),
+		pairs_(),
+		pairMap_(),
+		lhsIndex_(),
+		rhsIndex_(),
+		lhsEmpty_(),
+		rhsEmpty_(),
+		prunedCnt_(0),
+		workset_(),
+		processed_(),
+		failing_()
+	{ }
+
+	/**
+	 * @brief  Checks whether the languages of the automata are equal
+	 */
+	bool Check()
+	{
+		if (!post(std::vector<size_t>()))
+		{	// start with leaves
+			return false;
+		}
+
+		const std::vector<size_t>& ranks = backend_.GetRanks();
+		processed_.resize(ranks.size());
+		for (size_t i = 0; i < ranks.size(); ++i)
+		{
+			processed_[i].resize(ranks[i]);
+		}
+
+		while (!workset_.empty())
+		{
+			size_t pairId = workset_.front();
+			workset_.pop_front();
+
+			const MacroPair& pair = pairs_[pairId];
+			for (size_t i = 0; i < ranks.size(); ++i)
+			{
+				for (size_t pos = 0; pos < ranks[i]; ++pos)
+				{
+					if (backend_.OccursAt(ranks[i], pos, pair.lhs, pair.rhs))
+					{
+						processed_[i][pos].push_back(pairId);
+					}
+				}
+
+				if (!processTuples(i, pairId))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief  Returns the number of pairs whose post-images are computed
+	 */
+	size_t GetKeptPairCount() const
+	{
+		return pairs_.size();
+	}
+
+	/**
+	 * @brief  Returns the number of pairs dropped by the congruence closure
+	 */
+	size_t GetPrunedPairCount() const
+	{
+		return prunedCnt_;
+	}
+
+	/**
+	 * @brief  Returns a tree accepted by exactly one of the automata
+	 *
+	 * Valid only after Check() has returned @p false.
+	 */
+	Counterexample GetCounterexample() const
+	{
+		// Assertions
+		assert(!failing_.empty());
+
+		// the children of a pair were kept before it, so the pairs the tree
+		// consists of are built in the order of their identifiers
+		std::map<size_t, size_t> nodes;
+		std::vector<size_t> stack(failing_.front().children);
+		while (!stack.empty())
+		{
+			size_t pairId = stack.back();
+			stack.pop_back();
+
+			if (nodes.insert(std::make_pair(pairId, 0)).second)
+			{
+				const std::vector<size_t>& children = pairs_[pairId].children;
+				stack.insert(stack.end(), children.begin(), children.end());
+			}
+		}
+
+		Counterexample result;
+		for (auto& pairNodePair : nodes)
+		{
+			pairNodePair.second = result.size();
+			result.push_back(getCounterexampleNode(pairs_[pairNodePair.first], nodes));
+		}
+
+		result.push_back(getCounterexampleNode(failing_.front(), nodes));
+
+		return result;
+	}
+};
+
+#endif
@@ -16,6 +16,7 @@
 #include <unordered_set>
 
 #include <vata/util/convert.hh>
+#include <vata/util/stats.hh>
 
 namespace VATA
 {
@@ -45,6 +46,8 @@ public:
 	template <class Cont>
 	bool contains(const Cont& candidates /* candidates for p */) const {
 
+		VATA_STATS_INC("antichain1c.contains");
+
 		for (auto& p : candidates) {
 			
 			if (this->data_.find(p) != this->data_.end())
@@ -60,6 +63,8 @@ public:
 	template <class Cont>
 	void refine(const Cont& candidates /* candidates for p */) {
 
+		VATA_STATS_INC("antichain1c.refine");
+
 		for (auto& p : candidates)
 			this->data_.erase(p);
 
@@ -70,6 +75,8 @@ public:
 
 		this->data_.insert(q);
 
+		VATA_STATS_MAX("antichain1c.size_max", this->data_.size());
+
 	}
 
 	bool next(Key& s) {
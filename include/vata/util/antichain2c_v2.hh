@@ -16,6 +16,7 @@
 #include <unordered_map>
 
 #include <vata/util/convert.hh>
+#include <vata/util/stats.hh>
 
 namespace VATA
 {
@@ -45,6 +46,9 @@ private:
 
 	KeyToTListMap data_;
 
+	// number of pairs in the antichain
+	size_t size_;
+
 protected:
 
 	template <class Cont>
@@ -63,11 +67,12 @@ protected:
 
 public:
 
-	Antichain2Cv2() : data_() {}
+	Antichain2Cv2() : data_(), size_(0) {}
 
 	void swap(Antichain2Cv2& rhs) {
 
 		std::swap(this->data_, rhs.data_);
+		std::swap(this->size_, rhs.size_);
 
 	}
 
@@ -83,6 +88,8 @@ public:
 	template <class Cont, class Cmp>
 	bool contains(const Cont& candidates /* candidates for p */, const T& Q, const Cmp& cmp) const {
 
+		VATA_STATS_INC("antichain2c.contains");
+
 		for (auto& p : candidates) {
 
 			auto i = this->data_.find(p);
@@ -108,6 +115,8 @@ public:
 	void refine(const Cont& candidates /* candidates for p */, const T& Q, const Cmp& cmp,
 		const Eraser& eraser = DummyEraser()) {
 
+		VATA_STATS_INC("antichain2c.refine");
+
 		for (auto& p : candidates) {
 
 			auto i = this->data_.find(p);
@@ -125,6 +134,8 @@ public:
 
 					i->second.erase(k);
 
+					--this->size_;
+
 				}
 
 			}
@@ -141,6 +152,10 @@ public:
 
 		auto& list = this->data_.insert(std::make_pair(q, TList())).first->second;
 
+		++this->size_;
+
+		VATA_STATS_MAX("antichain2c.size_max", this->size_);
+
 		return list.insert(list.end(), Q);
 
 	}
@@ -157,6 +172,8 @@ public:
 
 		i->second.pop_front();
 
+		--this->size_;
+
 		if (i->second.empty())
 			this->data_.erase(i);
 
@@ -173,6 +190,8 @@ public:
 
 		iter->second.erase(Q);
 
+		--this->size_;
+
 		if (iter->second.empty())
 			this->data_.erase(iter);
 
@@ -180,19 +199,15 @@ public:
 
 	const KeyToTListMap& data() const { return this->data_; }
 
-	size_t size() const {
+	size_t size() const { return this->size_; }
 
-		size_t size = 0;
+	void clear() {
 
-		for (auto& p : this->data_)
-			size += p.second.size();
-
-		return size;
+		this->data_.clear();
+		this->size_ = 0;
 
 	}
 
-	void clear() { this->data_.clear(); }
-
 	inline bool empty() { return this->data_.empty();}
 
 	friend std::ostream& operator<<(std::ostream& os, const Antichain2Cv2& ac) {
@@ -148,7 +148,7 @@ public:
 
 public:
 
-	typedef std::vector<std::vector<size_t>> IndexType;
+	typedef std::vector<std::vector<IdType>> IndexType;
 
 	BinaryRelation(size_t size = 0, bool defVal = false, size_t rowSize = 16)
 		: data_(rowSize*rowSize, defVal), rowSize_(rowSize), size_(0) {
@@ -307,7 +307,7 @@ public:
 
 public:
 
-	typedef std::vector<std::vector<size_t>> IndexType;
+	typedef std::vector<std::vector<IdType>> IndexType;
 
 	explicit Identity(size_t size) : size_(size) {}
 
@@ -353,22 +353,22 @@ public:
 
 	// relation index
 	void buildIndex(IndexType& dst) const {
-		dst.resize(this->size_, std::vector<size_t>(1));
+		dst.resize(this->size_, std::vector<IdType>(1));
 		for (size_t i = 0; i < this->size_; ++i)
 			dst[i][0] = i;
 	}
 
 	// inverted relation index
 	void buildInvIndex(IndexType& dst) const {
-		dst.resize(this->size_, std::vector<size_t>(1));
+		dst.resize(this->size_, std::vector<IdType>(1));
 		for (size_t i = 0; i < this->size_; ++i)
 			dst[i][0] = i;
 	}
 
 	// relation index
 	void buildIndex(IndexType& ind, IndexType& inv) const {
-		ind.resize(this->size_, std::vector<size_t>(1));
-		inv.resize(this->size_, std::vector<size_t>(1));
+		ind.resize(this->size_, std::vector<IdType>(1));
+		inv.resize(this->size_, std::vector<IdType>(1));
 		for (size_t i = 0; i < this->size_; ++i) {
 			ind[i][0] = i;
 			inv[i][0] = i;
@@ -83,6 +83,8 @@ public:
 
 	bool empty() const { return this->store_.empty(); }
 
+	size_t size() const { return this->store_.size(); }
+
 };
 
 #endif
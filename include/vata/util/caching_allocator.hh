@@ -13,19 +13,39 @@
 
 #include <cstdlib>
 
+#include <new>
 #include <vector>
 #include <functional>
 
 #include <unordered_set>
 
+#include <vata/util/slab_allocator.hh>
+
 // insert class to proper namespace
 namespace VATA {
 	namespace Util {
-		template <class T, class Initializer = std::function<void(T*)>> class CachingAllocator;
-		template <class T, class Initializer = std::function<void(T*)>> class CachingArrayAllocator;
+		struct NoInitializer;
+		template <class T, class Initializer = NoInitializer> class CachingAllocator;
+		template <class T, class Initializer = NoInitializer> class CachingArrayAllocator;
 	}
 }
 
+struct VATA::Util::NoInitializer {
+
+	template <class T>
+	void operator()(T*) const {}
+
+};
+
+/**
+ * @brief  Allocator recycling objects of type T
+ *
+ * Reclaimed objects are kept for the following requests. New objects are
+ * either allocated on the heap or, if a slab allocator is given, placed in the
+ * slab allocator, which releases their memory in one shot (objects which are
+ * not reclaimed are not destructed in that case).
+ */
+
 template <class T, class Initializer>
 class VATA::Util::CachingAllocator {
 
@@ -36,18 +56,37 @@ public:
 private:
 
 	std::vector<T*> store_;
+	SlabAllocator* slab_;
 	Initializer initializer_;
 
+	CachingAllocator(const CachingAllocator&);
+	CachingAllocator& operator=(const CachingAllocator&);
+
 public:
 
-	CachingAllocator() : store_(), initializer_([](T*){}) {}
+	CachingAllocator() : store_(), slab_(nullptr), initializer_() {}
+
+	CachingAllocator(Initializer initializer) : store_(), slab_(nullptr),
+		initializer_(initializer) {}
 
-	CachingAllocator(Initializer initializer) : store_(), initializer_(initializer) {}
+	CachingAllocator(SlabAllocator& slab) : store_(), slab_(&slab), initializer_() {}
+
+	CachingAllocator(SlabAllocator& slab, Initializer initializer) : store_(), slab_(&slab),
+		initializer_(initializer) {}
 
 	~CachingAllocator() {
 
-		for (auto& element : this->store_)
-			delete element;
+		if (this->slab_) {
+
+			for (auto& element : this->store_)
+				element->~T();
+
+		} else {
+
+			for (auto& element : this->store_)
+				delete element;
+
+		}
 
 	}
 
@@ -60,6 +99,10 @@ public:
 			ptr = this->store_.back();
 			this->store_.pop_back();
 
+		} else if (this->slab_) {
+
+			ptr = new (this->slab_->allocate<T>()) T();
+
 		} else {
 
 			ptr = new T();
@@ -92,18 +135,28 @@ private:
 	std::vector<T*> store_;
 	size_t size_;
 	size_t byteSize_;
+	SlabAllocator* slab_;
 	Initializer initializer_;
 
+	CachingArrayAllocator(const CachingArrayAllocator&);
+	CachingArrayAllocator& operator=(const CachingArrayAllocator&);
+
 public:
 
 	CachingArrayAllocator(size_t size) : store_(), size_(size), byteSize_(size*sizeof(T)),
-		initializer_([](T*){}) {}
+		slab_(nullptr), initializer_() {}
 
 	CachingArrayAllocator(size_t size, Initializer initializer) : store_(), size_(size),
-		byteSize_(size*sizeof(T)), initializer_(initializer) {}
+		byteSize_(size*sizeof(T)), slab_(nullptr), initializer_(initializer) {}
+
+	CachingArrayAllocator(size_t size, SlabAllocator& slab) : store_(), size_(size),
+		byteSize_(size*sizeof(T)), slab_(&slab), initializer_() {}
 
 	~CachingArrayAllocator() {
 
+		if (this->slab_)
+			return;
+
 		for (auto& element : this->store_)
 			::operator delete(element);
 
@@ -119,6 +172,10 @@ public:
 
 			this->store_.pop_back();
 
+		} else if (this->slab_) {
+
+			ptr = reinterpret_cast<T*>(this->slab_->allocate(this->byteSize_));
+
 		} else {
 
 			ptr = reinterpret_cast<T*>(::operator new(this->byteSize_));
@@ -0,0 +1,344 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Header file with cooperative cancellation of long-running operations,
+ *    their deadlines and reporting of their progress.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_CANCELLATION_HH_
+#define _VATA_CANCELLATION_HH_
+
+// Standard library headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+
+namespace VATA
+{
+	namespace Util
+	{
+		struct Progress;
+		class CancellationToken;
+		class CancellationScope;
+		class OperationCancelled;
+		class OperationTimedOut;
+
+		/**
+		 * @brief  Throws OperationCancelled if the token bound to the current
+		 *         thread has been cancelled
+		 *
+		 * Called by the long-running loops of the library; it does nothing if
+		 * no token is bound to the thread.
+		 */
+		void PollCancellation();
+
+		/**
+		 * @brief  Polls the token like PollCancellation() and passes the state
+		 *         of the engine to the progress callback of the token
+		 *
+		 * @param[in]  engine         The name of the polling engine
+		 * @param[in]  worksetSize    The number of pending items of the engine
+		 * @param[in]  antichainSize  The number of processed items the engine
+		 *                            keeps (0 if it keeps none)
+		 */
+		void PollCancellation(const char* engine, size_t worksetSize,
+			size_t antichainSize = 0);
+	}
+}
+
+
+/**
+ * @brief  State of an operation passed to the progress callback
+ */
+struct VATA::Util::Progress
+{
+	/// the name of the engine that polled the token last
+	const char* engine;
+
+	/// the number of polls since the token was bound to the thread
+	uint64_t iterations;
+
+	size_t worksetSize;
+	size_t antichainSize;
+
+	/// seconds since the token was bound to the thread
+	double elapsed;
+};
+
+
+/**
+ * @brief  Exception thrown from an operation that has been cancelled
+ */
+class VATA::Util::OperationCancelled : public std::runtime_error
+{
+protected:// methods
+
+	explicit OperationCancelled(const char* message) :
+		std::runtime_error(message)
+	{ }
+
+public:   // methods
+
+	OperationCancelled() :
+		std::runtime_error("Operation cancelled")
+	{ }
+};
+
+
+/**
+ * @brief  Exception thrown from an operation that has run past the deadline
+ *         of its token
+ */
+class VATA::Util::OperationTimedOut : public VATA::Util::OperationCancelled
+{
+public:   // methods
+
+	OperationTimedOut() :
+		OperationCancelled("Operation timed out")
+	{ }
+};
+
+
+/**
+ * @brief  Flag by which operations running in other threads are asked to stop
+ *
+ * The token is bound to the threads running the operations by
+ * CancellationScope. The operations stop by throwing OperationCancelled at the
+ * next point where they poll the token, or OperationTimedOut once the deadline
+ * of the token passes. The deadline and the progress callback are to be set
+ * before the token is bound; the callback is called from the threads the
+ * token is bound to.
+ */
+class VATA::Util::CancellationToken
+{
+public:   // data types
+
+	typedef std::chrono::steady_clock Clock;
+	typedef std::function<void(const Progress&)> ProgressCallback;
+
+private:  // data members
+
+	std::atomic<bool> cancelled_;
+	std::atomic<bool> timedOut_;
+
+	bool hasDeadline_;
+	Clock::time_point deadline_;
+
+	ProgressCallback progressCallback_;
+	Clock::duration progressInterval_;
+
+private:  // methods
+
+	CancellationToken(const CancellationToken&);
+	CancellationToken& operator=(const CancellationToken&);
+
+public:   // methods
+
+	CancellationToken() :
+		cancelled_(false),
+		timedOut_(false),
+		hasDeadline_(false),
+		deadline_(),
+		progressCallback_(),
+		progressInterval_()
+	{ }
+
+	void Cancel()
+	{
+		cancelled_.store(true, std::memory_order_relaxed);
+	}
+
+	bool IsCancelled() const
+	{
+		return cancelled_.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief  Cancels the token as timed out (called when the deadline passes)
+	 */
+	void Expire()
+	{
+		timedOut_.store(true, std::memory_order_relaxed);
+		Cancel();
+	}
+
+	bool IsTimedOut() const
+	{
+		return timedOut_.load(std::memory_order_relaxed);
+	}
+
+	void SetDeadline(const Clock::time_point& deadline)
+	{
+		hasDeadline_ = true;
+		deadline_ = deadline;
+	}
+
+	/**
+	 * @brief  Sets the deadline to @p seconds from now
+	 */
+	void SetTimeout(double seconds)
+	{
+		SetDeadline(Clock::now() + std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(seconds)));
+	}
+
+	bool HasDeadline() const
+	{
+		return hasDeadline_;
+	}
+
+	const Clock::time_point& GetDeadline() const
+	{
+		return deadline_;
+	}
+
+	/**
+	 * @brief  Sets the callback called at most once per @p interval seconds
+	 *         while an operation polls the token
+	 */
+	void SetProgressCallback(const ProgressCallback& callback,
+		double interval = 1.0)
+	{
+		progressCallback_ = callback;
+		progressInterval_ = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(interval));
+	}
+
+	const ProgressCallback& GetProgressCallback() const
+	{
+		return progressCallback_;
+	}
+
+	const Clock::duration& GetProgressInterval() const
+	{
+		return progressInterval_;
+	}
+
+	/**
+	 * @brief  Takes over the deadline and the progress callback of @p token
+	 *
+	 * Used by operations that run their parts under a token of their own.
+	 */
+	void InheritLimits(const CancellationToken& token)
+	{
+		hasDeadline_ = token.hasDeadline_;
+		deadline_ = token.deadline_;
+		progressCallback_ = token.progressCallback_;
+		progressInterval_ = token.progressInterval_;
+	}
+
+	/**
+	 * @brief  Throws OperationTimedOut or OperationCancelled, depending on how
+	 *         the token has been cancelled
+	 */
+	void ThrowCancelled() const
+	{
+		if (IsTimedOut())
+		{
+			throw OperationTimedOut();
+		}
+
+		throw OperationCancelled();
+	}
+
+	/**
+	 * @brief  Returns the token bound to the current thread (or @p nullptr)
+	 */
+	static CancellationToken* GetCurrent();
+};
+
+
+/**
+ * @brief  Binds a token to the current thread for the lifetime of the object
+ *
+ * Scopes may be nested; the token of the enclosing scope is restored at the
+ * end. The scope counts the polls and looks at the clock only at the first
+ * and then every CLOCK_PERIOD-th poll, so that polling stays cheap in tight
+ * loops.
+ */
+class VATA::Util::CancellationScope
+{
+private:  // constants
+
+	enum
+	{
+		CLOCK_PERIOD = 64
+	};
+
+private:  // data members
+
+	CancellationToken& token_;
+	CancellationScope* previous_;
+
+	uint64_t polls_;
+	bool usesClock_;
+	CancellationToken::Clock::time_point start_;
+	CancellationToken::Clock::time_point nextProgress_;
+
+private:  // methods
+
+	CancellationScope(const CancellationScope&);
+	CancellationScope& operator=(const CancellationScope&);
+
+	void checkClock(const char* engine, size_t worksetSize,
+		size_t antichainSize);
+
+public:   // methods
+
+	explicit CancellationScope(CancellationToken& token);
+
+	~CancellationScope();
+
+	CancellationToken& GetToken()
+	{
+		return token_;
+	}
+
+	void Poll(const char* engine, size_t worksetSize, size_t antichainSize)
+	{
+		if (token_.IsCancelled())
+		{
+			token_.ThrowCancelled();
+		}
+
+		if (usesClock_ && ((++polls_ % CLOCK_PERIOD) == 1))
+		{
+			checkClock(engine, worksetSize, antichainSize);
+		}
+	}
+
+	/**
+	 * @brief  Returns the scope of the current thread (or @p nullptr)
+	 */
+	static CancellationScope* GetCurrent();
+};
+
+
+inline void VATA::Util::PollCancellation()
+{
+	CancellationScope* scope = CancellationScope::GetCurrent();
+	if (scope != nullptr)
+	{
+		scope->Poll(nullptr, 0, 0);
+	}
+}
+
+
+inline void VATA::Util::PollCancellation(const char* engine,
+	size_t worksetSize, size_t antichainSize)
+{
+	CancellationScope* scope = CancellationScope::GetCurrent();
+	if (scope != nullptr)
+	{
+		scope->Poll(engine, worksetSize, antichainSize);
+	}
+}
+
+#endif
@@ -136,11 +136,12 @@ public:   // Public methods
 	 * handled using a UNIX file pointer in the common way. The stream is opened
 	 * only for reading.
 	 *
-	 * @param[in]  str  The string to be inserted into the stream
+	 * @param[in]  str  The string to be inserted into the stream (it is not
+	 *                  copied and needs to outlive the stream)
 	 *
 	 * @returns  UNIX @c FILE* pointer
 	 */
-	FILE* OpenRead(std::string str);
+	FILE* OpenRead(const std::string& str);
 
 
 	/**
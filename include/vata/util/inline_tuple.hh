@@ -0,0 +1,443 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2012  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Tuple with inline storage for small ranks template header file.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_INLINE_TUPLE_HH_
+#define _VATA_INLINE_TUPLE_HH_
+
+// Standard library headers
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+#include <stdint.h>
+
+// Boost headers
+#include <boost/functional/hash.hpp>
+
+// insert class to proper namespace
+namespace VATA {
+	namespace Util {
+		template <class T, size_t InlineRank> class InlineTuple;
+	}
+}
+
+/**
+ * @brief  A tuple with inline storage
+ *
+ * Behaves like std::vector, but up to @p InlineRank elements are stored
+ * directly in the object, so tuples of small ranks need no allocation. Larger
+ * tuples fall back to the heap. Only trivially copyable elements are
+ * supported.
+ *
+ * DispatchRank() allows to specialise loops over tuples by their rank at
+ * compile time.
+ */
+template <class T, size_t InlineRank>
+class VATA::Util::InlineTuple {
+
+	static_assert(std::is_trivial<T>::value, "InlineTuple needs trivial elements");
+	static_assert(InlineRank > 0, "InlineTuple needs a positive inline rank");
+
+public:
+
+	typedef T value_type;
+	typedef T* iterator;
+	typedef const T* const_iterator;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+
+	/**
+	 * @brief  Rank passed by DispatchRank() for tuples larger than InlineRank
+	 */
+	static const size_t DYNAMIC_RANK = static_cast<size_t>(-1);
+
+private:
+
+	uint32_t size_;
+	uint32_t capacity_;
+
+	union {
+		T inline_[InlineRank];
+		T* heap_;
+	} storage_;
+
+	bool isInline() const {
+
+		return this->capacity_ == InlineRank;
+
+	}
+
+	void grow(size_t capacity) {
+
+		if (capacity <= this->capacity_)
+			return;
+
+		capacity = std::max<size_t>(capacity, 2 * this->capacity_);
+
+		T* heap = new T[capacity];
+
+		std::memcpy(heap, this->data(), this->size_ * sizeof(T));
+
+		if (!this->isInline())
+			delete[] this->storage_.heap_;
+
+		this->storage_.heap_ = heap;
+		this->capacity_ = capacity;
+
+	}
+
+	void release() {
+
+		if (!this->isInline())
+			delete[] this->storage_.heap_;
+
+		this->size_ = 0;
+		this->capacity_ = InlineRank;
+
+	}
+
+	template <class InputIterator>
+	void assign(InputIterator first, InputIterator last) {
+
+		for (; first != last; ++first)
+			this->push_back(*first);
+
+	}
+
+public:
+
+	InlineTuple() : size_(0), capacity_(InlineRank), storage_() {}
+
+	explicit InlineTuple(size_t size, const T& value = T()) : size_(0),
+		capacity_(InlineRank), storage_() {
+
+		this->resize(size, value);
+
+	}
+
+	template <class InputIterator>
+	InlineTuple(InputIterator first, InputIterator last,
+		typename std::enable_if<!std::is_integral<InputIterator>::value>::type* = nullptr) :
+		size_(0), capacity_(InlineRank), storage_() {
+
+		this->assign(first, last);
+
+	}
+
+	InlineTuple(std::initializer_list<T> list) : size_(0), capacity_(InlineRank),
+		storage_() {
+
+		this->assign(list.begin(), list.end());
+
+	}
+
+	InlineTuple(const std::vector<T>& vec) : size_(0), capacity_(InlineRank),
+		storage_() {
+
+		this->assign(vec.begin(), vec.end());
+
+	}
+
+	InlineTuple(const InlineTuple& tuple) : size_(0), capacity_(InlineRank),
+		storage_() {
+
+		this->grow(tuple.size_);
+
+		std::memcpy(this->data(), tuple.data(), tuple.size_ * sizeof(T));
+
+		this->size_ = tuple.size_;
+
+	}
+
+	InlineTuple(InlineTuple&& tuple) : size_(tuple.size_), capacity_(tuple.capacity_),
+		storage_(tuple.storage_) {
+
+		tuple.size_ = 0;
+		tuple.capacity_ = InlineRank;
+
+	}
+
+	~InlineTuple() {
+
+		this->release();
+
+	}
+
+	InlineTuple& operator=(const InlineTuple& rhs) {
+
+		if (this != &rhs) {
+
+			this->size_ = 0;
+
+			this->grow(rhs.size_);
+
+			std::memcpy(this->data(), rhs.data(), rhs.size_ * sizeof(T));
+
+			this->size_ = rhs.size_;
+
+		}
+
+		return *this;
+
+	}
+
+	InlineTuple& operator=(InlineTuple&& rhs) {
+
+		if (this != &rhs) {
+
+			this->release();
+
+			this->size_ = rhs.size_;
+			this->capacity_ = rhs.capacity_;
+			this->storage_ = rhs.storage_;
+
+			rhs.size_ = 0;
+			rhs.capacity_ = InlineRank;
+
+		}
+
+		return *this;
+
+	}
+
+	T* data() {
+
+		return (this->isInline())?(this->storage_.inline_):(this->storage_.heap_);
+
+	}
+
+	const T* data() const {
+
+		return (this->isInline())?(this->storage_.inline_):(this->storage_.heap_);
+
+	}
+
+	size_t size() const { return this->size_; }
+	bool empty() const { return this->size_ == 0; }
+
+	iterator begin() { return this->data(); }
+	iterator end() { return this->data() + this->size_; }
+	const_iterator begin() const { return this->data(); }
+	const_iterator end() const { return this->data() + this->size_; }
+	const_iterator cbegin() const { return this->data(); }
+	const_iterator cend() const { return this->data() + this->size_; }
+
+	T& operator[](size_t i) {
+
+		assert(i < this->size_);
+
+		return this->data()[i];
+
+	}
+
+	const T& operator[](size_t i) const {
+
+		assert(i < this->size_);
+
+		return this->data()[i];
+
+	}
+
+	T& front() { return (*this)[0]; }
+	const T& front() const { return (*this)[0]; }
+	T& back() { return (*this)[this->size_ - 1]; }
+	const T& back() const { return (*this)[this->size_ - 1]; }
+
+	void reserve(size_t capacity) {
+
+		this->grow(capacity);
+
+	}
+
+	void push_back(const T& value) {
+
+		if (this->size_ == this->capacity_) {
+
+			T copy(value);
+
+			this->grow(this->size_ + 1);
+
+			this->data()[this->size_++] = copy;
+
+			return;
+
+		}
+
+		this->data()[this->size_++] = value;
+
+	}
+
+	void pop_back() {
+
+		assert(this->size_);
+
+		--this->size_;
+
+	}
+
+	void resize(size_t size, const T& value = T()) {
+
+		this->grow(size);
+
+		std::fill(this->data() + this->size_, this->data() + std::max<size_t>(size, this->size_), value);
+
+		this->size_ = size;
+
+	}
+
+	void clear() {
+
+		this->size_ = 0;
+
+	}
+
+	template <class InputIterator>
+	iterator insert(const_iterator pos, InputIterator first, InputIterator last) {
+
+		size_t index = pos - this->begin();
+
+		assert(index <= this->size_);
+
+		InlineTuple tail(this->begin() + index, this->end());
+
+		this->size_ = index;
+
+		this->assign(first, last);
+		this->assign(tail.begin(), tail.end());
+
+		return this->begin() + index;
+
+	}
+
+	iterator insert(const_iterator pos, const T& value) {
+
+		size_t index = pos - this->begin();
+
+		assert(index <= this->size_);
+
+		T copy(value);
+
+		this->grow(this->size_ + 1);
+
+		std::memmove(this->data() + index + 1, this->data() + index,
+			(this->size_ - index) * sizeof(T));
+
+		this->data()[index] = copy;
+
+		++this->size_;
+
+		return this->begin() + index;
+
+	}
+
+	void swap(InlineTuple& rhs) {
+
+		InlineTuple tmp(std::move(rhs));
+
+		rhs = std::move(*this);
+		*this = std::move(tmp);
+
+	}
+
+	bool operator==(const InlineTuple& rhs) const {
+
+		return (this->size_ == rhs.size_) && std::equal(this->begin(), this->end(), rhs.begin());
+
+	}
+
+	bool operator!=(const InlineTuple& rhs) const {
+
+		return !(*this == rhs);
+
+	}
+
+	bool operator<(const InlineTuple& rhs) const {
+
+		return std::lexicographical_compare(this->begin(), this->end(), rhs.begin(), rhs.end());
+
+	}
+
+	operator std::vector<T>() const {
+
+		return std::vector<T>(this->begin(), this->end());
+
+	}
+
+	friend size_t hash_value(const InlineTuple& tuple) {
+
+		return boost::hash_range(tuple.begin(), tuple.end());
+
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const InlineTuple& tuple) {
+
+		os << "(";
+
+		for (size_t i = 0; i < tuple.size_; ++i)
+			os << ((i)?(", "):("")) << tuple[i];
+
+		return os << ")";
+
+	}
+
+	/**
+	 * @brief  Calls @p func.template apply<Rank>() with the rank as a constant
+	 *
+	 * Ranks up to InlineRank are passed as they are, larger ranks are passed as
+	 * DYNAMIC_RANK.
+	 */
+	template <class Func>
+	static void DispatchRank(size_t rank, Func& func) {
+
+		static_assert(InlineRank <= 2, "DispatchRank handles inline ranks up to 2");
+
+		if (rank > InlineRank) {
+
+			func.template apply<DYNAMIC_RANK>();
+
+			return;
+
+		}
+
+		switch (rank) {
+
+			case 0: func.template apply<0>(); break;
+			case 1: func.template apply<1>(); break;
+			default: func.template apply<InlineRank>(); break;
+
+		}
+
+	}
+
+	/**
+	 * @brief  Returns the rank of a tuple for a loop specialised to @p Rank
+	 *
+	 * The caller has to check that the tuple has the rank @p Rank (unless it
+	 * is DYNAMIC_RANK) before entering the loop.
+	 */
+	template <size_t Rank>
+	static size_t RankOf(const InlineTuple& tuple) {
+
+		assert((Rank == DYNAMIC_RANK) || (Rank == tuple.size()));
+
+		return (Rank == DYNAMIC_RANK)?(tuple.size()):(Rank);
+
+	}
+
+};
+
+template <class T, size_t InlineRank>
+const size_t VATA::Util::InlineTuple<T, InlineRank>::DYNAMIC_RANK;
+
+#endif
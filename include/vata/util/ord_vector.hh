@@ -14,6 +14,8 @@
 // VATA headers
 #include <vata/vata.hh>
 #include <vata/util/convert.hh>
+#include <vata/util/inline_tuple.hh>
+#include <vata/util/sorted_set_kernels.hh>
 
 // Standard library headers
 #include <vector>
@@ -29,9 +31,15 @@ namespace VATA
 	namespace Util
 	{
 		template <
-			class Key
+			class Key,
+			class Vector = std::vector<Key>
 		>
 		class OrdVector;
+
+		template <
+			class Key
+		>
+		struct SmallOrdVector;
 	}
 }
 
@@ -42,12 +50,15 @@ namespace VATA
  * This class implements the interface of a set (the same interface as
  * std::set) using ordered vector as the underlying data structure.
  *
- * @tparam  Key  Key type: type of the elements contained in the container.
- *               Each elements in a set is also its key.
+ * @tparam  Key     Key type: type of the elements contained in the
+ *                  container. Each elements in a set is also its key.
+ * @tparam  Vector  The underlying vector (std::vector or a vector with inline
+ *                  storage, see SmallOrdVector)
  */
 template
 <
-	class Key
+	class Key,
+	class Vector
 >
 class VATA::Util::OrdVector
 {
@@ -55,7 +66,9 @@ private:  // Private data types
 
 	typedef VATA::Util::Convert Convert;
 
-	typedef std::vector<Key> VectorType;
+	typedef Vector VectorType;
+
+	typedef VATA::Util::SortedSetKernels::Ops<Key> SetOps;
 
 public:   // Public data types
 
@@ -195,11 +208,8 @@ public:   // Public methods
 			}
 		}
 
-		vec_.resize(vec_.size() + 1);
-		std::copy_backward(vec_.begin() + first, vec_.end() - 1, vec_.end());
-
 		// insert the new element
-		vec_[first] = x;
+		vec_.insert(vec_.begin() + first, x);
 
 		// Assertions
 		assert(vectorIsSorted());
@@ -213,7 +223,7 @@ public:   // Public methods
 		assert(vec.vectorIsSorted());
 
 		OrdVector result = this->Union(vec);
-		vec_ = result.vec_;
+		vec_.swap(result.vec_);
 
 		// Assertions
 		assert(vectorIsSorted());
@@ -244,45 +254,27 @@ public:   // Public methods
 		assert(vectorIsSorted());
 		assert(rhs.vectorIsSorted());
 
-		VectorType newVector;
+		OrdVector result;
+		result.vec_.resize(vec_.size() + rhs.vec_.size());
+		result.vec_.resize(SetOps::Union(vec_.data(), vec_.size(),
+			rhs.vec_.data(), rhs.vec_.size(), result.vec_.data()));
 
-		auto lhsIt = vec_.begin();
-		auto rhsIt = rhs.vec_.begin();
+		// Assertions
+		assert(result.vectorIsSorted());
 
-		while ((lhsIt != vec_.end()) || (rhsIt != rhs.vec_.end()))
-		{	// until we get to the end of both vectors
-			if (lhsIt == vec_.end())
-			{	// if we are finished with the left-hand side vector
-				newVector.push_back(*rhsIt);
-				++rhsIt;
-			}
-			else if (rhsIt == rhs.vec_.end())
-			{	// if we are finished with the right-hand side vector
-				newVector.push_back(*lhsIt);
-				++lhsIt;
-			}
-			else
-			{
-				if (*lhsIt < *rhsIt)
-				{
-					newVector.push_back(*lhsIt);
-					++lhsIt;
-				}
-				else if (*rhsIt < *lhsIt)
-				{
-					newVector.push_back(*rhsIt);
-					++rhsIt;
-				}
-				else
-				{	// in case they are equal
-					newVector.push_back(*rhsIt);
-					++rhsIt;
-					++lhsIt;
-				}
-			}
-		}
+		return result;
+	}
 
-		OrdVector result(newVector);
+	OrdVector Intersection(const OrdVector& rhs) const
+	{
+		// Assertions
+		assert(vectorIsSorted());
+		assert(rhs.vectorIsSorted());
+
+		OrdVector result;
+		result.vec_.resize(std::min(vec_.size(), rhs.vec_.size()));
+		result.vec_.resize(SetOps::Intersection(vec_.data(), vec_.size(),
+			rhs.vec_.data(), rhs.vec_.size(), result.vec_.data()));
 
 		// Assertions
 		assert(result.vectorIsSorted());
@@ -406,15 +398,19 @@ public:   // Public methods
 			rhs.vec_.begin(), rhs.vec_.end());
 	}
 
-	const std::vector<Key>& ToVector() const
+	const VectorType& ToVector() const
 	{
 		return vec_;
 	}
 
 	bool IsSubsetOf(const OrdVector& bigger) const
 	{
-		return std::includes(bigger.cbegin(), bigger.cend(),
-			this->cbegin(), this->cend());
+		// Assertions
+		assert(vectorIsSorted());
+		assert(bigger.vectorIsSorted());
+
+		return SetOps::IsSubset(vec_.data(), vec_.size(),
+			bigger.vec_.data(), bigger.vec_.size());
 	}
 
 	bool HaveEmptyIntersection(const OrdVector& rhs) const
@@ -423,41 +419,47 @@ public:   // Public methods
 		assert(vectorIsSorted());
 		assert(rhs.vectorIsSorted());
 
-		const_iterator itLhs = begin();
-		const_iterator itRhs = rhs.begin();
+		return !SetOps::Intersects(vec_.data(), vec_.size(),
+			rhs.vec_.data(), rhs.vec_.size());
+	}
 
-		while ((itLhs != end()) || (itRhs != rhs.end()))
-		{	// until we drop out of the array (or find a common element)
-			if (*itLhs == *itRhs)
-			{	// in case there exists a common element
-				return false;
-			}
-			else if (*itLhs < *itRhs)
-			{	// in case the element in lhs is smaller
-				++itLhs;
-			}
-			else
-			{	// in case the element in rhs is smaller
-				assert(*itLhs > *itRhs);
-				++itRhs;
-			}
-		}
+	template <typename T, class V>
+	friend size_t hash_value(const OrdVector<T, V>& ordVec);
+};
 
-		return true;
-	}
 
-	template <typename T>
-	friend size_t hash_value(const OrdVector<T>& ordVec);
+/**
+ * @brief  OrdVector storing small sets inline
+ *
+ * Sets of up to @p INLINE_CAPACITY elements (so that the object takes 32 bytes
+ * on 64-bit platforms) need no heap allocation. Use @p Type for the set.
+ */
+template
+<
+	class Key
+>
+struct VATA::Util::SmallOrdVector
+{
+	static const size_t INLINE_CAPACITY =
+		(4 * sizeof(void*) > 2 * sizeof(uint32_t) + sizeof(Key))?
+		(4 * sizeof(void*) - 2 * sizeof(uint32_t)) / sizeof(Key) : 1;
+
+	typedef VATA::Util::OrdVector<Key,
+		VATA::Util::InlineTuple<Key, INLINE_CAPACITY>> Type;
 };
 
+template <class Key>
+const size_t VATA::Util::SmallOrdVector<Key>::INLINE_CAPACITY;
+
+
 namespace VATA
 {
 	namespace Util
 	{
-		template <typename T>
-		inline size_t hash_value(const OrdVector<T>& ordVec)
+		template <typename T, class V>
+		inline size_t hash_value(const OrdVector<T, V>& ordVec)
 		{
-			typedef OrdVector<T> OrdVectorType;
+			typedef OrdVector<T, V> OrdVectorType;
 			boost::hash<typename OrdVectorType::VectorType> hasher;
 			return hasher(ordVec.vec_);
 		}
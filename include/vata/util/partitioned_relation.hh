@@ -0,0 +1,332 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Preorder represented as a partition and a relation on its classes.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_PARTITIONED_RELATION_HH_
+#define _VATA_PARTITIONED_RELATION_HH_
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/util/binary_relation.hh>
+
+// Standard library headers
+#include <vector>
+#include <algorithm>
+#include <ostream>
+
+namespace VATA
+{
+	namespace Util
+	{
+		class PartitionedRelation;
+	}
+}
+
+/**
+ * @brief  A preorder stored as its equivalence classes and a sparse partial
+ *         order on them
+ *
+ * The memory needed is linear in the number of elements plus the number of
+ * related pairs of classes, so preorders which are close to the identity (as
+ * simulations usually are) stay small even when a dense BinaryRelation of the
+ * same size would not fit. The interface used by the consumers of
+ * BinaryRelation (get(), sym(), buildClasses(), buildIndex(), ...) is provided.
+ */
+class VATA::Util::PartitionedRelation {
+
+	// element -> class
+	std::vector<IdType> classOf_;
+
+	// class -> sorted elements
+	std::vector<std::vector<IdType>> classes_;
+
+	// class -> sorted classes above it (including itself)
+	std::vector<std::vector<IdType>> post_;
+
+	bool classLeq(size_t r, size_t c) const {
+
+		assert(r < this->post_.size());
+
+		return std::binary_search(this->post_[r].begin(), this->post_[r].end(), c);
+
+	}
+
+	template <class Index>
+	void appendClasses(Index& dst, const std::vector<IdType>& classes) const {
+
+		for (auto& c : classes)
+			dst.insert(dst.end(), this->classes_[c].begin(), this->classes_[c].end());
+
+		std::sort(dst.begin(), dst.end());
+
+	}
+
+	// merges mutually related blocks so that the classes are exactly the
+	// equivalence classes of the preorder
+	void init(const std::vector<std::vector<IdType>>& blocks,
+		const std::vector<std::vector<size_t>>& blockPost) {
+
+		assert(blocks.size() == blockPost.size());
+
+		std::vector<std::vector<size_t>> post(blockPost);
+
+		for (auto& p : post) {
+
+			std::sort(p.begin(), p.end());
+			p.erase(std::unique(p.begin(), p.end()), p.end());
+
+		}
+
+		// representative block of each block (the least equivalent one)
+		std::vector<size_t> repr(blocks.size());
+
+		for (size_t b = 0; b < blocks.size(); ++b) {
+
+			repr[b] = b;
+
+			for (auto& c : post[b]) {
+
+				if (c >= repr[b])
+					break;
+
+				if (std::binary_search(post[c].begin(), post[c].end(), b)) {
+
+					repr[b] = c;
+
+					break;
+
+				}
+
+			}
+
+		}
+
+		std::vector<size_t> classOfBlock(blocks.size(), static_cast<size_t>(-1));
+
+		this->classes_.clear();
+
+		for (size_t b = 0; b < blocks.size(); ++b) {
+
+			if (blocks[b].empty())
+				continue;
+
+			auto& cls = classOfBlock[repr[b]];
+
+			if (cls == static_cast<size_t>(-1)) {
+
+				cls = this->classes_.size();
+
+				this->classes_.push_back(std::vector<IdType>());
+
+			}
+
+			classOfBlock[b] = cls;
+
+			for (auto& q : blocks[b]) {
+
+				assert(q < this->classOf_.size());
+
+				this->classOf_[q] = cls;
+				this->classes_[cls].push_back(q);
+
+			}
+
+		}
+
+		this->post_.assign(this->classes_.size(), std::vector<IdType>());
+
+		// equivalent blocks are related to the same blocks, so the first
+		// non-empty block of each class suffices
+		std::vector<bool> done(this->classes_.size(), false);
+
+		for (size_t b = 0; b < blocks.size(); ++b) {
+
+			if (blocks[b].empty() || done[classOfBlock[b]])
+				continue;
+
+			done[classOfBlock[b]] = true;
+
+			auto& dst = this->post_[classOfBlock[b]];
+
+			for (auto& c : post[b]) {
+
+				if (classOfBlock[c] != static_cast<size_t>(-1))
+					dst.push_back(classOfBlock[c]);
+
+			}
+
+			std::sort(dst.begin(), dst.end());
+			dst.erase(std::unique(dst.begin(), dst.end()), dst.end());
+
+		}
+
+		for (auto& cls : this->classes_)
+			std::sort(cls.begin(), cls.end());
+
+	}
+
+public:
+
+	typedef std::vector<std::vector<IdType>> IndexType;
+
+	PartitionedRelation() : classOf_(), classes_(), post_() {}
+
+	/**
+	 * @brief  Builds the preorder from a partition and a relation on blocks
+	 *
+	 * @param[in]  size       Number of elements
+	 * @param[in]  blocks     Blocks of the partition of { 0, ..., size - 1 }
+	 * @param[in]  blockPost  For every block, the blocks above it (the relation
+	 *                        has to be a preorder on the blocks); blocks may be
+	 *                        equivalent and empty blocks are dropped
+	 */
+	PartitionedRelation(size_t size, const std::vector<std::vector<IdType>>& blocks,
+		const std::vector<std::vector<size_t>>& blockPost) : classOf_(size), classes_(),
+		post_() {
+
+		this->init(blocks, blockPost);
+
+	}
+
+	explicit PartitionedRelation(const BinaryRelation& rel) : classOf_(rel.size()),
+		classes_(), post_() {
+
+		std::vector<size_t> index, head;
+
+		rel.buildClasses(index, head);
+
+		std::vector<std::vector<IdType>> blocks(head.size());
+		std::vector<std::vector<size_t>> blockPost(head.size());
+
+		for (size_t i = 0; i < index.size(); ++i)
+			blocks[index[i]].push_back(i);
+
+		for (size_t i = 0; i < head.size(); ++i) {
+
+			for (size_t j = 0; j < head.size(); ++j) {
+
+				if (rel.get(head[i], head[j]))
+					blockPost[i].push_back(j);
+
+			}
+
+		}
+
+		this->init(blocks, blockPost);
+
+	}
+
+	bool get(size_t r, size_t c) const {
+
+		assert(r < this->size() && c < this->size());
+
+		return this->classLeq(this->classOf_[r], this->classOf_[c]);
+
+	}
+
+	bool sym(size_t r, size_t c) const {
+
+		assert(r < this->size() && c < this->size());
+
+		return this->classOf_[r] == this->classOf_[c];
+
+	}
+
+	size_t size() const { return this->classOf_.size(); }
+
+	size_t classCount() const { return this->classes_.size(); }
+
+	// build equivalence classes
+	void buildClasses(std::vector<size_t>& headIndex) const {
+
+		headIndex.resize(this->size());
+
+		for (size_t i = 0; i < this->size(); ++i)
+			headIndex[i] = this->classes_[this->classOf_[i]].front();
+
+	}
+
+	// build equivalence classes
+	void buildClasses(std::vector<size_t>& index, std::vector<size_t>& head) const {
+
+		std::vector<size_t> number(this->classes_.size(), static_cast<size_t>(-1));
+
+		index.resize(this->size());
+		head.clear();
+
+		for (size_t i = 0; i < this->size(); ++i) {
+
+			auto& n = number[this->classOf_[i]];
+
+			if (n == static_cast<size_t>(-1)) {
+
+				n = head.size();
+
+				head.push_back(i);
+
+			}
+
+			index[i] = n;
+
+		}
+
+	}
+
+	// relation index
+	void buildIndex(IndexType& dst) const {
+
+		dst.resize(this->size());
+
+		for (size_t i = 0; i < this->size(); ++i)
+			this->appendClasses(dst[i], this->post_[this->classOf_[i]]);
+
+	}
+
+	// inverted relation index
+	void buildInvIndex(IndexType& dst) const {
+
+		IndexType pre(this->classes_.size());
+
+		for (size_t c = 0; c < this->post_.size(); ++c) {
+
+			for (auto& d : this->post_[c])
+				pre[d].push_back(c);
+
+		}
+
+		dst.resize(this->size());
+
+		for (size_t i = 0; i < this->size(); ++i)
+			this->appendClasses(dst[i], pre[this->classOf_[i]]);
+
+	}
+
+	// relation index
+	void buildIndex(IndexType& ind, IndexType& inv) const {
+
+		this->buildIndex(ind);
+		this->buildInvIndex(inv);
+
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const PartitionedRelation& v) {
+
+		for (size_t i = 0; i < v.size(); ++i) {
+			for (size_t j = 0; j < v.size(); ++j)
+				os << v.get(i, j);
+			os << std::endl;
+		}
+
+		return os;
+
+	}
+
+};
+
+#endif
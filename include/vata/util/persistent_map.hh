@@ -0,0 +1,513 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2012  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Persistent hash map (hash array mapped trie) template header file.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_PERSISTENT_MAP_HH_
+#define _VATA_PERSISTENT_MAP_HH_
+
+// Standard library headers
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+// insert class to proper namespace
+namespace VATA {
+	namespace Util {
+		template <
+			class Key,
+			class Value,
+			class Hash = std::hash<Key>,
+			class Equal = std::equal_to<Key>
+		>
+		class PersistentHashMap;
+	}
+}
+
+/**
+ * @brief  A persistent hash map
+ *
+ * A hash array mapped trie: every internal node consumes 5 bits of the hash
+ * and stores only its non-empty children (selected by a bitmap), leaves keep
+ * the entries with the same hash. Nodes are reference counted and shared
+ * between copies of the map, hence copying the map takes constant time. A
+ * modification copies only the shared nodes on the path from the root to the
+ * modified entry, i.e., O(log n) nodes.
+ *
+ * Iterators are invalidated by any modification of the map.
+ */
+template <class Key, class Value, class Hash, class Equal>
+class VATA::Util::PersistentHashMap {
+
+public:
+
+	typedef Key key_type;
+	typedef Value mapped_type;
+	typedef std::pair<const Key, Value> value_type;
+
+private:
+
+	static const unsigned BITS = 5;
+	static const size_t MASK = (1 << BITS) - 1;
+
+	// the number of set bits
+	static size_t popCount(uint32_t bits) {
+
+#if defined(__GNUC__)
+		return __builtin_popcount(bits);
+#else
+		bits = bits - ((bits >> 1) & 0x55555555);
+		bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+
+		return (((bits + (bits >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+
+	}
+
+	struct Node;
+
+	typedef std::shared_ptr<Node> NodePtr;
+
+	struct Node {
+
+		// a leaf holds entries with the same hash, an internal node holds children
+		bool leaf_;
+		size_t hash_;
+		uint32_t bitmap_;
+		std::vector<NodePtr> children_;
+		std::vector<value_type> entries_;
+
+		Node(bool leaf, size_t hash) : leaf_(leaf), hash_(hash), bitmap_(0),
+			children_(), entries_() {}
+
+		size_t childIndex(size_t bit) const {
+
+			return popCount(this->bitmap_ & ((uint32_t(1) << bit) - 1));
+
+		}
+
+	};
+
+	struct Frame {
+
+		const Node* node_;
+		size_t pos_;
+
+		Frame(const Node* node, size_t pos) : node_(node), pos_(pos) {}
+
+		bool operator==(const Frame& rhs) const {
+
+			return (this->node_ == rhs.node_) && (this->pos_ == rhs.pos_);
+
+		}
+
+	};
+
+public:
+
+	class Iterator {
+
+		friend class PersistentHashMap;
+
+		// path to the current entry (the last frame is a leaf)
+		std::vector<Frame> stack_;
+
+		// descends to the leftmost entry below the last frame
+		void descend() {
+
+			while (!this->stack_.back().node_->leaf_) {
+
+				const Frame& frame = this->stack_.back();
+
+				this->stack_.push_back(Frame(frame.node_->children_[frame.pos_].get(), 0));
+
+			}
+
+		}
+
+	public:
+
+		typedef std::forward_iterator_tag iterator_category;
+		typedef ptrdiff_t difference_type;
+		typedef std::pair<const Key, Value> value_type;
+		typedef const value_type* pointer;
+		typedef const value_type& reference;
+
+		Iterator() : stack_() {}
+
+		Iterator& operator++() {
+
+			assert(!this->stack_.empty());
+
+			while (!this->stack_.empty()) {
+
+				Frame& frame = this->stack_.back();
+
+				size_t size = (frame.node_->leaf_)?
+					(frame.node_->entries_.size()):(frame.node_->children_.size());
+
+				if (++frame.pos_ < size) {
+
+					this->descend();
+
+					return *this;
+
+				}
+
+				this->stack_.pop_back();
+
+			}
+
+			return *this;
+
+		}
+
+		Iterator operator++(int) {
+
+			Iterator result(*this);
+
+			++*this;
+
+			return result;
+
+		}
+
+		bool operator==(const Iterator& rhs) const {
+
+			if (this->stack_.empty() || rhs.stack_.empty())
+				return this->stack_.empty() == rhs.stack_.empty();
+
+			return this->stack_.back() == rhs.stack_.back();
+
+		}
+
+		bool operator!=(const Iterator& rhs) const {
+
+			return !(*this == rhs);
+
+		}
+
+		reference operator*() const {
+
+			assert(!this->stack_.empty());
+
+			return this->stack_.back().node_->entries_[this->stack_.back().pos_];
+
+		}
+
+		pointer operator->() const {
+
+			return &**this;
+
+		}
+
+	};
+
+	typedef Iterator iterator;
+	typedef Iterator const_iterator;
+
+private:
+
+	NodePtr root_;
+	size_t size_;
+
+	static size_t hashOf(const Key& key) {
+
+		return Hash()(key);
+
+	}
+
+	// makes the node referenced by ptr private to this map
+	static Node& unique(NodePtr& ptr) {
+
+		assert(ptr);
+
+		if (!ptr.unique())
+			ptr = NodePtr(new Node(*ptr));
+
+		return *ptr;
+
+	}
+
+	static NodePtr makeLeaf(size_t hash, const value_type& value) {
+
+		NodePtr leaf(new Node(true, hash));
+
+		leaf->entries_.push_back(value);
+
+		return leaf;
+
+	}
+
+	static size_t bitAt(size_t hash, unsigned shift) {
+
+		return (hash >> shift) & MASK;
+
+	}
+
+	// creates an internal node separating two leaves with different hashes
+	static NodePtr split(const NodePtr& first, const NodePtr& second, unsigned shift) {
+
+		assert(first->hash_ != second->hash_);
+		assert(shift < sizeof(size_t) * 8);
+
+		NodePtr node(new Node(false, 0));
+
+		size_t firstBit = bitAt(first->hash_, shift);
+		size_t secondBit = bitAt(second->hash_, shift);
+
+		if (firstBit == secondBit) {
+
+			node->bitmap_ = uint32_t(1) << firstBit;
+			node->children_.push_back(split(first, second, shift + BITS));
+
+			return node;
+
+		}
+
+		node->bitmap_ = (uint32_t(1) << firstBit) | (uint32_t(1) << secondBit);
+
+		if (firstBit < secondBit) {
+
+			node->children_.push_back(first);
+			node->children_.push_back(second);
+
+		} else {
+
+			node->children_.push_back(second);
+			node->children_.push_back(first);
+
+		}
+
+		return node;
+
+	}
+
+	// returns the mapped value of key (inserts value if the key is not present)
+	Value& insertPath(NodePtr& ptr, size_t hash, unsigned shift, const value_type& value,
+		bool& inserted) {
+
+		if (ptr->leaf_ && (ptr->hash_ != hash)) {
+
+			NodePtr leaf = makeLeaf(hash, value);
+
+			ptr = split(ptr, leaf, shift);
+
+			inserted = true;
+
+			return leaf->entries_.front().second;
+
+		}
+
+		Node& node = unique(ptr);
+
+		if (node.leaf_) {
+
+			for (auto& entry : node.entries_) {
+
+				if (Equal()(entry.first, value.first))
+					return entry.second;
+
+			}
+
+			node.entries_.push_back(value);
+
+			inserted = true;
+
+			return node.entries_.back().second;
+
+		}
+
+		size_t bit = bitAt(hash, shift);
+		size_t index = node.childIndex(bit);
+
+		if (!(node.bitmap_ & (uint32_t(1) << bit))) {
+
+			node.bitmap_ |= uint32_t(1) << bit;
+			node.children_.insert(node.children_.begin() + index, makeLeaf(hash, value));
+
+			inserted = true;
+
+			return node.children_[index]->entries_.front().second;
+
+		}
+
+		return this->insertPath(node.children_[index], hash, shift + BITS, value, inserted);
+
+	}
+
+	Value& insertValue(const value_type& value, bool& inserted) {
+
+		inserted = false;
+
+		size_t hash = hashOf(value.first);
+
+		if (!this->root_) {
+
+			this->root_ = makeLeaf(hash, value);
+
+			inserted = true;
+
+			Value& result = this->root_->entries_.front().second;
+
+			++this->size_;
+
+			return result;
+
+		}
+
+		Value& result = this->insertPath(this->root_, hash, 0, value, inserted);
+
+		if (inserted)
+			++this->size_;
+
+		return result;
+
+	}
+
+public:
+
+	PersistentHashMap() : root_(), size_(0) {}
+
+	size_t size() const {
+
+		return this->size_;
+
+	}
+
+	bool empty() const {
+
+		return this->size_ == 0;
+
+	}
+
+	void clear() {
+
+		this->root_ = NodePtr();
+		this->size_ = 0;
+
+	}
+
+	const_iterator begin() const {
+
+		Iterator result;
+
+		if (!this->root_)
+			return result;
+
+		result.stack_.push_back(Frame(this->root_.get(), 0));
+		result.descend();
+
+		return result;
+
+	}
+
+	const_iterator end() const {
+
+		return Iterator();
+
+	}
+
+	const_iterator find(const Key& key) const {
+
+		Iterator result;
+
+		size_t hash = hashOf(key);
+		const Node* node = this->root_.get();
+
+		for (unsigned shift = 0; node; shift += BITS) {
+
+			if (node->leaf_) {
+
+				if (node->hash_ != hash)
+					return Iterator();
+
+				for (size_t i = 0; i < node->entries_.size(); ++i) {
+
+					if (Equal()(node->entries_[i].first, key)) {
+
+						result.stack_.push_back(Frame(node, i));
+
+						return result;
+
+					}
+
+				}
+
+				return Iterator();
+
+			}
+
+			size_t bit = bitAt(hash, shift);
+
+			if (!(node->bitmap_ & (uint32_t(1) << bit)))
+				return Iterator();
+
+			size_t index = node->childIndex(bit);
+
+			result.stack_.push_back(Frame(node, index));
+
+			node = node->children_[index].get();
+
+		}
+
+		return Iterator();
+
+	}
+
+	size_t count(const Key& key) const {
+
+		return (this->find(key) == this->end())?(0):(1);
+
+	}
+
+	/**
+	 * @brief  Inserts an entry unless the key is already present
+	 *
+	 * @return  The iterator to the entry with the key and @p true if the entry
+	 *          has been inserted
+	 */
+	std::pair<iterator, bool> insert(const value_type& value) {
+
+		bool inserted;
+
+		this->insertValue(value, inserted);
+
+		return std::make_pair(this->find(value.first), inserted);
+
+	}
+
+	template <class InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+
+		for (; first != last; ++first)
+			this->insert(*first);
+
+	}
+
+	/**
+	 * @brief  Returns a modifiable reference to a mapped value
+	 *
+	 * The value is default-constructed if the key is not present. Shared nodes
+	 * on the path to the entry are copied first.
+	 */
+	Value& operator[](const Key& key) {
+
+		bool inserted;
+
+		return this->insertValue(value_type(key, Value()), inserted);
+
+	}
+
+};
+
+#endif
@@ -0,0 +1,339 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    The header file of the translation table of product states.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_PRODUCT_TRANSL_TABLE_HH_
+#define _VATA_PRODUCT_TRANSL_TABLE_HH_
+
+// VATA headers
+#include <vata/vata.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+// Boost headers
+#include <boost/functional/hash.hpp>
+
+
+namespace VATA
+{
+	namespace Util
+	{
+		template
+		<
+			class State
+		>
+		class ProductTranslTable;
+	}
+}
+
+/**
+ * @brief  Translation table of product states
+ *
+ * Maps pairs of states to product states, which are numbered consecutively
+ * in the order of insertion, starting after the entries of a map passed to
+ * ImportFrom() (or from 0). If states of both operands lie in dense ranges
+ * (see SetRanges()), pairs are looked up in a two-level direct table: there
+ * is a row for every left-hand state, allocated when the state is first
+ * used, indexed by right-hand states. Rows are allocated only while their
+ * total size stays within MAX_TABLE_SIZE. Other pairs are kept in a hash
+ * table.
+ */
+template
+<
+	class State
+>
+class VATA::Util::ProductTranslTable
+{
+public:   // data types
+
+	typedef State StateType;
+	typedef std::pair<StateType, StateType> StatePair;
+
+private:  // data types
+
+	typedef std::vector<StateType> Row;
+	typedef std::unordered_map<StatePair, StateType, boost::hash<StatePair>>
+		HashTable;
+
+public:   // constants
+
+	/**
+	 * @brief  Maximum length of a row of the direct table
+	 */
+	static const size_t MAX_ROW_SIZE = 1 << 20;
+
+	/**
+	 * @brief  Maximum total length of the allocated rows of the direct table
+	 */
+	static const size_t MAX_TABLE_SIZE = 1 << 23;
+
+	/**
+	 * @brief  Maximum ratio of the size of a range and the number of states in it
+	 */
+	static const size_t MAX_SPARSENESS = 4;
+
+private:  // constants
+
+	static const StateType NO_STATE;
+
+private:  // data members
+
+	StateType lhsLow_;
+	std::vector<Row> rows_;
+	StateType rhsLow_;
+	size_t rowSize_;
+	size_t allocatedSize_;
+
+	HashTable hashTable_;
+
+	StateType firstState_;
+	std::vector<StatePair> pairs_;
+
+private:  // methods
+
+	inline bool inRange(const StateType& lhs, const StateType& rhs) const
+	{
+		return (lhs - lhsLow_ < rows_.size()) && (rhs - rhsLow_ < rowSize_);
+	}
+
+	// returns the entry of a pair (NO_STATE if it has no product state yet)
+	inline StateType& slot(const StateType& lhs, const StateType& rhs)
+	{
+		if (inRange(lhs, rhs))
+		{
+			Row& row = rows_[lhs - lhsLow_];
+			if (row.empty() && (allocatedSize_ + rowSize_ <= MAX_TABLE_SIZE))
+			{	// allocate the row if the budget allows it
+				row.resize(rowSize_, NO_STATE);
+				allocatedSize_ += rowSize_;
+			}
+
+			if (!row.empty())
+			{
+				return row[rhs - rhsLow_];
+			}
+		}
+
+		return hashTable_.insert(
+			std::make_pair(std::make_pair(lhs, rhs), NO_STATE)).first->second;
+	}
+
+	template <class StateVector>
+	static bool findDenseRange(const StateVector& states, StateType& low,
+		size_t& size)
+	{
+		if (states.empty())
+		{
+			return false;
+		}
+
+		low = *std::min_element(states.begin(), states.end());
+		size = *std::max_element(states.begin(), states.end()) - low + 1;
+
+		if (size > MAX_ROW_SIZE)
+		{
+			return false;
+		}
+
+		std::vector<bool> present(size, false);
+		size_t count = 0;
+		for (const StateType& state : states)
+		{
+			if (!present[state - low])
+			{
+				present[state - low] = true;
+				++count;
+			}
+		}
+
+		return size <= MAX_SPARSENESS * count;
+	}
+
+public:   // methods
+
+	ProductTranslTable() :
+		lhsLow_(0),
+		rows_(),
+		rhsLow_(0),
+		rowSize_(0),
+		allocatedSize_(0),
+		hashTable_(),
+		firstState_(0),
+		pairs_()
+	{ }
+
+	/**
+	 * @brief  Enables the direct table
+	 *
+	 * The direct table is used if states of both operands (possibly with
+	 * repetitions) form dense ranges. Pairs outside of the ranges are still
+	 * handled correctly.
+	 *
+	 * @param[in]  lhsStates  States of the left-hand side operand
+	 * @param[in]  rhsStates  States of the right-hand side operand
+	 *
+	 * @returns  @p true if the direct table is used
+	 */
+	template <class StateVector>
+	bool SetRanges(const StateVector& lhsStates, const StateVector& rhsStates)
+	{
+		assert(pairs_.empty());
+		assert(hashTable_.empty());
+
+		size_t lhsSize;
+		size_t rhsSize;
+		if (!findDenseRange(lhsStates, lhsLow_, lhsSize) ||
+			!findDenseRange(rhsStates, rhsLow_, rhsSize))
+		{
+			return false;
+		}
+
+		rows_.resize(lhsSize);
+		rowSize_ = rhsSize;
+		return true;
+	}
+
+	/**
+	 * @brief  Finds the product state of a pair
+	 *
+	 * @param[in]   lhs     Left-hand side state
+	 * @param[in]   rhs     Right-hand side state
+	 * @param[out]  result  The product state
+	 *
+	 * @returns  @p true if the pair has a product state
+	 */
+	inline bool Find(const StateType& lhs, const StateType& rhs,
+		StateType& result) const
+	{
+		if (inRange(lhs, rhs))
+		{
+			const Row& row = rows_[lhs - lhsLow_];
+			if (!row.empty())
+			{
+				result = row[rhs - rhsLow_];
+				return result != NO_STATE;
+			}
+		}
+
+		auto itHash = hashTable_.find(std::make_pair(lhs, rhs));
+		if (itHash == hashTable_.end())
+		{
+			return false;
+		}
+
+		result = itHash->second;
+		return true;
+	}
+
+	/**
+	 * @brief  Returns the product state of a pair, creating it if necessary
+	 *
+	 * @param[in]  lhs  Left-hand side state
+	 * @param[in]  rhs  Right-hand side state
+	 *
+	 * @returns  The product state and @p true if it has just been created
+	 */
+	inline std::pair<StateType, bool> Insert(const StateType& lhs,
+		const StateType& rhs)
+	{
+		StateType& result = slot(lhs, rhs);
+		if (result != NO_STATE)
+		{
+			return std::make_pair(result, false);
+		}
+
+		result = firstState_ + pairs_.size();
+		pairs_.push_back(std::make_pair(lhs, rhs));
+		return std::make_pair(result, true);
+	}
+
+	/**
+	 * @brief  Returns the pair of a product state created by Insert()
+	 */
+	inline const StatePair& GetPair(const StateType& state) const
+	{
+		assert(state - firstState_ < pairs_.size());
+
+		return pairs_[state - firstState_];
+	}
+
+	/**
+	 * @brief  Returns the first product state created by Insert()
+	 */
+	inline StateType GetFirstState() const
+	{
+		return firstState_;
+	}
+
+	/**
+	 * @brief  Returns the product state to be created next by Insert()
+	 */
+	inline StateType GetNextState() const
+	{
+		return firstState_ + pairs_.size();
+	}
+
+	/**
+	 * @brief  Returns the number of product states created by Insert()
+	 */
+	inline size_t size() const
+	{
+		return pairs_.size();
+	}
+
+	/**
+	 * @brief  Imports existing entries from a map from pairs to product states
+	 *
+	 * Imported pairs keep their product states, Insert() returns them as not
+	 * created (hence they are not processed again) and new product states are
+	 * numbered from the size of the map. Must be called after SetRanges() and
+	 * before any Insert().
+	 *
+	 * @param[in]  map  The map (e.g. AutBase::ProductTranslMap)
+	 */
+	template <class Map>
+	void ImportFrom(const Map& map)
+	{
+		assert(pairs_.empty());
+
+		for (const auto& pairStatePair : map)
+		{
+			slot(pairStatePair.first.first, pairStatePair.first.second) =
+				pairStatePair.second;
+		}
+
+		firstState_ = map.size();
+	}
+
+	/**
+	 * @brief  Exports the pairs created by Insert() into a map
+	 *
+	 * Entries already present in the map are kept.
+	 *
+	 * @param[out]  map  The map (e.g. AutBase::ProductTranslMap)
+	 */
+	template <class Map>
+	void ExportTo(Map& map) const
+	{
+		for (size_t i = 0; i < pairs_.size(); ++i)
+		{
+			map.insert(std::make_pair(pairs_[i], firstState_ + i));
+		}
+	}
+};
+
+template <class State>
+const State VATA::Util::ProductTranslTable<State>::NO_STATE =
+	std::numeric_limits<State>::max();
+
+#endif
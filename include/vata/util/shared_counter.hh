@@ -42,7 +42,7 @@ private:
 	};
 
 	const Key& key_;
-	const size_t& states_;
+	size_t states_;
 	const LabelMap& labelMap_;
 	const size_t& rowSize_;
 	Allocator& allocator_;
@@ -55,7 +55,7 @@ protected:
 
 public:
 
-	SharedCounter(const Key& key, const size_t& states, const LabelMap& labelMap,
+	SharedCounter(const Key& key, size_t states, const LabelMap& labelMap,
 		const size_t& rowSize, Allocator& allocator) : key_(key), states_(states),
 		labelMap_(labelMap), rowSize_(rowSize), allocator_(allocator), data_() {}
 
@@ -64,7 +64,7 @@ private:
 		Iterator operator++(int) const {return ++Iterator(pos_);}
 		bool operator==(const Iterator& rhs) const {return iter_ == rhs.iter_;}
 		bool operator!=(const Iterator& rhs) const {return iter_ != rhs.iter_;}
-		const size_t& operator*() const {return *iter_;}
+		const typename T::value_type& operator*() const {return *iter_;}
 	}; // struct Iterator
 
 public:
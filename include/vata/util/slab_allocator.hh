@@ -0,0 +1,146 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Slab allocator header file.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_SLAB_ALLOCATOR_HH_
+#define _VATA_SLAB_ALLOCATOR_HH_
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// insert class to proper namespace
+namespace VATA {
+	namespace Util {
+		class SlabAllocator;
+	}
+}
+
+/**
+ * @brief  An arena of memory
+ *
+ * Memory is carved from large slabs by bumping a pointer and it is never
+ * returned to the arena individually; everything is released at once by
+ * reset() or by the destructor. No destructors of objects placed in the arena
+ * are called, so it is intended for nodes of linked structures (elements of
+ * sets, relations, lists) which are either trivially destructible or recycled
+ * by a CachingAllocator.
+ */
+class VATA::Util::SlabAllocator {
+
+public:
+
+	static const size_t DEFAULT_SLAB_SIZE = 64 * 1024;
+
+private:
+
+	static const size_t ALIGNMENT = alignof(std::max_align_t);
+
+	// slabs together with their sizes
+	std::vector<std::pair<char*, size_t>> slabs_;
+	char* next_;
+	char* end_;
+	size_t slabSize_;
+
+	SlabAllocator(const SlabAllocator&);
+	SlabAllocator& operator=(const SlabAllocator&);
+
+	void newSlab(size_t size) {
+
+		size = std::max(size, this->slabSize_);
+
+		char* slab = static_cast<char*>(::operator new(size));
+
+		this->slabs_.push_back(std::make_pair(slab, size));
+
+		this->next_ = slab;
+		this->end_ = slab + size;
+
+	}
+
+	void releaseSlabs(size_t keep) {
+
+		assert(keep <= this->slabs_.size());
+
+		for (size_t i = keep; i < this->slabs_.size(); ++i)
+			::operator delete(this->slabs_[i].first);
+
+		this->slabs_.resize(keep);
+
+	}
+
+public:
+
+	SlabAllocator(size_t slabSize = DEFAULT_SLAB_SIZE) : slabs_(), next_(nullptr),
+		end_(nullptr), slabSize_(slabSize) {}
+
+	~SlabAllocator() {
+
+		this->releaseSlabs(0);
+
+	}
+
+	void* allocate(size_t size) {
+
+		size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+		if (static_cast<size_t>(this->end_ - this->next_) < size)
+			this->newSlab(size);
+
+		void* ptr = this->next_;
+
+		this->next_ += size;
+
+		return ptr;
+
+	}
+
+	template <class T>
+	T* allocate() {
+
+		return static_cast<T*>(this->allocate(sizeof(T)));
+
+	}
+
+	/**
+	 * @brief  Invalidates all memory handed out so far
+	 *
+	 * The first slab is kept for the following allocations, the others are
+	 * returned to the system.
+	 */
+	void reset() {
+
+		if (this->slabs_.empty())
+			return;
+
+		this->releaseSlabs(1);
+
+		this->next_ = this->slabs_.front().first;
+		this->end_ = this->next_ + this->slabs_.front().second;
+
+	}
+
+	size_t capacity() const {
+
+		size_t result = 0;
+
+		for (auto& slab : this->slabs_)
+			result += slab.second;
+
+		return result;
+
+	}
+
+};
+
+#endif
@@ -14,6 +14,8 @@
 #include <ostream>
 #include <vector>
 
+#include <vata/util/caching_allocator.hh>
+
 namespace VATA {
 		namespace Util {
 				class SmartSet;
@@ -34,10 +36,20 @@ private:
 		Key key_;
 		size_t count_;
 
-		Element(const Key& key, size_t count = 0) : next_(nullptr), key_(key), count_(count) {}
+		Element(const Key& key = Key(), size_t count = 0) : next_(nullptr), key_(key), count_(count) {}
 
 	};
 
+public:
+
+	/**
+	 * Allocator of elements shared by a family of sets (elements are allocated
+	 * on the heap if no allocator is given)
+	 */
+	typedef CachingAllocator<Element> Allocator;
+
+private:
+
 	GCC_DIAG_OFF(effc++)
 	struct Iterator : public std::iterator<std::input_iterator_tag, Key> {
 	GCC_DIAG_ON(effc++)
@@ -96,6 +108,49 @@ private:
 
 	std::vector<Element*> index_;
 
+	Allocator* allocator_;
+
+	Element* newElement(const Key& key, size_t count) {
+
+		if (!this->allocator_)
+			return new Element(key, count);
+
+		auto el = (*this->allocator_)();
+
+		el->next_ = nullptr;
+		el->key_ = key;
+		el->count_ = count;
+
+		return el;
+
+	}
+
+	void deleteElement(Element* el) {
+
+		if (this->allocator_)
+			this->allocator_->reclaim(el);
+		else
+			delete el;
+
+	}
+
+	// releases the elements without updating the index
+	void releaseElements() {
+
+		for (auto el = this->head_.next_; el; ) {
+
+			auto tmp = el;
+
+			el = el->next_;
+
+			this->deleteElement(tmp);
+
+		}
+
+		this->head_.next_ = nullptr;
+
+	}
+
 protected:
 
 	size_t& insert(const Key& key) {
@@ -107,7 +162,7 @@ protected:
 		if (!prev) {
 
 			prev = this->last_;
-			prev->next_ = new Element(key);
+			prev->next_ = this->newElement(key, 0);
 			this->last_ = prev->next_;
 
 			++this->size_;
@@ -141,7 +196,7 @@ protected:
 
 		}
 
-		delete el;
+		this->deleteElement(el);
 
 		prev = nullptr;
 
@@ -149,23 +204,35 @@ protected:
 
 public:
 
-	SmartSet(size_t range = 0) : head_(Key(), 0), last_(&head_), size_(0), index_(range, nullptr) {}
+	SmartSet(size_t range = 0, Allocator* allocator = nullptr) : head_(Key(), 0), last_(&head_),
+		size_(0), index_(range, nullptr), allocator_(allocator) {}
 
 	SmartSet(const SmartSet& s) : head_(Key(), 0), last_(&head_), size_(s.size_),
-		index_(s.index_.size(), nullptr) {
+		index_(s.index_.size(), nullptr), allocator_(s.allocator_) {
 
 		for (auto el = s.head_.next_ ; el; el = el->next_) {
 
 			this->index_[el->key_] = this->last_;
-			this->last_->next_ = new Element(el->key_, el->count_);
+			this->last_->next_ = this->newElement(el->key_, el->count_);
 			this->last_ = this->last_->next_;
 
 		}
 
 	}
 
+	~SmartSet() {
+
+		this->releaseElements();
+
+	}
+
 	SmartSet& operator=(const SmartSet& s) {
 
+		if (this == &s)
+			return *this;
+
+		this->releaseElements();
+
 		std::fill(this->index_.begin(), this->index_.end(), nullptr);
 
 		this->index_.resize(s.index_.size(), nullptr);
@@ -175,7 +242,7 @@ public:
 		for (auto el = s.head_.next_ ; el; el = el->next_) {
 
 			this->index_[el->key_] = this->last_;
-			this->last_->next_ = new Element(el->key_, el->count_);
+			this->last_->next_ = this->newElement(el->key_, el->count_);
 			this->last_ = this->last_->next_;
 
 		}
@@ -188,6 +255,10 @@ public:
 
 	void assignFlat(const SmartSet& s) {
 
+		assert(this != &s);
+
+		this->releaseElements();
+
 		std::fill(this->index_.begin(), this->index_.end(), nullptr);
 
 		this->index_.resize(s.index_.size(), nullptr);
@@ -197,7 +268,7 @@ public:
 		for (auto el = s.head_.next_ ; el; el = el->next_) {
 
 			this->index_[el->key_] = this->last_;
-			this->last_->next_ = new Element(el->key_, 1);
+			this->last_->next_ = this->newElement(el->key_, 1);
 			this->last_ = this->last_->next_;
 
 		}
@@ -310,6 +381,8 @@ public:
 
 	bool empty() const { return this->head_.next_ == nullptr; }
 
+	Allocator* allocator() const { return this->allocator_; }
+
 	size_t size() const { return this->size_; }
 
 	void clear() {
@@ -324,10 +397,11 @@ public:
 
 			this->index_[tmp->key_] = nullptr;
 
-			delete tmp;
+			this->deleteElement(tmp);
 
 		}
 
+		this->head_.next_ = nullptr;
 		this->last_ = &this->head_;
 		this->size_ = 0;
 
@@ -0,0 +1,794 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Header file with kernels of operations on sorted sets of integers.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_SORTED_SET_KERNELS_HH_
+#define _VATA_SORTED_SET_KERNELS_HH_
+
+// Standard library headers
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+
+namespace VATA
+{
+	namespace Util
+	{
+		namespace SortedSetKernels
+		{
+			/**
+			 * @brief  Instruction sets the kernels are implemented for
+			 */
+			enum class InstructionSet
+			{
+				SCALAR,
+				SSE42,
+				AVX2
+			};
+
+			/**
+			 * @brief  Table of the kernels for one instruction set
+			 */
+			struct KernelTable
+			{
+				size_t (*union32)(const uint32_t*, size_t, const uint32_t*, size_t,
+					uint32_t*);
+				size_t (*union64)(const uint64_t*, size_t, const uint64_t*, size_t,
+					uint64_t*);
+				size_t (*intersection32)(const uint32_t*, size_t, const uint32_t*,
+					size_t, uint32_t*);
+				size_t (*intersection64)(const uint64_t*, size_t, const uint64_t*,
+					size_t, uint64_t*);
+				bool (*isSubset32)(const uint32_t*, size_t, const uint32_t*, size_t);
+				bool (*isSubset64)(const uint64_t*, size_t, const uint64_t*, size_t);
+				bool (*intersects32)(const uint32_t*, size_t, const uint32_t*, size_t);
+				bool (*intersects64)(const uint64_t*, size_t, const uint64_t*, size_t);
+			};
+
+			/**
+			 * @brief  Vectorized kernels (defined only when the library is built
+			 *         for x86, see VATA_SIMD_KERNELS)
+			 */
+			extern const KernelTable SSE42_KERNELS;
+			extern const KernelTable AVX2_KERNELS;
+
+			template <class Block>
+			class Algorithms;
+
+			template <class T>
+			struct GenericBlock;
+
+			template <class T, class Enable = void>
+			struct KernelWord;
+
+			template <class T, class Word = typename KernelWord<T>::Type>
+			struct Ops;
+
+			/**
+			 * @brief  Returns the instruction set used by the kernels
+			 *
+			 * The best instruction set supported by the CPU is selected when the
+			 * kernels are called for the first time.
+			 */
+			InstructionSet GetInstructionSet();
+
+			/**
+			 * @brief  Forces the kernels to use given instruction set
+			 *
+			 * Meant for benchmarks and tests, must not be called while the kernels
+			 * are running in another thread.
+			 *
+			 * @returns  @p false if the instruction set is not supported
+			 */
+			bool SetInstructionSet(InstructionSet isa);
+
+			const char* GetInstructionSetName(InstructionSet isa);
+
+			/**
+			 * @brief  Union of sorted sets
+			 *
+			 * @param[out]  out  Output buffer with space for @p lhsSize + @p rhsSize
+			 *                   elements
+			 *
+			 * @returns  Size of the union
+			 */
+			size_t Union(const uint32_t* lhs, size_t lhsSize, const uint32_t* rhs,
+				size_t rhsSize, uint32_t* out);
+			size_t Union(const uint64_t* lhs, size_t lhsSize, const uint64_t* rhs,
+				size_t rhsSize, uint64_t* out);
+
+			/**
+			 * @brief  Intersection of sorted sets
+			 *
+			 * @param[out]  out  Output buffer with space for the smaller of the sets
+			 *
+			 * @returns  Size of the intersection
+			 */
+			size_t Intersection(const uint32_t* lhs, size_t lhsSize,
+				const uint32_t* rhs, size_t rhsSize, uint32_t* out);
+			size_t Intersection(const uint64_t* lhs, size_t lhsSize,
+				const uint64_t* rhs, size_t rhsSize, uint64_t* out);
+
+			/**
+			 * @brief  Checks whether @p smaller is a subset of @p bigger
+			 */
+			bool IsSubset(const uint32_t* smaller, size_t smallerSize,
+				const uint32_t* bigger, size_t biggerSize);
+			bool IsSubset(const uint64_t* smaller, size_t smallerSize,
+				const uint64_t* bigger, size_t biggerSize);
+
+			/**
+			 * @brief  Checks whether sorted sets have a common element
+			 */
+			bool Intersects(const uint32_t* lhs, size_t lhsSize, const uint32_t* rhs,
+				size_t rhsSize);
+			bool Intersects(const uint64_t* lhs, size_t lhsSize, const uint64_t* rhs,
+				size_t rhsSize);
+
+			/**
+			 * @brief  Checks whether sorted containers have a common element
+			 *
+			 * A vector and a container storing the same type contiguously (with
+			 * data()) are checked by Ops, other containers are merged element by
+			 * element.
+			 */
+			template <class T1, class T2>
+			bool Intersects(const T1& lhs, const T2& rhs);
+
+			template <class T, class Contiguous>
+			typename std::enable_if<std::is_same<
+				decltype(std::declval<const Contiguous&>().data()), const T*>::value,
+				bool>::type
+			Intersects(const std::vector<T>& lhs, const Contiguous& rhs);
+		}
+	}
+}
+
+
+/**
+ * @brief  Algorithms on sorted sets
+ *
+ * The algorithms are parameterized by a block comparison @p Block, which
+ * provides the type of elements (@p ValueType), the width of a block (@p
+ * WIDTH) and two functions:
+ *
+ *   * CountLess(block, x) returns the number of elements of a sorted block that
+ *     are smaller than @p x, and
+ *   * MatchMask(lhs, rhs) returns a bit mask of the elements of the block @p
+ *     lhs that occur in the block @p rhs.
+ *
+ * If @p Block::BLOCK_MATCHING is set, intersections and subset tests of sets
+ * of similar sizes compare a block of each set at a time (all pairs of
+ * elements at once), which is suitable for vector instructions. Otherwise, or
+ * for unions, the sets are merged element by element. If one of the sets is
+ * much larger, its elements are searched by galloping and runs between them
+ * are copied at once.
+ *
+ * The algorithms do not use the standard library templates, because they are
+ * compiled with different target flags in several translation units.
+ */
+template <class Block>
+class VATA::Util::SortedSetKernels::Algorithms
+{
+public:   // data types
+
+	typedef typename Block::ValueType ValueType;
+
+public:   // constants
+
+	/**
+	 * @brief  Ratio of sizes of sets from which the larger one is galloped
+	 */
+	static const size_t GALLOP_RATIO = 32;
+
+private:  // constants
+
+	static const size_t WIDTH = Block::WIDTH;
+
+	static const unsigned FULL_MASK = (1U << Block::WIDTH) - 1;
+
+private:  // methods
+
+	/**
+	 * @brief  Returns the first position from @p pos with an element >= @p x
+	 *
+	 * Uses exponential search.
+	 */
+	static size_t gallop(const ValueType* vec, size_t pos, size_t size,
+		const ValueType& x)
+	{
+		size_t step = WIDTH;
+		while ((pos + step <= size) && (vec[pos + step - 1] < x))
+		{	// all elements before pos are smaller than x
+			pos += step;
+			step *= 2;
+		}
+
+		size_t last = (pos + step <= size)? pos + step : size;
+		while (last - pos > WIDTH)
+		{	// binary search down to a single block
+			size_t middle = pos + (last - pos) / 2;
+			if (vec[middle] < x)
+			{
+				pos = middle + 1;
+			}
+			else
+			{
+				last = middle;
+			}
+		}
+
+		if (last - pos == WIDTH)
+		{
+			return pos + Block::CountLess(vec + pos, x);
+		}
+
+		while ((pos < last) && (vec[pos] < x))
+		{
+			++pos;
+		}
+
+		return pos;
+	}
+
+	static ValueType* copy(const ValueType* first, const ValueType* last,
+		ValueType* out, std::true_type /* trivially copyable */)
+	{
+		__builtin_memcpy(out, first, (last - first) * sizeof(ValueType));
+		return out + (last - first);
+	}
+
+	static ValueType* copy(const ValueType* first, const ValueType* last,
+		ValueType* out, std::false_type /* trivially copyable */)
+	{
+		while (first != last)
+		{
+			*out++ = *first++;
+		}
+
+		return out;
+	}
+
+	/**
+	 * @brief  Copies a run of elements, by memcpy if that is allowed for them
+	 */
+	static ValueType* copy(const ValueType* first, const ValueType* last,
+		ValueType* out)
+	{
+		return copy(first, last, out,
+			std::is_trivially_copyable<ValueType>());
+	}
+
+	/**
+	 * @brief  Stores elements of @p block selected by @p mask
+	 */
+	static ValueType* store(const ValueType* block, unsigned mask,
+		ValueType* out)
+	{
+		while (mask)
+		{
+			*out++ = block[__builtin_ctz(mask)];
+			mask &= mask - 1;
+		}
+
+		return out;
+	}
+
+	static bool isSkewed(size_t smallerSize, size_t biggerSize)
+	{
+		return biggerSize / GALLOP_RATIO >= smallerSize;
+	}
+
+	/**
+	 * @brief  Union of a set with a much larger one
+	 */
+	static size_t gallopingUnion(const ValueType* smaller, size_t smallerSize,
+		const ValueType* bigger, size_t biggerSize, ValueType* out)
+	{
+		ValueType* outIt = out;
+		size_t biggerPos = 0;
+		for (size_t smallerPos = 0; smallerPos < smallerSize; ++smallerPos)
+		{
+			const ValueType& x = smaller[smallerPos];
+			size_t end = gallop(bigger, biggerPos, biggerSize, x);
+			outIt = copy(bigger + biggerPos, bigger + end, outIt);
+			biggerPos = end;
+			if ((biggerPos < biggerSize) && !(x < bigger[biggerPos]))
+			{	// in case they are equal
+				++biggerPos;
+			}
+
+			*outIt++ = x;
+		}
+
+		outIt = copy(bigger + biggerPos, bigger + biggerSize, outIt);
+		return outIt - out;
+	}
+
+	/**
+	 * @brief  Compares blocks of sets while both sets have a whole block
+	 *
+	 * Calls @p retire(pos, mask) whenever a block of @p lhs at @p pos is
+	 * processed, @p mask marks its elements found in @p rhs. If @p retire
+	 * returns @p false, the comparison stops. At the end, @p lhsPos and
+	 * @p rhsPos point to the first blocks that have not been processed and
+	 * @p mask marks the elements of the block at @p lhsPos found so far (they
+	 * are all smaller than the element at @p rhsPos).
+	 */
+	template <class Retire>
+	static bool matchBlocks(const ValueType* lhs, size_t lhsSize,
+		const ValueType* rhs, size_t rhsSize, size_t& lhsPos, size_t& rhsPos,
+		unsigned& mask, Retire retire)
+	{
+		mask = 0;
+		while ((lhsPos + WIDTH <= lhsSize) && (rhsPos + WIDTH <= rhsSize))
+		{
+			mask |= Block::MatchMask(lhs + lhsPos, rhs + rhsPos);
+
+			const ValueType& lhsMax = lhs[lhsPos + WIDTH - 1];
+			const ValueType& rhsMax = rhs[rhsPos + WIDTH - 1];
+			if (!(rhsMax < lhsMax))
+			{	// the block of lhs cannot match any further element of rhs
+				if (!retire(lhsPos, mask))
+				{
+					return false;
+				}
+
+				mask = 0;
+				lhsPos += WIDTH;
+			}
+
+			if (!(lhsMax < rhsMax))
+			{	// the block of rhs cannot match any further element of lhs
+				rhsPos += WIDTH;
+			}
+		}
+
+		return true;
+	}
+
+public:   // methods
+
+	static size_t Union(const ValueType* lhs, size_t lhsSize,
+		const ValueType* rhs, size_t rhsSize, ValueType* out)
+	{
+		if (isSkewed(lhsSize, rhsSize))
+		{
+			return gallopingUnion(lhs, lhsSize, rhs, rhsSize, out);
+		}
+
+		if (isSkewed(rhsSize, lhsSize))
+		{
+			return gallopingUnion(rhs, rhsSize, lhs, lhsSize, out);
+		}
+
+		const ValueType* lhsIt = lhs;
+		const ValueType* lhsEnd = lhs + lhsSize;
+		const ValueType* rhsIt = rhs;
+		const ValueType* rhsEnd = rhs + rhsSize;
+		ValueType* outIt = out;
+
+		while ((lhsIt != lhsEnd) && (rhsIt != rhsEnd))
+		{
+			if (*lhsIt < *rhsIt)
+			{
+				*outIt++ = *lhsIt++;
+			}
+			else if (*rhsIt < *lhsIt)
+			{
+				*outIt++ = *rhsIt++;
+			}
+			else
+			{	// in case they are equal
+				*outIt++ = *lhsIt++;
+				++rhsIt;
+			}
+		}
+
+		outIt = copy(lhsIt, lhsEnd, outIt);
+		outIt = copy(rhsIt, rhsEnd, outIt);
+
+		return outIt - out;
+	}
+
+	static size_t Intersection(const ValueType* lhs, size_t lhsSize,
+		const ValueType* rhs, size_t rhsSize, ValueType* out)
+	{
+		if (lhsSize > rhsSize)
+		{	// make lhs the smaller set
+			return Intersection(rhs, rhsSize, lhs, lhsSize, out);
+		}
+
+		size_t lhsPos = 0;
+		size_t rhsPos = 0;
+		ValueType* outIt = out;
+
+		if (isSkewed(lhsSize, rhsSize))
+		{	// search elements of lhs in rhs
+			for (; (lhsPos < lhsSize) && (rhsPos < rhsSize); ++lhsPos)
+			{
+				rhsPos = gallop(rhs, rhsPos, rhsSize, lhs[lhsPos]);
+				if ((rhsPos < rhsSize) && !(lhs[lhsPos] < rhs[rhsPos]))
+				{
+					*outIt++ = rhs[rhsPos++];
+				}
+			}
+
+			return outIt - out;
+		}
+
+		if (Block::BLOCK_MATCHING)
+		{
+			unsigned mask;
+			matchBlocks(lhs, lhsSize, rhs, rhsSize, lhsPos, rhsPos, mask,
+				[lhs, &outIt](size_t pos, unsigned posMask) -> bool
+				{
+					outIt = store(lhs + pos, posMask, outIt);
+					return true;
+				});
+
+			outIt = store(lhs + lhsPos, mask, outIt);
+		}
+
+		const ValueType* lhsIt = lhs + lhsPos;
+		const ValueType* lhsEnd = lhs + lhsSize;
+		const ValueType* rhsIt = rhs + rhsPos;
+		const ValueType* rhsEnd = rhs + rhsSize;
+
+		while ((lhsIt != lhsEnd) && (rhsIt != rhsEnd))
+		{
+			if (*lhsIt < *rhsIt)
+			{
+				++lhsIt;
+			}
+			else if (*rhsIt < *lhsIt)
+			{
+				++rhsIt;
+			}
+			else
+			{	// in case they are equal
+				*outIt++ = *lhsIt++;
+				++rhsIt;
+			}
+		}
+
+		return outIt - out;
+	}
+
+	static bool IsSubset(const ValueType* smaller, size_t smallerSize,
+		const ValueType* bigger, size_t biggerSize)
+	{
+		if (smallerSize > biggerSize)
+		{
+			return false;
+		}
+
+		if (smallerSize == 0)
+		{
+			return true;
+		}
+
+		if ((smaller[0] < bigger[0]) ||
+			(bigger[biggerSize - 1] < smaller[smallerSize - 1]))
+		{	// the bounds do not fit
+			return false;
+		}
+
+		size_t smallerPos = 0;
+		size_t biggerPos = 0;
+		unsigned mask = 0;
+
+		bool galloping = isSkewed(smallerSize, biggerSize);
+		if (!galloping && Block::BLOCK_MATCHING)
+		{
+			if (!matchBlocks(smaller, smallerSize, bigger, biggerSize, smallerPos,
+				biggerPos, mask, [](size_t, unsigned posMask) -> bool
+				{
+					return posMask == FULL_MASK;
+				}))
+			{	// an element is missing
+				return false;
+			}
+		}
+
+		size_t blockPos = smallerPos;
+		for (; smallerPos < smallerSize; ++smallerPos)
+		{
+			if ((smallerPos - blockPos < WIDTH) &&
+				(mask & (1U << (smallerPos - blockPos))))
+			{	// already found by block matching
+				continue;
+			}
+
+			if (smallerSize - smallerPos > biggerSize - biggerPos)
+			{	// not enough elements left
+				return false;
+			}
+
+			const ValueType& x = smaller[smallerPos];
+			if (galloping)
+			{
+				biggerPos = gallop(bigger, biggerPos, biggerSize, x);
+			}
+			else
+			{
+				while ((biggerPos < biggerSize) && (bigger[biggerPos] < x))
+				{
+					++biggerPos;
+				}
+			}
+
+			if ((biggerPos == biggerSize) || (x < bigger[biggerPos]))
+			{	// the element is missing
+				return false;
+			}
+
+			++biggerPos;
+		}
+
+		return true;
+	}
+
+	static bool Intersects(const ValueType* lhs, size_t lhsSize,
+		const ValueType* rhs, size_t rhsSize)
+	{
+		if (lhsSize > rhsSize)
+		{	// make lhs the smaller set
+			return Intersects(rhs, rhsSize, lhs, lhsSize);
+		}
+
+		size_t lhsPos = 0;
+		size_t rhsPos = 0;
+
+		if (isSkewed(lhsSize, rhsSize))
+		{	// search elements of lhs in rhs
+			for (; (lhsPos < lhsSize) && (rhsPos < rhsSize); ++lhsPos)
+			{
+				rhsPos = gallop(rhs, rhsPos, rhsSize, lhs[lhsPos]);
+				if ((rhsPos < rhsSize) && !(lhs[lhsPos] < rhs[rhsPos]))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		if (Block::BLOCK_MATCHING)
+		{
+			unsigned mask;
+			if (!matchBlocks(lhs, lhsSize, rhs, rhsSize, lhsPos, rhsPos, mask,
+				[](size_t, unsigned posMask) -> bool { return posMask == 0; }) ||
+				mask)
+			{	// a common element found
+				return true;
+			}
+		}
+
+		while ((lhsPos < lhsSize) && (rhsPos < rhsSize))
+		{
+			if (lhs[lhsPos] < rhs[rhsPos])
+			{
+				++lhsPos;
+			}
+			else if (rhs[rhsPos] < lhs[lhsPos])
+			{
+				++rhsPos;
+			}
+			else
+			{	// in case they are equal
+				return true;
+			}
+		}
+
+		return false;
+	}
+};
+
+template <class Block>
+const size_t VATA::Util::SortedSetKernels::Algorithms<Block>::GALLOP_RATIO;
+
+template <class Block>
+const size_t VATA::Util::SortedSetKernels::Algorithms<Block>::WIDTH;
+
+template <class Block>
+const unsigned VATA::Util::SortedSetKernels::Algorithms<Block>::FULL_MASK;
+
+
+/**
+ * @brief  Block comparison of arbitrary ordered elements
+ */
+template <class T>
+struct VATA::Util::SortedSetKernels::GenericBlock
+{
+	typedef T ValueType;
+
+	static const size_t WIDTH = 4;
+
+	static const bool BLOCK_MATCHING = false;
+
+	static size_t CountLess(const T* block, const T& x)
+	{
+		return (block[0] < x) + (block[1] < x) + (block[2] < x) + (block[3] < x);
+	}
+
+	static unsigned MatchMask(const T* lhs, const T* rhs)
+	{
+		unsigned mask = 0;
+		for (size_t i = 0; i < WIDTH; ++i)
+		{
+			for (size_t j = 0; j < WIDTH; ++j)
+			{
+				mask |= (lhs[i] == rhs[j]) << i;
+			}
+		}
+
+		return mask;
+	}
+};
+
+template <class T>
+const size_t VATA::Util::SortedSetKernels::GenericBlock<T>::WIDTH;
+
+template <class T>
+const bool VATA::Util::SortedSetKernels::GenericBlock<T>::BLOCK_MATCHING;
+
+
+/**
+ * @brief  The word type of the kernels that handle @p T (@p void if none)
+ */
+template <class T, class Enable>
+struct VATA::Util::SortedSetKernels::KernelWord
+{
+	typedef void Type;
+};
+
+template <class T>
+struct VATA::Util::SortedSetKernels::KernelWord<T,
+	typename std::enable_if<std::is_integral<T>::value &&
+		std::is_unsigned<T>::value && (sizeof(T) == 4)>::type>
+{
+	typedef uint32_t Type;
+};
+
+template <class T>
+struct VATA::Util::SortedSetKernels::KernelWord<T,
+	typename std::enable_if<std::is_integral<T>::value &&
+		std::is_unsigned<T>::value && (sizeof(T) == 8)>::type>
+{
+	typedef uint64_t Type;
+};
+
+
+/**
+ * @brief  Operations on sorted arrays of @p T
+ *
+ * Arrays of unsigned integers are handled by the kernels selected at runtime
+ * (tiny arrays inline, as a call of the kernel would not pay off), other types
+ * by the generic algorithms.
+ */
+template <class T, class Word>
+struct VATA::Util::SortedSetKernels::Ops
+{
+	static_assert(sizeof(T) == sizeof(Word), "Kernel word of a wrong size");
+
+	typedef VATA::Util::SortedSetKernels::Algorithms<
+		VATA::Util::SortedSetKernels::GenericBlock<T>> InlineAlgorithms;
+
+	static const bool HAS_KERNEL = true;
+
+	/**
+	 * @brief  Total size of arrays from which the kernels are called
+	 */
+	static const size_t KERNEL_SIZE = 16;
+
+	static const Word* words(const T* vec)
+	{
+		return reinterpret_cast<const Word*>(vec);
+	}
+
+	static size_t Union(const T* lhs, size_t lhsSize, const T* rhs,
+		size_t rhsSize, T* out)
+	{
+		if (lhsSize + rhsSize < KERNEL_SIZE)
+		{
+			return InlineAlgorithms::Union(lhs, lhsSize, rhs, rhsSize, out);
+		}
+
+		return SortedSetKernels::Union(words(lhs), lhsSize, words(rhs), rhsSize,
+			reinterpret_cast<Word*>(out));
+	}
+
+	static size_t Intersection(const T* lhs, size_t lhsSize, const T* rhs,
+		size_t rhsSize, T* out)
+	{
+		if (lhsSize + rhsSize < KERNEL_SIZE)
+		{
+			return InlineAlgorithms::Intersection(lhs, lhsSize, rhs, rhsSize, out);
+		}
+
+		return SortedSetKernels::Intersection(words(lhs), lhsSize, words(rhs),
+			rhsSize, reinterpret_cast<Word*>(out));
+	}
+
+	static bool IsSubset(const T* smaller, size_t smallerSize, const T* bigger,
+		size_t biggerSize)
+	{
+		if (smallerSize + biggerSize < KERNEL_SIZE)
+		{
+			return InlineAlgorithms::IsSubset(smaller, smallerSize, bigger,
+				biggerSize);
+		}
+
+		return SortedSetKernels::IsSubset(words(smaller), smallerSize,
+			words(bigger), biggerSize);
+	}
+
+	static bool Intersects(const T* lhs, size_t lhsSize, const T* rhs,
+		size_t rhsSize)
+	{
+		if (lhsSize + rhsSize < KERNEL_SIZE)
+		{
+			return InlineAlgorithms::Intersects(lhs, lhsSize, rhs, rhsSize);
+		}
+
+		return SortedSetKernels::Intersects(words(lhs), lhsSize, words(rhs),
+			rhsSize);
+	}
+};
+
+template <class T, class Word>
+const size_t VATA::Util::SortedSetKernels::Ops<T, Word>::KERNEL_SIZE;
+
+template <class T>
+struct VATA::Util::SortedSetKernels::Ops<T, void> :
+	public VATA::Util::SortedSetKernels::Algorithms<
+		VATA::Util::SortedSetKernels::GenericBlock<T>>
+{
+	static const bool HAS_KERNEL = false;
+};
+
+template <class T1, class T2>
+bool VATA::Util::SortedSetKernels::Intersects(const T1& lhs, const T2& rhs)
+{
+	auto lhsIt = lhs.begin();
+	auto rhsIt = rhs.begin();
+	while ((lhsIt != lhs.end()) && (rhsIt != rhs.end()))
+	{
+		if (*lhsIt < *rhsIt)
+		{
+			++lhsIt;
+		}
+		else if (*rhsIt < *lhsIt)
+		{
+			++rhsIt;
+		}
+		else
+		{	// in case they are equal
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template <class T, class Contiguous>
+typename std::enable_if<std::is_same<
+	decltype(std::declval<const Contiguous&>().data()), const T*>::value,
+	bool>::type
+VATA::Util::SortedSetKernels::Intersects(const std::vector<T>& lhs,
+	const Contiguous& rhs)
+{
+	return Ops<T>::Intersects(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+}
+
+#endif
@@ -17,6 +17,7 @@
 // VATA headers
 #include <vata/vata.hh>
 #include <vata/util/caching_allocator.hh>
+#include <vata/util/slab_allocator.hh>
 
 namespace VATA
 {
@@ -216,6 +217,13 @@ public:
 
 	SplittingRelation(size_t maxSize) : columns_(maxSize), rows_(maxSize), size_(), allocator_() {}
 
+	/**
+	 * Elements of the relation are placed in @p slab, which has to outlive the
+	 * relation
+	 */
+	SplittingRelation(size_t maxSize, SlabAllocator& slab) : columns_(maxSize), rows_(maxSize),
+		size_(), allocator_(slab) {}
+
 	~SplittingRelation() {
 
 		for (size_t i = 0; i < this->size_; ++i) {
@@ -254,7 +262,9 @@ public:
 
 				assert(j < index.size());
 
-				el = new Element(i, j);
+				el = this->allocator_();
+				el->col_ = j;
+				el->row_ = i;
 				el->up_ = lastV[j];
 				el->left_ = last;
 
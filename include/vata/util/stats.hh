@@ -0,0 +1,198 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Header file with the registry of statistics collected by the library.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_STATS_HH_
+#define _VATA_STATS_HH_
+
+// Standard library headers
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <stdint.h>
+
+
+namespace VATA
+{
+	namespace Util
+	{
+		namespace Stats
+		{
+			/**
+			 * @brief  Kinds of statistics
+			 */
+			enum class Kind
+			{
+				COUNTER,  ///< sum of the added values
+				MAXIMUM,  ///< high-water mark of the reported values
+				TIMER     ///< total time spent in a scope (in nanoseconds)
+			};
+
+			class Entry;
+			class ScopedTimer;
+
+			/**
+			 * @brief  Returns the entry with the given name
+			 *
+			 * The entry is created when it is requested for the first time. The
+			 * returned reference stays valid for the lifetime of the program.
+			 */
+			Entry& Register(const std::string& name, Kind kind);
+
+			/**
+			 * @brief  Sets the values of all entries to zero
+			 */
+			void Reset();
+
+			/**
+			 * @brief  Returns the values of all entries ordered by their names
+			 */
+			std::map<std::string, uint64_t> GetValues();
+
+			/**
+			 * @brief  Returns the value of an entry (zero for unknown names)
+			 */
+			uint64_t GetValue(const std::string& name);
+
+			/**
+			 * @brief  Prints all entries as a JSON object
+			 */
+			void PrintJSON(std::ostream& os);
+
+			/**
+			 * @brief  Returns @p true if the library collects statistics (it is
+			 *         built with VATA_STATS)
+			 */
+			bool IsEnabled();
+		}
+	}
+}
+
+
+/**
+ * @brief  A single statistic
+ *
+ * Updates are lock-free so that entries may be shared between threads.
+ */
+class VATA::Util::Stats::Entry
+{
+private:  // data members
+
+	Kind kind_;
+
+	std::atomic<uint64_t> value_;
+
+private:  // methods
+
+	Entry(const Entry&);
+	Entry& operator=(const Entry&);
+
+public:   // methods
+
+	explicit Entry(Kind kind) :
+		kind_(kind),
+		value_(0)
+	{ }
+
+	inline Kind GetKind() const
+	{
+		return kind_;
+	}
+
+	inline uint64_t GetValue() const
+	{
+		return value_.load(std::memory_order_relaxed);
+	}
+
+	inline void Add(uint64_t value)
+	{
+		value_.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	inline void Max(uint64_t value)
+	{
+		uint64_t old = value_.load(std::memory_order_relaxed);
+		while ((old < value) &&
+			!value_.compare_exchange_weak(old, value, std::memory_order_relaxed))
+		{ }
+	}
+
+	inline void Reset()
+	{
+		value_.store(0, std::memory_order_relaxed);
+	}
+};
+
+
+/**
+ * @brief  Adds the time spent in its scope to a timer entry
+ */
+class VATA::Util::Stats::ScopedTimer
+{
+private:  // data members
+
+	Entry& entry_;
+
+	std::chrono::steady_clock::time_point start_;
+
+private:  // methods
+
+	ScopedTimer(const ScopedTimer&);
+	ScopedTimer& operator=(const ScopedTimer&);
+
+public:   // methods
+
+	explicit ScopedTimer(Entry& entry) :
+		entry_(entry),
+		start_(std::chrono::steady_clock::now())
+	{ }
+
+	~ScopedTimer()
+	{
+		entry_.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start_).count());
+	}
+};
+
+
+// The macros below are used for instrumentation of the library. Without
+// VATA_STATS they expand to nothing, so that the hot paths are not slowed down.
+// Each use site looks its entry up only once.
+#ifdef VATA_STATS
+
+#define VATA_STATS_ENTRY_(name, kind) \
+	([]() -> VATA::Util::Stats::Entry& { \
+		static VATA::Util::Stats::Entry& entry = \
+			VATA::Util::Stats::Register(name, VATA::Util::Stats::Kind::kind); \
+		return entry; }())
+
+#define VATA_STATS_CONCAT_(x, y) x ## y
+#define VATA_STATS_NAME_(x, y) VATA_STATS_CONCAT_(x, y)
+
+#define VATA_STATS_ADD(name, value) \
+	VATA_STATS_ENTRY_(name, COUNTER).Add(value)
+#define VATA_STATS_INC(name) VATA_STATS_ADD(name, 1)
+#define VATA_STATS_MAX(name, value) \
+	VATA_STATS_ENTRY_(name, MAXIMUM).Max(value)
+#define VATA_STATS_TIMER(name) \
+	VATA::Util::Stats::ScopedTimer VATA_STATS_NAME_(vataStatsTimer, __LINE__)( \
+		VATA_STATS_ENTRY_(name, TIMER))
+
+#else
+
+#define VATA_STATS_ADD(name, value) ((void)0)
+#define VATA_STATS_INC(name) ((void)0)
+#define VATA_STATS_MAX(name, value) ((void)0)
+#define VATA_STATS_TIMER(name) ((void)0)
+
+#endif
+
+#endif
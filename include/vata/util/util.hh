@@ -11,6 +11,8 @@
 #ifndef _VATA_UTIL_HH_
 #define _VATA_UTIL_HH_
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 // VATA headers
@@ -43,6 +45,9 @@ namespace VATA
 			const VATA::AutBase::StateToStateMap* translMapLhs = nullptr,
 			const VATA::AutBase::StateToStateMap* translMapRhs = nullptr);
 
+		class ProductStateNames;
+		class UnionStateNames;
+
 		constexpr inline size_t IntExp2(size_t val)
 		{
 			return (val == 0)? 1 : 2 * IntExp2(val - 1);
@@ -50,6 +55,91 @@ namespace VATA
 	}
 }
 
+/**
+ * @brief  Lazy names of states of a product of two automata
+ *
+ * In contrast to CreateProductStringToStateMap(), the name of a state of the
+ * product, e.g., @p [a_1|b_2], is created only when it is asked for; only the
+ * pair of states is kept for every state of the product. The dictionaries
+ * need to live as long as the object.
+ */
+class VATA::Util::ProductStateNames
+{
+private:  // data types
+
+	typedef VATA::AutBase::StateType StateType;
+	typedef VATA::AutBase::StatePair StatePair;
+	typedef VATA::AutBase::StringToStateDict StringToStateDict;
+
+	typedef std::unordered_map<StateType, StatePair> ProductToPairMap;
+
+private:  // data members
+
+	const StringToStateDict& lhsDict_;
+	const StringToStateDict& rhsDict_;
+	ProductToPairMap productToPair_;
+
+private:  // methods
+
+	ProductStateNames(const ProductStateNames&);
+	ProductStateNames& operator=(const ProductStateNames&);
+
+public:   // methods
+
+	ProductStateNames(
+		const StringToStateDict& lhsDict,
+		const StringToStateDict& rhsDict,
+		const VATA::AutBase::ProductTranslMap& translMap);
+
+	std::string operator()(const StateType& state) const;
+};
+
+
+/**
+ * @brief  Lazy names of states of a union of two automata
+ *
+ * The name of a state of the union, e.g., @p a_1, is created only when it is
+ * asked for. If a translation map is not given, the states of the respective
+ * automaton are not renamed in the union.
+ */
+class VATA::Util::UnionStateNames
+{
+private:  // data types
+
+	typedef VATA::AutBase::StateType StateType;
+	typedef VATA::AutBase::StateToStateMap StateToStateMap;
+	typedef VATA::AutBase::StringToStateDict StringToStateDict;
+
+	// the state of the operand and whether the operand is the right one
+	typedef std::unordered_map<StateType, std::pair<StateType, bool>>
+		UnionToOperandMap;
+
+private:  // data members
+
+	const StringToStateDict& lhsDict_;
+	const StringToStateDict& rhsDict_;
+	UnionToOperandMap unionToOperand_;
+
+private:  // methods
+
+	UnionStateNames(const UnionStateNames&);
+	UnionStateNames& operator=(const UnionStateNames&);
+
+	void addOperand(const StringToStateDict& dict,
+		const StateToStateMap* translMap, bool isRhs);
+
+public:   // methods
+
+	UnionStateNames(
+		const StringToStateDict& lhsDict,
+		const StringToStateDict& rhsDict,
+		const StateToStateMap* translMapLhs = nullptr,
+		const StateToStateMap* translMapRhs = nullptr);
+
+	std::string operator()(const StateType& state) const;
+};
+
+
 template <class Container, class Translator>
 Container VATA::Util::RebindMap(const Container& container,
 	const Translator& transl)
@@ -7,6 +7,7 @@
  *    Header file with global declarations. It contains:
  *      * macros for easy logging
  *      * macro for suppressing certain GCC warnings
+ *      * the integer type of identifiers
  *
  *****************************************************************************/
 
@@ -15,7 +16,9 @@
 
 // Standard library headers
 #include <cassert>
+#include <cstddef>
 #include <iostream>
+#include <stdint.h>
 
 //#define NDEBUG
 
@@ -54,4 +57,19 @@
 # define GCC_DIAG_ON(x)
 #endif
 
+namespace VATA
+{
+	/**
+	 * @brief  Integer type of identifiers of states and (explicit) symbols
+	 *
+	 * 64-bit by default, 32-bit if VATA_32BIT_IDS is defined (which roughly
+	 * halves the size of transition tables and tuples).
+	 */
+#ifdef VATA_32BIT_IDS
+	typedef uint32_t IdType;
+#else
+	typedef size_t IdType;
+#endif
+}
+
 #endif
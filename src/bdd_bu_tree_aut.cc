@@ -23,6 +23,8 @@ using VATA::Util::Convert;
 
 BDDTopDownTreeAut BDDBottomUpTreeAut::GetTopDownAut() const
 {
+	CheckEncoding();
+
 	GCC_DIAG_OFF(effc++)    // suppress missing virtual destructor warning
 	class InverterApplyFunctor :
 		public VATA::MTBDDPkg::Apply2Functor<InverterApplyFunctor, StateSet,
@@ -88,7 +90,7 @@ BDDTopDownTreeAut BDDBottomUpTreeAut::GetTopDownAut() const
 			SymbolType prefix(BDDTopDownTreeAut::SYMBOL_ARITY_LENGTH,
 				checkedTuple.size());
 			TransMTBDD extendedBdd = tupleBddPair.second.ExtendWith(prefix,
-				VATA::SymbolicAutBase::SYMBOL_SIZE);
+				VATA::SymbolicAutBase::GetSymbolSize());
 
 			result.SetMtbdd(state, invertFunc(
 				extendedBdd, result.GetMtbdd(state)));
@@ -0,0 +1,359 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of language equivalence on BDD bottom-up tree automata.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/bdd_bu_tree_aut.hh>
+#include <vata/bdd_bu_tree_aut_op.hh>
+#include <vata/tree_equiv_up.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+using VATA::BDDBottomUpTreeAut;
+
+namespace
+{
+	GCC_DIAG_OFF(effc++)    // suppress missing virtual destructor warning
+	/**
+	 * @brief  Collects the distinct pairs of leaves of two MTBDDs
+	 */
+	class PairCollectorApplyFunctor :
+		public VATA::MTBDDPkg::VoidApply2Functor<PairCollectorApplyFunctor,
+		BDDBottomUpTreeAut::StateSet, BDDBottomUpTreeAut::StateSet>
+	{
+	GCC_DIAG_ON(effc++)
+	public:   // data types
+
+		typedef BDDBottomUpTreeAut::StateSet StateSet;
+		typedef std::vector<BDDBottomUpTreeAut::StateType> StateVector;
+		typedef std::set<std::pair<StateVector, StateVector>> PairSet;
+
+	private:  // data members
+
+		PairSet pairs_;
+
+	public:   // methods
+
+		PairCollectorApplyFunctor() :
+			pairs_()
+		{ }
+
+		inline const PairSet& GetPairs() const
+		{
+			return pairs_;
+		}
+
+		inline void ApplyOperation(const StateSet& lhs, const StateSet& rhs)
+		{
+			pairs_.insert(std::make_pair(StateVector(lhs.begin(), lhs.end()),
+				StateVector(rhs.begin(), rhs.end())));
+		}
+	};
+
+	GCC_DIAG_OFF(effc++)    // suppress missing virtual destructor warning
+	/**
+	 * @brief  Collects the leaves of an MTBDD under a symbol
+	 */
+	class SymbolCollectorApplyFunctor :
+		public VATA::MTBDDPkg::VoidApply2Functor<SymbolCollectorApplyFunctor,
+		BDDBottomUpTreeAut::StateSet, bool>
+	{
+	GCC_DIAG_ON(effc++)
+	public:   // data types
+
+		typedef BDDBottomUpTreeAut::StateSet StateSet;
+
+	private:  // data members
+
+		StateSet states_;
+
+	public:   // methods
+
+		SymbolCollectorApplyFunctor() :
+			states_()
+		{ }
+
+		inline const StateSet& GetStates() const
+		{
+			return states_;
+		}
+
+		inline void ApplyOperation(const StateSet& lhs, const bool& rhs)
+		{
+			if (rhs)
+			{
+				states_ = states_.Union(lhs);
+			}
+		}
+	};
+
+
+	/**
+	 * @brief  Post-images of tuples of macro-states of two BDD bottom-up
+	 *         automata for UpwardEquivalenceChecker
+	 *
+	 * The post-image of a tuple is the union of the MTBDDs of the tuples of
+	 * states it contains, so post-images over all symbols are given by the
+	 * distinct pairs of leaves of the unions of both automata.
+	 */
+	class BDDUpwardEquivalence
+	{
+	public:   // data types
+
+		typedef BDDBottomUpTreeAut::StateType StateType;
+		typedef BDDBottomUpTreeAut::SymbolType SymbolType;
+
+		typedef std::vector<StateType> StateSet;
+		typedef std::vector<const StateSet*> MacroTuple;
+
+	private:  // data types
+
+		typedef BDDBottomUpTreeAut::StateTuple StateTuple;
+		typedef BDDBottomUpTreeAut::TransMTBDD TransMTBDD;
+		typedef VATA::MTBDDPkg::OndriksMTBDD<bool> BDD;
+
+		typedef std::unordered_map<StateType, std::vector<StateTuple>> TupleIndex;
+		typedef std::vector<std::vector<std::set<StateType>>> PositionIndex;
+
+	private:  // data members
+
+		const BDDBottomUpTreeAut& lhs_;
+		const BDDBottomUpTreeAut& rhs_;
+
+		/// tuples of the automata indexed by their first state
+		TupleIndex lhsTuples_;
+		TupleIndex rhsTuples_;
+
+		/// states of the tuples for every rank and position
+		PositionIndex lhsPositions_;
+		PositionIndex rhsPositions_;
+
+		std::vector<size_t> ranks_;
+
+	private:  // methods
+
+		static void indexTuples(const BDDBottomUpTreeAut& aut, TupleIndex& index,
+			PositionIndex& positions, std::set<size_t>& ranks)
+		{
+			for (auto tupleBddPair : aut.GetTransTable())
+			{
+				const StateTuple& tuple = tupleBddPair.first;
+				if (tuple.empty())
+				{
+					continue;
+				}
+
+				index[tuple.front()].push_back(tuple);
+				ranks.insert(tuple.size());
+
+				if (positions.size() <= tuple.size())
+				{
+					positions.resize(tuple.size() + 1);
+				}
+
+				positions[tuple.size()].resize(tuple.size());
+				for (size_t i = 0; i < tuple.size(); ++i)
+				{
+					positions[tuple.size()][i].insert(tuple[i]);
+				}
+			}
+		}
+
+		static bool occursAt(const PositionIndex& positions, size_t rank,
+			size_t position, const StateSet& states)
+		{
+			if ((rank >= positions.size()) || positions[rank].empty())
+			{
+				return false;
+			}
+
+			for (const StateType& state : states)
+			{
+				if (positions[rank][position].count(state) > 0)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		static TransMTBDD getPostMtbdd(const BDDBottomUpTreeAut& aut,
+			const TupleIndex& index, const MacroTuple& macroTuple)
+		{
+			if (macroTuple.empty())
+			{
+				return aut.GetMtbdd(StateTuple());
+			}
+
+			BDDBottomUpTreeAut::UnionApplyFunctor unioner;
+			TransMTBDD result((BDDBottomUpTreeAut::StateSet()));
+
+			for (const StateType& state : *macroTuple.front())
+			{
+				auto itIndex = index.find(state);
+				if (itIndex == index.end())
+				{
+					continue;
+				}
+
+				for (const StateTuple& tuple : itIndex->second)
+				{
+					if (tuple.size() != macroTuple.size())
+					{
+						continue;
+					}
+
+					bool matches = true;
+					for (size_t i = 1; i < tuple.size(); ++i)
+					{
+						if (!std::binary_search(macroTuple[i]->begin(),
+							macroTuple[i]->end(), tuple[i]))
+						{
+							matches = false;
+							break;
+						}
+					}
+
+					if (matches)
+					{
+						result = unioner(result, aut.GetMtbdd(tuple));
+					}
+				}
+			}
+
+			return result;
+		}
+
+		static StateSet getSymbolPost(const TransMTBDD& mtbdd, const BDD& symbolBdd)
+		{
+			SymbolCollectorApplyFunctor collector;
+			collector(mtbdd, symbolBdd);
+
+			return StateSet(collector.GetStates().begin(),
+				collector.GetStates().end());
+		}
+
+	public:   // methods
+
+		BDDUpwardEquivalence(const BDDBottomUpTreeAut& lhs,
+			const BDDBottomUpTreeAut& rhs) :
+			lhs_(lhs),
+			rhs_(rhs),
+			lhsTuples_(),
+			rhsTuples_(),
+			lhsPositions_(),
+			rhsPositions_(),
+			ranks_()
+		{
+			std::set<size_t> ranks;
+			indexTuples(lhs, lhsTuples_, lhsPositions_, ranks);
+			indexTuples(rhs, rhsTuples_, rhsPositions_, ranks);
+
+			ranks_.assign(ranks.begin(), ranks.end());
+		}
+
+		const std::vector<size_t>& GetRanks() const
+		{
+			return ranks_;
+		}
+
+		bool IsLhsFinal(const StateType& state) const
+		{
+			return lhs_.IsStateFinal(state);
+		}
+
+		bool IsRhsFinal(const StateType& state) const
+		{
+			return rhs_.IsStateFinal(state);
+		}
+
+		bool OccursAt(size_t rank, size_t position, const StateSet& lhs,
+			const StateSet& rhs) const
+		{
+			return occursAt(lhsPositions_, rank, position, lhs) ||
+				occursAt(rhsPositions_, rank, position, rhs);
+		}
+
+		template <class Func>
+		void ForeachPost(const MacroTuple& lhsTuple, const MacroTuple& rhsTuple,
+			Func func) const
+		{
+			PairCollectorApplyFunctor collector;
+			collector(getPostMtbdd(lhs_, lhsTuples_, lhsTuple),
+				getPostMtbdd(rhs_, rhsTuples_, rhsTuple));
+
+			for (auto& postPair : collector.GetPairs())
+			{
+				func(postPair.first, postPair.second);
+			}
+		}
+
+		SymbolType FindSymbol(const MacroTuple& lhsTuple,
+			const MacroTuple& rhsTuple, const StateSet& lhsPost,
+			const StateSet& rhsPost) const
+		{
+			TransMTBDD lhsMtbdd = getPostMtbdd(lhs_, lhsTuples_, lhsTuple);
+			TransMTBDD rhsMtbdd = getPostMtbdd(rhs_, rhsTuples_, rhsTuple);
+
+			for (auto sym : BDDBottomUpTreeAut::GetSymbolDict())
+			{	// iterate over all known symbols
+				BDD symbolBdd(sym.second, true, false);
+
+				if ((getSymbolPost(lhsMtbdd, symbolBdd) == lhsPost) &&
+					(getSymbolPost(rhsMtbdd, symbolBdd) == rhsPost))
+				{
+					return sym.second;
+				}
+			}
+
+			throw std::runtime_error("No symbol for the post-image of a tuple");
+		}
+	};
+}
+
+
+bool VATA::CheckEquivalence(const BDDBottomUpTreeAut& lhs,
+	const BDDBottomUpTreeAut& rhs, BDDBottomUpTreeAut* counterexample)
+{
+	typedef VATA::UpwardEquivalenceChecker<BDDUpwardEquivalence> Checker;
+
+	lhs.CheckEncoding();
+	rhs.CheckEncoding();
+
+	BDDUpwardEquivalence backend(lhs, rhs);
+	Checker checker(backend);
+
+	if (checker.Check())
+	{
+		return true;
+	}
+
+	if (counterexample != nullptr)
+	{	// every node of the tree becomes a state with a single transition
+		Checker::Counterexample tree = checker.GetCounterexample();
+
+		*counterexample = BDDBottomUpTreeAut();
+		for (size_t i = 0; i < tree.size(); ++i)
+		{
+			BDDBottomUpTreeAut::StateTuple children(tree[i].children.begin(),
+				tree[i].children.end());
+			counterexample->AddTransition(children, tree[i].symbol, i);
+		}
+
+		counterexample->SetStateFinal(tree.size() - 1);
+	}
+
+	return false;
+}
@@ -14,6 +14,15 @@
 #include <vata/bdd_bu_tree_aut_op.hh>
 #include <vata/bdd_td_tree_aut_op.hh>
 #include <vata/tree_incl_up.hh>
+#include <vata/up_tree_incl_fctor.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+// Boost library headers
+#include <boost/functional/hash.hpp>
 
 using VATA::AutBase;
 using VATA::BDDBottomUpTreeAut;
@@ -32,12 +41,233 @@ bool VATA::CheckDownwardInclusion(const BDDBottomUpTreeAut& smaller,
 bool VATA::CheckUpwardInclusion(const BDDBottomUpTreeAut& smaller,
 	const BDDBottomUpTreeAut& bigger)
 {
+	typedef BDDBottomUpTreeAut::StateType StateType;
+	typedef BDDBottomUpTreeAut::StateSet StateSet;
+	typedef BDDBottomUpTreeAut::StateTuple StateTuple;
+	typedef BDDBottomUpTreeAut::TransMTBDD TransMTBDD;
+	typedef VATA::UpwardInclusionFunctor<BDDBottomUpTreeAut> InclFctor;
+	typedef InclFctor::AntichainType AntichainType;
+	typedef std::vector<const StateSet*> MacroTuple;
+	typedef std::vector<size_t> TupleIdVector;
+	typedef std::unordered_map<StateType, TupleIdVector> StateToTupleIdsMap;
+
+	smaller.CheckEncoding();
+	bigger.CheckEncoding();
+
 	BDDBottomUpTreeAut newSmaller = smaller;
 	BDDBottomUpTreeAut newBigger = bigger;
 
-	AutBase::StateType states =
-		AutBase::SanitizeAutsForInclusion(newSmaller, newBigger);
+	AutBase::SanitizeAutsForInclusion(newSmaller, newBigger);
+
+	// tuples of the smaller automaton indexed by states they contain
+	std::unordered_map<StateType, std::vector<StateTuple>> smallerTuples;
+	for (auto tupleBddPair : newSmaller.GetTransTable())
+	{
+		const StateTuple& tuple = tupleBddPair.first;
+		for (size_t i = 0; i < tuple.size(); ++i)
+		{
+			if (std::find(tuple.begin(), tuple.begin() + i, tuple[i]) ==
+				tuple.begin() + i)
+			{	// every tuple is stored only once for each state
+				smallerTuples[tuple[i]].push_back(tuple);
+			}
+		}
+	}
+
+	// tuples of the bigger automaton indexed by arity, position and state
+	std::vector<StateTuple> biggerTupleList;
+	std::vector<std::vector<StateToTupleIdsMap>> biggerIndex;
+	TupleIdVector biggerLeafIds;
+	for (auto tupleBddPair : newBigger.GetTransTable())
+	{
+		const StateTuple& tuple = tupleBddPair.first;
+		const size_t id = biggerTupleList.size();
+		biggerTupleList.push_back(tuple);
+
+		if (tuple.empty())
+		{
+			biggerLeafIds.push_back(id);
+			continue;
+		}
+
+		if (biggerIndex.size() <= tuple.size())
+		{
+			biggerIndex.resize(tuple.size() + 1);
+		}
+
+		biggerIndex[tuple.size()].resize(tuple.size());
+		for (size_t i = 0; i < tuple.size(); ++i)
+		{
+			biggerIndex[tuple.size()][i][tuple[i]].push_back(id);
+		}
+	}
+
+	// unions of the MTBDDs of sets of bigger tuples
+	std::unordered_map<TupleIdVector, TransMTBDD, boost::hash<TupleIdVector>>
+		unionCache;
+	BDDBottomUpTreeAut::UnionApplyFunctor unioner;
+
+	// pairs (smaller tuple, bigger tuples) whose post-image has been computed
+	std::unordered_set<std::pair<StateTuple, TupleIdVector>,
+		boost::hash<std::pair<StateTuple, TupleIdVector>>> processedPosts;
+
+	AntichainType workset;
+	AntichainType antichain;
+	InclFctor upFctor(newSmaller, newBigger, workset, antichain);
+
+	// the post-image of (smaller tuple, tuple of macro-states): one apply over
+	// all symbols, the functor prunes the pairs in every leaf by the antichain
+	auto post = [&](const StateTuple& smallerTuple, const MacroTuple& macroTuple)
+	{
+		const size_t arity = smallerTuple.size();
+
+		TupleIdVector matching;
+		if (arity == 0)
+		{
+			matching = biggerLeafIds;
+		}
+		else if ((arity < biggerIndex.size()) && !biggerIndex[arity].empty())
+		{
+			// candidates are taken from the position with the smallest macro-state
+			size_t pivot = 0;
+			for (size_t i = 1; i < arity; ++i)
+			{
+				if (macroTuple[i]->size() < macroTuple[pivot]->size())
+				{
+					pivot = i;
+				}
+			}
+
+			for (const StateType& state : *macroTuple[pivot])
+			{
+				auto itIds = biggerIndex[arity][pivot].find(state);
+				if (itIds == biggerIndex[arity][pivot].end())
+				{
+					continue;
+				}
+
+				for (const size_t& id : itIds->second)
+				{
+					const StateTuple& biggerTuple = biggerTupleList[id];
+
+					bool matches = true;
+					for (size_t i = 0; matches && (i < arity); ++i)
+					{
+						matches = (i == pivot) ||
+							(macroTuple[i]->find(biggerTuple[i]) != macroTuple[i]->end());
+					}
+
+					if (matches)
+					{
+						matching.push_back(id);
+					}
+				}
+			}
+
+			std::sort(matching.begin(), matching.end());
+		}
+
+		if (!processedPosts.insert(std::make_pair(smallerTuple, matching)).second)
+		{	// in case the same post-image has already been computed
+			return;
+		}
+
+		auto itUnion = unionCache.find(matching);
+		if (itUnion == unionCache.end())
+		{	// in case the union has not been computed yet
+			TransMTBDD unionMtbdd((StateSet()));
+			for (const size_t& id : matching)
+			{
+				unionMtbdd = unioner(unionMtbdd,
+					newBigger.GetMtbdd(biggerTupleList[id]));
+			}
+
+			itUnion = unionCache.insert(std::make_pair(matching, unionMtbdd)).first;
+		}
+
+		BDDBottomUpTreeAut::ForeachUpSymbolFromTupleAndMtbddDo(newSmaller,
+			smallerTuple, itUnion->second, upFctor);
+	};
+
+	// start with leaves
+	post(StateTuple(), MacroTuple());
+
+	StateType procState;
+	StateSet procSet;
+	while (upFctor.InclusionHolds() && workset.get(procState, procSet))
+	{
+		auto itTuples = smallerTuples.find(procState);
+		if (itTuples == smallerTuples.end())
+		{	// in case the state does not occur in any tuple
+			continue;
+		}
+
+		for (const StateTuple& tuple : itTuples->second)
+		{
+			// macro-states that are available at every position (copied, as the
+			// antichain changes while post-images are computed)
+			std::vector<std::vector<StateSet>> macroSets(tuple.size());
+			bool allReached = true;
+			for (size_t i = 0; i < tuple.size(); ++i)
+			{
+				const AntichainType::TList* macroList = antichain.lookup(tuple[i]);
+				if ((macroList == nullptr) || macroList->empty())
+				{
+					allReached = false;
+					break;
+				}
+
+				macroSets[i].assign(macroList->begin(), macroList->end());
+			}
+
+			if (!allReached)
+			{	// in case the tuple cannot be reached yet
+				continue;
+			}
+
+			for (size_t fixed = 0; fixed < tuple.size(); ++fixed)
+			{
+				if (tuple[fixed] != procState)
+				{	// the processed macro-state is put at positions of the state
+					continue;
+				}
+
+				// go through all choices of macro-states at other positions
+				std::vector<size_t> choice(tuple.size(), 0);
+				MacroTuple macroTuple(tuple.size());
+				for (size_t i = 0; i < tuple.size(); ++i)
+				{
+					macroTuple[i] = (i == fixed)? &procSet : &macroSets[i][0];
+				}
+
+				bool lastChoice = false;
+				while (!lastChoice && upFctor.InclusionHolds())
+				{
+					post(tuple, macroTuple);
+
+					// move to the next choice
+					lastChoice = true;
+					for (size_t i = 0; i < tuple.size(); ++i)
+					{
+						if (i == fixed)
+						{
+							continue;
+						}
+
+						if (++choice[i] < macroSets[i].size())
+						{
+							macroTuple[i] = &macroSets[i][choice[i]];
+							lastChoice = false;
+							break;
+						}
+
+						choice[i] = 0;
+						macroTuple[i] = &macroSets[i][0];
+					}
+				}
+			}
+		}
+	}
 
-	return CheckUpwardInclusionWithPreorder(newSmaller, newBigger,
-		VATA::Util::Identity(states));
+	return upFctor.InclusionHolds();
 }
@@ -23,11 +23,12 @@ BDDBottomUpTreeAut VATA::Intersection(const BDDBottomUpTreeAut& lhs,
 	typedef BDDBottomUpTreeAut::StateTuple StateTuple;
 	typedef BDDBottomUpTreeAut::StateSet StateSet;
 	typedef std::pair<StateType, StateType> StatePair;
-	typedef std::map<StateType, StatePair> WorkSetType;
-	typedef AutBase::ProductTranslMap IntersectionTranslMap;
+	typedef AutBase::ProductTranslTable ProductTranslTable;
 	typedef BDDBottomUpTreeAut::TransMTBDD MTBDD;
 	typedef BDDBottomUpTreeAut::MTBDDHandle MTBDDHandle;
-	typedef VATA::Util::TranslatorWeak<IntersectionTranslMap> StateTranslator;
+
+	lhs.CheckEncoding();
+	rhs.CheckEncoding();
 
 	GCC_DIAG_OFF(effc++)
 	class IntersectionApplyFunctor :
@@ -37,13 +38,16 @@ BDDBottomUpTreeAut VATA::Intersection(const BDDBottomUpTreeAut& lhs,
 	GCC_DIAG_ON(effc++)
 	private:  // Private data members
 
-		StateTranslator& transl_;
+		ProductTranslTable& table_;
 
 	public:   // Public methods
 
-		IntersectionApplyFunctor(StateTranslator& transl) :
-			transl_(transl)
-		{ }
+		IntersectionApplyFunctor(ProductTranslTable& table) :
+			table_(table)
+		{
+			// the result only depends on the pair of leaves
+			enableLeafMemoization();
+		}
 
 		StateSet ApplyOperation(const StateSet& lhs, const StateSet& rhs)
 		{
@@ -53,7 +57,7 @@ BDDBottomUpTreeAut VATA::Intersection(const BDDBottomUpTreeAut& lhs,
 			{
 				for (auto rhsState : rhs)
 				{
-					result.insert(transl_(std::make_pair(lhsState, rhsState)));
+					result.insert(table_.Insert(lhsState, rhsState).first);
 				}
 			}
 
@@ -61,35 +65,40 @@ BDDBottomUpTreeAut VATA::Intersection(const BDDBottomUpTreeAut& lhs,
 		}
 	};
 
-	AutBase::ProductTranslMap translMap;
-	if (pTranslMap == nullptr)
-	{
-		pTranslMap = &translMap;
+	// states occurring in tuples and final states determine the ranges
+	auto collectStates = [](const BDDBottomUpTreeAut& aut) -> std::vector<StateType>
+		{
+			std::vector<StateType> states(aut.GetFinalStates().begin(),
+				aut.GetFinalStates().end());
+			for (auto tupleBddPair : aut.GetTransTable())
+			{
+				states.insert(states.end(), tupleBddPair.first.begin(),
+					tupleBddPair.first.end());
+			}
+
+			return states;
+		};
+
+	ProductTranslTable table;
+	table.SetRanges(collectStates(lhs), collectStates(rhs));
+	if (pTranslMap != nullptr)
+	{	// keep the entries of the translation map
+		table.ImportFrom(*pTranslMap);
 	}
 
 	BDDBottomUpTreeAut result;
-	WorkSetType workset;
-	StateType stateCnt;
 
-	StateTranslator stateTransl(*pTranslMap,
-		[&workset,&stateCnt](const StatePair& newPair) -> StateType
-		{
-			workset.insert(std::make_pair(stateCnt, newPair));
-			return stateCnt++;
-		});
-
-	IntersectionApplyFunctor isect(stateTransl);
+	IntersectionApplyFunctor isect(table);
 
 	// start with leaves
 	StateTuple tuple;
 	MTBDD mtbdd = isect(lhs.GetMtbdd(tuple), rhs.GetMtbdd(tuple));
 	result.SetMtbdd(tuple, mtbdd);
 
-	while (!workset.empty())
-	{	// while there is something in the workset
-		WorkSetType::iterator itWs = workset.begin();
-		const StateType& newState  = itWs->first;
-		const StatePair& procPair  = itWs->second;
+	for (StateType newState = table.GetFirstState();
+		newState < table.GetNextState(); ++newState)
+	{	// process product states in the order of creation
+		const StatePair procPair   = table.GetPair(newState);
 		const StateType& lhsState  = procPair.first;
 		const StateType& rhsState  = procPair.second;
 
@@ -148,12 +157,11 @@ BDDBottomUpTreeAut VATA::Intersection(const BDDBottomUpTreeAut& lhs,
 						continue;
 					}
 
-					IntersectionTranslMap::const_iterator itTable;
-					if ((itTable = pTranslMap->find(std::make_pair(
-						lhsTuple[arityIndex], rhsTuple[arityIndex]))) !=
-						pTranslMap->end())
+					StateType productState;
+					if (table.Find(lhsTuple[arityIndex], rhsTuple[arityIndex],
+						productState))
 					{
-						tuple.push_back(itTable->second);
+						tuple.push_back(productState);
 					}
 					else
 					{
@@ -168,9 +176,11 @@ BDDBottomUpTreeAut VATA::Intersection(const BDDBottomUpTreeAut& lhs,
 				}
 			}
 		}
+	}
 
-		// remove the processed state from the workset
-		workset.erase(itWs);
+	if (pTranslMap != nullptr)
+	{	// export the translation map if asked for
+		table.ExportTo(*pTranslMap);
 	}
 
 	return result;
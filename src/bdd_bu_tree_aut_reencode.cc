@@ -0,0 +1,126 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of re-encoding of symbols of BDD bottom-up tree automata.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/bdd_bu_tree_aut_op.hh>
+#include <vata/mtbdd/void_apply2func.hh>
+
+// Standard library headers
+#include <map>
+
+using VATA::BDDBottomUpTreeAut;
+using VATA::SymbolicAutBase;
+
+
+BDDBottomUpTreeAut VATA::ReencodeSymbols(const BDDBottomUpTreeAut& aut,
+	const SymbolicAutBase::StringToSymbolDict& oldDict)
+{
+	typedef BDDBottomUpTreeAut::StateType StateType;
+	typedef BDDBottomUpTreeAut::StateSet StateSet;
+	typedef BDDBottomUpTreeAut::SymbolType SymbolType;
+	typedef BDDBottomUpTreeAut::TransMTBDD TransMTBDD;
+	typedef SymbolicAutBase::SymbolIndexSet SymbolIndexSet;
+	typedef SymbolicAutBase::AlphabetMTBDD AlphabetMTBDD;
+
+	GCC_DIAG_OFF(effc++)
+	class RebuildApplyFunctor :
+		public VATA::MTBDDPkg::VoidApply2Functor<RebuildApplyFunctor,
+		StateSet, SymbolIndexSet>
+	{
+	GCC_DIAG_ON(effc++)
+
+	private:  // data members
+
+		const std::vector<std::string>& names_;
+
+		/// symbols in the new encoding, translated when they are first used
+		std::vector<SymbolType> newSymbols_;
+		std::vector<bool> translated_;
+
+		std::map<SymbolType, StateSet> symbolStates_;
+
+	private:  // methods
+
+		const SymbolType& translate(size_t index)
+		{
+			// Assertions
+			assert(index < names_.size());
+
+			if (!translated_[index])
+			{	// in case the symbol has not been translated yet
+				VATA::Util::TranslatorWeak<SymbolicAutBase::StringToSymbolDict>
+					symbolTrans(SymbolicAutBase::GetSymbolDict(),
+					[](const std::string&){return SymbolicAutBase::AddSymbol();});
+
+				newSymbols_[index] = symbolTrans(names_[index]);
+				translated_[index] = true;
+			}
+
+			return newSymbols_[index];
+		}
+
+	public:   // methods
+
+		explicit RebuildApplyFunctor(const std::vector<std::string>& names) :
+			names_(names),
+			newSymbols_(names.size(), SymbolType(0)),
+			translated_(names.size(), false),
+			symbolStates_()
+		{ }
+
+		inline void ApplyOperation(const StateSet& lhs, const SymbolIndexSet& rhs)
+		{
+			if (lhs.empty())
+			{
+				return;
+			}
+
+			for (const size_t& index : rhs)
+			{	// for every symbol leading to the given states
+				StateSet& states = symbolStates_[translate(index)];
+				states = states.Union(lhs);
+			}
+		}
+
+		TransMTBDD Rebuild(const TransMTBDD& mtbdd, const AlphabetMTBDD& alphabet)
+		{
+			symbolStates_.clear();
+			(*this)(mtbdd, alphabet);
+
+			TransMTBDD::AsgnValueList asgnValues(symbolStates_.begin(),
+				symbolStates_.end());
+
+			return TransMTBDD(asgnValues, StateSet());
+		}
+	};
+
+	// split the old encoding into symbols
+	std::vector<std::string> names;
+	AlphabetMTBDD oldAlphabet = SymbolicAutBase::GetAlphabetMtbdd(oldDict, names);
+
+	// symbols are translated into the new encoding only when they are used
+	RebuildApplyFunctor rebuilder(names);
+
+	BDDBottomUpTreeAut result;
+
+	for (const StateType& fst : aut.GetFinalStates())
+	{
+		result.SetStateFinal(fst);
+	}
+
+	for (auto tupleBddPair : aut.GetTransTable())
+	{	// for every tuple (including the nullary one)
+		result.SetMtbdd(tupleBddPair.first,
+			rebuilder.Rebuild(tupleBddPair.second, oldAlphabet));
+	}
+
+	return result;
+}
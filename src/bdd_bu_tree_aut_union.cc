@@ -30,6 +30,8 @@ BDDBottomUpTreeAut VATA::Union(const BDDBottomUpTreeAut& lhs,
 	typedef VATA::AutBase::StateToStateMap StateToStateMap;
 	typedef BDDBottomUpTreeAut::StateToStateTranslator StateToStateTranslator;
 
+	lhs.CheckEncoding();
+	rhs.CheckEncoding();
 
 	BDDBottomUpTreeAut::UnionApplyFunctor unionFunc;
 
@@ -24,6 +24,8 @@ BDDBottomUpTreeAut VATA::UnionDisjunctStates(const BDDBottomUpTreeAut& lhs,
 	typedef BDDBottomUpTreeAut::StateTuple StateTuple;
 	typedef BDDBottomUpTreeAut::TransMTBDD TransMTBDD;
 
+	lhs.CheckEncoding();
+	rhs.CheckEncoding();
 
 	BDDBottomUpTreeAut::UnionApplyFunctor unionFunc;
 
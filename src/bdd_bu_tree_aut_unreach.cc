@@ -67,6 +67,8 @@ namespace
 
 BDDBottomUpTreeAut VATA::RemoveUnreachableStates(const BDDBottomUpTreeAut& aut)
 {
+	aut.CheckEncoding();
+
 	BDDBottomUpTreeAut result;
 
 	StateHT reachable;
@@ -94,7 +94,7 @@ namespace
 				for (const StateType& tupState : tuple_)
 				{
 					NodeToStateDict::ConstIteratorBwd itOtherNode;
-					if ((itOtherNode = nodes_.FindBwd(tupState)) == nodes_.end())
+					if ((itOtherNode = nodes_.FindBwd(tupState)) == nodes_.EndBwd())
 					{
 						assert(false);      // fail gracefully
 					}
@@ -144,6 +144,8 @@ public:   // methods
 
 BDDBottomUpTreeAut VATA::RemoveUselessStates(const BDDBottomUpTreeAut& aut)
 {
+	aut.CheckEncoding();
+
 	BDDBottomUpTreeAut result;
 
 	StateHT reachable;
@@ -0,0 +1,139 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of a BDD-based top-down tree automaton.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/bdd_bu_tree_aut.hh>
+#include <vata/bdd_td_tree_aut.hh>
+#include <vata/mtbdd/apply2func.hh>
+#include <vata/mtbdd/void_apply1func.hh>
+
+// Standard library headers
+#include <map>
+#include <set>
+
+
+using VATA::BDDBottomUpTreeAut;
+using VATA::BDDTopDownTreeAut;
+
+
+BDDBottomUpTreeAut BDDTopDownTreeAut::GetBottomUpAut() const
+{
+	typedef BDDBottomUpTreeAut::StateSet BUStateSet;
+
+	CheckEncoding();
+
+	GCC_DIAG_OFF(effc++)    // suppress missing virtual destructor warning
+	class CollectorApplyFunctor :
+		public VATA::MTBDDPkg::VoidApply1Functor<CollectorApplyFunctor,
+		StateTupleSet>
+	{
+	GCC_DIAG_ON(effc++)
+	public:   // data types
+
+		typedef std::map<size_t, std::set<StateTuple>> ArityToTuplesMap;
+
+	private:  // data members
+
+		ArityToTuplesMap tuples_;
+
+	public:   // methods
+
+		CollectorApplyFunctor() :
+			tuples_()
+		{ }
+
+		inline const ArityToTuplesMap& GetTuples() const
+		{
+			return tuples_;
+		}
+
+		inline void Clear()
+		{
+			tuples_.clear();
+		}
+
+		inline void ApplyOperation(const StateTupleSet& val)
+		{
+			for (const StateTuple& tuple : val)
+			{
+				tuples_[tuple.size()].insert(tuple);
+			}
+		}
+	};
+
+	GCC_DIAG_OFF(effc++)    // suppress missing virtual destructor warning
+	class InverterApplyFunctor :
+		public VATA::MTBDDPkg::Apply2Functor<InverterApplyFunctor, StateTupleSet,
+		BUStateSet, BUStateSet>
+	{
+	GCC_DIAG_ON(effc++)
+	private:  // data members
+
+		const StateType& soughtState_;
+		const StateTuple& checkedTuple_;
+
+	public:   // methods
+
+		InverterApplyFunctor(const StateType& soughtState,
+			const StateTuple& checkedTuple) :
+			soughtState_(soughtState),
+			checkedTuple_(checkedTuple)
+		{ }
+
+		inline BUStateSet ApplyOperation(const StateTupleSet& lhs,
+			const BUStateSet& rhs)
+		{
+			BUStateSet result = rhs;
+			if (lhs.find(checkedTuple_) != lhs.end())
+			{
+				result.insert(soughtState_);
+			}
+
+			return result;
+		}
+	};
+
+	BDDBottomUpTreeAut result;
+
+	StateType soughtState;
+	StateTuple checkedTuple;
+	InverterApplyFunctor invertFunc(soughtState, checkedTuple);
+	CollectorApplyFunctor collector;
+
+	for (const StateType& fst : finalStates_)
+	{
+		result.SetStateFinal(fst);
+	}
+
+	for (auto stateBddPair : GetStates())
+	{
+		soughtState = stateBddPair.first;
+		const TransMTBDD& transMtbdd = GetMtbdd(soughtState);
+
+		// collect the tuples below the state by their arities
+		collector.Clear();
+		collector(transMtbdd);
+
+		for (const auto& arityTuplesPair : collector.GetTuples())
+		{
+			TransMTBDD arityMtbdd = GetMtbddForArity(transMtbdd, arityTuplesPair.first);
+
+			for (const StateTuple& tuple : arityTuplesPair.second)
+			{
+				checkedTuple = tuple;
+				result.SetMtbdd(checkedTuple, invertFunc(
+					arityMtbdd, result.GetMtbdd(checkedTuple)));
+			}
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,41 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of language equivalence on BDD top-down tree automata.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/bdd_bu_tree_aut.hh>
+#include <vata/bdd_bu_tree_aut_op.hh>
+#include <vata/bdd_td_tree_aut_op.hh>
+
+using VATA::BDDBottomUpTreeAut;
+using VATA::BDDTopDownTreeAut;
+
+
+bool VATA::CheckEquivalence(const BDDTopDownTreeAut& lhs,
+	const BDDTopDownTreeAut& rhs, BDDTopDownTreeAut* counterexample)
+{
+	lhs.CheckEncoding();
+	rhs.CheckEncoding();
+
+	// the check explores the automata upwards
+	BDDBottomUpTreeAut buCounterexample;
+	if (CheckEquivalence(lhs.GetBottomUpAut(), rhs.GetBottomUpAut(),
+		(counterexample != nullptr)? &buCounterexample : nullptr))
+	{
+		return true;
+	}
+
+	if (counterexample != nullptr)
+	{
+		*counterexample = buCounterexample.GetTopDownAut();
+	}
+
+	return false;
+}
@@ -22,6 +22,9 @@ typedef VATA::AutBase::StateType StateType;
 bool VATA::CheckDownwardInclusion(
 	const BDDTopDownTreeAut& smaller, const BDDTopDownTreeAut& bigger)
 {
+	smaller.CheckEncoding();
+	bigger.CheckEncoding();
+
 	BDDTopDownTreeAut newSmaller = smaller;
 	BDDTopDownTreeAut newBigger = bigger;
 	StateType states = AutBase::SanitizeAutsForInclusion(newSmaller, newBigger);
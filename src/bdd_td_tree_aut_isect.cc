@@ -16,7 +16,7 @@ using VATA::AutBase;
 using VATA::BDDTopDownTreeAut;
 
 // Standard library headers
-#include <unordered_map>
+#include <vector>
 
 BDDTopDownTreeAut VATA::Intersection(
 	const BDDTopDownTreeAut& lhs, const BDDTopDownTreeAut& rhs,
@@ -27,8 +27,10 @@ BDDTopDownTreeAut VATA::Intersection(
 	typedef BDDTopDownTreeAut::StateTuple StateTuple;
 	typedef BDDTopDownTreeAut::StateTupleSet StateTupleSet;
 	typedef std::pair<StateType, StateType> StatePair;
-	typedef std::map<StateType, StatePair> WorkSetType;
-	typedef VATA::Util::TranslatorWeak<AutBase::ProductTranslMap> StateTranslator;
+	typedef AutBase::ProductTranslTable ProductTranslTable;
+
+	lhs.CheckEncoding();
+	rhs.CheckEncoding();
 
 	GCC_DIAG_OFF(effc++)  // suppress non-virtual destructor warning
 	class IntersectionApplyFunctor :
@@ -38,13 +40,16 @@ BDDTopDownTreeAut VATA::Intersection(
 	GCC_DIAG_ON(effc++)
 	private:  // data members
 
-		StateTranslator& transl_;
+		ProductTranslTable& table_;
 
 	public:   // methods
 
-		IntersectionApplyFunctor(StateTranslator& transl) :
-			transl_(transl)
-		{ }
+		IntersectionApplyFunctor(ProductTranslTable& table) :
+			table_(table)
+		{
+			// the result only depends on the pair of leaves
+			enableLeafMemoization();
+		}
 
 		StateTupleSet ApplyOperation(const StateTupleSet& lhs,
 			const StateTupleSet& rhs)
@@ -60,8 +65,8 @@ BDDTopDownTreeAut VATA::Intersection(
 					StateTuple resultTuple;
 					for (size_t i = 0; i < lhsTuple.size(); ++i)
 					{
-						resultTuple.push_back(transl_(
-							std::make_pair(lhsTuple[i], rhsTuple[i])));
+						resultTuple.push_back(
+							table_.Insert(lhsTuple[i], rhsTuple[i]).first);
 					}
 
 					result.insert(resultTuple);
@@ -72,49 +77,51 @@ BDDTopDownTreeAut VATA::Intersection(
 		}
 	};
 
-	AutBase::ProductTranslMap translMap;
-	if (pTranslMap == nullptr)
-	{	// if no translation map was given
-		pTranslMap = &translMap;
+	std::vector<StateType> lhsStates;
+	for (auto stateBddPair : lhs.GetStates())
+	{
+		lhsStates.push_back(stateBddPair.first);
 	}
 
-	BDDTopDownTreeAut result;
-	WorkSetType workset;
-	StateType stateCnt;
+	std::vector<StateType> rhsStates;
+	for (auto stateBddPair : rhs.GetStates())
+	{
+		rhsStates.push_back(stateBddPair.first);
+	}
 
-	StateTranslator stateTransl(*pTranslMap,
-		[&workset,&stateCnt](const StatePair& newPair) -> StateType
-		{
-			workset.insert(std::make_pair(stateCnt, newPair));
-			return stateCnt++;
-		});
+	ProductTranslTable table;
+	table.SetRanges(lhsStates, rhsStates);
+	if (pTranslMap != nullptr)
+	{	// keep the entries of the translation map
+		table.ImportFrom(*pTranslMap);
+	}
+
+	BDDTopDownTreeAut result;
 
 	for (auto lhsFst : lhs.GetFinalStates())
 	{	// iterate over LHS's final states
 		for (auto rhsFst : rhs.GetFinalStates())
 		{	// iterate over RHS's final states
-			StatePair origStates = std::make_pair(lhsFst, rhsFst);
-
-			StateType newState = stateTransl(origStates);
-			result.SetStateFinal(newState);
+			result.SetStateFinal(table.Insert(lhsFst, rhsFst).first);
 		}
 	}
 
-	IntersectionApplyFunctor isect(stateTransl);
+	IntersectionApplyFunctor isect(table);
 
-	while (!workset.empty())
-	{	// while there is something in the workset
-		WorkSetType::iterator itWs = workset.begin();
-		const StatePair& procPair  = itWs->second;
-		const StateType& procState = itWs->first;
+	for (StateType procState = table.GetFirstState();
+		procState < table.GetNextState(); ++procState)
+	{	// process product states in the order of creation
+		StatePair procPair = table.GetPair(procState);
 
 		BDDTopDownTreeAut::TransMTBDD mtbdd = isect(lhs.GetMtbdd(procPair.first),
 			rhs.GetMtbdd(procPair.second));
 
 		result.SetMtbdd(procState, mtbdd);
+	}
 
-		// remove the processed state from the workset
-		workset.erase(itWs);
+	if (pTranslMap != nullptr)
+	{	// export the translation map if asked for
+		table.ExportTo(*pTranslMap);
 	}
 
 	return result;
@@ -0,0 +1,139 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of re-encoding of symbols of BDD top-down tree automata.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/bdd_td_tree_aut_op.hh>
+#include <vata/mtbdd/void_apply2func.hh>
+
+// Standard library headers
+#include <map>
+
+using VATA::BDDTopDownTreeAut;
+using VATA::SymbolicAutBase;
+
+
+BDDTopDownTreeAut VATA::ReencodeSymbols(const BDDTopDownTreeAut& aut,
+	const SymbolicAutBase::StringToSymbolDict& oldDict)
+{
+	typedef BDDTopDownTreeAut::StateType StateType;
+	typedef BDDTopDownTreeAut::StateTuple StateTuple;
+	typedef BDDTopDownTreeAut::StateTupleSet StateTupleSet;
+	typedef BDDTopDownTreeAut::SymbolType SymbolType;
+	typedef BDDTopDownTreeAut::TransMTBDD TransMTBDD;
+	typedef SymbolicAutBase::SymbolIndexSet SymbolIndexSet;
+	typedef SymbolicAutBase::AlphabetMTBDD AlphabetMTBDD;
+
+	GCC_DIAG_OFF(effc++)
+	class RebuildApplyFunctor :
+		public VATA::MTBDDPkg::VoidApply2Functor<RebuildApplyFunctor,
+		StateTupleSet, SymbolIndexSet>
+	{
+	GCC_DIAG_ON(effc++)
+
+	private:  // data members
+
+		const std::vector<std::string>& names_;
+
+		/// symbols in the new encoding, translated when they are first used
+		std::vector<SymbolType> newSymbols_;
+		std::vector<bool> translated_;
+
+		/// tuples for every symbol with the arity appended
+		std::map<SymbolType, std::vector<StateTuple>> symbolTuples_;
+
+	private:  // methods
+
+		const SymbolType& translate(size_t index)
+		{
+			// Assertions
+			assert(index < names_.size());
+
+			if (!translated_[index])
+			{	// in case the symbol has not been translated yet
+				VATA::Util::TranslatorWeak<SymbolicAutBase::StringToSymbolDict>
+					symbolTrans(SymbolicAutBase::GetSymbolDict(),
+					[](const std::string&){return SymbolicAutBase::AddSymbol();});
+
+				newSymbols_[index] = symbolTrans(names_[index]);
+				translated_[index] = true;
+			}
+
+			return newSymbols_[index];
+		}
+
+	public:   // methods
+
+		explicit RebuildApplyFunctor(const std::vector<std::string>& names) :
+			names_(names),
+			newSymbols_(names.size(), SymbolType(0)),
+			translated_(names.size(), false),
+			symbolTuples_()
+		{ }
+
+		inline void ApplyOperation(const StateTupleSet& lhs,
+			const SymbolIndexSet& rhs)
+		{
+			if (lhs.empty())
+			{
+				return;
+			}
+
+			for (const size_t& index : rhs)
+			{	// for every symbol leading to the given tuples
+				for (const StateTuple& tuple : lhs)
+				{	// the arity is not a part of the alphabet
+					SymbolType symbol = translate(index);
+					symbol.append(SymbolType(BDDTopDownTreeAut::SYMBOL_ARITY_LENGTH,
+						tuple.size()));
+
+					symbolTuples_[symbol].push_back(tuple);
+				}
+			}
+		}
+
+		TransMTBDD Rebuild(const TransMTBDD& mtbdd, const AlphabetMTBDD& alphabet)
+		{
+			symbolTuples_.clear();
+			(*this)(mtbdd, alphabet);
+
+			TransMTBDD::AsgnValueList asgnValues;
+			for (auto& symbolTuplesPair : symbolTuples_)
+			{
+				asgnValues.push_back(std::make_pair(symbolTuplesPair.first,
+					StateTupleSet(symbolTuplesPair.second)));
+			}
+
+			return TransMTBDD(asgnValues, StateTupleSet());
+		}
+	};
+
+	// split the old encoding into symbols
+	std::vector<std::string> names;
+	AlphabetMTBDD oldAlphabet = SymbolicAutBase::GetAlphabetMtbdd(oldDict, names);
+
+	// symbols are translated into the new encoding only when they are used
+	RebuildApplyFunctor rebuilder(names);
+
+	BDDTopDownTreeAut result;
+
+	for (const StateType& fst : aut.GetFinalStates())
+	{
+		result.SetStateFinal(fst);
+	}
+
+	for (auto stateBddPair : aut.GetStates())
+	{	// for every state
+		result.SetMtbdd(stateBddPair.first,
+			rebuilder.Rebuild(aut.GetMtbdd(stateBddPair.first), oldAlphabet));
+	}
+
+	return result;
+}
@@ -32,6 +32,9 @@ BDDTopDownTreeAut VATA::Union(const BDDTopDownTreeAut& lhs,
 	typedef VATA::Util::TranslatorWeak<typename AutBase::StateToStateMap>
 		StateToStateTranslator;
 
+	lhs.CheckEncoding();
+	rhs.CheckEncoding();
+
 	GCC_DIAG_OFF(effc++)    // suppress missing virtual destructor warning
 	class RewriterApplyFunctor :
 		public VATA::MTBDDPkg::Apply1Functor<RewriterApplyFunctor,
@@ -24,6 +24,8 @@ BDDTopDownTreeAut VATA::UnionDisjunctStates(const BDDTopDownTreeAut& lhs,
 	typedef BDDTopDownTreeAut::StateTuple StateTuple;
 	typedef BDDTopDownTreeAut::TransMTBDD TransMTBDD;
 
+	lhs.CheckEncoding();
+	rhs.CheckEncoding();
 
 	BDDTopDownTreeAut::UnionApplyFunctor unionFunc;
 
@@ -34,6 +34,8 @@ BDDTopDownTreeAut VATA::RemoveUnreachableStates(const BDDTopDownTreeAut& aut)
 	typedef BDDTopDownTreeAut::StateSet StateHT;
 
 
+	aut.CheckEncoding();
+
 	GCC_DIAG_OFF(effc++)   // suppress missing virtual destructor warning
 	class UnreachableApplyFunctor :
 		public VATA::MTBDDPkg::Apply1Functor<UnreachableApplyFunctor,
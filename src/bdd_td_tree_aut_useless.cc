@@ -55,6 +55,8 @@ BDDTopDownTreeAut VATA::RemoveUselessStates(const BDDTopDownTreeAut& aut)
 	typedef BDDTopDownTreeAut::TransMTBDD TransMTBDD;
 
 
+	aut.CheckEncoding();
+
 	GCC_DIAG_OFF(effc++)   // suppress missing virtual destructor warning
 	class AndOrGraphConstrFunctor :
 		public VATA::MTBDDPkg::VoidApply1Functor<AndOrGraphConstrFunctor,
@@ -0,0 +1,79 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of cooperative cancellation of long-running operations.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/util/cancellation.hh>
+
+using VATA::Util::CancellationScope;
+using VATA::Util::CancellationToken;
+using VATA::Util::Progress;
+
+namespace
+{
+	thread_local CancellationScope* currentScope = nullptr;
+}
+
+
+CancellationToken* CancellationToken::GetCurrent()
+{
+	return (currentScope != nullptr)? &currentScope->GetToken() : nullptr;
+}
+
+
+CancellationScope::CancellationScope(CancellationToken& token) :
+	token_(token),
+	previous_(currentScope),
+	polls_(0),
+	usesClock_(token.HasDeadline() || token.GetProgressCallback()),
+	start_(CancellationToken::Clock::now()),
+	nextProgress_(start_ + token.GetProgressInterval())
+{
+	currentScope = this;
+}
+
+
+CancellationScope::~CancellationScope()
+{
+	currentScope = previous_;
+}
+
+
+CancellationScope* CancellationScope::GetCurrent()
+{
+	return currentScope;
+}
+
+
+void CancellationScope::checkClock(const char* engine, size_t worksetSize,
+	size_t antichainSize)
+{
+	CancellationToken::Clock::time_point now = CancellationToken::Clock::now();
+
+	if (token_.HasDeadline() && (now >= token_.GetDeadline()))
+	{	// the other threads sharing the token stop at their next poll
+		token_.Expire();
+		token_.ThrowCancelled();
+	}
+
+	if (token_.GetProgressCallback() && (now >= nextProgress_))
+	{
+		nextProgress_ = now + token_.GetProgressInterval();
+
+		Progress progress;
+		progress.engine = (engine != nullptr)? engine : "operation";
+		progress.iterations = polls_;
+		progress.worksetSize = worksetSize;
+		progress.antichainSize = antichainSize;
+		progress.elapsed = std::chrono::duration<double>(now - start_).count();
+
+		token_.GetProgressCallback()(progress);
+	}
+}
@@ -18,23 +18,32 @@
 #include <cstddef>
 
 #include <vata/util/binary_relation.hh>
+#include <vata/util/partitioned_relation.hh>
 #include <vata/util/splitting_relation.hh>
 #include <vata/util/smart_set.hh>
 #include <vata/util/caching_allocator.hh>
+#include <vata/util/cancellation.hh>
+#include <vata/util/slab_allocator.hh>
 #include <vata/util/shared_list.hh>
 #include <vata/util/shared_counter.hh>
 #include <vata/util/convert.hh>
+#include <vata/util/stats.hh>
 #include <vata/explicit_lts.hh>
 
 using VATA::Util::BinaryRelation;
+using VATA::Util::PartitionedRelation;
 using VATA::Util::SplittingRelation;
 using VATA::Util::SmartSet;
 using VATA::Util::CachingAllocator;
+using VATA::Util::SlabAllocator;
 using VATA::Util::SharedList;
 using VATA::Util::SharedCounter;
 using VATA::Util::Convert;
 
-typedef CachingAllocator<std::vector<size_t>> VectorAllocator;
+typedef VATA::ExplicitLTS::StateType StateType;
+typedef VATA::ExplicitLTS::StateListTable StateListTable;
+
+typedef CachingAllocator<std::vector<StateType>> VectorAllocator;
 
 struct SharedListInitF {
 
@@ -42,7 +51,7 @@ struct SharedListInitF {
 
 	SharedListInitF(VectorAllocator& allocator) : allocator_(allocator) {}
 
-	void operator()(SharedList<std::vector<size_t>>* list) {
+	void operator()(SharedList<std::vector<StateType>>* list) {
 
 		auto sublist = this->allocator_();
 
@@ -56,7 +65,7 @@ struct SharedListInitF {
 
 struct StateListElem {
 
-	size_t index_;
+	StateType index_;
 	class Block* block_;
 	StateListElem* next_;
 	StateListElem* prev_;
@@ -70,7 +79,7 @@ struct StateListElem {
 
 };
 
-typedef SharedList<std::vector<size_t>> RemoveList;
+typedef SharedList<std::vector<StateType>> RemoveList;
 typedef CachingAllocator<RemoveList, SharedListInitF> RemoveAllocator;
 
 typedef std::pair<struct Block*, size_t> RemoveQueueElement;
@@ -96,9 +105,10 @@ public:
 
 	Block(const VATA::ExplicitLTS& lts, size_t index, StateListElem* states, size_t size,
 		const SharedCounter::Key& key, const SharedCounter::LabelMap& labelMap,
-		const size_t& rowSize, SharedCounter::Allocator& allocator) : index_(index),
-		states_(states), size_(size), remove_(lts.labels()),
-		counter_(key, lts.states(), labelMap, rowSize, allocator), inset_(lts.labels()), tmp_() {
+		const size_t& rowSize, SharedCounter::Allocator& allocator,
+		SmartSet::Allocator& insetAllocator) : index_(index), states_(states), size_(size),
+		remove_(lts.labels()), counter_(key, lts.states(), labelMap, rowSize, allocator),
+		inset_(lts.labels(), &insetAllocator), tmp_() {
 
 		do {
 
@@ -116,7 +126,7 @@ public:
 
 	Block(const VATA::ExplicitLTS& lts, Block& parent, StateListElem* states, size_t size,
 		size_t index) : index_(index), states_(states), size_(size), remove_(lts.labels()),
-		counter_(parent.counter_), inset_(lts.labels()), tmp_() {
+		counter_(parent.counter_), inset_(lts.labels(), parent.inset_.allocator()), tmp_() {
 
 		do {
 
@@ -283,13 +293,14 @@ protected:
 				this->key_,
 				this->labelMap_,
 				this->rowSize_,
-				this->counterAllocator_
+				this->counterAllocator_,
+				this->smartSetAllocator_
 			)
 		);
 
 	}
 
-	void enqueueToRemove(Block* block, size_t label, size_t state) {
+	void enqueueToRemove(Block* block, size_t label, StateType state) {
 
 		if (RemoveList::append(block->remove_[label], state, this->removeAllocator_))
 			this->queue_.push_back(std::make_pair(block, label));
@@ -382,6 +393,8 @@ protected:
 
 			this->relation_.split(block->index_);
 
+			VATA_STATS_INC("simulation.block_splits");
+
 		}
 
 	}
@@ -415,6 +428,8 @@ protected:
 
 			this->relation_.split(block->index_);
 
+			VATA_STATS_INC("simulation.block_splits");
+
 			removeMask[newBlock->index_] = true;
 
 			newBlock->counter_.copyLabels(newBlock->inset_, block->counter_);
@@ -504,7 +519,7 @@ protected:
 
 	}
 
-	static bool isPartition(const std::vector<std::vector<size_t>>& part, size_t states) {
+	static bool isPartition(const StateListTable& part, size_t states) {
 
 		std::vector<bool> mask(states, false);
 
@@ -542,7 +557,7 @@ protected:
 
 	}
 
-	static bool isConsistent(const std::vector<std::vector<size_t>>& part,
+	static bool isConsistent(const StateListTable& part,
 		const BinaryRelation& rel) {
 
 		if (part.size() != rel.size()) {
@@ -575,9 +590,13 @@ private:
 
 	size_t rowSize_;
 
+	// nodes of the structures below are placed here and freed in one shot
+	SlabAllocator slab_;
+
 	VectorAllocator vectorAllocator_;
 	RemoveAllocator removeAllocator_;
 	SharedCounter::Allocator counterAllocator_;
+	SmartSet::Allocator smartSetAllocator_;
 
 	std::vector<Block*> partition_;
 	SplittingRelation relation_;
@@ -608,9 +627,10 @@ private:
 public:
 
 	SimulationEngine(const VATA::ExplicitLTS& lts) : lts_(lts),
-		rowSize_(SimulationEngine::getRowSize(lts.states())), vectorAllocator_(),
-		removeAllocator_(SharedListInitF(vectorAllocator_)), counterAllocator_(rowSize_ + 1),
-		partition_(), relation_(lts.states()), index_(lts.states()), queue_(), key_(), labelMap_() {
+		rowSize_(SimulationEngine::getRowSize(lts.states())), slab_(), vectorAllocator_(),
+		removeAllocator_(slab_, SharedListInitF(vectorAllocator_)),
+		counterAllocator_(rowSize_ + 1, slab_), smartSetAllocator_(slab_), partition_(),
+		relation_(lts.states(), slab_), index_(lts.states()), queue_(), key_(), labelMap_() {
 
 		assert(this->index_.size());
 
@@ -623,7 +643,7 @@ public:
 
 	}
 
-	void init(const std::vector<std::vector<size_t>>& partition, const BinaryRelation& relation) {
+	void init(const StateListTable& partition, const BinaryRelation& relation) {
 
 		assert(SimulationEngine::isPartition(partition, this->lts_.states()));
 		assert(SimulationEngine::isConsistent(partition, relation));
@@ -632,7 +652,7 @@ public:
 
 		std::vector<SmartSet> delta1;
 
-		this->lts_.buildDelta1(delta1);
+		this->lts_.buildDelta1(delta1, &this->smartSetAllocator_);
 
 		this->key_.resize(this->lts_.labels()*this->lts_.states(), static_cast<size_t>(-1));
 		this->labelMap_.resize(this->lts_.labels());
@@ -721,7 +741,7 @@ public:
 
 		// initialize counters
 
-		SmartSet s;
+		SmartSet s(0, &this->smartSetAllocator_);
 
 		for (auto& b1 : this->partition_) {
 
@@ -779,7 +799,8 @@ public:
 				if (s.empty())
 					continue;
 
-				b1->remove_[a] = new RemoveList(new std::vector<size_t>(s.begin(), s.end()));
+				for (auto& q : s)
+					RemoveList::append(b1->remove_[a], q, this->removeAllocator_);
 
 				this->queue_.push_back(std::make_pair(b1, a));
 
@@ -795,8 +816,15 @@ public:
 
 	void run() {
 
+		VATA_STATS_TIMER("simulation.time_ns");
+		VATA_STATS_MAX("lts.states_max", this->lts_.states());
+		VATA_STATS_MAX("lts.labels_max", this->lts_.labels());
+		VATA_STATS_MAX("lts.transitions_max", this->lts_.transitions());
+
 	    while (!this->queue_.empty()) {
 
+			VATA::Util::PollCancellation("simulation", this->queue_.size());
+
 			std::pair<Block*, size_t> tmp(this->queue_.back());
 
 			this->queue_.pop_back();
@@ -805,13 +833,15 @@ public:
 
 		}
 
+		VATA_STATS_MAX("simulation.blocks_max", this->partition_.size());
+
 	}
 
 	void buildResult(BinaryRelation& result, size_t size) const {
 
 		result.resize(size);
 
-		std::vector<std::vector<size_t>> tmp(this->partition_.size());
+		StateListTable tmp(this->partition_.size());
 
 		for (size_t i = 0; i < this->partition_.size(); ++i) {
 
@@ -847,6 +877,39 @@ public:
 
 	}
 
+	void buildResult(PartitionedRelation& result, size_t size) const {
+
+		StateListTable blocks(this->partition_.size());
+		std::vector<std::vector<size_t>> blockPost(this->relation_.size());
+
+		for (size_t i = 0; i < this->partition_.size(); ++i) {
+
+			auto elem = this->partition_[i]->states_;
+
+			do {
+
+				assert(elem);
+
+				if (elem->index_ < size)
+					blocks[i].push_back(elem->index_);
+
+				elem = elem->next_;
+
+			} while (elem != this->partition_[i]->states_);
+
+		}
+
+		for (size_t i = 0; i < this->relation_.size(); ++i) {
+
+			for (auto j : const_cast<SplittingRelation*>(&this->relation_)->row(i))
+				blockPost[i].push_back(j);
+
+		}
+
+		result = PartitionedRelation(size, blocks, blockPost);
+
+	}
+
 	friend std::ostream& operator<<(std::ostream& os, const SimulationEngine& engine) {
 
 		os << "partition: " << std::endl;
@@ -865,7 +928,7 @@ public:
 };
 
 BinaryRelation VATA::ExplicitLTS::computeSimulation(
-	const std::vector<std::vector<size_t>>& partition,
+	const StateListTable& partition,
 	const BinaryRelation& relation,
 	size_t outputSize
 ) {
@@ -885,3 +948,25 @@ BinaryRelation VATA::ExplicitLTS::computeSimulation(
 	return result;
 
 }
+
+PartitionedRelation VATA::ExplicitLTS::computePartitionedSimulation(
+	const StateListTable& partition,
+	const BinaryRelation& relation,
+	size_t outputSize
+) {
+
+	if (this->states_ == 0)
+		return PartitionedRelation();
+
+	SimulationEngine engine(*this);
+
+	engine.init(partition, relation);
+	engine.run();
+
+	PartitionedRelation result;
+
+	engine.buildResult(result, outputSize);
+
+	return result;
+
+}
@@ -16,28 +16,16 @@
 #include <vata/explicit_tree_aut.hh>
 #include <vata/util/cache.hh>
 #include <vata/util/cached_binary_op.hh>
+#include <vata/util/cancellation.hh>
+#include <vata/util/stats.hh>
+#include <vata/util/sorted_set_kernels.hh>
 #include <vata/util/antichain1c.hh>
 #include <vata/util/antichain2c_v2.hh>
 #include <vata/util/caching_allocator.hh>
 
 #include <vata/explicit_tree_incl_down.hh>
 
-template <class T1, class T2>
-bool checkIntersection(const T1& s1, const T2& s2) {
-
-	auto i1 = s1.begin(), i2 = s2.begin();
-
-	while (i1 != s1.end() && i2 != s2.end()) {
-
-		if (*i1 < *i2) ++i1;
-		else if (*i2 < *i1) ++i2;
-		else return true;
-
-	}
-
-	return false;
-
-}
+using VATA::Util::SortedSetKernels::Intersects;
 
 template <class T1, class T2>
 void intersectionByLookup(T1& d, const T2& s) {
@@ -192,6 +180,21 @@ public:
 
 	ExpandCallEmulator() : allocator_(), ptr_() {}
 
+	~ExpandCallEmulator() {
+
+		// the frames left on the stack when the check is cancelled hold
+		// references to the cache of bigger types, which has to end up empty
+		while (this->ptr_) {
+
+			ExpandStackFrame* parent = this->ptr_->parent;
+
+			this->allocator_.reclaim(this->ptr_);
+			this->ptr_ = parent;
+
+		}
+
+	}
+
 	void push(ExpandStackFrame& top) {
 
 		ExpandStackFrame* newFrame = this->allocator_();
@@ -280,18 +283,20 @@ inline bool expand(BiggerTypeCache& biggerTypeCache,
 	Antichain2C& nonincluded,
 	const SmallerType& p_S, const BiggerType& P_B,
 	const DoubleIndexedTupleList& smallerIndex, const DoubleIndexedTupleList& biggerIndex,
-	const std::vector<std::vector<size_t>>& ind, const std::vector<std::vector<size_t>>& inv
+	const VATA::Util::BinaryRelation::IndexType& ind, const VATA::Util::BinaryRelation::IndexType& inv
 ) {
 
 	auto noncachedLte = [&ind](const StateSet* x, const StateSet* y) -> bool {
 
 		assert(x); assert(y);
 
+		VATA_STATS_INC("lte_cache.misses");
+
 		for (auto& s1 : *x) {
 
 			assert(s1 < ind.size());
 
-			if (!checkIntersection(ind[s1], *y))
+			if (!Intersects(ind[s1], *y))
 				return false;
 
 		}
@@ -304,7 +309,12 @@ inline bool expand(BiggerTypeCache& biggerTypeCache,
 
 		assert(x); assert(y);
 
-		return (x.get() == y.get())?(true):(lteCache.lookup(x.get(), y.get(), noncachedLte));
+		if (x.get() == y.get())
+			return true;
+
+		VATA_STATS_INC("lte_cache.lookups");
+
+		return lteCache.lookup(x.get(), y.get(), noncachedLte);
 
 	};
 
@@ -340,7 +350,7 @@ _call:
 
 	}
 
-	if (checkIntersection(ind[r_i], *S)) {
+	if (Intersects(ind[r_i], *S)) {
 
 		found = true;
 
@@ -368,6 +378,9 @@ _call:
 
 	}
 
+	VATA::Util::PollCancellation("downward inclusion", workset.size(),
+		nonincluded.size());
+
 	EXPAND_PUSH
 
 	assert(r_i < smallerIndex.size());
@@ -463,6 +476,9 @@ _simret:
 
 			do {
 				// we loop for each choice function
+				VATA::Util::PollCancellation("downward inclusion", workset.size(),
+					nonincluded.size());
+
 				found = false;
 
 				for (top.i = 0; top.i < top.choiceFunction.arity(); ++top.i) {
@@ -551,9 +567,11 @@ _end:
 bool VATA::ExplicitDownwardInclusion::checkInternal(
 	const DoubleIndexedTupleList& smallerIndex, const Explicit::StateSet& smallerFinalStates,
 	const DoubleIndexedTupleList& biggerIndex, const Explicit::StateSet& biggerFinalStates,
-	const std::vector<std::vector<size_t>>& ind, const std::vector<std::vector<size_t>>& inv
+	const VATA::Util::BinaryRelation::IndexType& ind, const VATA::Util::BinaryRelation::IndexType& inv
 ) {
 
+	VATA_STATS_TIMER("explicit.downward_inclusion.time_ns");
+
 	Util::CachedBinaryOp<const StateSet*, const StateSet*, bool> lteCache;
 
 	BiggerTypeCache biggerTypeCache(
@@ -565,7 +583,7 @@ bool VATA::ExplicitDownwardInclusion::checkInternal(
 
 	Antichain2C nonincluded;
 
-	std::vector<size_t> v(biggerFinalStates.begin(), biggerFinalStates.end());
+	StateSet v(biggerFinalStates.begin(), biggerFinalStates.end());
 
 	std::sort(v.begin(), v.end());
 
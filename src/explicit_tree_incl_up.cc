@@ -9,51 +9,64 @@
  *****************************************************************************/
 
 #include <set>
+#include <limits>
 #include <algorithm>
+#include <stdexcept>
 
 // VATA headers
 #include <vata/vata.hh>
 #include <vata/explicit_tree_aut.hh>
 #include <vata/util/cache.hh>
 #include <vata/util/cached_binary_op.hh>
+#include <vata/util/cancellation.hh>
+#include <vata/util/stats.hh>
+#include <vata/util/sorted_set_kernels.hh>
 #include <vata/util/antichain1c.hh>
 #include <vata/util/antichain2c_v2.hh>
 
 #include <vata/explicit_tree_incl_up.hh>
 
-template <class T1, class T2>
-bool checkIntersection(const T1& s1, const T2& s2) {
+using VATA::Util::SortedSetKernels::Intersects;
 
-	auto i1 = s1.begin(), i2 = s2.begin();
+typedef VATA::ExplicitUpwardInclusion::TransitionId TransitionId;
+typedef VATA::ExplicitUpwardInclusion::TransitionIdList TransitionIdList;
 
-	while (i1 != s1.end() && i2 != s2.end()) {
+// intersects sorted lists starting from the shortest one, so the kernels gallop
+// through the longer ones
+void intersection(std::vector<const TransitionIdList*>& lists,
+	TransitionIdList& result, TransitionIdList& buffer) {
 
-		if (*i1 < *i2) ++i1;
-		else if (*i2 < *i1) ++i2;
-		else return true;
+	assert(lists.size());
 
-	}
+	std::sort(
+		lists.begin(), lists.end(),
+		[](const TransitionIdList* x, const TransitionIdList* y) {
+			return x->size() < y->size();
+		}
+	);
 
-	return false;
+	result.assign(lists[0]->begin(), lists[0]->end());
 
-}
+	for (size_t i = 1; (i < lists.size()) && !result.empty(); ++i) {
 
-template <class T1, class T2>
-void intersectionByLookup(T1& d, const T2& s) {
-
-	for (auto i = d.begin(); i != d.end(); ) {
+		buffer.resize(result.size());
+		buffer.resize(
+			VATA::Util::SortedSetKernels::Ops<TransitionId>::Intersection(
+				result.data(), result.size(), lists[i]->data(), lists[i]->size(),
+				buffer.data()
+			)
+		);
 
-		if (s.count(*i) == 0)
-			i = d.erase(i);
-		else
-			++i;
+		result.swap(buffer);
 
 	}
 
 }
 
 typedef VATA::Explicit::StateType SmallerType;
-typedef std::vector<VATA::Explicit::StateType> StateSet;
+// macro-states of the bigger automaton are mostly small, so they are stored
+// inline
+typedef VATA::Util::SmallOrdVector<VATA::Explicit::StateType>::Type StateSet;
 
 typedef size_t SymbolType;
 
@@ -196,26 +209,156 @@ public:
 
 };
 
+void VATA::ExplicitUpwardInclusion::TransitionIndex::init(
+	std::vector<Entry>& entries, std::vector<std::vector<Explicit::StateType>>& leaves) {
+
+	if (entries.size() > std::numeric_limits<TransitionId>::max())
+		throw std::runtime_error("Too many transitions for the upward inclusion index");
+
+	std::sort(entries.begin(), entries.end());
+
+	this->symbols_.reserve(entries.size());
+	this->parents_.reserve(entries.size());
+	this->children_.reserve(entries.size());
+
+	for (auto& entry : entries) {
+
+		this->symbols_.push_back(entry.symbol_);
+		this->parents_.push_back(entry.state_);
+		this->children_.push_back(entry.children_);
+
+		this->states_ = std::max(this->states_, static_cast<size_t>(entry.state_) + 1);
+
+		for (auto& state : *entry.children_)
+			this->states_ = std::max(this->states_, static_cast<size_t>(state) + 1);
+
+	}
+
+	this->leafOffsets_.assign(1, 0);
+
+	for (auto& parents : leaves) {
+
+		this->leafParents_.insert(this->leafParents_.end(), parents.begin(), parents.end());
+		this->leafOffsets_.push_back(this->leafParents_.size());
+
+		for (auto& state : parents)
+			this->states_ = std::max(this->states_, static_cast<size_t>(state) + 1);
+
+	}
+
+}
+
+void VATA::ExplicitUpwardInclusion::TransitionIndex::indexByChild() {
+
+	this->childOffsets_.assign(this->states_ + 1, 0);
+
+	for (auto& children : this->children_) {
+
+		for (auto& state : *children)
+			++this->childOffsets_[state + 1];
+
+	}
+
+	for (size_t i = 1; i < this->childOffsets_.size(); ++i)
+		this->childOffsets_[i] += this->childOffsets_[i - 1];
+
+	this->childTransitions_.resize(this->childOffsets_.back());
+	this->childPositions_.resize(this->childOffsets_.back());
+
+	std::vector<size_t> next(this->childOffsets_.begin(), this->childOffsets_.end() - 1);
+
+	for (size_t transition = 0; transition < this->children_.size(); ++transition) {
+
+		auto& children = *this->children_[transition];
+
+		for (size_t i = 0; i < children.size(); ++i) {
+
+			size_t pos = next[children[i]]++;
+
+			this->childTransitions_[pos] = transition;
+			this->childPositions_[pos] = i;
+
+		}
+
+	}
+
+}
+
+void VATA::ExplicitUpwardInclusion::TransitionIndex::indexBySymbolPositionChild() {
+
+	// the transitions are sorted by symbols
+	size_t symbols = this->symbols_.empty() ? 0 : this->symbols_.back() + 1;
+
+	std::vector<size_t> arity(symbols, 0);
+
+	for (size_t transition = 0; transition < this->children_.size(); ++transition) {
+
+		auto& symbolArity = arity[this->symbols_[transition]];
+
+		symbolArity = std::max(symbolArity, this->children_[transition]->size());
+
+	}
+
+	this->slotOffsets_.assign(1, 0);
+
+	for (auto& symbolArity : arity)
+		this->slotOffsets_.push_back(this->slotOffsets_.back() + symbolArity * this->states_);
+
+	this->postingOffsets_.assign(this->slotOffsets_.back() + 1, 0);
+
+	auto slot = [this](TransitionId transition, size_t i) -> size_t {
+
+		return this->slotOffsets_[this->symbols_[transition]] + i * this->states_ +
+			(*this->children_[transition])[i];
+
+	};
+
+	for (size_t transition = 0; transition < this->children_.size(); ++transition) {
+
+		for (size_t i = 0; i < this->children_[transition]->size(); ++i)
+			++this->postingOffsets_[slot(transition, i) + 1];
+
+	}
+
+	for (size_t i = 1; i < this->postingOffsets_.size(); ++i)
+		this->postingOffsets_[i] += this->postingOffsets_[i - 1];
+
+	this->postings_.resize(this->postingOffsets_.back());
+
+	std::vector<size_t> next(this->postingOffsets_.begin(), this->postingOffsets_.end() - 1);
+
+	// the ids are visited in the ascending order, so the lists come out sorted
+	for (size_t transition = 0; transition < this->children_.size(); ++transition) {
+
+		for (size_t i = 0; i < this->children_[transition]->size(); ++i)
+			this->postings_[next[slot(transition, i)]++] = transition;
+
+	}
+
+}
+
 bool VATA::ExplicitUpwardInclusion::checkInternal(
-	const SymbolToTransitionListMap& smallerLeaves,
-	const IndexedSymbolToIndexedTransitionListMap& smallerIndex,
+	const TransitionIndex& smallerIndex,
 	const Explicit::StateSet& smallerFinalStates,
-	const SymbolToTransitionListMap& biggerLeaves,
-	const SymbolToDoubleIndexedTransitionListMap& biggerIndex,
+	const TransitionIndex& biggerIndex,
 	const Explicit::StateSet& biggerFinalStates,
-	const std::vector<std::vector<size_t>>& ind,
-	const std::vector<std::vector<size_t>>& inv
+	const VATA::Util::BinaryRelation::IndexType& ind,
+	const VATA::Util::BinaryRelation::IndexType& inv
 ) {
 
+	VATA_STATS_TIMER("explicit.upward_inclusion.time_ns");
+
 	auto noncachedLte = [&ind](const StateSet* x, const StateSet* y) -> bool {
 
 		assert(x); assert(y);
 
+		VATA_STATS_INC("lte_cache.misses");
+
 		for (auto& s1 : *x) {
 
 			assert(s1 < ind.size());
 
-			if (!checkIntersection(ind[s1], *y))
+			if (!Intersects(ind[s1], y->ToVector()))
 				return false;
 
 		}
@@ -230,54 +373,56 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 
 		assert(x); assert(y);
 
-		return (x.get() == y.get())?(true):(lteCache.lookup(x.get(), y.get(), noncachedLte));
+		if (x.get() == y.get())
+			return true;
+
+		VATA_STATS_INC("lte_cache.lookups");
+
+		return lteCache.lookup(x.get(), y.get(), noncachedLte);
 
 	};
 
 	auto gte = [&lte](const BiggerType& x, const BiggerType& y) { return lte(y, x); };
 
-	typedef VATA::ExplicitUpwardInclusion::Transition Transition;
-	typedef std::unordered_set<const Transition*> TransitionSet;
-	typedef typename std::shared_ptr<TransitionSet> TransitionSetPtr;
+	typedef typename std::shared_ptr<TransitionIdList> TransitionIdListPtr;
 
 	auto noncachedEvalTransitions = [&biggerIndex](const std::pair<SymbolType, size_t>& key,
-		const StateSet* states) -> TransitionSetPtr {
+		const StateSet* states) -> TransitionIdListPtr {
 
 		assert(states);
 
-		TransitionSetPtr result = TransitionSetPtr(new TransitionSet());
+		TransitionIdListPtr result = TransitionIdListPtr(new TransitionIdList());
 
-		if (biggerIndex.size() <= key.first)
-			return result;
-
-		auto& iter = biggerIndex[key.first];
-
-		if (iter.size() <= key.second)
-			return result;
-
-		auto& indexedTransitionList = iter[key.second];
+		size_t lists = 0;
 
 		for (auto& state: *states) {
 
-			if (state >= indexedTransitionList.size())
+			auto range = biggerIndex.postings(key.first, key.second, state);
+
+			if (range.first == range.second)
 				continue;
 
-			for (auto& transition : indexedTransitionList[state])
-				result->insert(transition.get());
+			result->insert(result->end(), range.first, range.second);
+
+			++lists;
 
 		}
 
+		// every transition has a single child at the position
+		if (lists > 1)
+			std::sort(result->begin(), result->end());
+
 		return result;
 
 	};
 
 	Util::CachedBinaryOp<
-		std::pair<SymbolType, size_t>, const StateSet*, TransitionSetPtr
+		std::pair<SymbolType, size_t>, const StateSet*, TransitionIdListPtr
 	> evalTransitionsCache;
 
 	auto evalTransitions = [&noncachedEvalTransitions, &evalTransitionsCache](
 		const SymbolType& symbol, size_t i, const StateSet* states)
-		-> TransitionSetPtr {
+		-> TransitionIdListPtr {
 
 		assert(states);
 
@@ -305,60 +450,58 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 
 	// Post(\emptyset)
 
-	if (biggerLeaves.size() < smallerLeaves.size())
+	if (biggerIndex.leafSymbols() < smallerIndex.leafSymbols())
 		return false;
 
-	for (size_t symbol = 0; symbol < smallerLeaves.size(); ++symbol) {
+	for (size_t symbol = 0; symbol < smallerIndex.leafSymbols(); ++symbol) {
 
 		post.clear();
 		isAccepting = false;
 
-		for (auto& transition : biggerLeaves[symbol]) {
+		auto biggerLeaves = biggerIndex.leafParents(symbol);
+
+		for (auto state = biggerLeaves.first; state != biggerLeaves.second; ++state) {
 
-			assert(transition);
-			assert(transition->children().empty());
-			assert(transition->state() < ind.size());
+			assert(*state < ind.size());
 
-			if (post.contains(ind[transition->state()]))
+			if (post.contains(ind[*state]))
 				continue;
 
-			assert(transition->state() < inv.size());
+			assert(*state < inv.size());
 
-			post.refine(inv[transition->state()]);
-			post.insert(transition->state());
+			post.refine(inv[*state]);
+			post.insert(*state);
 
-			isAccepting = isAccepting || biggerFinalStates.count(transition->state());
+			isAccepting = isAccepting || biggerFinalStates.count(*state);
 
 		}
 
 		StateSet tmp(post.data().begin(), post.data().end());
 
-		std::sort(tmp.begin(), tmp.end());
-
 		auto ptr = biggerTypeCache.lookup(tmp);
 
-		for (auto& transition : smallerLeaves[symbol]) {
+		auto smallerLeaves = smallerIndex.leafParents(symbol);
 
-			assert(transition);
+		for (auto state = smallerLeaves.first; state != smallerLeaves.second; ++state) {
 
-			if (!isAccepting && smallerFinalStates.count(transition->state()))
+			if (!isAccepting && smallerFinalStates.count(*state))
 				return false;
 
-			assert(transition->state() < ind.size());
+			assert(*state < ind.size());
 
-			if (checkIntersection(ind[transition->state()], tmp))
+			if (Intersects(ind[*state], tmp.ToVector()))
 				continue;
 
-			if (processed.contains(ind[transition->state()], ptr, lte))
+			if (processed.contains(ind[*state], ptr, lte))
 				continue;
 
-			assert(transition->state() < inv.size());
+			assert(*state < inv.size());
 
-			processed.refine(inv[transition->state()], ptr, gte, Eraser(next));
+			processed.refine(inv[*state], ptr, gte, Eraser(next));
 
-			Antichain2C::TList::iterator iter = processed.insert(transition->state(), ptr);
+			Antichain2C::TList::iterator iter = processed.insert(*state, ptr);
 
-			next.insert(std::make_pair(transition->state(), iter));
+			next.insert(std::make_pair(*state, iter));
 
 		}
 
@@ -372,8 +515,14 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 
 	ChoiceVector choiceVector(processed, fixedList);
 
+	std::vector<TransitionIdListPtr> listPtrs;
+	std::vector<const TransitionIdList*> lists;
+	TransitionIdList biggerTransitions, buffer;
+
 	while (!next.empty()) {
 
+		Util::PollCancellation("upward inclusion", next.size(), processed.size());
+
 		q = next.begin()->first;
 		Q = *next.begin()->second;
 
@@ -383,127 +532,115 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 
 		// Post(processed)
 
-		auto& smallerTransitionIndex = smallerIndex[q];
+		auto range = smallerIndex.byChild(q);
 
-		for (size_t symbol = 0; symbol < smallerTransitionIndex.size(); ++symbol) {
+		for (size_t i = range.first; i < range.second; ++i) {
 
-			size_t j = 0;
+			TransitionId smallerTransition = smallerIndex.childTransitions()[i];
 
-			for (auto& smallerTransitions : smallerTransitionIndex[symbol]) {
+			size_t symbol = smallerIndex.symbol(smallerTransition);
+			auto& smallerState = smallerIndex.parent(smallerTransition);
 
-				for (auto& smallerTransition : smallerTransitions) {
-
-					assert(smallerTransition);
-
-					if (!choiceVector.build(smallerTransition->children(), j))
-						continue;
-
-					do {
-
-						post.clear();
-						isAccepting = false;
-
-						assert(choiceVector(0));
-
-						auto firstSet = evalTransitions(symbol, 0, choiceVector(0).get());
+			if (!choiceVector.build(
+				smallerIndex.children(smallerTransition), smallerIndex.childPositions()[i]
+			))
+				continue;
 
-						assert(firstSet);
+			do {
 
-						std::list<const Transition*> biggerTransitions(
-							firstSet->begin(), firstSet->end()
-						);
+				post.clear();
+				isAccepting = false;
 
-						for (size_t k = 1; k < choiceVector.size(); ++k) {
+				lists.clear();
+				listPtrs.clear();
 
-							assert(choiceVector(k));
+				for (size_t k = 0; k < choiceVector.size(); ++k) {
 
-							auto transitions = evalTransitions(
-								symbol, k, choiceVector(k).get()
-							);
+					assert(choiceVector(k));
 
-							assert(transitions);
+					listPtrs.push_back(evalTransitions(symbol, k, choiceVector(k).get()));
 
-							intersectionByLookup(biggerTransitions, *transitions);
+					assert(listPtrs.back());
 
-						}
+					lists.push_back(listPtrs.back().get());
 
-						for (auto& biggerTransition : biggerTransitions) {
+				}
 
-							assert(biggerTransition);
-							assert(biggerTransition->state() < ind.size());
+				intersection(lists, biggerTransitions, buffer);
 
-							if (post.contains(ind[biggerTransition->state()]))
-								continue;
+				// the transitions of a symbol are sorted by parents
+				for (size_t k = 0; k < biggerTransitions.size(); ++k) {
 
-							assert(biggerTransition->state() < inv.size());
+					auto& biggerState = biggerIndex.parent(biggerTransitions[k]);
 
-							post.refine(inv[biggerTransition->state()]);
-							post.insert(biggerTransition->state());
+					if (k && (biggerIndex.parent(biggerTransitions[k - 1]) == biggerState))
+						continue;
 
-							isAccepting = isAccepting ||
-								biggerFinalStates.count(biggerTransition->state());
+					assert(biggerState < ind.size());
 
-						}
+					if (post.contains(ind[biggerState]))
+						continue;
 
-						if (post.data().empty())
-							return false;
+					assert(biggerState < inv.size());
 
-						if (!isAccepting && smallerFinalStates.count(smallerTransition->state()))
-							return false;
+					post.refine(inv[biggerState]);
+					post.insert(biggerState);
 
-						StateSet tmp(post.data().begin(), post.data().end());
+					isAccepting = isAccepting || biggerFinalStates.count(biggerState);
 
-						std::sort(tmp.begin(), tmp.end());
+				}
 
-						assert(smallerTransition->state() < ind.size());
+				if (post.data().empty())
+					return false;
 
-						if (checkIntersection(ind[smallerTransition->state()], tmp))
-							continue;
+				if (!isAccepting && smallerFinalStates.count(smallerState))
+					return false;
 
-						auto ptr = biggerTypeCache.lookup(tmp);
+				StateSet tmp(post.data().begin(), post.data().end());
 
-						if (temporary.contains(ind[smallerTransition->state()], ptr, lte))
-							continue;
+				assert(smallerState < ind.size());
 
-						assert(smallerTransition->state() < inv.size());
+				if (Intersects(ind[smallerState], tmp.ToVector()))
+					continue;
 
-						temporary.refine(inv[smallerTransition->state()], ptr, gte);
-						temporary.insert(smallerTransition->state(), ptr);
+				auto ptr = biggerTypeCache.lookup(tmp);
 
-					} while (choiceVector.next());
+				if (temporary.contains(ind[smallerState], ptr, lte))
+					continue;
 
-					for (auto& smallerBiggerListPair : temporary.data()) {
+				assert(smallerState < inv.size());
 
-						for (auto& bigger : smallerBiggerListPair.second) {
+				temporary.refine(inv[smallerState], ptr, gte);
+				temporary.insert(smallerState, ptr);
 
-							assert(smallerBiggerListPair.first < ind.size());
+			} while (choiceVector.next());
 
-							if (processed.contains(ind[smallerBiggerListPair.first], bigger, lte))
-								continue;
+			for (auto& smallerBiggerListPair : temporary.data()) {
 
-							assert(smallerBiggerListPair.first < inv.size());
+				for (auto& bigger : smallerBiggerListPair.second) {
 
-							processed.refine(
-								inv[smallerBiggerListPair.first], bigger, gte, Eraser(next)
-							);
+					assert(smallerBiggerListPair.first < ind.size());
 
-							Antichain2C::TList::iterator iter =
-								processed.insert(smallerBiggerListPair.first, bigger);
+					if (processed.contains(ind[smallerBiggerListPair.first], bigger, lte))
+						continue;
 
-							next.insert(std::make_pair(smallerBiggerListPair.first, iter));
+					assert(smallerBiggerListPair.first < inv.size());
 
-						}
+					processed.refine(
+						inv[smallerBiggerListPair.first], bigger, gte, Eraser(next)
+					);
 
-					}
+					Antichain2C::TList::iterator iter =
+						processed.insert(smallerBiggerListPair.first, bigger);
 
-					temporary.clear();
+					next.insert(std::make_pair(smallerBiggerListPair.first, iter));
 
 				}
 
-				++j;
-
 			}
 
+			temporary.clear();
+
 		}
 
 	}
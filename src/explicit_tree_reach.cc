@@ -0,0 +1,274 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2012  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of the bottom-up reachability kernel of explicit tree
+ *    automata.
+ *
+ *****************************************************************************/
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <thread>
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/explicit_tree_reach.hh>
+
+using VATA::ExplicitTreeReachability;
+
+// frontiers smaller than this are not worth splitting among threads
+static const size_t MIN_PARALLEL_FRONTIER = 1024;
+
+static const size_t NO_WITNESS = std::numeric_limits<size_t>::max();
+
+size_t ExplicitTreeReachability::getIndex(const StateType& state) {
+
+	auto p = this->stateIndex_.insert(std::make_pair(state, this->states_.size()));
+
+	if (p.second)
+		this->states_.push_back(state);
+
+	return p.first->second;
+
+}
+
+void ExplicitTreeReachability::SetTarget(const StateType& state) {
+
+	size_t index = this->getIndex(state);
+
+	if (this->targets_.size() <= index)
+		this->targets_.resize(index + 1, 0);
+
+	this->targets_[index] = 1;
+
+}
+
+void ExplicitTreeReachability::buildOccurrences() {
+
+	// count occurrences of each state
+	this->occurrenceOffsets_.assign(this->states_.size() + 1, 0);
+
+	for (auto& child : this->children_)
+		++this->occurrenceOffsets_[child + 1];
+
+	for (size_t i = 1; i < this->occurrenceOffsets_.size(); ++i)
+		this->occurrenceOffsets_[i] += this->occurrenceOffsets_[i - 1];
+
+	// fill the lists
+	std::vector<size_t> next(
+		this->occurrenceOffsets_.begin(), this->occurrenceOffsets_.end() - 1
+	);
+
+	this->occurrences_.resize(this->children_.size());
+
+	for (size_t t = 0; t < this->parents_.size(); ++t) {
+
+		for (size_t i = this->childOffsets_[t]; i < this->childOffsets_[t + 1]; ++i)
+			this->occurrences_[next[this->children_[i]]++] = t;
+
+	}
+
+}
+
+bool ExplicitTreeReachability::runSequential(const std::vector<size_t>& initial,
+	bool stopAtTarget) {
+
+	std::vector<size_t> counters(this->parents_.size());
+
+	for (size_t t = 0; t < this->parents_.size(); ++t)
+		counters[t] = this->childOffsets_[t + 1] - this->childOffsets_[t];
+
+	std::vector<size_t> queue;
+	bool targetReached = false;
+
+	auto fire = [&](size_t t) {
+
+		this->fired_[t] = 1;
+
+		++this->firedCount_;
+
+		size_t parent = this->parents_[t];
+
+		if (this->reached_[parent])
+			return;
+
+		this->reached_[parent] = 1;
+		this->witnesses_[parent] = t;
+
+		queue.push_back(parent);
+
+		if ((parent < this->targets_.size()) && this->targets_[parent])
+			targetReached = true;
+
+	};
+
+	for (auto& t : initial)
+		fire(t);
+
+	for (size_t head = 0; head < queue.size(); ++head) {
+
+		if (stopAtTarget && targetReached)
+			break;
+
+		size_t state = queue[head];
+
+		for (size_t i = this->occurrenceOffsets_[state];
+			i < this->occurrenceOffsets_[state + 1]; ++i) {
+
+			size_t t = this->occurrences_[i];
+
+			assert(counters[t] > 0);
+
+			if (--counters[t] == 0)
+				fire(t);
+
+		}
+
+	}
+
+	return targetReached;
+
+}
+
+bool ExplicitTreeReachability::runParallel(const std::vector<size_t>& initial,
+	bool stopAtTarget) {
+
+	std::unique_ptr<std::atomic<size_t>[]> counters(
+		new std::atomic<size_t>[this->parents_.size()]
+	);
+
+	for (size_t t = 0; t < this->parents_.size(); ++t)
+		counters[t] = this->childOffsets_[t + 1] - this->childOffsets_[t];
+
+	std::unique_ptr<std::atomic<bool>[]> reached(
+		new std::atomic<bool>[this->states_.size()]
+	);
+
+	for (size_t s = 0; s < this->states_.size(); ++s)
+		reached[s] = false;
+
+	std::atomic<bool> targetReached(false);
+
+	// fires a transition, newly reached states are appended to next
+	auto fire = [&](size_t t, std::vector<size_t>& next, size_t& firedCount) {
+
+		this->fired_[t] = 1;
+
+		++firedCount;
+
+		size_t parent = this->parents_[t];
+
+		if (reached[parent].exchange(true))
+			return;
+
+		this->reached_[parent] = 1;
+		this->witnesses_[parent] = t;
+
+		next.push_back(parent);
+
+		if ((parent < this->targets_.size()) && this->targets_[parent])
+			targetReached = true;
+
+	};
+
+	// processes a part of the frontier
+	auto process = [&](const size_t* begin, const size_t* end,
+		std::vector<size_t>& next, size_t& firedCount) {
+
+		for (; begin != end; ++begin) {
+
+			for (size_t i = this->occurrenceOffsets_[*begin];
+				i < this->occurrenceOffsets_[*begin + 1]; ++i) {
+
+				size_t t = this->occurrences_[i];
+
+				if (counters[t].fetch_sub(1) == 1)
+					fire(t, next, firedCount);
+
+			}
+
+		}
+
+	};
+
+	std::vector<size_t> frontier;
+
+	for (auto& t : initial)
+		fire(t, frontier, this->firedCount_);
+
+	while (!frontier.empty() && !(stopAtTarget && targetReached)) {
+
+		size_t threads = std::min<size_t>(
+			this->parallelism_, frontier.size() / MIN_PARALLEL_FRONTIER + 1
+		);
+
+		std::vector<std::vector<size_t>> nexts(threads);
+		std::vector<size_t> firedCounts(threads, 0);
+		std::vector<std::thread> workers;
+
+		size_t chunk = (frontier.size() + threads - 1) / threads;
+
+		for (size_t i = 1; i < threads; ++i) {
+
+			const size_t* begin = frontier.data() + std::min(i * chunk, frontier.size());
+			const size_t* end = frontier.data() + std::min((i + 1) * chunk, frontier.size());
+
+			workers.push_back(std::thread(process, begin, end, std::ref(nexts[i]),
+				std::ref(firedCounts[i])));
+
+		}
+
+		process(frontier.data(), frontier.data() + std::min(chunk, frontier.size()),
+			nexts[0], firedCounts[0]);
+
+		for (auto& worker : workers)
+			worker.join();
+
+		frontier.clear();
+
+		for (size_t i = 0; i < threads; ++i) {
+
+			frontier.insert(frontier.end(), nexts[i].begin(), nexts[i].end());
+
+			this->firedCount_ += firedCounts[i];
+
+		}
+
+	}
+
+	return targetReached;
+
+}
+
+bool ExplicitTreeReachability::Run(bool stopAtTarget) {
+
+	this->buildOccurrences();
+
+	this->reached_.assign(this->states_.size(), 0);
+	this->fired_.assign(this->parents_.size(), 0);
+	this->witnesses_.assign(this->states_.size(), NO_WITNESS);
+	this->firedCount_ = 0;
+
+	// transitions without children fire immediately
+	std::vector<size_t> initial;
+
+	for (size_t t = 0; t < this->parents_.size(); ++t) {
+
+		if (this->childOffsets_[t] == this->childOffsets_[t + 1])
+			initial.push_back(t);
+
+	}
+
+	if (this->parallelism_ > 1)
+		return this->runParallel(initial, stopAtTarget);
+
+	return this->runSequential(initial, stopAtTarget);
+
+}
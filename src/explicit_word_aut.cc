@@ -0,0 +1,609 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Source file for algorithms on explicitly represented word automata.
+ *
+ *****************************************************************************/
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/explicit_lts.hh>
+#include <vata/explicit_word_aut.hh>
+#include <vata/util/binary_relation.hh>
+#include <vata/util/cancellation.hh>
+#include <vata/util/stats.hh>
+
+using VATA::ExplicitLTS;
+using VATA::ExplicitWordAut;
+using VATA::Util::BinaryRelation;
+
+typedef ExplicitWordAut::StateType StateType;
+typedef ExplicitWordAut::LabelType LabelType;
+typedef ExplicitWordAut::StateBitSet StateBitSet;
+
+const ExplicitWordAut::StateList ExplicitWordAut::emptyList_;
+
+namespace {
+
+	/*
+	 * Successors of sets of states. The successors of a single state are kept as
+	 * a bit set when there are more of them than words in the set, so that the
+	 * cost of a state is the smaller of the two.
+	 */
+	class PostComputer {
+
+		const ExplicitWordAut& aut_;
+		std::vector<std::vector<StateBitSet>> dense_;
+
+	public:
+
+		PostComputer(const ExplicitWordAut& aut) : aut_(aut), dense_(aut.labels()) {
+
+			size_t words = (aut.states() + 63) / 64;
+
+			for (size_t label = 0; label < aut.labels(); ++label) {
+
+				for (size_t state = 0; state < aut.states(); ++state) {
+
+					auto& successors = aut.GetSuccessors(state, label);
+
+					if (successors.size() <= words)
+						continue;
+
+					if (this->dense_[label].empty())
+						this->dense_[label].resize(aut.states());
+
+					StateBitSet& set = this->dense_[label][state];
+
+					set = StateBitSet(aut.states());
+
+					for (auto& successor : successors)
+						set.set(successor);
+
+				}
+
+			}
+
+		}
+
+		StateBitSet post(const StateBitSet& set, const LabelType& label) const {
+
+			StateBitSet result(this->aut_.states());
+
+			if (label >= this->aut_.labels())
+				return result;
+
+			auto& dense = this->dense_[label];
+
+			set.forEach([this, &label, &dense, &result](size_t state) {
+
+				if ((state < dense.size()) && !dense[state].empty()) {
+
+					result.unite(dense[state]);
+
+					return;
+
+				}
+
+				for (auto& successor : this->aut_.GetSuccessors(state, label))
+					result.set(successor);
+
+			});
+
+			return result;
+
+		}
+
+		StateBitSet initial(const LabelType& label) const {
+
+			StateBitSet result(this->aut_.states());
+
+			for (auto& state : this->aut_.GetInitialStates(label))
+				result.set(state);
+
+			return result;
+
+		}
+
+		StateBitSet finalStates() const {
+
+			StateBitSet result(this->aut_.states());
+
+			for (size_t state = 0; state < this->aut_.states(); ++state) {
+
+				if (this->aut_.IsStateFinal(state))
+					result.set(state);
+
+			}
+
+			return result;
+
+		}
+
+	};
+
+	/*
+	 * For every state, the set of states it simulates; closing a set of states
+	 * under them allows to compare macrostates up to simulation using the subset
+	 * test. An empty table stands for the identity.
+	 */
+	class SimulatedStates {
+
+		std::vector<StateBitSet> rows_;
+
+	public:
+
+		SimulatedStates() : rows_() {}
+
+		SimulatedStates(const BinaryRelation& sim, size_t offset, size_t size)
+			: rows_(size, StateBitSet(size)) {
+
+			for (size_t p = 0; p < size; ++p) {
+
+				for (size_t q = 0; q < size; ++q) {
+
+					if (sim.get(offset + p, offset + q))
+						this->rows_[q].set(p);
+
+				}
+
+			}
+
+		}
+
+		StateBitSet close(const StateBitSet& set) const {
+
+			if (this->rows_.empty())
+				return set;
+
+			StateBitSet result(this->rows_.size());
+
+			set.forEach([this, &result](size_t state) {
+
+				result.unite(this->rows_[state]);
+
+			});
+
+			return result;
+
+		}
+
+	};
+
+	/*
+	 * Macrostates of which none is subsumed by another; a new macrostate is
+	 * subsumed by an old one if the old one is included in its closure.
+	 */
+	class Antichain {
+
+		std::vector<StateBitSet> sets_;
+
+	public:
+
+		Antichain() : sets_() {}
+
+		bool subsumes(const StateBitSet& closure) const {
+
+			for (auto& set : this->sets_) {
+
+				if (set.isSubsetOf(closure))
+					return true;
+
+			}
+
+			return false;
+
+		}
+
+		void insert(const StateBitSet& set) {
+
+			this->sets_.erase(
+				std::remove_if(
+					this->sets_.begin(), this->sets_.end(),
+					[&set](const StateBitSet& old) { return set.isSubsetOf(old); }
+				),
+				this->sets_.end()
+			);
+
+			this->sets_.push_back(set);
+
+		}
+
+		size_t size() const { return this->sets_.size(); }
+
+	};
+
+	void addToLTS(ExplicitLTS& lts, const ExplicitWordAut& aut, size_t offset) {
+
+		for (size_t label = 0; label < aut.labels(); ++label) {
+
+			for (size_t state = 0; state < aut.states(); ++state) {
+
+				for (auto& target : aut.GetSuccessors(state, label))
+					lts.addTransition(offset + state, label, offset + target);
+
+			}
+
+		}
+
+	}
+
+	/*
+	 * The simulation over the disjoint union of the automata, the states of the
+	 * second one follow the ones of the first one.
+	 */
+	BinaryRelation computeSimulation(const ExplicitWordAut& aut1,
+		const ExplicitWordAut* aut2) {
+
+		size_t states = aut1.states() + (aut2 ? aut2->states() : 0);
+		size_t labels = std::max(aut1.labels(), aut2 ? aut2->labels() : 0);
+
+		ExplicitLTS lts;
+
+		addToLTS(lts, aut1, 0);
+
+		if (aut2)
+			addToLTS(lts, *aut2, aut1.states());
+
+		lts.addTransition(states, labels, states);
+		lts.init();
+
+		// non-final states may be simulated by final states but not vice versa
+		ExplicitLTS::StateListTable blocks(2);
+
+		for (ExplicitLTS::StateType state = 0; state < states; ++state) {
+
+			bool isFinal = (state < aut1.states()) ?
+				aut1.IsStateFinal(state) : aut2->IsStateFinal(state - aut1.states());
+
+			blocks[isFinal ? 1 : 0].push_back(state);
+
+		}
+
+		ExplicitLTS::StateListTable partition;
+
+		for (auto& block : blocks) {
+
+			if (!block.empty())
+				partition.push_back(block);
+
+		}
+
+		partition.push_back(ExplicitLTS::StateListTable::value_type(1, states));
+
+		BinaryRelation relation(partition.size(), false);
+
+		for (size_t i = 0; i < partition.size(); ++i)
+			relation.set(i, i, true);
+
+		if (partition.size() == 3)
+			relation.set(0, 1, true);
+
+		return lts.computeSimulation(partition, relation, states);
+
+	}
+
+	class InclusionChecker {
+
+		const ExplicitWordAut& smaller_;
+		const ExplicitWordAut& bigger_;
+		PostComputer post_;
+		StateBitSet finalStates_;
+
+		// the states of the smaller automaton simulating a given one
+		std::vector<std::vector<StateType>> simulating_;
+		// the states of the bigger automaton simulating a given state of the smaller one
+		std::vector<StateBitSet> covering_;
+		SimulatedStates simulated_;
+
+		std::vector<Antichain> antichains_;
+		std::vector<std::pair<StateType, StateBitSet>> next_;
+
+		// returns false when the pair is a counterexample
+		bool insert(const StateType& state, const StateBitSet& macrostate) {
+
+			if (this->smaller_.IsStateFinal(state) &&
+				!macrostate.intersects(this->finalStates_))
+				return false;
+
+			if (!this->covering_.empty() && macrostate.intersects(this->covering_[state]))
+				return true;
+
+			StateBitSet closure = this->simulated_.close(macrostate);
+
+			if (this->simulating_.empty()) {
+
+				if (this->antichains_[state].subsumes(closure))
+					return true;
+
+			} else {
+
+				for (auto& simulating : this->simulating_[state]) {
+
+					if (this->antichains_[simulating].subsumes(closure))
+						return true;
+
+				}
+
+			}
+
+			this->antichains_[state].insert(macrostate);
+			this->next_.push_back(std::make_pair(state, macrostate));
+
+			VATA_STATS_MAX("word.antichain_max", this->antichains_[state].size());
+
+			return true;
+
+		}
+
+	public:
+
+		InclusionChecker(const ExplicitWordAut& smaller, const ExplicitWordAut& bigger,
+			bool useSimulation) : smaller_(smaller), bigger_(bigger), post_(bigger),
+			finalStates_(post_.finalStates()), simulating_(), covering_(),
+			simulated_(), antichains_(smaller.states()), next_() {
+
+			if (!useSimulation)
+				return;
+
+			BinaryRelation sim = computeSimulation(smaller, &bigger);
+
+			size_t offset = smaller.states();
+
+			this->simulating_.resize(smaller.states());
+			this->covering_.resize(smaller.states(), StateBitSet(bigger.states()));
+
+			for (size_t p = 0; p < smaller.states(); ++p) {
+
+				for (size_t r = 0; r < smaller.states(); ++r) {
+
+					if (sim.get(p, r))
+						this->simulating_[p].push_back(r);
+
+				}
+
+				for (size_t q = 0; q < bigger.states(); ++q) {
+
+					if (sim.get(p, offset + q))
+						this->covering_[p].set(q);
+
+				}
+
+			}
+
+			this->simulated_ = SimulatedStates(sim, offset, bigger.states());
+
+		}
+
+		bool check() {
+
+			for (size_t label = 0; label < this->smaller_.labels(); ++label) {
+
+				auto& initialStates = this->smaller_.GetInitialStates(label);
+
+				if (initialStates.empty())
+					continue;
+
+				StateBitSet macrostate = this->post_.initial(label);
+
+				for (auto& state : initialStates) {
+
+					if (!this->insert(state, macrostate))
+						return false;
+
+				}
+
+			}
+
+			while (!this->next_.empty()) {
+
+				VATA::Util::PollCancellation("word inclusion", this->next_.size());
+
+				std::pair<StateType, StateBitSet> pair = this->next_.back();
+
+				this->next_.pop_back();
+
+				for (size_t label = 0; label < this->smaller_.labels(); ++label) {
+
+					auto& successors = this->smaller_.GetSuccessors(pair.first, label);
+
+					if (successors.empty())
+						continue;
+
+					StateBitSet macrostate = this->post_.post(pair.second, label);
+
+					for (auto& successor : successors) {
+
+						if (!this->insert(successor, macrostate))
+							return false;
+
+					}
+
+				}
+
+			}
+
+			return true;
+
+		}
+
+	};
+
+}
+
+ExplicitLTS ExplicitWordAut::TranslateToLTS() const {
+
+	ExplicitLTS lts;
+
+	addToLTS(lts, *this, 0);
+
+	lts.addTransition(this->states_, this->labels(), this->states_);
+	lts.init();
+
+	return lts;
+
+}
+
+BinaryRelation ExplicitWordAut::ComputeSimulation() const {
+
+	return computeSimulation(*this, nullptr);
+
+}
+
+ExplicitWordAut ExplicitWordAut::Determinize() const {
+
+	typedef std::unordered_map<StateBitSet, StateType, boost::hash<StateBitSet>>
+		MacrostateMap;
+
+	PostComputer post(*this);
+	StateBitSet finalStates = post.finalStates();
+
+	ExplicitWordAut result;
+	MacrostateMap macrostates;
+	std::vector<const StateBitSet*> next;
+
+	auto translate = [&result, &macrostates, &next, &finalStates](
+		const StateBitSet& macrostate) -> StateType {
+
+		auto p = macrostates.insert(std::make_pair(macrostate, macrostates.size()));
+
+		if (p.second) {
+
+			if (macrostate.intersects(finalStates))
+				result.SetStateFinal(p.first->second);
+
+			next.push_back(&p.first->first);
+
+		}
+
+		return p.first->second;
+
+	};
+
+	for (size_t label = 0; label < this->initialStates_.size(); ++label) {
+
+		if (!this->initialStates_[label].empty())
+			result.AddInitialTransition(label, translate(post.initial(label)));
+
+	}
+
+	while (!next.empty()) {
+
+		VATA::Util::PollCancellation("word determinization", next.size(),
+			macrostates.size());
+
+		const StateBitSet* macrostate = next.back();
+
+		next.pop_back();
+
+		StateType state = macrostates.find(*macrostate)->second;
+
+		for (size_t label = 0; label < this->transitions_.size(); ++label) {
+
+			StateBitSet successor = post.post(*macrostate, label);
+
+			if (!successor.empty())
+				result.AddTransition(state, label, translate(successor));
+
+		}
+
+	}
+
+	VATA_STATS_MAX("word.determinized_states_max", result.states());
+
+	return result;
+
+}
+
+bool ExplicitWordAut::CheckInclusion(const ExplicitWordAut& smaller,
+	const ExplicitWordAut& bigger, bool useSimulation) {
+
+	VATA_STATS_TIMER("word.inclusion.time_ns");
+
+	return InclusionChecker(smaller, bigger, useSimulation).check();
+
+}
+
+bool ExplicitWordAut::CheckUniversality(const AlphabetType& alphabet,
+	bool useSimulation) const {
+
+	VATA_STATS_TIMER("word.universality.time_ns");
+
+	std::vector<LabelType> leafLabels, unaryLabels;
+
+	for (auto& labelRankPair : alphabet) {
+
+		switch (labelRankPair.second) {
+
+			case 0: leafLabels.push_back(labelRankPair.first); break;
+			case 1: unaryLabels.push_back(labelRankPair.first); break;
+			default:
+				throw std::runtime_error("Symbols of word automata have rank at most one");
+
+		}
+
+	}
+
+	PostComputer post(*this);
+	StateBitSet finalStates = post.finalStates();
+	SimulatedStates simulated;
+
+	if (useSimulation)
+		simulated = SimulatedStates(this->ComputeSimulation(), 0, this->states_);
+
+	Antichain antichain;
+	std::vector<StateBitSet> next;
+
+	// returns false when the macrostate is a counterexample
+	auto insert = [&finalStates, &simulated, &antichain, &next](
+		const StateBitSet& macrostate) -> bool {
+
+		if (!macrostate.intersects(finalStates))
+			return false;
+
+		if (antichain.subsumes(simulated.close(macrostate)))
+			return true;
+
+		antichain.insert(macrostate);
+		next.push_back(macrostate);
+
+		VATA_STATS_MAX("word.antichain_max", antichain.size());
+
+		return true;
+
+	};
+
+	for (auto& label : leafLabels) {
+
+		if (!insert(post.initial(label)))
+			return false;
+
+	}
+
+	while (!next.empty()) {
+
+		VATA::Util::PollCancellation("word universality", next.size());
+
+		StateBitSet macrostate = next.back();
+
+		next.pop_back();
+
+		for (auto& label : unaryLabels) {
+
+			if (!insert(post.post(macrostate, label)))
+				return false;
+
+		}
+
+	}
+
+	return true;
+
+}
@@ -49,7 +49,7 @@ FILE* FakeFile::OpenWrite()
 }
 
 
-FILE* FakeFile::OpenRead(std::string str)
+FILE* FakeFile::OpenRead(const std::string& str)
 {
 	if (str.empty())
 	{
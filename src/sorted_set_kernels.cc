@@ -0,0 +1,179 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of the scalar kernels of operations on sorted sets and of
+ *    the selection of kernels at runtime.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/util/sorted_set_kernels.hh>
+
+using VATA::Util::SortedSetKernels::Algorithms;
+using VATA::Util::SortedSetKernels::GenericBlock;
+using VATA::Util::SortedSetKernels::InstructionSet;
+using VATA::Util::SortedSetKernels::KernelTable;
+
+namespace
+{
+	typedef Algorithms<GenericBlock<uint32_t>> Scalar32;
+	typedef Algorithms<GenericBlock<uint64_t>> Scalar64;
+
+	const KernelTable SCALAR_KERNELS =
+	{
+		&Scalar32::Union,
+		&Scalar64::Union,
+		&Scalar32::Intersection,
+		&Scalar64::Intersection,
+		&Scalar32::IsSubset,
+		&Scalar64::IsSubset,
+		&Scalar32::Intersects,
+		&Scalar64::Intersects
+	};
+
+	bool isSupported(InstructionSet isa)
+	{
+		switch (isa)
+		{
+			case InstructionSet::SCALAR: return true;
+#ifdef VATA_SIMD_KERNELS
+			case InstructionSet::SSE42: return __builtin_cpu_supports("sse4.2");
+			case InstructionSet::AVX2: return __builtin_cpu_supports("avx2");
+#endif
+			default: return false;
+		}
+	}
+
+	const KernelTable* tableOf(InstructionSet isa)
+	{
+		switch (isa)
+		{
+#ifdef VATA_SIMD_KERNELS
+			case InstructionSet::SSE42:
+				return &VATA::Util::SortedSetKernels::SSE42_KERNELS;
+			case InstructionSet::AVX2:
+				return &VATA::Util::SortedSetKernels::AVX2_KERNELS;
+#endif
+			default: return &SCALAR_KERNELS;
+		}
+	}
+
+	InstructionSet detectInstructionSet()
+	{
+		if (isSupported(InstructionSet::AVX2))
+		{
+			return InstructionSet::AVX2;
+		}
+
+		if (isSupported(InstructionSet::SSE42))
+		{
+			return InstructionSet::SSE42;
+		}
+
+		return InstructionSet::SCALAR;
+	}
+
+	InstructionSet& currentInstructionSet()
+	{
+		static InstructionSet isa = detectInstructionSet();
+		return isa;
+	}
+
+	const KernelTable*& currentTable()
+	{
+		static const KernelTable* table = tableOf(currentInstructionSet());
+		return table;
+	}
+}
+
+
+InstructionSet VATA::Util::SortedSetKernels::GetInstructionSet()
+{
+	return currentInstructionSet();
+}
+
+
+bool VATA::Util::SortedSetKernels::SetInstructionSet(InstructionSet isa)
+{
+	if (!isSupported(isa))
+	{
+		return false;
+	}
+
+	currentInstructionSet() = isa;
+	currentTable() = tableOf(isa);
+	return true;
+}
+
+
+const char* VATA::Util::SortedSetKernels::GetInstructionSetName(
+	InstructionSet isa)
+{
+	switch (isa)
+	{
+		case InstructionSet::SCALAR: return "scalar";
+		case InstructionSet::SSE42: return "sse4.2";
+		case InstructionSet::AVX2: return "avx2";
+		default: assert(false); return "";
+	}
+}
+
+
+size_t VATA::Util::SortedSetKernels::Union(const uint32_t* lhs,
+	size_t lhsSize, const uint32_t* rhs, size_t rhsSize, uint32_t* out)
+{
+	return currentTable()->union32(lhs, lhsSize, rhs, rhsSize, out);
+}
+
+
+size_t VATA::Util::SortedSetKernels::Union(const uint64_t* lhs,
+	size_t lhsSize, const uint64_t* rhs, size_t rhsSize, uint64_t* out)
+{
+	return currentTable()->union64(lhs, lhsSize, rhs, rhsSize, out);
+}
+
+
+size_t VATA::Util::SortedSetKernels::Intersection(const uint32_t* lhs,
+	size_t lhsSize, const uint32_t* rhs, size_t rhsSize, uint32_t* out)
+{
+	return currentTable()->intersection32(lhs, lhsSize, rhs, rhsSize, out);
+}
+
+
+size_t VATA::Util::SortedSetKernels::Intersection(const uint64_t* lhs,
+	size_t lhsSize, const uint64_t* rhs, size_t rhsSize, uint64_t* out)
+{
+	return currentTable()->intersection64(lhs, lhsSize, rhs, rhsSize, out);
+}
+
+
+bool VATA::Util::SortedSetKernels::IsSubset(const uint32_t* smaller,
+	size_t smallerSize, const uint32_t* bigger, size_t biggerSize)
+{
+	return currentTable()->isSubset32(smaller, smallerSize, bigger, biggerSize);
+}
+
+
+bool VATA::Util::SortedSetKernels::IsSubset(const uint64_t* smaller,
+	size_t smallerSize, const uint64_t* bigger, size_t biggerSize)
+{
+	return currentTable()->isSubset64(smaller, smallerSize, bigger, biggerSize);
+}
+
+
+bool VATA::Util::SortedSetKernels::Intersects(const uint32_t* lhs,
+	size_t lhsSize, const uint32_t* rhs, size_t rhsSize)
+{
+	return currentTable()->intersects32(lhs, lhsSize, rhs, rhsSize);
+}
+
+
+bool VATA::Util::SortedSetKernels::Intersects(const uint64_t* lhs,
+	size_t lhsSize, const uint64_t* rhs, size_t rhsSize)
+{
+	return currentTable()->intersects64(lhs, lhsSize, rhs, rhsSize);
+}
@@ -0,0 +1,124 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of the AVX2 kernels of operations on sorted sets. The
+ *    file is compiled with -mavx2.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/util/sorted_set_kernels.hh>
+
+#ifdef __AVX2__
+
+// Standard library headers
+#include <immintrin.h>
+
+using VATA::Util::SortedSetKernels::Algorithms;
+using VATA::Util::SortedSetKernels::KernelTable;
+
+namespace
+{
+	// unsigned comparison is carried out as signed comparison of biased values
+	struct Avx2Block32
+	{
+		typedef uint32_t ValueType;
+
+		static const size_t WIDTH = 8;
+
+		static const bool BLOCK_MATCHING = true;
+
+		static size_t CountLess(const uint32_t* block, uint32_t x)
+		{
+			const __m256i bias = _mm256_set1_epi32(0x80000000);
+			__m256i vec = _mm256_xor_si256(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), bias);
+			__m256i less = _mm256_cmpgt_epi32(
+				_mm256_xor_si256(_mm256_set1_epi32(x), bias), vec);
+			return __builtin_popcount(
+				_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+		}
+
+		static unsigned MatchMask(const uint32_t* lhs, const uint32_t* rhs)
+		{	// compare with all rotations of both lanes of rhs
+			__m256i lhsVec = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(lhs));
+			__m256i rhsVec = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(rhs));
+			__m256i rhsSwapped = _mm256_permute2x128_si256(rhsVec, rhsVec, 0x01);
+			__m256i eq = _mm256_or_si256(
+				_mm256_or_si256(
+					_mm256_or_si256(
+						_mm256_cmpeq_epi32(lhsVec, rhsVec),
+						_mm256_cmpeq_epi32(lhsVec, _mm256_shuffle_epi32(rhsVec, 0x39))),
+					_mm256_or_si256(
+						_mm256_cmpeq_epi32(lhsVec, _mm256_shuffle_epi32(rhsVec, 0x4E)),
+						_mm256_cmpeq_epi32(lhsVec, _mm256_shuffle_epi32(rhsVec, 0x93)))),
+				_mm256_or_si256(
+					_mm256_or_si256(
+						_mm256_cmpeq_epi32(lhsVec, rhsSwapped),
+						_mm256_cmpeq_epi32(lhsVec, _mm256_shuffle_epi32(rhsSwapped, 0x39))),
+					_mm256_or_si256(
+						_mm256_cmpeq_epi32(lhsVec, _mm256_shuffle_epi32(rhsSwapped, 0x4E)),
+						_mm256_cmpeq_epi32(lhsVec,
+							_mm256_shuffle_epi32(rhsSwapped, 0x93)))));
+			return _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+		}
+	};
+
+	struct Avx2Block64
+	{
+		typedef uint64_t ValueType;
+
+		static const size_t WIDTH = 4;
+
+		static const bool BLOCK_MATCHING = true;
+
+		static size_t CountLess(const uint64_t* block, uint64_t x)
+		{
+			const __m256i bias = _mm256_set1_epi64x(0x8000000000000000LL);
+			__m256i vec = _mm256_xor_si256(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), bias);
+			__m256i less = _mm256_cmpgt_epi64(
+				_mm256_xor_si256(_mm256_set1_epi64x(x), bias), vec);
+			return __builtin_popcount(
+				_mm256_movemask_pd(_mm256_castsi256_pd(less)));
+		}
+
+		static unsigned MatchMask(const uint64_t* lhs, const uint64_t* rhs)
+		{	// compare with all rotations of rhs
+			__m256i lhsVec = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(lhs));
+			__m256i rhsVec = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(rhs));
+			__m256i eq = _mm256_or_si256(
+				_mm256_or_si256(
+					_mm256_cmpeq_epi64(lhsVec, rhsVec),
+					_mm256_cmpeq_epi64(lhsVec, _mm256_permute4x64_epi64(rhsVec, 0x39))),
+				_mm256_or_si256(
+					_mm256_cmpeq_epi64(lhsVec, _mm256_permute4x64_epi64(rhsVec, 0x4E)),
+					_mm256_cmpeq_epi64(lhsVec, _mm256_permute4x64_epi64(rhsVec, 0x93))));
+			return _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+		}
+	};
+
+	typedef Algorithms<Avx2Block32> Avx32;
+	typedef Algorithms<Avx2Block64> Avx64;
+}
+
+const KernelTable VATA::Util::SortedSetKernels::AVX2_KERNELS =
+{
+	&Avx32::Union,
+	&Avx64::Union,
+	&Avx32::Intersection,
+	&Avx64::Intersection,
+	&Avx32::IsSubset,
+	&Avx64::IsSubset,
+	&Avx32::Intersects,
+	&Avx64::Intersects
+};
+
+#endif
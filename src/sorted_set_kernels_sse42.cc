@@ -0,0 +1,104 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of the SSE4.2 kernels of operations on sorted sets. The
+ *    file is compiled with -msse4.2.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/util/sorted_set_kernels.hh>
+
+#ifdef __SSE4_2__
+
+// Standard library headers
+#include <nmmintrin.h>
+
+using VATA::Util::SortedSetKernels::Algorithms;
+using VATA::Util::SortedSetKernels::KernelTable;
+
+namespace
+{
+	// unsigned comparison is carried out as signed comparison of biased values
+	struct SseBlock32
+	{
+		typedef uint32_t ValueType;
+
+		static const size_t WIDTH = 4;
+
+		static const bool BLOCK_MATCHING = true;
+
+		static size_t CountLess(const uint32_t* block, uint32_t x)
+		{
+			const __m128i bias = _mm_set1_epi32(0x80000000);
+			__m128i vec = _mm_xor_si128(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), bias);
+			__m128i less = _mm_cmpgt_epi32(
+				_mm_xor_si128(_mm_set1_epi32(x), bias), vec);
+			return __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(less)));
+		}
+
+		static unsigned MatchMask(const uint32_t* lhs, const uint32_t* rhs)
+		{	// compare with all rotations of rhs
+			__m128i lhsVec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs));
+			__m128i rhsVec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs));
+			__m128i eq = _mm_or_si128(
+				_mm_or_si128(
+					_mm_cmpeq_epi32(lhsVec, rhsVec),
+					_mm_cmpeq_epi32(lhsVec, _mm_shuffle_epi32(rhsVec, 0x39))),
+				_mm_or_si128(
+					_mm_cmpeq_epi32(lhsVec, _mm_shuffle_epi32(rhsVec, 0x4E)),
+					_mm_cmpeq_epi32(lhsVec, _mm_shuffle_epi32(rhsVec, 0x93))));
+			return _mm_movemask_ps(_mm_castsi128_ps(eq));
+		}
+	};
+
+	struct SseBlock64
+	{
+		typedef uint64_t ValueType;
+
+		static const size_t WIDTH = 2;
+
+		static const bool BLOCK_MATCHING = true;
+
+		static size_t CountLess(const uint64_t* block, uint64_t x)
+		{
+			const __m128i bias = _mm_set1_epi64x(0x8000000000000000LL);
+			__m128i vec = _mm_xor_si128(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), bias);
+			__m128i less = _mm_cmpgt_epi64(
+				_mm_xor_si128(_mm_set1_epi64x(x), bias), vec);
+			return __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(less)));
+		}
+
+		static unsigned MatchMask(const uint64_t* lhs, const uint64_t* rhs)
+		{	// compare with both rotations of rhs
+			__m128i lhsVec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs));
+			__m128i rhsVec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs));
+			__m128i eq = _mm_or_si128(
+				_mm_cmpeq_epi64(lhsVec, rhsVec),
+				_mm_cmpeq_epi64(lhsVec, _mm_shuffle_epi32(rhsVec, 0x4E)));
+			return _mm_movemask_pd(_mm_castsi128_pd(eq));
+		}
+	};
+
+	typedef Algorithms<SseBlock32> Sse32;
+	typedef Algorithms<SseBlock64> Sse64;
+}
+
+const KernelTable VATA::Util::SortedSetKernels::SSE42_KERNELS =
+{
+	&Sse32::Union,
+	&Sse64::Union,
+	&Sse32::Intersection,
+	&Sse64::Intersection,
+	&Sse32::IsSubset,
+	&Sse64::IsSubset,
+	&Sse32::Intersects,
+	&Sse64::Intersects
+};
+
+#endif
@@ -0,0 +1,124 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of the registry of statistics collected by the library.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/util/stats.hh>
+
+// Standard library headers
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+using VATA::Util::Stats::Entry;
+using VATA::Util::Stats::Kind;
+
+namespace
+{
+	typedef std::map<std::string, std::unique_ptr<Entry>> EntryMap;
+
+	// the registry is created on the first use so that entries may be
+	// registered during static initialization
+	EntryMap& entries()
+	{
+		static EntryMap map;
+		return map;
+	}
+
+	std::mutex& entriesMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+}
+
+
+Entry& VATA::Util::Stats::Register(const std::string& name, Kind kind)
+{
+	std::lock_guard<std::mutex> lock(entriesMutex());
+
+	std::unique_ptr<Entry>& entry = entries()[name];
+	if (!entry)
+	{	// the first request for the entry
+		entry.reset(new Entry(kind));
+	}
+	else if (entry->GetKind() != kind)
+	{
+		throw std::runtime_error("Statistic " + name +
+			" registered with different kinds");
+	}
+
+	return *entry;
+}
+
+
+void VATA::Util::Stats::Reset()
+{
+	std::lock_guard<std::mutex> lock(entriesMutex());
+
+	for (auto& nameEntryPair : entries())
+	{
+		nameEntryPair.second->Reset();
+	}
+}
+
+
+std::map<std::string, uint64_t> VATA::Util::Stats::GetValues()
+{
+	std::lock_guard<std::mutex> lock(entriesMutex());
+
+	std::map<std::string, uint64_t> result;
+	for (auto& nameEntryPair : entries())
+	{
+		result.insert(std::make_pair(nameEntryPair.first,
+			nameEntryPair.second->GetValue()));
+	}
+
+	return result;
+}
+
+
+uint64_t VATA::Util::Stats::GetValue(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(entriesMutex());
+
+	EntryMap::const_iterator itEntry = entries().find(name);
+	return (itEntry == entries().end())? 0 : itEntry->second->GetValue();
+}
+
+
+void VATA::Util::Stats::PrintJSON(std::ostream& os)
+{
+	std::map<std::string, uint64_t> values = GetValues();
+
+	os << "{";
+	for (auto itValue = values.begin(); itValue != values.end(); ++itValue)
+	{
+		if (itValue != values.begin())
+		{
+			os << ",";
+		}
+
+		// names consist of identifiers and dots, no escaping is needed
+		os << "\n  \"" << itValue->first << "\": " << itValue->second;
+	}
+
+	os << (values.empty()? "}" : "\n}") << "\n";
+}
+
+
+bool VATA::Util::Stats::IsEnabled()
+{
+#ifdef VATA_STATS
+	return true;
+#else
+	return false;
+#endif
+}
@@ -11,11 +11,159 @@
 // VATA headers
 #include <vata/vata.hh>
 #include <vata/symbolic_aut_base.hh>
+#include <vata/mtbdd/apply2func.hh>
+#include <vata/util/convert.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
 
 using VATA::SymbolicAutBase;
+using VATA::Util::AutDescription;
+using VATA::Util::Convert;
 
 SymbolicAutBase::StringToSymbolDict* SymbolicAutBase::pSymbolDict_ = nullptr;
 
 SymbolicAutBase::SymbolType* SymbolicAutBase::pNextSymbol_ = nullptr;
 
-const size_t SymbolicAutBase::SYMBOL_SIZE;
+const size_t SymbolicAutBase::DEFAULT_SYMBOL_SIZE;
+
+size_t SymbolicAutBase::symbolSize_ = SymbolicAutBase::DEFAULT_SYMBOL_SIZE;
+
+
+SymbolicAutBase::SymbolType SymbolicAutBase::AddSymbol()
+{
+	// Assertions
+	assert(pNextSymbol_ != nullptr);
+
+	SymbolType& nextSymbol = *pNextSymbol_;
+	if ((nextSymbol.length() == 0) ||
+		(nextSymbol.GetIthVariableValue(0) == SymbolType::DONT_CARE))
+	{	// in case all codes have been used
+		throw std::runtime_error("The symbol encoding is full: no room for a new "
+			"symbol in " + Convert::ToString(nextSymbol.length()) +
+			" variables.");
+	}
+
+	SymbolType result = nextSymbol++;
+
+	for (size_t i = 0; i < nextSymbol.length(); ++i)
+	{
+		if (nextSymbol.GetIthVariableValue(i) != SymbolType::ZERO)
+		{	// in case the code did not wrap around
+			return result;
+		}
+	}
+
+	// the last code was used, which is marked by a symbol with don't cares
+	nextSymbol = SymbolType(nextSymbol.length());
+
+	return result;
+}
+
+
+void SymbolicAutBase::CheckEncoding() const
+{
+	if (encodingSize_ != symbolSize_)
+	{	// in case the encoding changed since the automaton was created
+		throw std::runtime_error("The automaton encodes symbols in " +
+			Convert::ToString(encodingSize_) + " variables, but the current "
+			"encoding uses " + Convert::ToString(symbolSize_) + "; the automaton "
+			"needs to be converted by ReencodeSymbols().");
+	}
+}
+
+
+size_t SymbolicAutBase::GetMinimalSymbolSize(size_t alphabetSize)
+{
+	size_t size = 1;
+	while ((size < std::numeric_limits<size_t>::digits) &&
+		((static_cast<size_t>(1) << size) < alphabetSize))
+	{	// until 2^size is enough
+		++size;
+	}
+
+	return size;
+}
+
+
+void SymbolicAutBase::EncodeAlphabet(const AutDescription::SymbolSet& symbols)
+{
+	// Assertions
+	assert(pSymbolDict_ != nullptr);
+	assert(pNextSymbol_ != nullptr);
+
+	typedef std::pair<size_t, std::string> RankNamePair;
+
+	const size_t UNKNOWN_RANK = std::numeric_limits<size_t>::max();
+
+	std::vector<RankNamePair> alphabet;
+	for (const AutDescription::Symbol& symbol : symbols)
+	{
+		alphabet.push_back(RankNamePair(symbol.second, symbol.first));
+	}
+
+	for (auto stringSymbolPair : *pSymbolDict_)
+	{	// symbols in the dictionary have no rank information
+		alphabet.push_back(RankNamePair(UNKNOWN_RANK, stringSymbolPair.first));
+	}
+
+	// order the symbols by rank and name, each name only once (symbolic
+	// automata do not distinguish symbols by rank)
+	std::sort(alphabet.begin(), alphabet.end());
+
+	std::vector<std::string> names;
+	std::set<std::string> processedNames;
+	for (const RankNamePair& rankName : alphabet)
+	{
+		if (processedNames.insert(rankName.second).second)
+		{	// in case the name has not been seen yet
+			names.push_back(rankName.second);
+		}
+	}
+
+	SetSymbolSize(GetMinimalSymbolSize(names.size()));
+
+	*pSymbolDict_ = StringToSymbolDict();
+	*pNextSymbol_ = SymbolType(GetSymbolSize(), 0);
+
+	for (const std::string& name : names)
+	{
+		pSymbolDict_->insert(std::make_pair(name, AddSymbol()));
+	}
+}
+
+
+SymbolicAutBase::AlphabetMTBDD SymbolicAutBase::GetAlphabetMtbdd(
+	const StringToSymbolDict& dict, std::vector<std::string>& names)
+{
+	GCC_DIAG_OFF(effc++)    // suppress missing virtual destructor warning
+	class UnionApplyFunctor :
+		public VATA::MTBDDPkg::Apply2Functor<UnionApplyFunctor,
+		SymbolIndexSet, SymbolIndexSet, SymbolIndexSet>
+	{
+	GCC_DIAG_ON(effc++)
+	public:   // methods
+
+		inline SymbolIndexSet ApplyOperation(const SymbolIndexSet& lhs,
+			const SymbolIndexSet& rhs)
+		{
+			return lhs.Union(rhs);
+		}
+	};
+
+	UnionApplyFunctor unioner;
+
+	AlphabetMTBDD result((SymbolIndexSet()));
+	for (auto stringSymbolPair : dict)
+	{	// for every symbol
+		AlphabetMTBDD symbolMtbdd(stringSymbolPair.second,
+			SymbolIndexSet(names.size()), SymbolIndexSet());
+		names.push_back(stringSymbolPair.first);
+
+		result = unioner(result, symbolMtbdd);
+	}
+
+	return result;
+}
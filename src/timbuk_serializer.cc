@@ -12,63 +12,250 @@
 #include <vata/vata.hh>
 #include <vata/serialization/timbuk_serializer.hh>
 
+using VATA::Serialization::AbstrStreamWriter;
 using VATA::Serialization::TimbukSerializer;
+using VATA::Serialization::TimbukStreamWriter;
 
 // Standard library headers
-#include <algorithm>
+#include <cerrno>
+#include <sstream>
+#include <stdexcept>
 
-using std::for_each;
+// system headers
+#include <unistd.h>
 
 
 std::string TimbukSerializer::Serialize(const AutDescription& desc)
 {
-	std::string result;
+	std::ostringstream os;
 
-	result += "Ops ";
-	for (auto itSymb = desc.symbols.cbegin();
-		itSymb != desc.symbols.cend(); ++itSymb)
-	{
-		result += itSymb->first + ":" +
-			VATA::Util::Convert::ToString(itSymb->second) + " ";
-	}
+	TimbukStreamWriter writer(os);
+	writer.Write(desc);
+	writer.Finish();
+
+	return os.str();
+}
 
-	result += "\n";
-	result += "Automaton " + (desc.name.empty()? "anonymous" : desc.name);
 
-	result += "\n";
-	result += "States ";
-	for_each(desc.states.cbegin(), desc.states.cend(),
-		[&result](const std::string& sStr){ result += sStr + " ";});
+std::unique_ptr<AbstrStreamWriter> TimbukSerializer::CreateStreamWriter(
+	std::ostream& os)
+{
+	return std::unique_ptr<AbstrStreamWriter>(new TimbukStreamWriter(os));
+}
+
 
-	result += "\n";
-	result += "Final States ";
-	for_each(desc.finalStates.cbegin(), desc.finalStates.cend(),
-		[&result](const std::string& fsStr){ result += fsStr + " ";});
+std::unique_ptr<AbstrStreamWriter> TimbukSerializer::CreateStreamWriter(int fd)
+{
+	return std::unique_ptr<AbstrStreamWriter>(new TimbukStreamWriter(fd));
+}
+
+
+TimbukStreamWriter::TimbukStreamWriter(std::ostream& os, size_t bufferSize) :
+	os_(&os),
+	fd_(-1),
+	buffer_(),
+	bufferSize_(bufferSize),
+	section_(SECTION_NONE)
+{
+	buffer_.reserve(bufferSize_);
+}
 
-	result += "\n";
-	result += "Transitions\n";
-	for (auto itTran = desc.transitions.cbegin();
-		itTran != desc.transitions.cend(); ++itTran)
+
+TimbukStreamWriter::TimbukStreamWriter(int fd, size_t bufferSize) :
+	os_(nullptr),
+	fd_(fd),
+	buffer_(),
+	bufferSize_(bufferSize),
+	section_(SECTION_NONE)
+{
+	buffer_.reserve(bufferSize_);
+}
+
+
+TimbukStreamWriter::~TimbukStreamWriter()
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{ }
+}
+
+
+void TimbukStreamWriter::flush()
+{
+	if (os_ != nullptr)
 	{
-		result += itTran->second;
-		if (!(itTran->first.empty()))
+		os_->write(buffer_.data(), buffer_.size());
+		if (!*os_)
 		{
-			result += "(";
-			result += itTran->first[0];
-			for (size_t i = 1; i < itTran->first.size(); ++i)
+			throw std::runtime_error("Error writing the automaton to a stream");
+		}
+	}
+	else
+	{
+		size_t written = 0;
+		while (written < buffer_.size())
+		{
+			ssize_t result = ::write(fd_, buffer_.data() + written,
+				buffer_.size() - written);
+			if (result < 0)
 			{
-				result += ", ";
-				result += itTran->first[i];
+				if (errno == EINTR)
+				{
+					continue;
+				}
+
+				throw std::runtime_error("Error writing the automaton to a file");
 			}
 
-			result += ")";
+			written += result;
 		}
+	}
 
-		result += " -> ";
-		result += itTran->third;
+	buffer_.clear();
+}
 
-		result += "\n";
+
+void TimbukStreamWriter::enterSection(SectionEnum section)
+{
+	if (section < section_)
+	{
+		throw std::runtime_error("Parts of an automaton written in a wrong order");
 	}
 
-	return result;
+	while (section_ < section)
+	{
+		switch (section_)
+		{	// close the current section
+			case SECTION_OPS:
+			case SECTION_STATES:
+			case SECTION_FINAL_STATES: append("\n"); break;
+			case SECTION_AUTOMATON: append("anonymous\n"); break;
+			default: break;
+		}
+
+		section_ = static_cast<SectionEnum>(section_ + 1);
+
+		switch (section_)
+		{	// open the next one
+			case SECTION_OPS: append("Ops "); break;
+			case SECTION_AUTOMATON: append("Automaton "); break;
+			case SECTION_STATES: append("States "); break;
+			case SECTION_FINAL_STATES: append("Final States "); break;
+			case SECTION_TRANSITIONS: append("Transitions\n"); break;
+			default: break;
+		}
+	}
+}
+
+
+void TimbukStreamWriter::WriteSymbol(const std::string& symbol, unsigned rank)
+{
+	enterSection(SECTION_OPS);
+
+	append(symbol);
+	append(":");
+	append(VATA::Util::Convert::ToString(rank));
+	append(" ");
+}
+
+
+void TimbukStreamWriter::WriteName(const std::string& name)
+{
+	enterSection(SECTION_AUTOMATON);
+
+	append(name.empty()? "anonymous" : name);
+	append("\n");
+
+	// the section is closed already
+	section_ = SECTION_STATES;
+	append("States ");
+}
+
+
+void TimbukStreamWriter::WriteState(const std::string& state)
+{
+	enterSection(SECTION_STATES);
+
+	append(state);
+	append(" ");
+}
+
+
+void TimbukStreamWriter::WriteFinalState(const std::string& state)
+{
+	enterSection(SECTION_FINAL_STATES);
+
+	append(state);
+	append(" ");
+}
+
+
+void TimbukStreamWriter::WriteTransition(
+	const AutDescription::StateTuple& children, const std::string& symbol,
+	const std::string& parent)
+{
+	enterSection(SECTION_TRANSITIONS);
+
+	append(symbol);
+	if (!children.empty())
+	{
+		append("(");
+		append(children[0]);
+		for (size_t i = 1; i < children.size(); ++i)
+		{
+			append(", ");
+			append(children[i]);
+		}
+
+		append(")");
+	}
+
+	append(" -> ");
+	append(parent);
+	append("\n");
+}
+
+
+void TimbukStreamWriter::Write(const AutDescription& desc)
+{
+	for (const AutDescription::Symbol& symbol : desc.symbols)
+	{
+		WriteSymbol(symbol.first, symbol.second);
+	}
+
+	WriteName(desc.name);
+
+	for (const AutDescription::State& state : desc.states)
+	{
+		WriteState(state);
+	}
+
+	for (const AutDescription::State& state : desc.finalStates)
+	{
+		WriteFinalState(state);
+	}
+
+	for (const AutDescription::Transition& trans : desc.transitions)
+	{
+		WriteTransition(trans.first, trans.second, trans.third);
+	}
+}
+
+
+void TimbukStreamWriter::Finish()
+{
+	if (section_ != SECTION_DONE)
+	{
+		enterSection(SECTION_DONE);
+	}
+
+	flush();
+
+	if (os_ != nullptr)
+	{
+		os_->flush();
+	}
 }
@@ -10,6 +10,7 @@
 
 // VATA headers
 #include <vata/vata.hh>
+#include <vata/util/convert.hh>
 #include <vata/util/util.hh>
 
 // Standard library headers
@@ -118,3 +119,115 @@ VATA::AutBase::StringToStateDict VATA::Util::CreateUnionStringToStateMap(
 
 	return result;
 }
+
+
+namespace
+{
+	const std::string& findStateName(
+		const VATA::AutBase::StringToStateDict& dict,
+		const VATA::AutBase::StateType& state)
+	{
+		VATA::AutBase::StringToStateDict::ConstIteratorBwd itDict;
+		if ((itDict = dict.FindBwd(state)) == dict.EndBwd())
+		{
+			throw std::runtime_error("No name for state " +
+				VATA::Util::Convert::ToString(state));
+		}
+
+		return itDict->second;
+	}
+
+	std::runtime_error noStateError(const VATA::AutBase::StateType& state)
+	{
+		return std::runtime_error("No translation for " +
+			VATA::Util::Convert::ToString(state));
+	}
+}
+
+
+VATA::Util::ProductStateNames::ProductStateNames(
+	const StringToStateDict& lhsDict,
+	const StringToStateDict& rhsDict,
+	const VATA::AutBase::ProductTranslMap& translMap) :
+	lhsDict_(lhsDict),
+	rhsDict_(rhsDict),
+	productToPair_()
+{
+	productToPair_.reserve(translMap.size());
+	for (auto& mapElem : translMap)
+	{
+		productToPair_.insert(std::make_pair(mapElem.second, mapElem.first));
+	}
+}
+
+
+std::string VATA::Util::ProductStateNames::operator()(
+	const StateType& state) const
+{
+	ProductToPairMap::const_iterator itPair;
+	if ((itPair = productToPair_.find(state)) == productToPair_.end())
+	{
+		throw noStateError(state);
+	}
+
+	return '[' + findStateName(lhsDict_, itPair->second.first) + "_1|" +
+		findStateName(rhsDict_, itPair->second.second) + "_2]";
+}
+
+
+VATA::Util::UnionStateNames::UnionStateNames(
+	const StringToStateDict& lhsDict,
+	const StringToStateDict& rhsDict,
+	const StateToStateMap* translMapLhs,
+	const StateToStateMap* translMapRhs) :
+	lhsDict_(lhsDict),
+	rhsDict_(rhsDict),
+	unionToOperand_()
+{
+	addOperand(lhsDict_, translMapLhs, false);
+	addOperand(rhsDict_, translMapRhs, true);
+}
+
+
+void VATA::Util::UnionStateNames::addOperand(const StringToStateDict& dict,
+	const StateToStateMap* translMap, bool isRhs)
+{
+	for (auto itDict = dict.BeginBwd(); itDict != dict.EndBwd(); ++itDict)
+	{
+		StateType state = itDict->first;
+		if (translMap != nullptr)
+		{	// in case there should be translation
+			StateToStateMap::const_iterator itTransl;
+			if ((itTransl = translMap->find(state)) == translMap->end())
+			{
+				assert(false);    // fail gracefully
+			}
+
+			state = itTransl->second;
+		}
+
+		unionToOperand_.insert(std::make_pair(state,
+			std::make_pair(itDict->first, isRhs)));
+	}
+}
+
+
+std::string VATA::Util::UnionStateNames::operator()(
+	const StateType& state) const
+{
+	UnionToOperandMap::const_iterator itOperand;
+	if ((itOperand = unionToOperand_.find(state)) == unionToOperand_.end())
+	{
+		throw noStateError(state);
+	}
+
+	const std::pair<StateType, bool>& operandState = itOperand->second;
+	if (operandState.second)
+	{
+		return findStateName(rhsDict_, operandState.first) + "_2";
+	}
+	else
+	{
+		return findStateName(lhsDict_, operandState.first) + "_1";
+	}
+}
@@ -0,0 +1,206 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Implementation of the global variable ordering of MTBDDs.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/mtbdd/var_ordering.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <stdexcept>
+
+using VATA::MTBDDPkg::VarOrdering;
+
+
+const double VarOrdering::MAX_SIFTING_GROWTH = 1.2;
+
+VarOrdering::LevelTable VarOrdering::varToLevel_;
+VarOrdering::LevelTable VarOrdering::levelToVar_;
+std::vector<VarOrdering::NodeStore> VarOrdering::nodeStores_;
+size_t VarOrdering::operationDepth_ = 0;
+bool VarOrdering::autoSifting_ = false;
+size_t VarOrdering::siftingThreshold_ = VarOrdering::DEFAULT_SIFTING_THRESHOLD;
+size_t VarOrdering::nextSifting_ = VarOrdering::DEFAULT_SIFTING_THRESHOLD;
+std::thread::id VarOrdering::ownerThread_;
+
+
+void VarOrdering::ensureLevels(const VarType& levels)
+{
+	for (VarType i = varToLevel_.size(); i < levels; ++i)
+	{	// variables above the table are mapped to themselves
+		varToLevel_.push_back(i);
+		levelToVar_.push_back(i);
+	}
+}
+
+
+bool VarOrdering::RegisterNodeStore(const NodeStore& store)
+{
+	assertSingleThread();
+
+	nodeStores_.push_back(store);
+	return true;
+}
+
+
+size_t VarOrdering::GetNodeCount()
+{
+	size_t count = 0;
+	for (const NodeStore& store : nodeStores_)
+	{
+		count += store.GetNodeCount();
+	}
+
+	return count;
+}
+
+
+void VarOrdering::SwapAdjacentLevels(const VarType& level)
+{
+	assertSingleThread();
+
+	if (operationDepth_ != 0)
+	{
+		throw std::runtime_error("Cannot reorder variables during an MTBDD operation.");
+	}
+
+	ensureLevels(level + 2);
+
+	for (const NodeStore& store : nodeStores_)
+	{
+		store.SwapLevels(level);
+	}
+
+	std::swap(levelToVar_[level], levelToVar_[level + 1]);
+	varToLevel_[levelToVar_[level]] = level;
+	varToLevel_[levelToVar_[level + 1]] = level + 1;
+}
+
+
+void VarOrdering::siftVariable(const VarType& var, const VarType& levels)
+{
+	VarType pos = GetLevelOfVar(var);
+	VarType bestPos = pos;
+	size_t bestSize = GetNodeCount();
+
+	// move the variable to the closer end first
+	const bool downFirst = (pos < levels - 1 - pos);
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		if ((pass == 0) == downFirst)
+		{	// move down
+			while (pos > 0)
+			{
+				SwapAdjacentLevels(pos - 1);
+				--pos;
+
+				size_t size = GetNodeCount();
+				if (size < bestSize)
+				{
+					bestSize = size;
+					bestPos = pos;
+				}
+				else if (size > bestSize * MAX_SIFTING_GROWTH)
+				{
+					break;
+				}
+			}
+		}
+		else
+		{	// move up
+			while (pos + 1 < levels)
+			{
+				SwapAdjacentLevels(pos);
+				++pos;
+
+				size_t size = GetNodeCount();
+				if (size < bestSize)
+				{
+					bestSize = size;
+					bestPos = pos;
+				}
+				else if (size > bestSize * MAX_SIFTING_GROWTH)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	// return to the best position
+	for (; pos > bestPos; --pos)
+	{
+		SwapAdjacentLevels(pos - 1);
+	}
+
+	for (; pos < bestPos; ++pos)
+	{
+		SwapAdjacentLevels(pos);
+	}
+}
+
+
+void VarOrdering::Sift()
+{
+	assertSingleThread();
+
+	LevelCountTable counts;
+	for (const NodeStore& store : nodeStores_)
+	{
+		store.AddLevelNodeCounts(counts);
+	}
+
+	const VarType levels = counts.size();
+	if (levels >= 2)
+	{
+		ensureLevels(levels);
+
+		// process variables from the most populated levels
+		std::vector<VarType> vars;
+		for (VarType level = 0; level < levels; ++level)
+		{
+			if (counts[level] > 0)
+			{
+				vars.push_back(GetVarAtLevel(level));
+			}
+		}
+
+		std::stable_sort(vars.begin(), vars.end(),
+			[&counts](const VarType& lhs, const VarType& rhs)
+			{
+				return counts[GetLevelOfVar(lhs)] > counts[GetLevelOfVar(rhs)];
+			});
+
+		for (const VarType& var : vars)
+		{
+			siftVariable(var, levels);
+		}
+	}
+
+	nextSifting_ = std::max(siftingThreshold_, 2 * GetNodeCount());
+}
+
+
+void VarOrdering::EnableAutoSifting(const size_t& threshold)
+{
+	assertSingleThread();
+
+	autoSifting_ = true;
+	siftingThreshold_ = threshold;
+	nextSifting_ = threshold;
+}
+
+
+void VarOrdering::DisableAutoSifting()
+{
+	assertSingleThread();
+
+	autoSifting_ = false;
+}
@@ -0,0 +1,173 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Microbenchmark of the kernels of operations on sorted sets.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/util/sorted_set_kernels.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace SortedSetKernels = VATA::Util::SortedSetKernels;
+
+using SortedSetKernels::InstructionSet;
+
+
+namespace
+{
+	const InstructionSet INSTRUCTION_SETS[] =
+	{
+		InstructionSet::SCALAR,
+		InstructionSet::SSE42,
+		InstructionSet::AVX2
+	};
+
+	// total number of elements processed by every measurement
+	const size_t WORK = 1 << 26;
+
+	template <class T>
+	std::vector<T> randomSet(std::mt19937_64& gen, size_t size, T maxValue)
+	{
+		std::uniform_int_distribution<T> dist(0, maxValue);
+
+		std::vector<T> result;
+		while (result.size() < size)
+		{
+			for (size_t i = result.size(); i < size; ++i)
+			{
+				result.push_back(dist(gen));
+			}
+
+			std::sort(result.begin(), result.end());
+			result.erase(std::unique(result.begin(), result.end()), result.end());
+		}
+
+		return result;
+	}
+
+	template <class Func>
+	double measure(size_t elements, Func func)
+	{
+		size_t repetitions = std::max<size_t>(1, WORK / elements);
+
+		auto start = std::chrono::steady_clock::now();
+		size_t checksum = 0;
+		for (size_t i = 0; i < repetitions; ++i)
+		{
+			checksum += func();
+		}
+
+		std::chrono::duration<double> time =
+			std::chrono::steady_clock::now() - start;
+
+		if (checksum == static_cast<size_t>(-1))
+		{	// prevent the optimizer from dropping the calls
+			std::cerr << checksum;
+		}
+
+		// nanoseconds per element
+		return 1e9 * time.count() / (repetitions * elements);
+	}
+
+	template <class T>
+	void benchmark(const char* name, size_t lhsSize, size_t rhsSize)
+	{
+		std::mt19937_64 gen(lhsSize * 31 + rhsSize);
+		T maxValue = static_cast<T>(4 * (lhsSize + rhsSize));
+		std::vector<T> lhs = randomSet<T>(gen, lhsSize, maxValue);
+		std::vector<T> rhs = randomSet<T>(gen, rhsSize, maxValue);
+		std::vector<T> subset;
+		for (size_t i = 0; i < lhsSize; ++i)
+		{
+			subset.push_back(rhs[i * rhsSize / lhsSize]);
+		}
+
+		std::vector<T> out(lhsSize + rhsSize);
+		size_t elements = lhsSize + rhsSize;
+
+		std::cout << std::setw(4) << name << " " << std::setw(7) << lhsSize <<
+			" x " << std::setw(7) << rhsSize << " | std:";
+
+		std::cout << std::fixed << std::setprecision(2) <<
+			" union " << std::setw(6) << measure(elements, [&]()
+			{
+				return std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+					out.begin()) - out.begin();
+			}) <<
+			" isect " << std::setw(6) << measure(elements, [&]()
+			{
+				return std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(),
+					rhs.end(), out.begin()) - out.begin();
+			}) <<
+			" subset " << std::setw(6) << measure(elements, [&]()
+			{
+				return std::includes(rhs.begin(), rhs.end(), subset.begin(),
+					subset.end());
+			});
+
+		for (InstructionSet isa : INSTRUCTION_SETS)
+		{
+			if (!SortedSetKernels::SetInstructionSet(isa))
+			{	// not supported by the CPU
+				continue;
+			}
+
+			std::cout << " | " << SortedSetKernels::GetInstructionSetName(isa) <<
+				":" <<
+				" union " << std::setw(6) << measure(elements, [&]()
+				{
+					return SortedSetKernels::Union(lhs.data(), lhs.size(), rhs.data(),
+						rhs.size(), out.data());
+				}) <<
+				" isect " << std::setw(6) << measure(elements, [&]()
+				{
+					return SortedSetKernels::Intersection(lhs.data(), lhs.size(),
+						rhs.data(), rhs.size(), out.data());
+				}) <<
+				" subset " << std::setw(6) << measure(elements, [&]()
+				{
+					return SortedSetKernels::IsSubset(subset.data(), subset.size(),
+						rhs.data(), rhs.size());
+				});
+		}
+
+		std::cout << "\n";
+	}
+}
+
+
+int main()
+{
+	const size_t SIZES[][2] =
+	{
+		{4, 4}, {16, 16}, {256, 256}, {4096, 4096}, {65536, 65536},
+		{16, 4096}, {64, 65536}, {1024, 65536}
+	};
+
+	std::cout << "nanoseconds per element of the operands\n";
+	for (auto& sizes : SIZES)
+	{
+		benchmark<uint32_t>("u32", sizes[0], sizes[1]);
+	}
+
+	for (auto& sizes : SIZES)
+	{
+		benchmark<uint64_t>("u64", sizes[0], sizes[1]);
+	}
+
+	return EXIT_SUCCESS;
+}
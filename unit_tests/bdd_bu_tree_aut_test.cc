@@ -14,6 +14,9 @@
 #include <vata/bdd_bu_tree_aut_op.hh>
 #include <vata/bdd_td_tree_aut.hh>
 #include <vata/bdd_td_tree_aut_op.hh>
+#include <vata/explicit_tree_aut.hh>
+#include <vata/explicit_tree_aut_op.hh>
+#include <vata/tree_aut_conv.hh>
 
 // testing headers
 #include "log_fixture.hh"
@@ -39,6 +42,7 @@ protected:// data types
 
 	typedef VATA::BDDBottomUpTreeAut AutType;
 	typedef VATA::BDDTopDownTreeAut AutTypeInverted;
+	typedef VATA::ExplicitTreeAut<size_t> AutTypeExplicit;
 
 	typedef AutType::StringToStateDict StringToStateDict;
 
@@ -56,7 +60,10 @@ protected:// methods
 		nextSymbol_(BDD_SIZE, 0)
 	{ }
 
-	virtual ~AutTypeFixture() { }
+	virtual ~AutTypeFixture()
+	{	// in case a test changed the encoding of symbols
+		AutType::SetSymbolSize(AutType::DEFAULT_SYMBOL_SIZE);
+	}
 };
 
 #include "tree_aut_test.hh"
@@ -98,6 +105,252 @@ BOOST_AUTO_TEST_CASE(aut_inversion)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(aut_explicit_conversion)
+{
+	AutTypeInverted::SetSymbolDictPtr(&AutType::GetSymbolDict());
+
+	AutTypeExplicit::StringToSymbolDict explicitSymbolDict;
+	AutTypeExplicit::SymbolType explicitNextSymbol = 0;
+	AutTypeExplicit::SetSymbolDictPtr(&explicitSymbolDict);
+	AutTypeExplicit::SetNextSymbolPtr(&explicitNextSymbol);
+
+	auto testfileContent = ParseTestFile(INVERT_TIMBUK_FILE.string());
+
+	for (auto testcase : testfileContent)
+	{
+		BOOST_REQUIRE_MESSAGE(testcase.size() == 1, "Invalid format of a testcase: " +
+			Convert::ToString(testcase));
+
+		std::string filename = (AUT_DIR / testcase[0]).string();
+		BOOST_MESSAGE("Converting automaton " + filename + "...");
+		std::string autStr = VATA::Util::ReadFile(filename);
+
+		StringToStateDict stateDict;
+		AutType aut;
+		readAut(aut, stateDict, autStr);
+		std::string refOut = dumpAut(aut, stateDict);
+
+		AutTypeExplicit explAut = VATA::TreeAutConverter::ToExplicit<size_t>(aut);
+
+		AutType buAut = VATA::TreeAutConverter::ToBDDBottomUp(explAut);
+		std::string buOut = dumpAut(buAut, stateDict);
+
+		AutTypeInverted tdAut = VATA::TreeAutConverter::ToBDDTopDown(
+			VATA::TreeAutConverter::ToExplicit<size_t>(
+			VATA::TreeAutConverter::ToBDDTopDown(explAut)));
+		std::string tdOut = dumpAut(tdAut, stateDict);
+
+		StringToStateDict stateDictRef;
+		AutTypeInverted refTdAut;
+		readAut(refTdAut, stateDictRef, autStr);
+		std::string refTdOut = dumpAut(refTdAut, stateDictRef);
+
+		AutDescription descOrig = parser_.ParseString(refOut);
+		AutDescription descOrigTD = parser_.ParseString(refTdOut);
+		AutDescription descBU = parser_.ParseString(buOut);
+		AutDescription descTD = parser_.ParseString(tdOut);
+		BOOST_CHECK_MESSAGE(descOrig == descBU,
+			"\n\nExpecting:\n===========\n" +
+			std::string(refOut) +
+			"===========\n\nGot:\n===========\n" + buOut + "\n===========");
+		BOOST_CHECK_MESSAGE(descOrigTD == descTD,
+			"\n\nExpecting:\n===========\n" +
+			std::string(refTdOut) +
+			"===========\n\nGot:\n===========\n" + tdOut + "\n===========");
+
+		// compare with the automaton loaded directly in the explicit
+		// representation (states are numbered as in the bottom-up one)
+		StringToStateDict stateDictExpl(stateDict);
+		AutTypeExplicit refExplAut;
+		readAut(refExplAut, stateDictExpl, autStr);
+		std::string refExplOut = refExplAut.DumpToString(serializer_,
+			StateBackTranslatorStrict(stateDictExpl.GetReverseMap()),
+			AutTypeExplicit::SymbolBackTranslatorStrict(
+			refExplAut.GetSymbolDict().GetReverseMap()));
+		std::string explOut = explAut.DumpToString(serializer_,
+			StateBackTranslatorStrict(stateDict.GetReverseMap()),
+			AutTypeExplicit::SymbolBackTranslatorStrict(
+			explAut.GetSymbolDict().GetReverseMap()));
+
+		std::string buDirectOut = dumpAut(
+			VATA::TreeAutConverter::ToBDDBottomUp(refExplAut), stateDictExpl);
+		std::string tdDirectOut = dumpAut(
+			VATA::TreeAutConverter::ToBDDTopDown(refExplAut), stateDictExpl);
+
+		AutDescription descExpl = parser_.ParseString(explOut);
+		AutDescription descRefExpl = parser_.ParseString(refExplOut);
+		AutDescription descBUDirect = parser_.ParseString(buDirectOut);
+		AutDescription descTDDirect = parser_.ParseString(tdDirectOut);
+		BOOST_CHECK_MESSAGE(descRefExpl == descExpl,
+			"\n\nExpecting:\n===========\n" +
+			std::string(refExplOut) +
+			"===========\n\nGot:\n===========\n" + explOut + "\n===========");
+		BOOST_CHECK_MESSAGE(descOrig == descBUDirect,
+			"\n\nExpecting:\n===========\n" +
+			std::string(refOut) +
+			"===========\n\nGot:\n===========\n" + buDirectOut + "\n===========");
+		BOOST_CHECK_MESSAGE(descOrigTD == descTDDirect,
+			"\n\nExpecting:\n===========\n" +
+			std::string(refTdOut) +
+			"===========\n\nGot:\n===========\n" + tdDirectOut + "\n===========");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(aut_explicit_conversion_arity)
+{
+	AutTypeExplicit::StringToSymbolDict explicitSymbolDict;
+	AutTypeExplicit::SymbolType explicitNextSymbol = 0;
+	AutTypeExplicit::SetSymbolDictPtr(&explicitSymbolDict);
+	AutTypeExplicit::SetNextSymbolPtr(&explicitNextSymbol);
+
+	// a transition of the given arity over a single leaf
+	auto makeAutStr = [](size_t arity) -> std::string
+	{
+		std::string children;
+		for (size_t i = 0; i < arity; ++i)
+		{
+			children += (i? ", " : "") + std::string("q");
+		}
+
+		return "Ops a:0 f:" + Convert::ToString(arity) + "\n"
+			"Automaton wide\n"
+			"States q p\n"
+			"Final States p\n"
+			"Transitions\n"
+			"a -> q\n"
+			"f(" + children + ") -> p\n";
+	};
+
+	// 63 is the maximal arity encoded in the symbols of top-down automata
+	AutTypeExplicit maxAut;
+	readAut(maxAut, makeAutStr(63));
+	BOOST_CHECK_NO_THROW(VATA::TreeAutConverter::ToBDDTopDown(maxAut));
+
+	AutTypeExplicit wideAut;
+	readAut(wideAut, makeAutStr(64));
+	BOOST_CHECK_THROW(VATA::TreeAutConverter::ToBDDTopDown(wideAut),
+		std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(aut_symbol_encoding)
+{
+	BOOST_CHECK_EQUAL(AutType::GetMinimalSymbolSize(0), 1U);
+	BOOST_CHECK_EQUAL(AutType::GetMinimalSymbolSize(1), 1U);
+	BOOST_CHECK_EQUAL(AutType::GetMinimalSymbolSize(2), 1U);
+	BOOST_CHECK_EQUAL(AutType::GetMinimalSymbolSize(3), 2U);
+	BOOST_CHECK_EQUAL(AutType::GetMinimalSymbolSize(4), 2U);
+	BOOST_CHECK_EQUAL(AutType::GetMinimalSymbolSize(5), 3U);
+	BOOST_CHECK_EQUAL(AutType::GetMinimalSymbolSize(1024), 10U);
+	BOOST_CHECK_EQUAL(AutType::GetMinimalSymbolSize(1025), 11U);
+
+	const std::string autStr =
+		"Ops a:0 b:0 f:2 g:1 h:2\n"
+		"Automaton A\n"
+		"States p q r\n"
+		"Final States r\n"
+		"Transitions\n"
+		"a -> p\n"
+		"b -> q\n"
+		"g(p) -> q\n"
+		"f(p,q) -> r\n"
+		"h(q,q) -> r\n";
+
+	StringToStateDict stateDict;
+	AutType aut;
+	readAut(aut, stateDict, autStr);
+	std::string refOut = dumpAut(aut, stateDict);
+	AutDescription descOrig = parser_.ParseString(refOut);
+
+	// the language is compared on explicit automata
+	AutTypeExplicit::StringToSymbolDict explicitSymbolDict;
+	AutTypeExplicit::SymbolType explicitNextSymbol = 0;
+	AutTypeExplicit::SetSymbolDictPtr(&explicitSymbolDict);
+	AutTypeExplicit::SetNextSymbolPtr(&explicitNextSymbol);
+
+	AutTypeExplicit explAut = VATA::TreeAutConverter::ToExplicit<size_t>(aut);
+
+	// dense encoding of the five symbols
+	AutType::StringToSymbolDict oldDict = symbolDict_;
+	AutType::SymbolType oldNextSymbol = nextSymbol_;
+	AutType::EncodeAlphabet(parser_.ParseString(autStr).symbols);
+
+	BOOST_CHECK_EQUAL(AutType::GetSymbolSize(), 3U);
+	BOOST_CHECK_EQUAL(symbolDict_.size(), 5U);
+	for (auto stringSymbolPair : symbolDict_)
+	{
+		BOOST_CHECK_EQUAL(stringSymbolPair.second.length(), 3U);
+	}
+
+	AutType denseAut = VATA::ReencodeSymbols(aut, oldDict);
+	std::string denseOut = dumpAut(denseAut, stateDict);
+	BOOST_CHECK_MESSAGE(descOrig == parser_.ParseString(denseOut),
+		"\n\nExpecting:\n===========\n" + refOut +
+		"===========\n\nGot:\n===========\n" + denseOut + "\n===========");
+	BOOST_CHECK(VATA::CheckEquivalence(explAut,
+		VATA::TreeAutConverter::ToExplicit<size_t>(denseAut)));
+	BOOST_CHECK_EQUAL(denseAut.GetEncodingSize(), 3U);
+
+	// the automaton in the old encoding cannot be used any more
+	BOOST_CHECK_EQUAL(aut.GetEncodingSize(), AutType::DEFAULT_SYMBOL_SIZE);
+	BOOST_CHECK_THROW(VATA::CheckInclusion(aut, denseAut), std::runtime_error);
+	BOOST_CHECK_THROW(VATA::RemoveUselessStates(aut), std::runtime_error);
+	BOOST_CHECK_THROW(dumpAut(aut, stateDict), std::runtime_error);
+
+	// and back to the original encoding
+	AutType::StringToSymbolDict denseDict = symbolDict_;
+	symbolDict_ = oldDict;
+	nextSymbol_ = oldNextSymbol;
+	AutType::SetSymbolSize(AutType::DEFAULT_SYMBOL_SIZE);
+
+	AutType backAut = VATA::ReencodeSymbols(denseAut, denseDict);
+	std::string backOut = dumpAut(backAut, stateDict);
+	BOOST_CHECK_MESSAGE(descOrig == parser_.ParseString(backOut),
+		"\n\nExpecting:\n===========\n" + refOut +
+		"===========\n\nGot:\n===========\n" + backOut + "\n===========");
+	BOOST_CHECK(VATA::CheckEquivalence(aut, backAut));
+	BOOST_CHECK(VATA::CheckEquivalence(explAut,
+		VATA::TreeAutConverter::ToExplicit<size_t>(backAut)));
+
+	// symbols missing in the new encoding take its free codes until it is full
+	const std::string missingStr =
+		"Ops a:0 b:0 f:2 g:1\n"
+		"Automaton B\n"
+		"States p q\n"
+		"Final States q\n"
+		"Transitions\n"
+		"a -> p\n"
+		"g(p) -> q\n"
+		"f(p,q) -> q\n";
+
+	StringToStateDict missingStateDict;
+	AutType missingAut;
+	readAut(missingAut, missingStateDict, missingStr);
+	std::string missingRefOut = dumpAut(missingAut, missingStateDict);
+	oldDict = symbolDict_;
+
+	AutDescription::SymbolSet smallAlphabet;
+	smallAlphabet.insert(AutDescription::Symbol("a", 0));
+	smallAlphabet.insert(AutDescription::Symbol("b", 0));
+	smallAlphabet.insert(AutDescription::Symbol("f", 2));
+
+	symbolDict_ = AutType::StringToSymbolDict();
+	AutType::EncodeAlphabet(smallAlphabet);
+	BOOST_CHECK_EQUAL(AutType::GetSymbolSize(), 2U);
+
+	// 'g' gets the fourth code
+	AutType missingDenseAut = VATA::ReencodeSymbols(missingAut, oldDict);
+	std::string missingOut = dumpAut(missingDenseAut, missingStateDict);
+	BOOST_CHECK_EQUAL(symbolDict_.size(), 4U);
+	BOOST_CHECK_MESSAGE(parser_.ParseString(missingRefOut) ==
+		parser_.ParseString(missingOut),
+		"\n\nExpecting:\n===========\n" + missingRefOut +
+		"===========\n\nGot:\n===========\n" + missingOut + "\n===========");
+
+	// 'h' does not fit any more
+	BOOST_CHECK_THROW(VATA::ReencodeSymbols(aut, oldDict), std::runtime_error);
+	BOOST_CHECK_THROW(AutType::AddSymbol(), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_CASE(aut_down_simulation)
 {
 	testDownwardSimulation();
@@ -118,4 +371,217 @@ BOOST_AUTO_TEST_CASE(aut_up_inclusion)
 	testInclusion(checkUpInclusion);
 }
 
+BOOST_AUTO_TEST_CASE(aut_equivalence)
+{
+	testInclusion(checkEquivalence);
+}
+
+BOOST_AUTO_TEST_CASE(aut_up_inclusion_direct)
+{
+	const std::string smallerStr =
+		"Ops a:0 b:0 f:2\n"
+		"Automaton A\n"
+		"States p q\n"
+		"Final States q\n"
+		"Transitions\n"
+		"a -> p\n"
+		"b -> p\n"
+		"f(p,p) -> q\n";
+
+	// pairs of (bigger automaton, whether it contains the smaller one)
+	const std::vector<std::pair<std::string, bool>> biggerStrs =
+	{
+		// all combinations of leaves under f
+		std::make_pair(std::string(
+			"Ops a:0 b:0 f:2\n"
+			"Automaton B\n"
+			"States r1 r2 s\n"
+			"Final States s\n"
+			"Transitions\n"
+			"a -> r1\n"
+			"b -> r2\n"
+			"f(r1,r1) -> s\n"
+			"f(r1,r2) -> s\n"
+			"f(r2,r1) -> s\n"
+			"f(r2,r2) -> s\n"), true),
+		// f(b,a) is missing
+		std::make_pair(std::string(
+			"Ops a:0 b:0 f:2\n"
+			"Automaton B\n"
+			"States r1 r2 s\n"
+			"Final States s\n"
+			"Transitions\n"
+			"a -> r1\n"
+			"b -> r2\n"
+			"f(r1,r1) -> s\n"
+			"f(r1,r2) -> s\n"
+			"f(r2,r2) -> s\n"), false),
+		// the leaf b is missing
+		std::make_pair(std::string(
+			"Ops a:0 b:0 f:2\n"
+			"Automaton B\n"
+			"States r1 s\n"
+			"Final States s\n"
+			"Transitions\n"
+			"a -> r1\n"
+			"f(r1,r1) -> s\n"), false),
+		// a nondeterministic automaton needing macro-states
+		std::make_pair(std::string(
+			"Ops a:0 b:0 f:2\n"
+			"Automaton B\n"
+			"States r1 r2 r3 s t\n"
+			"Final States s\n"
+			"Transitions\n"
+			"a -> r1\n"
+			"a -> r2\n"
+			"b -> r2\n"
+			"b -> r3\n"
+			"f(r1,r2) -> s\n"
+			"f(r2,r2) -> s\n"
+			"f(r2,r1) -> t\n"
+			"f(r3,r1) -> t\n"), true),
+	};
+
+	StringToStateDict stateDictSmaller;
+	AutType autSmaller;
+	readAut(autSmaller, stateDictSmaller, smallerStr);
+
+	for (const auto& biggerStrResultPair : biggerStrs)
+	{
+		StringToStateDict stateDictBigger;
+		AutType autBigger;
+		readAut(autBigger, stateDictBigger, biggerStrResultPair.first);
+
+		BOOST_CHECK_MESSAGE(biggerStrResultPair.second ==
+			VATA::CheckUpwardInclusion(autSmaller, autBigger),
+			"\n\nError checking inclusion of\n" + smallerStr + "in\n" +
+			biggerStrResultPair.first + "expected " +
+			Convert::ToString(biggerStrResultPair.second));
+	}
+
+	// the bigger automata from the testfile in both directions, compared with
+	// the downward check
+	auto testfileContent = ParseTestFile(INCLUSION_TIMBUK_FILE.string());
+	for (auto testcase : testfileContent)
+	{
+		BOOST_REQUIRE_MESSAGE(testcase.size() == 3, "Invalid format of a testcase: " +
+			Convert::ToString(testcase));
+
+		std::string lhsFile = (AUT_DIR / testcase[0]).string();
+		std::string rhsFile = (AUT_DIR / testcase[1]).string();
+		unsigned expectedResult = static_cast<bool>(
+			Convert::FromString<unsigned>(testcase[2]));
+
+		StringToStateDict stateDictLhs;
+		AutType autLhs;
+		readAut(autLhs, stateDictLhs, VATA::Util::ReadFile(lhsFile));
+
+		StringToStateDict stateDictRhs;
+		AutType autRhs;
+		readAut(autRhs, stateDictRhs, VATA::Util::ReadFile(rhsFile));
+
+		BOOST_CHECK_MESSAGE(expectedResult ==
+			VATA::CheckUpwardInclusion(autLhs, autRhs),
+			"\n\nError checking inclusion " + lhsFile + " <= " + rhsFile +
+			": expected " + Convert::ToString(expectedResult));
+
+		bool reverseResult = VATA::CheckDownwardInclusion(autRhs, autLhs);
+		BOOST_CHECK_MESSAGE(reverseResult ==
+			VATA::CheckUpwardInclusion(autRhs, autLhs),
+			"\n\nError checking inclusion " + rhsFile + " <= " + lhsFile +
+			": expected " + Convert::ToString(reverseResult));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(aut_up_inclusion_symbols)
+{
+	// the post-image of (p, {r}) is computed for all symbols in one apply, the
+	// pair produced for f is already in the antichain and has to be pruned in its
+	// leaf while the pair produced for g decides the result
+	const std::string smallerStr =
+		"Ops a:0 b:0 f:2 g:2\n"
+		"Automaton A\n"
+		"States p\n"
+		"Final States p\n"
+		"Transitions\n"
+		"a -> p\n"
+		"b -> p\n"
+		"f(p,p) -> p\n"
+		"g(p,p) -> p\n";
+
+	// pairs of (bigger automaton, whether it contains the smaller one)
+	const std::vector<std::pair<std::string, bool>> biggerStrs =
+	{
+		// both binary symbols lead back to r
+		std::make_pair(std::string(
+			"Ops a:0 b:0 f:2 g:2\n"
+			"Automaton B\n"
+			"States r\n"
+			"Final States r\n"
+			"Transitions\n"
+			"a -> r\n"
+			"b -> r\n"
+			"f(r,r) -> r\n"
+			"g(r,r) -> r\n"), true),
+		// g(a,a) is accepted only in the non-final state u
+		std::make_pair(std::string(
+			"Ops a:0 b:0 f:2 g:2\n"
+			"Automaton B\n"
+			"States r u\n"
+			"Final States r\n"
+			"Transitions\n"
+			"a -> r\n"
+			"b -> r\n"
+			"f(r,r) -> r\n"
+			"g(r,r) -> u\n"), false),
+		// g(a,a) is accepted in u, but f(g(a,a),a) is not accepted
+		std::make_pair(std::string(
+			"Ops a:0 b:0 f:2 g:2\n"
+			"Automaton B\n"
+			"States r u\n"
+			"Final States r u\n"
+			"Transitions\n"
+			"a -> r\n"
+			"b -> r\n"
+			"f(r,r) -> r\n"
+			"g(r,r) -> u\n"
+			"g(u,r) -> u\n"
+			"g(r,u) -> u\n"
+			"g(u,u) -> u\n"), false),
+		// only the leaf b is missing
+		std::make_pair(std::string(
+			"Ops a:0 b:0 f:2 g:2\n"
+			"Automaton B\n"
+			"States r\n"
+			"Final States r\n"
+			"Transitions\n"
+			"a -> r\n"
+			"f(r,r) -> r\n"
+			"g(r,r) -> r\n"), false),
+	};
+
+	StringToStateDict stateDictSmaller;
+	AutType autSmaller;
+	readAut(autSmaller, stateDictSmaller, smallerStr);
+
+	for (const auto& biggerStrResultPair : biggerStrs)
+	{
+		StringToStateDict stateDictBigger;
+		AutType autBigger;
+		readAut(autBigger, stateDictBigger, biggerStrResultPair.first);
+
+		BOOST_CHECK_MESSAGE(biggerStrResultPair.second ==
+			VATA::CheckUpwardInclusion(autSmaller, autBigger),
+			"\n\nError checking inclusion of\n" + smallerStr + "in\n" +
+			biggerStrResultPair.first + "expected " +
+			Convert::ToString(biggerStrResultPair.second));
+
+		BOOST_CHECK_MESSAGE(biggerStrResultPair.second ==
+			VATA::CheckDownwardInclusion(autSmaller, autBigger),
+			"\n\nError checking downward inclusion of\n" + smallerStr + "in\n" +
+			biggerStrResultPair.first + "expected " +
+			Convert::ToString(biggerStrResultPair.second));
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -10,6 +10,7 @@
 
 // VATA headers
 #include <vata/vata.hh>
+#include <vata/bdd_bu_tree_aut.hh>
 #include <vata/bdd_td_tree_aut.hh>
 #include <vata/bdd_td_tree_aut_op.hh>
 
@@ -49,10 +50,99 @@ protected:// methods
 		nextSymbol_(BDD_SIZE, 0)
 	{ }
 
-	virtual ~AutTypeFixture() { }
+	virtual ~AutTypeFixture()
+	{	// in case a test changed the encoding of symbols
+		AutType::SetSymbolSize(AutType::DEFAULT_SYMBOL_SIZE);
+	}
 };
 
 #include "tree_aut_test.hh"
 
+
+BOOST_AUTO_TEST_CASE(aut_symbol_encoding)
+{
+	const std::string autStr =
+		"Ops a:0 b:0 f:2 g:1\n"
+		"Automaton A\n"
+		"States p q r\n"
+		"Final States r\n"
+		"Transitions\n"
+		"a -> p\n"
+		"b -> q\n"
+		"g(p) -> q\n"
+		"f(p,q) -> r\n"
+		"f(q,q) -> r\n";
+
+	StringToStateDict stateDict;
+	AutType aut;
+	readAut(aut, stateDict, autStr);
+	std::string refOut = dumpAut(aut, stateDict);
+	AutDescription descOrig = parser_.ParseString(refOut);
+
+	AutType::StringToSymbolDict oldDict = symbolDict_;
+	AutType::SymbolType oldNextSymbol = nextSymbol_;
+
+	// dense encoding of the alphabet without 'g'
+	AutDescription::SymbolSet alphabet = parser_.ParseString(autStr).symbols;
+	alphabet.erase(AutDescription::Symbol("g", 1));
+
+	symbolDict_ = AutType::StringToSymbolDict();
+	AutType::EncodeAlphabet(alphabet);
+	BOOST_CHECK_EQUAL(AutType::GetSymbolSize(), 2U);
+
+	// 'g' gets the last free code
+	AutType denseAut = VATA::ReencodeSymbols(aut, oldDict);
+	std::string denseOut = dumpAut(denseAut, stateDict);
+	BOOST_CHECK_EQUAL(symbolDict_.size(), 4U);
+	BOOST_CHECK_MESSAGE(descOrig == parser_.ParseString(denseOut),
+		"\n\nExpecting:\n===========\n" + refOut +
+		"===========\n\nGot:\n===========\n" + denseOut + "\n===========");
+	BOOST_CHECK_THROW(AutType::AddSymbol(), std::runtime_error);
+
+	// and back to the original encoding
+	AutType::StringToSymbolDict denseDict = symbolDict_;
+	symbolDict_ = oldDict;
+	nextSymbol_ = oldNextSymbol;
+	AutType::SetSymbolSize(AutType::DEFAULT_SYMBOL_SIZE);
+
+	AutType backAut = VATA::ReencodeSymbols(denseAut, denseDict);
+	std::string backOut = dumpAut(backAut, stateDict);
+	BOOST_CHECK_MESSAGE(descOrig == parser_.ParseString(backOut),
+		"\n\nExpecting:\n===========\n" + refOut +
+		"===========\n\nGot:\n===========\n" + backOut + "\n===========");
+}
+
+BOOST_AUTO_TEST_CASE(aut_bottom_up_conversion)
+{
+	auto testfileContent = ParseTestFile(LOAD_TIMBUK_FILE.string());
+
+	for (auto testcase : testfileContent)
+	{
+		BOOST_REQUIRE_MESSAGE(testcase.size() == 1, "Invalid format of a testcase: " +
+			Convert::ToString(testcase));
+
+		std::string filename = (AUT_DIR / testcase[0]).string();
+		BOOST_MESSAGE("Converting automaton " + filename + "...");
+		std::string autStr = VATA::Util::ReadFile(filename);
+
+		StringToStateDict stateDict;
+		AutType aut;
+		readAut(aut, stateDict, autStr);
+
+		std::string autOut = dumpAut(aut, stateDict);
+		std::string buAutOut = dumpAut(aut.GetBottomUpAut(), stateDict);
+
+		BOOST_CHECK_MESSAGE(parser_.ParseString(autOut) ==
+			parser_.ParseString(buAutOut),
+			"\n\nExpecting:\n===========\n" + autOut +
+			"===========\n\nGot:\n===========\n" + buAutOut + "\n===========");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(aut_equivalence)
+{
+	testInclusion(checkEquivalence);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
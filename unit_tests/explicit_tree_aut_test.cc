@@ -12,6 +12,7 @@
 #include <vata/vata.hh>
 #include <vata/explicit_tree_aut.hh>
 #include <vata/explicit_tree_aut_op.hh>
+#include <vata/util/cancellation.hh>
 
 // testing headers
 #include "log_fixture.hh"
@@ -55,6 +56,61 @@ BOOST_AUTO_TEST_CASE(aut_down_simulation)
 	testDownwardSimulation();
 }
 
+BOOST_AUTO_TEST_CASE(aut_down_simulation_partitioned)
+{
+	auto testfileContent = ParseTestFile(DOWN_SIM_TIMBUK_FILE.string());
+
+	for (auto testcase : testfileContent)
+	{
+		BOOST_REQUIRE_MESSAGE(testcase.size() == 2, "Invalid format of a testcase: " +
+			Convert::ToString(testcase));
+
+		std::string inputFile = (AUT_DIR / testcase[0]).string();
+
+		BOOST_MESSAGE("Computing partitioned downward simulation for " +
+			inputFile + "...");
+
+		StringToStateDict stateDict;
+		AutType aut;
+		readAut(aut, stateDict, VATA::Util::ReadFile(inputFile));
+
+		StateType stateCnt = 0;
+		StateToStateMap stateMap;
+		StateToStateTranslator stateTrans(stateMap,
+			[&stateCnt](const StateType&){return stateCnt++;});
+
+		aut = VATA::RemoveUselessStates(aut);
+		AutType reindexedAut;
+		aut.ReindexStates(reindexedAut, stateTrans);
+
+		StateBinaryRelation sim = VATA::ComputeDownwardSimulation(
+			reindexedAut, stateCnt);
+		VATA::AutBase::StatePartitionedRelation partSim =
+			VATA::ComputePartitionedDownwardSimulation(reindexedAut, stateCnt);
+
+		BOOST_REQUIRE_EQUAL(sim.size(), partSim.size());
+
+		for (size_t i = 0; i < sim.size(); ++i)
+		{
+			for (size_t j = 0; j < sim.size(); ++j)
+			{
+				BOOST_CHECK_EQUAL(sim.get(i, j), partSim.get(i, j));
+			}
+		}
+
+		StateBinaryRelation::IndexType ind, inv, partInd, partInv;
+		sim.buildIndex(ind, inv);
+		partSim.buildIndex(partInd, partInv);
+		BOOST_CHECK(ind == partInd);
+		BOOST_CHECK(inv == partInv);
+
+		std::vector<size_t> heads, partHeads;
+		sim.buildClasses(heads);
+		partSim.buildClasses(partHeads);
+		BOOST_CHECK(heads == partHeads);
+	}
+}
+
 BOOST_AUTO_TEST_CASE(aut_down_inclusion_sim)
 {
 	testInclusion(checkDownInclusionWithSimulation);
@@ -70,9 +126,492 @@ BOOST_AUTO_TEST_CASE(aut_up_inclusion)
 	testInclusion(checkUpInclusion);
 }
 
+BOOST_AUTO_TEST_CASE(aut_equivalence)
+{
+	testInclusion(checkEquivalence);
+}
+
+BOOST_AUTO_TEST_CASE(aut_equivalence_counterexample)
+{
+	testInclusion([](AutType lhs, AutType rhs)
+	{
+		AutType counterexample;
+		bool areEquivalent = VATA::CheckEquivalence(lhs, rhs, &counterexample);
+		BOOST_CHECK_EQUAL(areEquivalent,
+			VATA::CheckInclusion(lhs, rhs) && VATA::CheckInclusion(rhs, lhs));
+
+		if (!areEquivalent)
+		{	// the tree is accepted by exactly one of the automata
+			BOOST_CHECK_NE(VATA::CheckInclusion(counterexample, lhs),
+				VATA::CheckInclusion(counterexample, rhs));
+		}
+
+		return VATA::CheckInclusion(lhs, rhs);
+	});
+}
+
+BOOST_AUTO_TEST_CASE(aut_equivalence_congruence)
+{
+	typedef VATA::ExplicitUpwardEquivalence<AutType::SymbolType> Backend;
+	typedef VATA::UpwardEquivalenceChecker<Backend> Checker;
+
+	// the leaves reach the pairs ({p1}, {r1}), ({p2}, {r1}), ({p2}, {r2}) and
+	// ({p1}, {r2}); none of them is a union of the others, but any of them
+	// follows from the other three by transitivity
+	const std::string lhsStr =
+		"Ops a:0 b:0 c:0 d:0 g:1\n"
+		"Automaton A\n"
+		"States p1 p2 q\n"
+		"Final States q\n"
+		"Transitions\n"
+		"a -> p1\n"
+		"b -> p2\n"
+		"c -> p2\n"
+		"d -> p1\n"
+		"g(p1) -> q\n"
+		"g(p2) -> q\n";
+	const std::string rhsStr =
+		"Ops a:0 b:0 c:0 d:0 g:1\n"
+		"Automaton B\n"
+		"States r1 r2 s\n"
+		"Final States s\n"
+		"Transitions\n"
+		"a -> r1\n"
+		"b -> r1\n"
+		"c -> r2\n"
+		"d -> r2\n"
+		"g(r1) -> s\n"
+		"g(r2) -> s\n";
+
+	AutType lhs;
+	readAut(lhs, lhsStr);
+	AutType rhs;
+	readAut(rhs, rhsStr);
+
+	Backend backend(lhs, rhs);
+	Checker checker(backend);
+	BOOST_CHECK(checker.Check());
+
+	// three of the leaf pairs and the pair ({q}, {s})
+	BOOST_CHECK_EQUAL(checker.GetKeptPairCount(), 4);
+	BOOST_CHECK_EQUAL(checker.GetPrunedPairCount(), 1);
+
+	BOOST_CHECK(VATA::CheckEquivalence(lhs, rhs));
+}
+
 BOOST_AUTO_TEST_CASE(aut_up_inclusion_sim)
 {
 	testInclusion(checkUpInclusionWithSimulation);
 }
 
+BOOST_AUTO_TEST_CASE(aut_word_inclusion)
+{
+	testInclusion([](AutType smaller, AutType bigger)
+	{
+		if (!VATA::IsWordAut(smaller) || !VATA::IsWordAut(bigger))
+		{
+			return VATA::CheckInclusion(smaller, bigger);
+		}
+
+		bool result = VATA::CheckWordInclusion(smaller, bigger, false);
+		BOOST_CHECK_EQUAL(result, VATA::CheckWordInclusion(smaller, bigger, true));
+		return result;
+	});
+}
+
+BOOST_AUTO_TEST_CASE(aut_word_engine)
+{
+	typedef VATA::ExplicitWordAut WordAut;
+
+	// words over {a, b} starting with a leaf b and containing a
+	WordAut aut;
+	aut.AddInitialTransition(1, 0);
+	aut.AddTransition(0, 0, 1);
+	aut.AddTransition(0, 1, 0);
+	aut.AddTransition(1, 0, 1);
+	aut.AddTransition(1, 1, 1);
+	aut.AddTransition(0, 0, 2);
+	aut.SetStateFinal(1);
+	aut.SetStateFinal(2);
+
+	StateBinaryRelation sim = aut.ComputeSimulation();
+	BOOST_CHECK(sim.get(2, 1));
+	BOOST_CHECK(!sim.get(1, 2));
+	BOOST_CHECK(sim.get(0, 1));
+	BOOST_CHECK(!sim.get(1, 0));
+
+	WordAut dfa = aut.Determinize();
+	BOOST_CHECK_EQUAL(dfa.states(), 3);
+	BOOST_CHECK(WordAut::CheckInclusion(aut, dfa));
+	BOOST_CHECK(WordAut::CheckInclusion(dfa, aut));
+
+	WordAut all;
+	all.AddInitialTransition(0, 0);
+	all.AddInitialTransition(1, 0);
+	all.AddTransition(0, 0, 0);
+	all.AddTransition(0, 1, 0);
+	all.SetStateFinal(0);
+
+	WordAut::AlphabetType alphabet = {{0, 0}, {1, 0}, {0, 1}, {1, 1}};
+	for (bool useSimulation : {false, true})
+	{
+		BOOST_CHECK(WordAut::CheckInclusion(aut, all, useSimulation));
+		BOOST_CHECK(!WordAut::CheckInclusion(all, aut, useSimulation));
+		BOOST_CHECK(all.CheckUniversality(alphabet, useSimulation));
+		BOOST_CHECK(!aut.CheckUniversality(alphabet, useSimulation));
+	}
+
+	// conversions keep the language
+	const std::string autStr =
+		"Ops a:0 g:1 h:1\n"
+		"Automaton A\n"
+		"States p q r\n"
+		"Final States r\n"
+		"Transitions\n"
+		"a -> p\n"
+		"g(p) -> q\n"
+		"h(q) -> r\n"
+		"g(r) -> r\n";
+
+	AutType treeAut;
+	readAut(treeAut, autStr);
+	BOOST_REQUIRE(VATA::IsWordAut(treeAut));
+
+	StateType stateCnt = 0;
+	StateToStateMap stateMap;
+	StateToStateTranslator stateTrans(stateMap,
+		[&stateCnt](const StateType&){return stateCnt++;});
+
+	WordAut wordAut;
+	wordAut.LoadFromTreeAut(treeAut, stateTrans,
+		[](const AutType::SymbolType& symbol){ return symbol; });
+	BOOST_CHECK_EQUAL(wordAut.states(), 3);
+
+	AutType backAut;
+	wordAut.ConvertToTreeAut(backAut,
+		[](const StateType& state){ return state; },
+		[](const WordAut::LabelType& label){ return label; });
+	BOOST_CHECK(VATA::CheckInclusion(treeAut, backAut));
+	BOOST_CHECK(VATA::CheckInclusion(backAut, treeAut));
+	BOOST_CHECK(!VATA::CheckWordUniversality(treeAut));
+}
+
+BOOST_AUTO_TEST_CASE(aut_contexts)
+{
+	const std::string autStrA =
+		"Ops a:0 f:2\n"
+		"Automaton A\n"
+		"States p q\n"
+		"Final States q\n"
+		"Transitions\n"
+		"a -> p\n"
+		"f(p, p) -> q\n";
+	const std::string autStrB =
+		"Ops a:0 g:1\n"
+		"Automaton B\n"
+		"States r\n"
+		"Final States r\n"
+		"Transitions\n"
+		"a -> r\n"
+		"g(r) -> r\n";
+
+	const size_t defaultSymbols = symbolDict_.size();
+
+	AutType::Context contextA;
+	AutType::Context contextB;
+
+	StringToStateDict stateDictA;
+	AutType autA(contextA);
+	readAut(autA, stateDictA, autStrA);
+
+	AutType autB(contextB);
+	readAut(autB, autStrB);
+
+	// every context has its own alphabet
+	BOOST_CHECK_EQUAL(contextA.GetSymbolDict().size(), 2);
+	BOOST_CHECK_EQUAL(contextB.GetSymbolDict().size(), 2);
+	BOOST_CHECK_EQUAL(symbolDict_.size(), defaultSymbols);
+
+	AutDescription descOut = parser_.ParseString(dumpAut(autA, stateDictA));
+	BOOST_CHECK(descOut == parser_.ParseString(autStrA));
+
+	// results of operations are bound to the context of the operands
+	AutType autUnion = VATA::Union(autA, autA);
+	BOOST_CHECK(&autUnion.GetContext() == &contextA);
+	BOOST_CHECK(VATA::CheckInclusion(autA, autUnion));
+
+	BOOST_CHECK_THROW(VATA::Union(autA, autB), std::runtime_error);
+	BOOST_CHECK_THROW(VATA::Intersection(autA, autB), std::runtime_error);
+	BOOST_CHECK_THROW(VATA::CheckInclusion(autA, autB), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(aut_default_context_states)
+{
+	AutType::StateType nextState = 42;
+	AutType::SetNextStatePtr(&nextState);
+
+	// the default context allocates states from the shared counter
+	AutType aut;
+	BOOST_CHECK_EQUAL(aut.AddState(), 42);
+	BOOST_CHECK_EQUAL(aut.AddState(), 43);
+	BOOST_CHECK_EQUAL(nextState, 44);
+
+	// other contexts have their own counters
+	AutType::Context context;
+	AutType autContext(context);
+	BOOST_CHECK_EQUAL(autContext.AddState(), 0);
+	BOOST_CHECK_EQUAL(nextState, 44);
+
+	AutType::SetNextStatePtr(&nextState_);
+}
+
+BOOST_AUTO_TEST_CASE(aut_intersection_transl_map)
+{
+	const std::string autStr =
+		"Ops a:0 f:2\n"
+		"Automaton A\n"
+		"States p q\n"
+		"Final States q\n"
+		"Transitions\n"
+		"a -> p\n"
+		"f(p, p) -> q\n";
+
+	StringToStateDict stateDict;
+	AutType aut;
+	readAut(aut, stateDict, autStr);
+
+	const AutType::StateType p = stateDict.TranslateFwd("p");
+	const AutType::StateType q = stateDict.TranslateFwd("q");
+
+	// entries already in the map are kept and new states are numbered after them
+	VATA::AutBase::ProductTranslMap translMap;
+	translMap.insert(std::make_pair(std::make_pair(p, p), 7));
+	translMap.insert(std::make_pair(std::make_pair(1000, 1000), 0));
+
+	AutType autIsect = VATA::Intersection(aut, aut, &translMap);
+
+	BOOST_REQUIRE_EQUAL(translMap.size(), 3);
+	BOOST_CHECK_EQUAL(translMap[std::make_pair(p, p)], 7);
+	BOOST_CHECK_EQUAL(translMap[std::make_pair(1000, 1000)], 0);
+	BOOST_CHECK_EQUAL(translMap[std::make_pair(q, q)], 2);
+
+	// the imported pair is reused, but not explored again
+	BOOST_CHECK(autIsect.GetFinalStates() == AutType::StateSet({2}));
+	size_t transitions = 0;
+	for (const auto& trans : autIsect)
+	{
+		BOOST_CHECK_EQUAL(trans.state(), 2);
+		BOOST_CHECK(trans.children() == AutType::StateTuple({7, 7}));
+		++transitions;
+	}
+
+	BOOST_CHECK_EQUAL(transitions, 1);
+}
+
+BOOST_AUTO_TEST_CASE(aut_intersection_mixed_ranks)
+{
+	// the symbol 1 is used with ranks 1, 2 and 3
+	AutType aut;
+	aut.AddTransition(AutType::StateTuple(), 0, 0);
+	aut.AddTransition(AutType::StateTuple({0}), 1, 1);
+	aut.AddTransition(AutType::StateTuple({0, 0}), 1, 1);
+	aut.AddTransition(AutType::StateTuple({0, 0, 0}), 1, 1);
+	aut.SetStateFinal(1);
+
+	VATA::AutBase::ProductTranslMap translMap;
+	AutType autIsect = VATA::Intersection(aut, aut, &translMap);
+
+	const AutType::StateType leaf = translMap[std::make_pair(0, 0)];
+
+	std::set<size_t> ranks;
+	for (const auto& trans : autIsect)
+	{
+		for (const auto& child : trans.children())
+		{
+			BOOST_CHECK_EQUAL(child, leaf);
+		}
+
+		BOOST_CHECK(ranks.insert(trans.children().size()).second);
+	}
+
+	BOOST_CHECK(ranks == std::set<size_t>({0, 1, 2, 3}));
+	BOOST_CHECK(VATA::CheckInclusion(aut, autIsect));
+	BOOST_CHECK(VATA::CheckInclusion(autIsect, aut));
+}
+
+BOOST_AUTO_TEST_CASE(aut_parallel_reachability)
+{
+	typedef std::tuple<std::vector<AutType::StateType>, AutType::SymbolType,
+		AutType::StateType> TransitionTuple;
+
+	// enough leaves for the frontier to be split among threads
+	const AutType::StateType leaves = 3000;
+	const AutType::StateType root = 2 * leaves;
+	const AutType::StateType sink = 3 * leaves;
+	const AutType::StateType dead = 4 * leaves;
+
+	auto build = [&](AutType::Context& context)
+	{
+		AutType aut(context);
+
+		for (AutType::StateType i = 0; i < leaves; ++i)
+		{
+			aut.AddTransition(AutType::StateTuple(), 0, i);
+		}
+
+		for (AutType::StateType i = 0; i + 1 < leaves; ++i)
+		{
+			aut.AddTransition(AutType::StateTuple({i, i + 1}), 1, leaves + i);
+
+			// the sink is never reached bottom-up
+			aut.AddTransition(AutType::StateTuple({i, sink}), 1, root);
+
+			// the dead state does not reach the root
+			aut.AddTransition(AutType::StateTuple({leaves + i}), 2, dead);
+
+			if (i % 2 == 0)
+			{
+				aut.AddTransition(AutType::StateTuple({leaves + i}), 3, root);
+			}
+		}
+
+		aut.SetStateFinal(root);
+
+		return aut;
+	};
+
+	auto transitions = [](const AutType& aut)
+	{
+		std::set<TransitionTuple> result;
+		for (const auto& trans : aut)
+		{
+			result.insert(TransitionTuple(std::vector<AutType::StateType>(
+				trans.children().begin(), trans.children().end()),
+				trans.symbol(), trans.state()));
+		}
+
+		return result;
+	};
+
+	AutType::Context sequentialContext;
+	AutType::Context parallelContext;
+	parallelContext.SetParallelism(4);
+
+	BOOST_CHECK_EQUAL(sequentialContext.GetParallelism(), 1);
+	BOOST_CHECK_EQUAL(parallelContext.GetParallelism(), 4);
+
+	AutType sequentialAut = build(sequentialContext);
+	AutType parallelAut = build(parallelContext);
+
+	std::set<TransitionTuple> sequentialUseless =
+		transitions(VATA::RemoveUselessStates(sequentialAut));
+	std::set<TransitionTuple> parallelUseless =
+		transitions(VATA::RemoveUselessStates(parallelAut));
+
+	BOOST_CHECK(sequentialUseless == parallelUseless);
+	BOOST_CHECK_EQUAL(sequentialUseless.size(), leaves + 2 * (leaves / 2));
+	for (const TransitionTuple& trans : parallelUseless)
+	{
+		BOOST_CHECK(std::get<2>(trans) != dead);
+		BOOST_CHECK(std::find(std::get<0>(trans).begin(), std::get<0>(trans).end(),
+			sink) == std::get<0>(trans).end());
+	}
+
+	std::set<TransitionTuple> sequentialUnreach =
+		transitions(VATA::RemoveUnreachableStates(sequentialAut));
+	std::set<TransitionTuple> parallelUnreach =
+		transitions(VATA::RemoveUnreachableStates(parallelAut));
+
+	BOOST_CHECK(sequentialUnreach == parallelUnreach);
+	BOOST_CHECK_EQUAL(sequentialUnreach.size(),
+		leaves + (leaves - 1) + 2 * (leaves / 2));
+}
+
+BOOST_AUTO_TEST_CASE(aut_cancellation)
+{
+	const std::string autStr =
+		"Ops a:0 f:2\n"
+		"Automaton A\n"
+		"States p q\n"
+		"Final States q\n"
+		"Transitions\n"
+		"a -> p\n"
+		"f(p, p) -> q\n"
+		"f(q, p) -> q\n";
+
+	AutType aut;
+	readAut(aut, autStr);
+
+	VATA::Util::CancellationToken token;
+	token.Cancel();
+
+	{
+		VATA::Util::CancellationScope scope(token);
+		BOOST_CHECK(VATA::Util::CancellationToken::GetCurrent() == &token);
+
+		BOOST_CHECK_THROW(VATA::CheckUpwardInclusion(aut, aut),
+			VATA::Util::OperationCancelled);
+		BOOST_CHECK_THROW(VATA::CheckDownwardInclusion(aut, aut),
+			VATA::Util::OperationCancelled);
+		BOOST_CHECK_THROW(VATA::ComputeDownwardSimulation(aut, 2),
+			VATA::Util::OperationCancelled);
+	}
+
+	// the token is not polled outside of the scope
+	BOOST_CHECK(VATA::Util::CancellationToken::GetCurrent() == nullptr);
+	BOOST_CHECK(VATA::CheckUpwardInclusion(aut, aut));
+}
+
+BOOST_AUTO_TEST_CASE(aut_deadline)
+{
+	const std::string autStr =
+		"Ops a:0 f:2\n"
+		"Automaton A\n"
+		"States p q\n"
+		"Final States q\n"
+		"Transitions\n"
+		"a -> p\n"
+		"f(p, p) -> q\n"
+		"f(q, p) -> q\n";
+
+	AutType aut;
+	readAut(aut, autStr);
+
+	VATA::Util::CancellationToken token;
+	token.SetTimeout(-1);
+
+	{
+		VATA::Util::CancellationScope scope(token);
+
+		BOOST_CHECK_THROW(VATA::CheckUpwardInclusion(aut, aut),
+			VATA::Util::OperationTimedOut);
+		BOOST_CHECK(token.IsTimedOut());
+
+		// the expired token stops the other engines at once
+		BOOST_CHECK_THROW(VATA::CheckDownwardInclusion(aut, aut),
+			VATA::Util::OperationTimedOut);
+		BOOST_CHECK_THROW(VATA::Complement(aut, aut.GetAlphabet()),
+			VATA::Util::OperationTimedOut);
+	}
+
+	VATA::Util::CancellationToken progressToken;
+	progressToken.SetTimeout(3600);
+
+	std::vector<std::string> engines;
+	progressToken.SetProgressCallback(
+		[&engines](const VATA::Util::Progress& progress)
+		{
+			engines.push_back(progress.engine);
+		}, 0);
+
+	{
+		VATA::Util::CancellationScope scope(progressToken);
+		BOOST_CHECK(VATA::CheckUpwardInclusion(aut, aut));
+	}
+
+	BOOST_CHECK(!progressToken.IsCancelled());
+	BOOST_REQUIRE(!engines.empty());
+	BOOST_CHECK_EQUAL(engines.front(), "upward inclusion");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -14,6 +14,7 @@
 #include <vata/mtbdd/apply2func.hh>
 #include <vata/mtbdd/apply3func.hh>
 #include <vata/mtbdd/ondriks_mtbdd.hh>
+#include <vata/mtbdd/var_ordering.hh>
 #include <vata/mtbdd/var_asgn.hh>
 #include <vata/util/convert.hh>
 
@@ -21,6 +22,7 @@ using VATA::MTBDDPkg::OndriksMTBDD;
 using VATA::MTBDDPkg::Apply1Functor;
 using VATA::MTBDDPkg::Apply2Functor;
 using VATA::MTBDDPkg::Apply3Functor;
+using VATA::MTBDDPkg::VarOrdering;
 using VATA::Util::Convert;
 
 
@@ -672,6 +674,62 @@ BOOST_AUTO_TEST_CASE(apply)
 }
 
 
+BOOST_AUTO_TEST_CASE(memoized_apply)
+{
+	// load test cases
+	ListOfTestCasesType testCases;
+	ListOfTestCasesType failedCases;
+	loadStandardTests(testCases, failedCases);
+
+	MTBDD bdd = createMTBDDForTestCases(testCases);
+
+	// apply functor that multiplies values in leaves and counts the calls
+	GCC_DIAG_OFF(effc++)
+	class CountingTimesApply2Functor :
+		public Apply2Functor<CountingTimesApply2Functor, DataType, DataType, DataType>
+	{
+	GCC_DIAG_ON(effc++)
+
+	public:
+
+		unsigned calls;
+
+		CountingTimesApply2Functor() :
+			calls(0)
+		{
+			enableLeafMemoization();
+		}
+
+		inline DataType ApplyOperation(const DataType& lhs, const DataType& rhs)
+		{
+			++calls;
+			return lhs * rhs;
+		}
+	};
+
+	CountingTimesApply2Functor func;
+
+	MTBDD timesBdd = func(bdd, bdd);
+	unsigned callsFirst = func.calls;
+	MTBDD timesBdd2 = func(bdd, bdd);
+
+	// only the default values are combined again
+	BOOST_CHECK(func.calls == callsFirst + 1);
+
+	for (ListOfTestCasesType::const_iterator itTests = testCases.begin();
+		itTests != testCases.end(); ++itTests)
+	{	// test that the test cases have been stored properly
+		FormulaParser::ParserResultUnsignedType prsRes =
+			FormulaParser::ParseExpressionUnsigned(*itTests);
+		DataType leafValue = static_cast<DataType>(prsRes.first);
+		leafValue *= leafValue;
+		VarAsgn asgn = varListToAsgn(prsRes.second);
+
+		BOOST_CHECK_MESSAGE(timesBdd2.GetValue(asgn) == leafValue,
+			*itTests + " != " + Convert::ToString(timesBdd2.GetValue(asgn)));
+	}
+}
+
 BOOST_AUTO_TEST_CASE(ternary_apply)
 {
 	// load test cases
@@ -720,6 +778,82 @@ BOOST_AUTO_TEST_CASE(ternary_apply)
 }
 
 
+BOOST_AUTO_TEST_CASE(variable_reordering)
+{
+	boost::mt19937 prnGen(PRNG_SEED);
+
+	// formulae that we wish to store in the BDD
+	ListOfTestCasesType testCases;
+
+	for (unsigned i = 0; i < LARGE_TEST_FORMULA_CASES; ++i)
+	{	// generate test cases
+		std::string formula;
+
+		for (unsigned j = 0; j < NUM_VARIABLES; ++j)
+		{
+			if (prnGen() % 4 != 0)
+			{
+				formula += (formula.empty()? "" : " * ") +
+					Convert::ToString((prnGen() % 2 == 0)? " " : "~")
+					+ "x" + Convert::ToString(j);
+			}
+		}
+
+		DataType randomNum;
+		while ((randomNum = prnGen()) == 0) ;   // generate non-zero random number
+
+		formula += " = " + Convert::ToString(static_cast<unsigned>(randomNum));
+
+		testCases.push_back(formula);
+	}
+
+	MTBDD bdd = createMTBDDForTestCases(testCases);
+
+	// checks that the test cases are still stored in the BDD
+	auto checkTestCases = [&](const MTBDD& checkedBdd)
+	{
+		for (ListOfTestCasesType::const_iterator itTests = testCases.begin();
+			itTests != testCases.end(); ++itTests)
+		{
+			FormulaParser::ParserResultUnsignedType prsRes =
+				FormulaParser::ParseExpressionUnsigned(*itTests);
+			DataType leafValue = static_cast<DataType>(prsRes.first);
+			VarAsgn asgn = varListToAsgn(prsRes.second);
+
+			BOOST_CHECK_MESSAGE(checkedBdd.GetValue(asgn) == leafValue,
+				*itTests + " != " + Convert::ToString(checkedBdd.GetValue(asgn)));
+		}
+	};
+
+	for (unsigned i = 0; i < NUM_VARIABLES; ++i)
+	{	// shuffle the variables by random swaps
+		VarOrdering::SwapAdjacentLevels(prnGen() % (NUM_VARIABLES - 1));
+	}
+
+	checkTestCases(bdd);
+
+	// diagrams constructed with the new ordering need to work as well
+	MTBDD rebuiltBdd = createMTBDDForTestCases(testCases);
+	BOOST_CHECK(rebuiltBdd.GetValue(VarAsgn(VAR_COUNT)) == DEFAULT_DATA_VALUE);
+	checkTestCases(rebuiltBdd);
+
+	size_t sizeBefore = VarOrdering::GetNodeCount();
+	VarOrdering::Sift();
+	BOOST_CHECK(VarOrdering::GetNodeCount() <= sizeBefore);
+
+	checkTestCases(bdd);
+	checkTestCases(rebuiltBdd);
+
+	// the dump names the variables, not the levels they are at
+	std::string dot = MTBDD::DumpToDot({&bdd});
+	for (unsigned j = 0; j < NUM_VARIABLES; ++j)
+	{
+		BOOST_CHECK_MESSAGE(dot.find("[label = \"x" + Convert::ToString(j) + "\"]")
+			!= std::string::npos, "Variable x" + Convert::ToString(j) +
+			" missing in the dump");
+	}
+}
+
 // BOOST_AUTO_TEST_CASE(variable_renaming)
 // {
 // 	ASMTBDDCC* bdd = new CuddMTBDDCC();
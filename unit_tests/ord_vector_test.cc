@@ -0,0 +1,232 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2011  Ondra Lengal <ilengal@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Test suite for the OrdVector class and the kernels of operations on
+ *    sorted sets.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/util/ord_vector.hh>
+#include <vata/util/sorted_set_kernels.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+using VATA::Util::OrdVector;
+using VATA::Util::SmallOrdVector;
+
+namespace SortedSetKernels = VATA::Util::SortedSetKernels;
+
+
+// Boost headers
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OrdVector
+#include <boost/test/unit_test.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+
+/******************************************************************************
+ *                                  Constants                                 *
+ ******************************************************************************/
+
+
+/**
+ * Number of random pairs of sets tested for each instruction set
+ */
+const unsigned RANDOM_TEST_CASES = 2000;
+
+/**
+ * Instruction sets to be tested (if supported by the CPU)
+ */
+const SortedSetKernels::InstructionSet INSTRUCTION_SETS[] =
+{
+	SortedSetKernels::InstructionSet::SCALAR,
+	SortedSetKernels::InstructionSet::SSE42,
+	SortedSetKernels::InstructionSet::AVX2
+};
+
+
+/******************************************************************************
+ *                                  Fixtures                                  *
+ ******************************************************************************/
+
+/**
+ * @brief  Fixture generating random sorted sets
+ */
+class OrdVectorFixture
+{
+private:  // data members
+
+	boost::random::mt19937 gen_;
+
+public:   // methods
+
+	OrdVectorFixture() :
+		gen_()
+	{ }
+
+	/**
+	 * @brief  Generates a random sorted set
+	 *
+	 * Sizes and densities vary so that both the merging and the galloping
+	 * paths of the kernels are exercised.
+	 */
+	template <class T>
+	std::vector<T> randomSet(T maxValue)
+	{
+		static const size_t SIZES[] = {0, 1, 2, 3, 5, 8, 17, 64, 300, 2000};
+
+		boost::random::uniform_int_distribution<size_t> sizeDist(0,
+			sizeof(SIZES) / sizeof(SIZES[0]) - 1);
+		boost::random::uniform_int_distribution<T> valueDist(0, maxValue);
+
+		std::vector<T> result(SIZES[sizeDist(gen_)]);
+		for (T& value : result)
+		{
+			value = valueDist(gen_);
+		}
+
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+		return result;
+	}
+
+	template <class T>
+	void testKernels(T maxValue)
+	{
+		for (unsigned i = 0; i < RANDOM_TEST_CASES; ++i)
+		{
+			std::vector<T> lhs = randomSet<T>(maxValue);
+			std::vector<T> rhs = randomSet<T>(maxValue);
+			if (i % 4 == 0)
+			{	// make lhs a subset of rhs
+				std::vector<T> tmp;
+				std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+					std::back_inserter(tmp));
+				rhs.swap(tmp);
+			}
+
+			std::vector<T> expUnion;
+			std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+				std::back_inserter(expUnion));
+			std::vector<T> expIsect;
+			std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+				std::back_inserter(expIsect));
+
+			std::vector<T> out(lhs.size() + rhs.size());
+			out.resize(SortedSetKernels::Union(lhs.data(), lhs.size(),
+				rhs.data(), rhs.size(), out.data()));
+			BOOST_REQUIRE(out == expUnion);
+
+			out.resize(lhs.size() + rhs.size());
+			out.resize(SortedSetKernels::Intersection(lhs.data(), lhs.size(),
+				rhs.data(), rhs.size(), out.data()));
+			BOOST_REQUIRE(out == expIsect);
+
+			BOOST_REQUIRE_EQUAL(SortedSetKernels::Intersects(lhs.data(),
+				lhs.size(), rhs.data(), rhs.size()), !expIsect.empty());
+			BOOST_REQUIRE_EQUAL(SortedSetKernels::IsSubset(lhs.data(), lhs.size(),
+				rhs.data(), rhs.size()), expIsect.size() == lhs.size());
+			BOOST_REQUIRE_EQUAL(SortedSetKernels::IsSubset(rhs.data(), rhs.size(),
+				lhs.data(), lhs.size()), expIsect.size() == rhs.size());
+		}
+	}
+};
+
+
+/******************************************************************************
+ *                              Start of testing                              *
+ ******************************************************************************/
+
+
+BOOST_FIXTURE_TEST_SUITE(suite, OrdVectorFixture)
+
+BOOST_AUTO_TEST_CASE(kernels)
+{
+	SortedSetKernels::InstructionSet original =
+		SortedSetKernels::GetInstructionSet();
+
+	for (SortedSetKernels::InstructionSet isa : INSTRUCTION_SETS)
+	{
+		if (!SortedSetKernels::SetInstructionSet(isa))
+		{	// not supported by the CPU
+			continue;
+		}
+
+		BOOST_TEST_MESSAGE("Testing kernels: " +
+			std::string(SortedSetKernels::GetInstructionSetName(isa)));
+
+		// small values for dense sets, large values that need unsigned comparison
+		testKernels<uint32_t>(4000);
+		testKernels<uint32_t>(0xFFFFFFFF);
+		testKernels<uint64_t>(4000);
+		testKernels<uint64_t>(0xFFFFFFFFFFFFFFFFULL);
+	}
+
+	BOOST_REQUIRE(SortedSetKernels::SetInstructionSet(original));
+}
+
+BOOST_AUTO_TEST_CASE(ord_vector_operations)
+{
+	OrdVector<size_t> lhs = {1, 5, 3, 9, 7};
+	OrdVector<size_t> rhs = {2, 3, 4, 9};
+
+	BOOST_CHECK(lhs.Union(rhs) == OrdVector<size_t>({1, 2, 3, 4, 5, 7, 9}));
+	BOOST_CHECK(lhs.Intersection(rhs) == OrdVector<size_t>({3, 9}));
+	BOOST_CHECK(!lhs.HaveEmptyIntersection(rhs));
+	BOOST_CHECK(lhs.HaveEmptyIntersection(OrdVector<size_t>({2, 4, 6})));
+	BOOST_CHECK(OrdVector<size_t>().HaveEmptyIntersection(lhs));
+	BOOST_CHECK(OrdVector<size_t>({3, 9}).IsSubsetOf(lhs));
+	BOOST_CHECK(!rhs.IsSubsetOf(lhs));
+
+	lhs.insert(4);
+	lhs.insert(0);
+	lhs.insert(4);
+	BOOST_CHECK(lhs == OrdVector<size_t>({0, 1, 3, 4, 5, 7, 9}));
+
+	// elements without kernels use the generic algorithms
+	typedef std::vector<size_t> Tuple;
+	OrdVector<Tuple> tuples = {Tuple({1, 2}), Tuple({0})};
+	OrdVector<Tuple> others = {Tuple({1, 2}), Tuple({3})};
+	BOOST_CHECK(tuples.Union(others).size() == 3);
+	BOOST_CHECK(tuples.Intersection(others) == OrdVector<Tuple>({Tuple({1, 2})}));
+	BOOST_CHECK(!tuples.IsSubsetOf(others));
+}
+
+BOOST_AUTO_TEST_CASE(small_ord_vector_operations)
+{
+	typedef SmallOrdVector<size_t>::Type SmallSet;
+
+	SmallSet lhs = {1, 5, 3};
+	SmallSet rhs = {2, 3, 4, 9, 11};
+
+	BOOST_CHECK(lhs.Union(rhs) == SmallSet({1, 2, 3, 4, 5, 9, 11}));
+	BOOST_CHECK(lhs.Intersection(rhs) == SmallSet({3}));
+	BOOST_CHECK(!lhs.HaveEmptyIntersection(rhs));
+	BOOST_CHECK(SmallSet({3}).IsSubsetOf(lhs));
+
+	// grow past the inline capacity
+	for (size_t i = 20; i > 0; --i)
+	{
+		lhs.insert(2 * i);
+	}
+
+	BOOST_CHECK_EQUAL(lhs.size(), 23);
+	BOOST_CHECK(std::is_sorted(lhs.begin(), lhs.end()));
+	BOOST_CHECK(rhs.Union(lhs).IsSubsetOf(lhs.Union(rhs)));
+
+	SmallSet copy = lhs;
+	BOOST_CHECK(copy == lhs);
+	copy = rhs;
+	BOOST_CHECK(copy == SmallSet({2, 3, 4, 9, 11}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,193 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Copyright (c) 2012  Jiri Simacek <isimacek@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Test suite for the PersistentHashMap class.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/util/persistent_map.hh>
+
+// Standard library headers
+#include <map>
+#include <string>
+
+using VATA::Util::PersistentHashMap;
+
+
+// Boost headers
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PersistentHashMap
+#include <boost/test/unit_test.hpp>
+
+
+/******************************************************************************
+ *                                  Constants                                 *
+ ******************************************************************************/
+
+
+/**
+ * Number of entries inserted in the tests (more than fit into one node)
+ */
+const size_t ENTRIES = 5000;
+
+
+/******************************************************************************
+ *                                  Fixtures                                  *
+ ******************************************************************************/
+
+/**
+ * @brief  Hasher mapping all keys to the same hash
+ */
+struct ConstantHash
+{
+	size_t operator()(size_t) const
+	{
+		return 42;
+	}
+};
+
+/**
+ * @brief  Hasher mapping keys to a few hashes sharing most bits
+ */
+struct CollidingHash
+{
+	size_t operator()(size_t key) const
+	{
+		return (key % 3) << 30;
+	}
+};
+
+/**
+ * @brief  Fixture comparing maps with std::map
+ */
+class PersistentHashMapFixture
+{
+public:   // methods
+
+	template <class Map>
+	static void checkEqual(const Map& map, const std::map<size_t, size_t>& ref)
+	{
+		BOOST_REQUIRE_EQUAL(map.size(), ref.size());
+		BOOST_REQUIRE_EQUAL(map.empty(), ref.empty());
+
+		// every entry is visited exactly once
+		std::map<size_t, size_t> visited;
+		for (auto& keyValuePair : map)
+		{
+			BOOST_REQUIRE(visited.insert(keyValuePair).second);
+		}
+
+		BOOST_REQUIRE(visited == ref);
+
+		for (auto& keyValuePair : ref)
+		{
+			auto iter = map.find(keyValuePair.first);
+			BOOST_REQUIRE(iter != map.end());
+			BOOST_REQUIRE_EQUAL(iter->first, keyValuePair.first);
+			BOOST_REQUIRE_EQUAL(iter->second, keyValuePair.second);
+			BOOST_REQUIRE_EQUAL(map.count(keyValuePair.first), 1);
+		}
+	}
+
+	template <class Map>
+	static void testOperations()
+	{
+		Map map;
+		std::map<size_t, size_t> ref;
+
+		checkEqual(map, ref);
+		BOOST_REQUIRE(map.find(0) == map.end());
+
+		for (size_t i = 0; i < ENTRIES; ++i)
+		{
+			auto result = map.insert(std::make_pair(3 * i, i));
+			BOOST_REQUIRE(result.second);
+			BOOST_REQUIRE(result.first != map.end());
+			BOOST_REQUIRE_EQUAL(result.first->first, 3 * i);
+			BOOST_REQUIRE_EQUAL(result.first->second, i);
+
+			ref.insert(std::make_pair(3 * i, i));
+		}
+
+		checkEqual(map, ref);
+
+		// inserting a present key keeps the entry
+		auto result = map.insert(std::make_pair(3, 100));
+		BOOST_CHECK(!result.second);
+		BOOST_CHECK_EQUAL(result.first->first, 3);
+		BOOST_CHECK_EQUAL(result.first->second, 1);
+		BOOST_CHECK(map.find(1) == map.end());
+		BOOST_CHECK_EQUAL(map.count(1), 0);
+
+		// modifications of a copy do not change the original
+		Map copy = map;
+		const std::map<size_t, size_t> refCopy = ref;
+
+		for (size_t i = 0; i < ENTRIES; i += 2)
+		{
+			copy[3 * i] += ENTRIES;
+			ref[3 * i] += ENTRIES;
+		}
+
+		for (size_t i = 0; i < ENTRIES; i += 7)
+		{
+			BOOST_REQUIRE_EQUAL(copy[3 * i + 1], 0);
+			ref[3 * i + 1] = 0;
+		}
+
+		checkEqual(copy, ref);
+		checkEqual(map, refCopy);
+
+		map.clear();
+		checkEqual(map, std::map<size_t, size_t>());
+		checkEqual(copy, ref);
+	}
+};
+
+
+/******************************************************************************
+ *                              Start of testing                              *
+ ******************************************************************************/
+
+
+BOOST_FIXTURE_TEST_SUITE(suite, PersistentHashMapFixture)
+
+BOOST_AUTO_TEST_CASE(operations)
+{
+	testOperations<PersistentHashMap<size_t, size_t>>();
+}
+
+BOOST_AUTO_TEST_CASE(colliding_hashes)
+{
+	testOperations<PersistentHashMap<size_t, size_t, CollidingHash>>();
+}
+
+BOOST_AUTO_TEST_CASE(constant_hash)
+{
+	testOperations<PersistentHashMap<size_t, size_t, ConstantHash>>();
+}
+
+BOOST_AUTO_TEST_CASE(string_values)
+{
+	PersistentHashMap<std::string, std::string> map;
+
+	map["a"] = "x";
+	PersistentHashMap<std::string, std::string> copy = map;
+	copy["a"] += "y";
+	copy["b"] = "z";
+
+	BOOST_CHECK_EQUAL(map.size(), 1);
+	BOOST_CHECK_EQUAL(map.find("a")->second, "x");
+	BOOST_CHECK(map.find("b") == map.end());
+
+	BOOST_CHECK_EQUAL(copy.size(), 2);
+	BOOST_CHECK_EQUAL(copy.find("a")->second, "xy");
+	BOOST_CHECK_EQUAL(copy.find("b")->second, "z");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
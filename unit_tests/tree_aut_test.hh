@@ -127,7 +127,15 @@ protected:// methods
 	{
 		return aut.DumpToString(serializer_,
 			StateBackTranslatorStrict(stateDict.GetReverseMap()),
-			SymbolBackTranslatorStrict(Automaton::GetSymbolDict().GetReverseMap()));
+			SymbolBackTranslatorStrict(aut.GetSymbolDict().GetReverseMap()));
+	}
+
+	template <class Automaton, class StateNames>
+	std::string dumpAutLazy(const Automaton& aut, const StateNames& stateNames)
+	{
+		return aut.DumpToString(serializer_,
+			[&stateNames](const AutBase::StateType& state){ return stateNames(state); },
+			SymbolBackTranslatorStrict(aut.GetSymbolDict().GetReverseMap()));
 	}
 
 	void testInclusion(bool (*inclFunc)(AutType, AutType))
@@ -219,6 +227,25 @@ protected:// methods
 		return VATA::CheckUpwardInclusionWithPreorder(smaller, bigger, ident);
 	}
 
+	static bool checkEquivalence(AutType smaller, AutType bigger)
+	{
+		// the inclusion holds iff adding the smaller language does not change
+		// the bigger one
+		AutType unionAut = VATA::Union(smaller, bigger);
+
+		AutType counterexample;
+		bool areEquivalent = VATA::CheckEquivalence(bigger, unionAut, &counterexample);
+		if (!areEquivalent)
+		{	// the tree is in the smaller language only
+			BOOST_CHECK(VATA::CheckInclusion(counterexample, smaller));
+			BOOST_CHECK(!VATA::CheckInclusion(counterexample, bigger));
+		}
+
+		BOOST_CHECK(VATA::CheckEquivalence(smaller, smaller));
+
+		return areEquivalent;
+	}
+
 	static bool checkUpInclusionWithSimulation(AutType smaller, AutType bigger)
 	{
 		AutBase::StateType states =
@@ -573,6 +600,14 @@ BOOST_AUTO_TEST_CASE(aut_union_trans_table_copy)
 		BOOST_CHECK_MESSAGE(descOut == descCorrect,
 			"\n\nExpecting:\n===========\n" + autCorrectStr +
 			"===========\n\nGot:\n===========\n" + autUnionStr + "\n===========");
+
+		std::string autUnionLazyStr = dumpAutLazy(autUnion,
+			VATA::Util::UnionStateNames(stateDictLhs, stateDictRhs,
+				&stateTranslMapLhs, &stateTranslMapRhs));
+
+		BOOST_CHECK_MESSAGE(autUnionLazyStr == autUnionStr,
+			"\n\nExpecting:\n===========\n" + autUnionStr +
+			"===========\n\nGot:\n===========\n" + autUnionLazyStr + "\n===========");
 	}
 }
 
@@ -621,6 +656,13 @@ BOOST_AUTO_TEST_CASE(aut_intersection)
 		BOOST_CHECK_MESSAGE(descOut == descCorrect,
 			"\n\nExpecting:\n===========\n" + autCorrectStr +
 			"===========\n\nGot:\n===========\n" + autIntersectStr + "\n===========");
+
+		std::string autIntersectLazyStr = dumpAutLazy(autIntersect,
+			VATA::Util::ProductStateNames(stateDictLhs, stateDictRhs, translMap));
+
+		BOOST_CHECK_MESSAGE(autIntersectLazyStr == autIntersectStr,
+			"\n\nExpecting:\n===========\n" + autIntersectStr +
+			"===========\n\nGot:\n===========\n" + autIntersectLazyStr + "\n===========");
 	}
 }
 